@@ -42,7 +42,7 @@ int main(int argc, char **argv) {
     Var x("x"), y("y"), c("c");
 
     Func clamped;
-    clamped(x, y, c) = input(clamp(x, 0, input.width()-1), clamp(y, 0, input.height()-1), c);
+    clamped(x, y, c) = BoundaryConditions::repeat_edge(input)(x, y, c);
 
     // This triggers a bug in llvm 3.3 (3.2 and trunk are fine), so we
     // rewrite it in a way that doesn't trigger the bug. The rewritten
@@ -60,7 +60,10 @@ int main(int argc, char **argv) {
             // pixels off each edge.
             Expr w = input.width()/(1 << l);
             Expr h = input.height()/(1 << l);
-            prev = lambda(x, y, c, prev(clamp(x, 0, w), clamp(y, 0, h), c));
+            vector<std::pair<Expr, Expr> > bounds;
+            bounds.push_back(std::make_pair(0, w + 1));
+            bounds.push_back(std::make_pair(0, h + 1));
+            prev = BoundaryConditions::repeat_edge(prev, bounds);
         }
 
         downx[l](x, y, c) = (prev(x*2-1, y, c) +
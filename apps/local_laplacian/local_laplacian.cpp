@@ -26,6 +26,12 @@ Func upsample(Func f) {
 
 int main(int argc, char **argv) {
 
+    // Pass "float16" to store the pyramids at half precision, which
+    // halves the memory traffic between levels. The arithmetic is
+    // still done in float32.
+    bool use_float16 = argc > 1 && std::string(argv[1]) == "float16";
+    Type storage = use_float16 ? Float(16) : Float(32);
+
     /* THE ALGORITHM */
 
     // Number of pyramid levels
@@ -66,7 +72,7 @@ int main(int argc, char **argv) {
     idx = clamp(cast<int>(idx), 0, (levels-1)*256);
     gPyramid[0](x, y, k) = beta*(gray(x, y) - level) + level + remap(idx - 256*k);
     for (int j = 1; j < J; j++) {
-        gPyramid[j](x, y, k) = downsample(gPyramid[j-1])(x, y, k);
+        gPyramid[j](x, y, k) = cast(storage, downsample(gPyramid[j-1])(x, y, k));
     }
 
     // Get its laplacian pyramid
@@ -80,7 +86,7 @@ int main(int argc, char **argv) {
     Func inGPyramid[J];
     inGPyramid[0](x, y) = gray(x, y);
     for (int j = 1; j < J; j++) {
-        inGPyramid[j](x, y) = downsample(inGPyramid[j-1])(x, y);
+        inGPyramid[j](x, y) = cast(storage, downsample(inGPyramid[j-1])(x, y));
     }
 
     // Make the laplacian pyramid of the output
@@ -96,9 +102,9 @@ int main(int argc, char **argv) {
 
     // Make the Gaussian pyramid of the output
     Func outGPyramid[J];
-    outGPyramid[J-1](x, y) = outLPyramid[J-1](x, y);
+    outGPyramid[J-1](x, y) = cast(storage, outLPyramid[J-1](x, y));
     for (int j = J-2; j >= 0; j--) {
-        outGPyramid[j](x, y) = upsample(outGPyramid[j+1])(x, y) + outLPyramid[j](x, y);
+        outGPyramid[j](x, y) = cast(storage, upsample(outGPyramid[j+1])(x, y) + outLPyramid[j](x, y));
     }
 
     // Reintroduce color (Connelly: use eps to avoid scaling up noise w/ apollo3.png input)
@@ -146,7 +152,8 @@ int main(int argc, char **argv) {
         }
     }
 
-    output.compile_to_file("local_laplacian", levels, alpha, beta, input, target);
+    output.compile_to_file(use_float16 ? "local_laplacian_f16" : "local_laplacian",
+                           levels, alpha, beta, input, target);
 
     return 0;
 }
@@ -35,9 +35,13 @@ struct Argument {
     /** If this is a scalar parameter, then this is its type */
     Type type;
 
-    Argument() : is_buffer(false) {}
+    /** For buffers, the alignment in bytes that the host pointer is
+     * promised to have, or zero if nothing is promised. */
+    int host_alignment;
+
+    Argument() : is_buffer(false), host_alignment(0) {}
     Argument(const std::string &_name, bool _is_buffer, Type _type) : 
-        name(_name), is_buffer(_is_buffer), type(_type) {
+        name(_name), is_buffer(_is_buffer), type(_type), host_alignment(0) {
         read = write = is_buffer;
     }
 };
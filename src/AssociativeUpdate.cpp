@@ -0,0 +1,119 @@
+#include "AssociativeUpdate.h"
+#include "IRVisitor.h"
+#include "IREquality.h"
+#include "IROperator.h"
+
+namespace Halide {
+namespace Internal {
+
+using std::string;
+
+namespace {
+
+class LoadsFrom : public IRVisitor {
+    const string &buf;
+
+    using IRVisitor::visit;
+
+    void visit(const Load *op) {
+        IRVisitor::visit(op);
+        if (op->name == buf) result = true;
+    }
+public:
+    bool result;
+    LoadsFrom(const string &b) : buf(b), result(false) {}
+};
+
+// Is an expression a load of the site a store writes to?
+bool is_load_of_store_site(Expr e, const Store *store) {
+    const Load *l = e.as<Load>();
+    return (l && l->name == store->name && equal(l->index, store->index));
+}
+
+}
+
+bool loads_from(Expr e, const string &buf) {
+    LoadsFrom l(buf);
+    e.accept(&l);
+    return l.result;
+}
+
+bool match_associative_update(const Store *op, string *reduce_op, Expr *self, Expr *other) {
+    Expr a, b;
+    if (const Add *add = op->value.as<Add>()) {
+        *reduce_op = Call::vector_reduce_add;
+        a = add->a;
+        b = add->b;
+    } else if (const Mul *mul = op->value.as<Mul>()) {
+        *reduce_op = Call::vector_reduce_mul;
+        a = mul->a;
+        b = mul->b;
+    } else if (const Min *mn = op->value.as<Min>()) {
+        *reduce_op = Call::vector_reduce_min;
+        a = mn->a;
+        b = mn->b;
+    } else if (const Max *mx = op->value.as<Max>()) {
+        *reduce_op = Call::vector_reduce_max;
+        a = mx->a;
+        b = mx->b;
+    } else if (const Sub *sub = op->value.as<Sub>()) {
+        // f - a - b - c == f - (a + b + c)
+        *reduce_op = Call::vector_reduce_add;
+        a = sub->a;
+        b = sub->b;
+        if (!is_load_of_store_site(a, op)) {
+            return false;
+        }
+    } else {
+        return false;
+    }
+
+    if (is_load_of_store_site(a, op)) {
+        *self = a;
+        *other = b;
+    } else if (is_load_of_store_site(b, op)) {
+        *self = b;
+        *other = a;
+    } else {
+        return false;
+    }
+
+    return !loads_from(*other, op->name);
+}
+
+Expr associative_combine(const string &reduce_op, Expr a, Expr b) {
+    if (reduce_op == Call::vector_reduce_add) {
+        return Add::make(a, b);
+    } else if (reduce_op == Call::vector_reduce_mul) {
+        return Mul::make(a, b);
+    } else if (reduce_op == Call::vector_reduce_min) {
+        return Min::make(a, b);
+    } else {
+        internal_assert(reduce_op == Call::vector_reduce_max);
+        return Max::make(a, b);
+    }
+}
+
+Expr rebuild_associative_update(const Store *op, const string &reduce_op, Expr self, Expr other) {
+    if (op->value.as<Sub>()) {
+        return Sub::make(self, other);
+    } else {
+        return associative_combine(reduce_op, self, other);
+    }
+}
+
+Expr associative_identity(const string &reduce_op, Type t) {
+    if (reduce_op == Call::vector_reduce_add) {
+        return make_zero(t);
+    } else if (reduce_op == Call::vector_reduce_mul) {
+        return make_one(t);
+    } else if (reduce_op == Call::vector_reduce_min) {
+        return t.max();
+    } else {
+        internal_assert(reduce_op == Call::vector_reduce_max);
+        return t.min();
+    }
+}
+
+}
+}
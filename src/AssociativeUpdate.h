@@ -0,0 +1,40 @@
+#ifndef HALIDE_ASSOCIATIVE_UPDATE_H
+#define HALIDE_ASSOCIATIVE_UPDATE_H
+
+/** \file
+ * Defines helpers for recognizing and rewriting stores that update a
+ * site using an associative operator.
+ */
+
+#include "IR.h"
+
+namespace Halide {
+namespace Internal {
+
+/** Test if an expression loads from the named buffer. */
+bool loads_from(Expr e, const std::string &buf);
+
+/** If the value stored by a store is an associative combination (+,
+ * -, *, min, max) of the site stored to with some other value that
+ * doesn't load from the same buffer, set reduce_op to the name of the
+ * Call::vector_reduce_* intrinsic for that operator, self to the load
+ * of the site, and other to the other value, and return true. A
+ * subtraction from the site is treated as an addition. */
+bool match_associative_update(const Store *op, std::string *reduce_op, Expr *self, Expr *other);
+
+/** Build op(a, b) for the associative operator corresponding to a
+ * Call::vector_reduce_* intrinsic. */
+Expr associative_combine(const std::string &reduce_op, Expr a, Expr b);
+
+/** The identity of the associative operator corresponding to a
+ * Call::vector_reduce_* intrinsic. */
+Expr associative_identity(const std::string &reduce_op, Type t);
+
+/** Rebuild the value of a store matched by match_associative_update,
+ * given the load of the site and a new value to combine with it. */
+Expr rebuild_associative_update(const Store *op, const std::string &reduce_op, Expr self, Expr other);
+
+}
+}
+
+#endif
@@ -0,0 +1,229 @@
+#include "AsyncProducers.h"
+#include "IRMutator.h"
+#include "IROperator.h"
+#include "Bounds.h"
+#include "Simplify.h"
+#include "Substitute.h"
+#include "ExprUsesVar.h"
+#include "Function.h"
+#include "Debug.h"
+
+namespace Halide {
+namespace Internal {
+
+using std::map;
+using std::string;
+using std::vector;
+using std::pair;
+using std::make_pair;
+
+namespace {
+
+// Rebase the accesses to a function into one slot of a ring of
+// buffers. The slots are stacked along the outermost dimension.
+class RebaseAccesses : public IRMutator {
+    const string &func;
+    const vector<Expr> &mins;
+    Expr slot_offset;
+
+    using IRMutator::visit;
+
+    vector<Expr> rebase(const vector<Expr> &args) {
+        internal_assert(args.size() == mins.size());
+        vector<Expr> result(args.size());
+        for (size_t i = 0; i < args.size(); i++) {
+            result[i] = args[i] - mins[i];
+        }
+        result.back() += slot_offset;
+        return result;
+    }
+
+    void visit(const Call *op) {
+        IRMutator::visit(op);
+        op = expr.as<Call>();
+        internal_assert(op);
+        if (op->name == func && op->call_type == Call::Halide) {
+            expr = Call::make(op->type, op->name, rebase(op->args), op->call_type,
+                              op->func, op->value_index, op->image, op->param);
+        } else if (op->name == func && op->call_type == Call::Intrinsic) {
+            user_error << "Can't compute " << func << " asynchronously, because its "
+                       << "buffer is accessed directly (e.g. by an extern stage).\n";
+        }
+    }
+
+    void visit(const Provide *op) {
+        IRMutator::visit(op);
+        op = stmt.as<Provide>();
+        internal_assert(op);
+        if (op->name == func) {
+            stmt = Provide::make(op->name, op->values, rebase(op->args));
+        }
+    }
+
+public:
+    RebaseAccesses(const string &f, const vector<Expr> &m, Expr o) :
+        func(f), mins(m), slot_offset(o) {}
+};
+
+// Keep either the production or the consumption of a function,
+// replacing the other with a no-op.
+class SplitPipeline : public IRMutator {
+    const string &func;
+    bool keep_produce;
+
+    using IRMutator::visit;
+
+    void visit(const Pipeline *op) {
+        if (op->name != func) {
+            IRMutator::visit(op);
+        } else if (keep_produce) {
+            stmt = Pipeline::make(op->name, op->produce, op->update, Evaluate::make(0));
+        } else {
+            stmt = Pipeline::make(op->name, Evaluate::make(0), Stmt(), op->consume);
+        }
+    }
+
+public:
+    SplitPipeline(const string &f, bool p) : func(f), keep_produce(p) {}
+};
+
+Stmt wrap_lets(Stmt s, const vector<pair<string, Expr> > &lets) {
+    for (size_t i = lets.size(); i > 0; i--) {
+        s = LetStmt::make(lets[i-1].first, lets[i-1].second, s);
+    }
+    return s;
+}
+
+class AsyncProducers : public IRMutator {
+    const map<string, Function> &env;
+
+    using IRMutator::visit;
+
+    Stmt make_async(const For *op, const Function &f) {
+        user_assert(op->for_type == For::Serial)
+            << "Can't compute " << f.name() << " asynchronously at " << op->name
+            << ", because the loop isn't serial.\n";
+        user_assert(f.dimensions() > 0)
+            << "Can't compute " << f.name() << " asynchronously, because it has no dimensions.\n";
+
+        // Dig through the lets to the realization
+        vector<pair<string, Expr> > lets;
+        Stmt body = op->body;
+        while (const LetStmt *let = body.as<LetStmt>()) {
+            lets.push_back(make_pair(let->name, let->value));
+            body = let->body;
+        }
+        const Realize *realize = body.as<Realize>();
+        user_assert(realize && realize->name == f.name())
+            << "Can't compute " << f.name() << " asynchronously at " << op->name
+            << ", because it must be stored at the same loop level, and any other "
+            << "functions computed there must be realized inside it.\n";
+
+        // Find an extent for each dimension that covers every
+        // iteration, in terms of values known outside the loop.
+        Scope<Interval> scope;
+        scope.push(op->name, Interval(op->min, op->min + op->extent - 1));
+        Scope<int> loop_lets;
+        for (size_t i = 0; i < lets.size(); i++) {
+            loop_lets.push(lets[i].first, 0);
+        }
+
+        vector<Expr> mins, ring_extents;
+        vector<pair<string, Expr> > ring_lets;
+        for (size_t i = 0; i < realize->bounds.size(); i++) {
+            Expr extent = realize->bounds[i].extent;
+            for (size_t j = lets.size(); j > 0; j--) {
+                if (expr_uses_var(extent, lets[j-1].first)) {
+                    extent = substitute(lets[j-1].first, lets[j-1].second, extent);
+                }
+            }
+            extent = bounds_of_expr_in_scope(simplify(extent), scope).max;
+            user_assert(extent.defined() &&
+                        !expr_uses_vars(extent, loop_lets) &&
+                        !expr_uses_var(extent, op->name))
+                << "Can't compute " << f.name() << " asynchronously at " << op->name
+                << ", because the size of the region it computes can't be bounded"
+                << " across the iterations of the loop.\n";
+
+            string name = f.name() + "." + f.args()[i] + ".ring_extent";
+            ring_lets.push_back(make_pair(name, simplify(extent)));
+            ring_extents.push_back(Variable::make(Int(32), name));
+            mins.push_back(realize->bounds[i].min);
+        }
+
+        // The slots of the ring are stacked along the outermost dimension
+        string step_name = f.name() + ".async.step";
+        string task_name = f.name() + ".async.task";
+        Expr step = Variable::make(Int(32), step_name);
+        Expr task = Variable::make(Int(32), task_name);
+        Expr loop_var = Variable::make(Int(32), op->name);
+        Expr slot = (loop_var - op->min) % 2;
+
+        RebaseAccesses rebase(f.name(), mins, slot * ring_extents.back());
+        Stmt produce = rebase.mutate(SplitPipeline(f.name(), true).mutate(realize->body));
+        Stmt consume = rebase.mutate(SplitPipeline(f.name(), false).mutate(realize->body));
+
+        // At each step, one task produces the region for this step,
+        // while the other consumes the region of the previous one.
+        produce = LetStmt::make(op->name, step, wrap_lets(produce, lets));
+        consume = LetStmt::make(op->name, step - 1, wrap_lets(consume, lets));
+        Expr end = op->min + op->extent;
+        Stmt tasks = Block::make(IfThenElse::make(task == 0 && step < end, produce),
+                                 IfThenElse::make(task == 1 && step > op->min, consume));
+        tasks = For::make(task_name, 0, 2, For::Parallel, tasks);
+        Stmt steps = For::make(step_name, op->min, op->extent + 1, For::Serial, tasks);
+
+        Region bounds;
+        for (size_t i = 0; i < ring_extents.size(); i++) {
+            Expr extent = ring_extents[i];
+            if (i == ring_extents.size() - 1) extent *= 2;
+            bounds.push_back(Range(0, extent));
+        }
+        Stmt result = Realize::make(f.name(), realize->types, bounds, steps);
+        result = wrap_lets(result, ring_lets);
+
+        debug(3) << "Computing " << f.name() << " asynchronously at " << op->name << "\n";
+        return result;
+    }
+
+    void visit(const For *op) {
+        Stmt s = op;
+        for (map<string, Function>::const_iterator iter = env.begin();
+             iter != env.end(); ++iter) {
+            const Function &f = iter->second;
+            if (!f.schedule().async()) continue;
+            const LoopLevel &level = f.schedule().compute_level();
+            user_assert(!level.is_inline() && !level.is_root())
+                << "Can't compute " << f.name() << " asynchronously, because it "
+                << "isn't computed at a loop level.\n";
+            if (level.match(op->name)) {
+                s = make_async(op, f);
+                break;
+            }
+        }
+
+        if (s.same_as(op)) {
+            IRMutator::visit(op);
+        } else {
+            stmt = mutate(s);
+        }
+    }
+
+public:
+    AsyncProducers(const map<string, Function> &e) : env(e) {}
+};
+
+}
+
+Stmt async_producers(Stmt s, const map<string, Function> &env) {
+    bool any = false;
+    for (map<string, Function>::const_iterator iter = env.begin();
+         iter != env.end(); ++iter) {
+        any = any || iter->second.schedule().async();
+    }
+    if (!any) return s;
+    return AsyncProducers(env).mutate(s);
+}
+
+}
+}
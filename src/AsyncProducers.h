@@ -0,0 +1,27 @@
+#ifndef HALIDE_ASYNC_PRODUCERS_H
+#define HALIDE_ASYNC_PRODUCERS_H
+
+/** \file
+ * Defines the lowering pass that pipelines async producers with
+ * their consumers across threads.
+ */
+
+#include <map>
+
+#include "IR.h"
+
+namespace Halide {
+namespace Internal {
+
+/** Rewrite the loops that functions scheduled async are computed
+ * at, so that each iteration computes the function for the next
+ * iteration on one thread while consuming it for the current
+ * iteration on another, alternating between two buffers. Should be
+ * run after allocation bounds inference, and before the variable
+ * names are uniquified. */
+Stmt async_producers(Stmt s, const std::map<std::string, Function> &env);
+
+}
+}
+
+#endif
@@ -0,0 +1,184 @@
+#include "BoundaryConditions.h"
+#include "IROperator.h"
+#include "Lambda.h"
+#include "Util.h"
+
+namespace Halide {
+namespace BoundaryConditions {
+
+using std::vector;
+using std::pair;
+using std::string;
+
+namespace {
+
+// Clamp a coordinate that is usually within [min, min + extent) to
+// that range, using the given coordinate outside of it. The clamp
+// tells bounds inference that only the range is accessed, and the
+// likely lets loop partitioning remove the select and the clamp
+// from the interior.
+Expr likely_in_bounds(Expr coord, Expr min, Expr extent, Expr outside) {
+    Expr max = min + extent - 1;
+    Expr in_bounds = coord >= min && coord <= max;
+    return clamp(select(in_bounds, likely(coord), outside), min, max);
+}
+
+Expr repeat_edge_coord(Expr coord, Expr min, Expr extent) {
+    return clamp(coord, min, min + extent - 1);
+}
+
+Expr repeat_image_coord(Expr coord, Expr min, Expr extent) {
+    // Halide's % is always positive for positive divisors.
+    return likely_in_bounds(coord, min, extent, (coord - min) % extent + min);
+}
+
+Expr mirror_image_coord(Expr coord, Expr min, Expr extent) {
+    Expr c = (coord - min) % (2 * extent);
+    c = select(c < extent, c, 2 * extent - 1 - c);
+    return likely_in_bounds(coord, min, extent, c + min);
+}
+
+Expr mirror_interior_coord(Expr coord, Expr min, Expr extent) {
+    Expr period = max(2 * extent - 2, 1);
+    Expr c = (coord - min) % period;
+    c = select(c < extent, c, period - c);
+    return likely_in_bounds(coord, min, extent, c + min);
+}
+
+typedef Expr (*CoordinateMap)(Expr coord, Expr min, Expr extent);
+
+bool is_bounded(const vector<pair<Expr, Expr> > &bounds, size_t i, const string &name) {
+    if (i >= bounds.size() || !bounds[i].first.defined()) {
+        return false;
+    }
+    user_assert(bounds[i].second.defined())
+        << "The bounds passed to BoundaryConditions::" << name
+        << " give a min but no extent for dimension " << i << "\n";
+    return true;
+}
+
+vector<Var> make_args(const Func &source, const vector<pair<Expr, Expr> > &bounds, const string &name) {
+    user_assert(source.defined())
+        << "Can't apply BoundaryConditions::" << name << " to an undefined Func\n";
+    user_assert((int)bounds.size() <= source.dimensions())
+        << "BoundaryConditions::" << name << " was given bounds for "
+        << bounds.size() << " dimensions, but " << source.name()
+        << " only has " << source.dimensions() << "\n";
+    // Reuse the pure vars of the source, so that the result can be
+    // scheduled in the same terms. Implicit vars (e.g. from a lambda
+    // wrapped around an ImageParam) are replaced with fresh ones, so
+    // that calls to the source aren't mistaken for calls with a
+    // placeholder.
+    vector<Var> args = source.args();
+    for (size_t i = 0; i < args.size(); i++) {
+        if (Var::is_implicit(args[i].name())) {
+            args[i] = Var();
+        }
+    }
+    return args;
+}
+
+// Make a Func that calls the source at coordinates mapped back into
+// the bounds.
+Func map_coordinates(const Func &source, const vector<pair<Expr, Expr> > &bounds,
+                     CoordinateMap map_coord, const string &name) {
+    vector<Var> args = make_args(source, bounds, name);
+    vector<Expr> coords;
+    for (size_t i = 0; i < args.size(); i++) {
+        if (is_bounded(bounds, i, name)) {
+            coords.push_back(map_coord(args[i], bounds[i].first, bounds[i].second));
+        } else {
+            coords.push_back(args[i]);
+        }
+    }
+
+    Func bounded(name + Internal::unique_name('_'));
+    if (source.outputs() == 1) {
+        bounded(args) = source(coords);
+    } else {
+        bounded(args) = Tuple(source(coords));
+    }
+    return bounded;
+}
+
+vector<pair<Expr, Expr> > image_bounds(const ImageParam &source) {
+    vector<pair<Expr, Expr> > bounds;
+    for (int i = 0; i < source.dimensions(); i++) {
+        bounds.push_back(std::make_pair(source.min(i), source.extent(i)));
+    }
+    return bounds;
+}
+
+}
+
+Func constant_exterior(const Func &source, Expr value,
+                       const vector<pair<Expr, Expr> > &bounds) {
+    Func repeated = repeat_edge(source, bounds);
+
+    vector<Var> args = make_args(source, bounds, "constant_exterior");
+    Expr out_of_bounds;
+    for (size_t i = 0; i < args.size(); i++) {
+        if (!is_bounded(bounds, i, "constant_exterior")) continue;
+        Expr min = bounds[i].first, extent = bounds[i].second;
+        Expr outside = args[i] < min || args[i] >= min + extent;
+        out_of_bounds = out_of_bounds.defined() ? (out_of_bounds || outside) : outside;
+    }
+
+    vector<Expr> coords(args.begin(), args.end());
+    FuncRefExpr call = repeated(coords);
+    vector<Expr> exprs;
+    for (size_t i = 0; i < call.size(); i++) {
+        Expr v = call.size() == 1 ? Expr(call) : call[i];
+        if (out_of_bounds.defined()) {
+            v = select(out_of_bounds, cast(v.type(), value), likely(v));
+        }
+        exprs.push_back(v);
+    }
+
+    Func bounded("constant_exterior" + Internal::unique_name('_'));
+    if (exprs.size() == 1) {
+        bounded(args) = exprs[0];
+    } else {
+        bounded(args) = Tuple(exprs);
+    }
+    return bounded;
+}
+
+Func constant_exterior(const ImageParam &source, Expr value) {
+    return constant_exterior(lambda(source), value, image_bounds(source));
+}
+
+Func repeat_edge(const Func &source, const vector<pair<Expr, Expr> > &bounds) {
+    return map_coordinates(source, bounds, repeat_edge_coord, "repeat_edge");
+}
+
+Func repeat_edge(const ImageParam &source) {
+    return repeat_edge(lambda(source), image_bounds(source));
+}
+
+Func repeat_image(const Func &source, const vector<pair<Expr, Expr> > &bounds) {
+    return map_coordinates(source, bounds, repeat_image_coord, "repeat_image");
+}
+
+Func repeat_image(const ImageParam &source) {
+    return repeat_image(lambda(source), image_bounds(source));
+}
+
+Func mirror_image(const Func &source, const vector<pair<Expr, Expr> > &bounds) {
+    return map_coordinates(source, bounds, mirror_image_coord, "mirror_image");
+}
+
+Func mirror_image(const ImageParam &source) {
+    return mirror_image(lambda(source), image_bounds(source));
+}
+
+Func mirror_interior(const Func &source, const vector<pair<Expr, Expr> > &bounds) {
+    return map_coordinates(source, bounds, mirror_interior_coord, "mirror_interior");
+}
+
+Func mirror_interior(const ImageParam &source) {
+    return mirror_interior(lambda(source), image_bounds(source));
+}
+
+}
+}
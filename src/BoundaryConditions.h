@@ -0,0 +1,87 @@
+#ifndef HALIDE_BOUNDARY_CONDITIONS_H
+#define HALIDE_BOUNDARY_CONDITIONS_H
+
+/** \file
+ * Support for imposing boundary conditions on Halide Funcs and
+ * ImageParams.
+ */
+
+#include <vector>
+#include <utility>
+
+#include "Func.h"
+#include "Param.h"
+
+namespace Halide {
+
+/** Functions that wrap a Func or an ImageParam in a new Func that is
+ * defined everywhere, by saying what to do outside of some
+ * bounds. The bounds are given as a (min, extent) pair per dimension
+ * of the source. A pair with undefined Exprs leaves that dimension
+ * unbounded. The ImageParam forms use the bounds of the image.
+ *
+ * Within the bounds the result is the source itself, and the
+ * boundary logic is marked as unlikely, so that loop partitioning
+ * can generate interior loops with no clamps or selects in them. The
+ * source is only ever accessed within the bounds, so bounds
+ * inference (and infer_input_bounds) asks for exactly that region of
+ * it. E.g. a 3x3 blur of an image that repeats its edge pixels:
+
+ \code
+ ImageParam in(UInt(8), 2);
+ Func clamped = BoundaryConditions::repeat_edge(in);
+ blur(x, y) = (clamped(x-1, y) + clamped(x, y) + clamped(x+1, y)) / 3;
+ \endcode
+ */
+namespace BoundaryConditions {
+
+/** Impose a boundary condition such that a given expression is
+ * returned everywhere outside the bounds. For a Func with more than
+ * one output, every element of the Tuple is replaced by the value. */
+// @{
+EXPORT Func constant_exterior(const Func &source, Expr value,
+                              const std::vector<std::pair<Expr, Expr> > &bounds);
+EXPORT Func constant_exterior(const ImageParam &source, Expr value);
+// @}
+
+/** Impose a boundary condition such that the nearest edge sample is
+ * returned everywhere outside the bounds. */
+// @{
+EXPORT Func repeat_edge(const Func &source,
+                        const std::vector<std::pair<Expr, Expr> > &bounds);
+EXPORT Func repeat_edge(const ImageParam &source);
+// @}
+
+/** Impose a boundary condition such that the entire region inside
+ * the bounds is tiled around it, as if the image wraps around. */
+// @{
+EXPORT Func repeat_image(const Func &source,
+                         const std::vector<std::pair<Expr, Expr> > &bounds);
+EXPORT Func repeat_image(const ImageParam &source);
+// @}
+
+/** Impose a boundary condition such that the region inside the
+ * bounds is mirrored about each edge, including the edge sample
+ * itself. The sequence of samples in one dimension is ..., 1, 0, 0,
+ * 1, 2, ... */
+// @{
+EXPORT Func mirror_image(const Func &source,
+                         const std::vector<std::pair<Expr, Expr> > &bounds);
+EXPORT Func mirror_image(const ImageParam &source);
+// @}
+
+/** Impose a boundary condition such that the region inside the
+ * bounds is mirrored about each edge, without repeating the edge
+ * sample. The sequence of samples in one dimension is ..., 2, 1, 0,
+ * 1, 2, ... */
+// @{
+EXPORT Func mirror_interior(const Func &source,
+                            const std::vector<std::pair<Expr, Expr> > &bounds);
+EXPORT Func mirror_interior(const ImageParam &source);
+// @}
+
+}
+
+}
+
+#endif
@@ -51,6 +51,14 @@ private:
         }
     }
 
+    // The value of a constant shift amount small enough to turn into
+    // a division, or -1.
+    int const_shift(Expr e) {
+        const Cast *c = e.as<Cast>();
+        const int *shift = as_const_int(c ? c->value : e);
+        return (shift && *shift >= 0 && *shift < 31) ? *shift : -1;
+    }
+
     void bounds_of_type(Type t) {
         if (t.is_uint() && t.bits <= 16) {
             max = cast(t, (1 << t.bits) - 1);
@@ -674,6 +682,21 @@ private:
             max = Call::make(op->type, op->name, vec<Expr>(max_a), op->call_type,
                              op->func, op->value_index, op->image, op->param);
 
+        } else if (op->call_type == Call::Intrinsic &&
+                   op->name == Call::shift_right &&
+                   const_shift(op->args[1]) >= 0) {
+            // Shifting right by a constant is a division that rounds
+            // towards negative infinity, which is monotonic.
+            Expr divisor = make_const(op->type, 1 << const_shift(op->args[1]));
+            op->args[0].accept(this);
+            if (min.defined()) min = min / divisor;
+            if (max.defined()) max = max / divisor;
+        } else if (op->call_type == Call::Intrinsic &&
+                   op->name == Call::bitwise_and &&
+                   (is_positive_const(op->args[1]) || is_zero(op->args[1]))) {
+            // Masking with a non-negative constant clears the sign bit.
+            min = make_zero(op->type);
+            max = op->args[1];
         } else if (op->call_type == Call::Intrinsic &&
                    (op->name == Call::extract_buffer_min ||
                     op->name == Call::extract_buffer_max) &&
@@ -966,11 +989,82 @@ private:
         }
     }
 
+    // If a condition bounds a variable in scope, tighten the
+    // interval of that variable, and remember the name so that the
+    // caller can pop it again afterwards. This lets the bounds of a
+    // guarded loop body (e.g. from a split with
+    // TailStrategy_GuardWithIf) stop at the guard.
+    void push_condition_bounds(Expr cond, vector<string> &pushed) {
+        if (const Call *c = cond.as<Call>()) {
+            if (c->call_type == Call::Intrinsic && c->name == Call::likely) {
+                push_condition_bounds(c->args[0], pushed);
+            }
+            return;
+        }
+
+        if (const And *a = cond.as<And>()) {
+            push_condition_bounds(a->a, pushed);
+            push_condition_bounds(a->b, pushed);
+            return;
+        }
+
+        const Variable *var = NULL;
+        Expr limit;
+        bool is_max = false;
+        int offset = 0;
+        if (const LE *le = cond.as<LE>()) {
+            if ((var = le->a.as<Variable>())) {
+                limit = le->b; is_max = true;
+            } else if ((var = le->b.as<Variable>())) {
+                limit = le->a; is_max = false;
+            }
+        } else if (const LT *lt = cond.as<LT>()) {
+            if ((var = lt->a.as<Variable>())) {
+                limit = lt->b; is_max = true; offset = -1;
+            } else if ((var = lt->b.as<Variable>())) {
+                limit = lt->a; is_max = false; offset = 1;
+            }
+        } else if (const GE *ge = cond.as<GE>()) {
+            if ((var = ge->a.as<Variable>())) {
+                limit = ge->b; is_max = false;
+            } else if ((var = ge->b.as<Variable>())) {
+                limit = ge->a; is_max = true;
+            }
+        } else if (const GT *gt = cond.as<GT>()) {
+            if ((var = gt->a.as<Variable>())) {
+                limit = gt->b; is_max = false; offset = 1;
+            } else if ((var = gt->b.as<Variable>())) {
+                limit = gt->a; is_max = true; offset = -1;
+            }
+        }
+
+        if (!var || !var->type.is_int() || !scope.contains(var->name)) return;
+
+        Interval limit_bounds = bounds_of_expr_in_scope(limit, scope, func_bounds);
+        Interval i = scope.get(var->name);
+        if (is_max && limit_bounds.max.defined()) {
+            Expr m = limit_bounds.max + offset;
+            i.max = i.max.defined() ? simplify(Min::make(i.max, m)) : m;
+        } else if (!is_max && limit_bounds.min.defined()) {
+            Expr m = limit_bounds.min + offset;
+            i.min = i.min.defined() ? simplify(Max::make(i.min, m)) : m;
+        } else {
+            return;
+        }
+        scope.push(var->name, i);
+        pushed.push_back(var->name);
+    }
+
     void visit(const IfThenElse *op) {
         op->condition.accept(this);
 
         if (expr_uses_vars(op->condition, scope)) {
+            vector<string> pushed;
+            push_condition_bounds(op->condition, pushed);
             op->then_case.accept(this);
+            for (size_t i = 0; i < pushed.size(); i++) {
+                scope.pop(pushed[i]);
+            }
             if (op->else_case.defined()) {
                 op->else_case.accept(this);
             }
@@ -1158,6 +1252,31 @@ void check(const Scope<Interval> &scope, Expr e, Expr correct_min, Expr correct_
     }
 }
 
+namespace {
+// Find the ranges given to the Params used by an expression.
+class FindParamRanges : public IRVisitor {
+    using IRVisitor::visit;
+
+    void visit(const Variable *op) {
+        if (op->param.defined() &&
+            !op->param.is_buffer() &&
+            !scope.contains(op->name)) {
+            Parameter p = op->param;
+            Expr min = p.get_min_value(), max = p.get_max_value();
+            if (min.defined() || max.defined()) {
+                // A side with no limit is just the Param itself.
+                Expr self = op;
+                scope.push(op->name, Interval(min.defined() ? min : self,
+                                              max.defined() ? max : self));
+            }
+        }
+    }
+public:
+    Scope<Interval> &scope;
+    FindParamRanges(Scope<Interval> &s) : scope(s) {}
+};
+}
+
 FuncValueBounds compute_function_value_bounds(const vector<string> &order,
                                               const map<string, Function> &env) {
     FuncValueBounds fb;
@@ -1179,6 +1298,10 @@ FuncValueBounds compute_function_value_bounds(const vector<string> &order,
                     arg_scope.push(f.args()[k], Interval(Expr(), Expr()));
                 }
 
+                // Params can be anything in the range they were given.
+                FindParamRanges params(arg_scope);
+                f.values()[j].accept(&params);
+
                 result = bounds_of_expr_in_scope(f.values()[j], arg_scope, fb);
 
                 if (result.min.defined()) {
@@ -1242,6 +1365,10 @@ void bounds_test() {
     check(scope, cast<uint16_t>(u8_1) + cast<uint16_t>(u8_2),
           cast<uint16_t>(0), cast<uint16_t>(255*2));
 
+    // Check some bit manipulation that narrows the range
+    check(scope, cast<int>(u8_1 >> 4), 0, 15);
+    check(scope, cast<int>(u8_1) & 7, 0, 7);
+
     vector<Expr> input_site_1 = vec(2*x);
     vector<Expr> input_site_2 = vec(2*x+1);
     vector<Expr> output_site = vec(x+1);
@@ -41,10 +41,18 @@ bool depends_on_bounds_inference(Expr e) {
 class BoundsInference : public IRMutator {
 public:
     const vector<Function> &funcs;
+    const vector<Function> &outputs;
     const FuncValueBounds &func_bounds;
     set<string> in_pipeline, inner_productions;
     Scope<int> in_stages;
 
+    bool is_output(Function f) const {
+        for (size_t i = 0; i < outputs.size(); i++) {
+            if (f.same_as(outputs[i])) return true;
+        }
+        return false;
+    }
+
     struct Stage {
         Function func;
         int stage; // 0 is the pure definition, 1 is the first update
@@ -317,10 +325,10 @@ public:
     vector<Stage> stages;
 
     BoundsInference(const vector<Function> &f,
+                    const vector<Function> &o,
                     const FuncValueBounds &fb) :
-        funcs(f), func_bounds(fb) {
+        funcs(f), outputs(o), func_bounds(fb) {
         internal_assert(!f.empty());
-        Function output_function = f[f.size()-1];
 
         // Compute the intrinsic relationships between the stages of
         // the functions.
@@ -328,7 +336,7 @@ public:
         // Figure out which functions will be inlined away
         vector<bool> inlined(f.size());
         for (size_t i = 0; i < inlined.size(); i++) {
-            if (i < f.size() - 1 &&
+            if (!is_output(f[i]) &&
                 f[i].schedule().compute_level().is_inline() &&
                 f[i].is_pure()) {
                 inlined[i] = true;
@@ -376,7 +384,7 @@ public:
         // Remove the inlined stages
         vector<Stage> new_stages;
         for (size_t i = 0; i < stages.size(); i++) {
-            if (stages[i].func.same_as(output_function) ||
+            if (is_output(stages[i].func) ||
                 !stages[i].func.schedule().compute_level().is_inline() ||
                 !stages[i].func.is_pure()) {
                 new_stages.push_back(stages[i]);
@@ -468,35 +476,38 @@ public:
             }
         }
 
-        // The region required of the last function is expanded to include output size
-        Function output = stages[stages.size()-1].func;
-        Box output_box;
-        string buffer_name = output.name();
-        if (output.outputs() > 1) {
-            // Use the output size of the first output buffer
-            buffer_name += ".0";
-        }
-        for (int d = 0; d < output.dimensions(); d++) {
-            Expr min = Variable::make(Int(32), buffer_name + ".min." + int_to_string(d));
-            Expr extent = Variable::make(Int(32), buffer_name + ".extent." + int_to_string(d));
+        // The region required of each output function is expanded to
+        // include its output size
+        for (size_t i = 0; i < outputs.size(); i++) {
+            Function output = outputs[i];
+            Box output_box;
+            string buffer_name = output.name();
+            if (output.outputs() > 1) {
+                // Use the output size of the first output buffer
+                buffer_name += ".0";
+            }
+            for (int d = 0; d < output.dimensions(); d++) {
+                Expr min = Variable::make(Int(32), buffer_name + ".min." + int_to_string(d));
+                Expr extent = Variable::make(Int(32), buffer_name + ".extent." + int_to_string(d));
 
-            // Respect any output min and extent constraints
-            Expr min_constraint = output.output_buffers()[0].min_constraint(d);
-            Expr extent_constraint = output.output_buffers()[0].extent_constraint(d);
+                // Respect any output min and extent constraints
+                Expr min_constraint = output.output_buffers()[0].min_constraint(d);
+                Expr extent_constraint = output.output_buffers()[0].extent_constraint(d);
 
-            if (min_constraint.defined()) {
-                min = min_constraint;
+                if (min_constraint.defined()) {
+                    min = min_constraint;
+                }
+                if (extent_constraint.defined()) {
+                    extent = extent_constraint;
+                }
+
+                output_box.push_back(Interval(min, (min + extent) - 1));
             }
-            if (extent_constraint.defined()) {
-                extent = extent_constraint;
+            for (size_t j = 0; j < stages.size(); j++) {
+                Stage &s = stages[j];
+                if (!s.func.same_as(output)) continue;
+                s.bounds[make_pair(s.name, s.stage)] = output_box;
             }
-
-            output_box.push_back(Interval(min, (min + extent) - 1));
-        }
-        for (size_t i = 0; i < stages.size(); i++) {
-            Stage &s = stages[i];
-            if (!s.func.same_as(output)) continue;
-            s.bounds[make_pair(s.name, s.stage)] = output_box;
         }
 
         // Dump out the region required of each stage for debugging.
@@ -642,7 +653,9 @@ public:
 
 
 
-Stmt bounds_inference(Stmt s, const vector<string> &order,
+Stmt bounds_inference(Stmt s,
+                      const vector<Function> &outputs,
+                      const vector<string> &order,
                       const map<string, Function> &env,
                       const FuncValueBounds &func_bounds) {
 
@@ -653,7 +666,7 @@ Stmt bounds_inference(Stmt s, const vector<string> &order,
 
     // Add an outermost bounds inference marker
     s = For::make("<outermost>", 0, 1, For::Serial, s);
-    s = BoundsInference(funcs, func_bounds).mutate(s);
+    s = BoundsInference(funcs, outputs, func_bounds).mutate(s);
     return s.as<For>()->body;
 }
 
@@ -1,5 +1,6 @@
 #include <iostream>
 #include <sstream>
+#include <algorithm>
 
 #include "IRPrinter.h"
 #include "CodeGen.h"
@@ -11,6 +12,7 @@
 #include "CodeGen_Internal.h"
 #include "Lerp.h"
 #include "Util.h"
+#include "VectorizeLoops.h"
 
 namespace Halide {
 namespace Internal {
@@ -93,7 +95,8 @@ CodeGen::CodeGen(Target t) :
     target(t),
     void_t(NULL), i1(NULL), i8(NULL), i16(NULL), i32(NULL), i64(NULL),
     f16(NULL), f32(NULL), f64(NULL),
-    buffer_t_type(NULL) {
+    buffer_t_type(NULL),
+    predicate(NULL) {
     initialize_llvm();
 }
 
@@ -165,6 +168,64 @@ bool CodeGen::llvm_ARM64_enabled = false;
 bool CodeGen::llvm_AArch64_enabled = false;
 bool CodeGen::llvm_NVPTX_enabled = false;
 
+namespace {
+// Find the dense vector loads from the same buffer within the same
+// loop body whose bases differ by a constant less than the vector
+// width, e.g. the taps f(x-1), f(x), f(x+1) of a stencil vectorized
+// across x. These can share aligned loads.
+class FindStencilTaps : public IRVisitor {
+    using IRVisitor::visit;
+
+    const For *loop;
+    map<const For *, vector<const Load *> > dense_loads;
+
+    void visit(const For *op) {
+        op->min.accept(this);
+        op->extent.accept(this);
+        const For *old_loop = loop;
+        loop = op;
+        op->body.accept(this);
+        loop = old_loop;
+    }
+
+    void visit(const Load *op) {
+        IRVisitor::visit(op);
+        const Ramp *ramp = op->index.as<Ramp>();
+        if (ramp && is_one(ramp->stride)) {
+            vector<const Load *> &loads = dense_loads[loop];
+            if (std::find(loads.begin(), loads.end(), op) == loads.end()) {
+                loads.push_back(op);
+            }
+        }
+    }
+
+public:
+    FindStencilTaps() : loop(NULL) {}
+
+    std::set<const Load *> taps() {
+        std::set<const Load *> result;
+        for (map<const For *, vector<const Load *> >::iterator iter = dense_loads.begin();
+             iter != dense_loads.end(); ++iter) {
+            const vector<const Load *> &loads = iter->second;
+            for (size_t i = 0; i < loads.size(); i++) {
+                for (size_t j = i+1; j < loads.size(); j++) {
+                    const Load *a = loads[i], *b = loads[j];
+                    if (a->name != b->name || a->type != b->type) continue;
+                    Expr delta = simplify(a->index.as<Ramp>()->base - b->index.as<Ramp>()->base);
+                    const IntImm *d = delta.as<IntImm>();
+                    if (d && d->value != 0 &&
+                        d->value > -a->type.width && d->value < a->type.width) {
+                        result.insert(a);
+                        result.insert(b);
+                    }
+                }
+            }
+        }
+        return result;
+    }
+};
+}
+
 void CodeGen::compile(Stmt stmt, string name,
                       const vector<Argument> &args,
                       const vector<Buffer> &images_to_embed) {
@@ -209,7 +270,7 @@ void CodeGen::compile(Stmt stmt, string name,
              iter++) {
 
             if (args[i].is_buffer) {
-                unpack_buffer(args[i].name, iter);
+                unpack_buffer(args[i].name, iter, args[i].host_alignment);
             } else {
                 sym_push(args[i].name, iter);
             }
@@ -280,6 +341,10 @@ void CodeGen::compile(Stmt stmt, string name,
 
     }
 
+    FindStencilTaps find_taps;
+    stmt.accept(&find_taps);
+    stencil_taps = find_taps.taps();
+
     debug(1) << "Generating llvm bitcode...\n";
     // Ok, we have a module, function, context, and a builder
     // pointing at a brand new basic block. We're good to go.
@@ -411,8 +476,8 @@ void CodeGen::compile_to_native(const string &filename, bool assembly) {
     TargetOptions options;
     options.LessPreciseFPMADOption = true;
     options.NoFramePointerElim = false;
-    options.AllowFPOpFusion = FPOpFusion::Fast;
-    options.UnsafeFPMath = true;
+    options.AllowFPOpFusion = allow_fp_op_fusion() ? FPOpFusion::Fast : FPOpFusion::Standard;
+    options.UnsafeFPMath = allow_fp_op_fusion();
     options.NoInfsFPMath = true;
     options.NoNaNsFPMath = true;
     options.HonorSignDependentRoundingFPMathOption = false;
@@ -519,30 +584,31 @@ bool CodeGen::sym_exists(const string &name) const {
 
 // Take an llvm Value representing a pointer to a buffer_t,
 // and populate the symbol table with its constituent parts
-void CodeGen::unpack_buffer(string name, llvm::Value *buffer) {
+void CodeGen::unpack_buffer(string name, llvm::Value *buffer, int alignment) {
+    // Make sure the buffer object itself is not null
+    create_assertion(builder->CreateIsNotNull(buffer), "buffer argument " + name + " is NULL");
+
     Value *host_ptr = buffer_host(buffer);
     Value *dev_ptr = buffer_dev(buffer);
 
-    // Check it's 32-byte aligned
-
-    // Disabled, because we don't currently require external
-    // allocations to be aligned.
+    if (alignment > 1) {
+        // Check the promised alignment, so that loads and stores
+        // can rely on it.
+        Value *base = builder->CreatePtrToInt(host_ptr, i64);
+        Value *check_alignment = builder->CreateAnd(base, alignment - 1);
+        check_alignment = builder->CreateIsNull(check_alignment);
 
-    /*
-    Value *base = builder->CreatePtrToInt(host_ptr, i64);
-    Value *check_alignment = builder->CreateAnd(base, 0x1f);
-    check_alignment = builder->CreateIsNull(check_alignment);
+        ostringstream error_message;
+        error_message << "Buffer " << name << " is not " << alignment << "-byte aligned";
+        create_assertion(check_alignment, error_message.str());
 
-    string error_message = "Buffer " + name + " is not 32-byte aligned";
-    create_assertion(check_alignment, error_message);
-    */
-
-    // Instead track this buffer name so that loads and stores from it
-    // don't try to be too aligned.
-    might_be_misaligned.insert(name);
-
-    // Make sure the buffer object itself is not null
-    create_assertion(builder->CreateIsNotNull(buffer), "buffer argument " + name + " is NULL");
+        host_alignment[name] = alignment;
+    } else {
+        // We don't require external allocations to be aligned, so
+        // track this buffer name so that loads and stores from it
+        // don't try to be too aligned.
+        might_be_misaligned.insert(name);
+    }
 
     // Push the buffer pointer as well, for backends that care.
     sym_push(name + ".buffer", buffer);
@@ -684,6 +750,28 @@ void CodeGen::visit(const Cast *op) {
     Halide::Type src = op->value.type();
     Halide::Type dst = op->type;
 
+    // Float(16) is only converted to and from Float(32). Other casts
+    // go via Float(32).
+    bool src_half = src.is_float() && src.bits == 16;
+    bool dst_half = dst.is_float() && dst.bits == 16;
+    if (src_half && !dst_half) {
+        value = float16_to_float32(codegen(op->value));
+        if (dst.bits != 32 || !dst.is_float()) {
+            string name = unique_name('h');
+            sym_push(name, value);
+            value = codegen(Cast::make(dst, Variable::make(Float(32, dst.width), name)));
+            sym_pop(name);
+        }
+        return;
+    } else if (dst_half && !src_half) {
+        Expr f = op->value;
+        if (src.bits != 32 || !src.is_float()) {
+            f = Cast::make(Float(32, src.width), f);
+        }
+        value = float32_to_float16(codegen(f));
+        return;
+    }
+
     value = codegen(op->value);
 
     llvm::Type *llvm_dst = llvm_type_of(dst);
@@ -1085,26 +1173,87 @@ void CodeGen::visit(const Load *op) {
         LoadInst *load = builder->CreateAlignedLoad(ptr, op->type.bytes());
         add_tbaa_metadata(load, op->name);
         value = load;
+    } else if (predicate) {
+        // Only load the active lanes. Use a masked load for dense
+        // vectors, which AVX-512 and AVX2 can do in one instruction.
+        internal_assert((int)dyn_cast<VectorType>(predicate->getType())->getNumElements() == op->type.width)
+            << "Predicated load of a different width than the predicate\n";
+        const Ramp *ramp = op->index.as<Ramp>();
+        #if LLVM_VERSION >= 37
+        if (ramp && is_one(ramp->stride)) {
+            Value *ptr = codegen_buffer_pointer(op->name, op->type.element_of(), ramp->base);
+            ptr = builder->CreatePointerCast(ptr, llvm_type_of(op->type)->getPointerTo());
+            value = builder->CreateMaskedLoad(ptr, op->type.bytes(), predicate,
+                                              UndefValue::get(llvm_type_of(op->type)));
+            return;
+        }
+        #endif
+        value = codegen_predicated_lanes(op->name, op->type, codegen(op->index), NULL);
     } else {
         int alignment = op->type.bytes(); // The size of a single element
         const Ramp *ramp = op->index.as<Ramp>();
         const IntImm *stride = ramp ? ramp->stride.as<IntImm>() : NULL;
 
         bool internal = !op->image.defined() && !op->param.defined();
+        map<string, int>::const_iterator promise = host_alignment.find(op->name);
+        bool promised = promise != host_alignment.end();
 
-        if (ramp && internal) {
-            // If it's an internal allocation, we can boost the
-            // alignment using the results of the modulus remainder
-            // analysis
-            ModulusRemainder mod_rem = modulus_remainder(ramp->base);
+        if (ramp && (internal || promised)) {
+            // If it's an internal allocation, or an external buffer
+            // with a promised alignment, we can boost the alignment
+            // using the results of the modulus remainder analysis
+            ModulusRemainder mod_rem = modulus_remainder(ramp->base, alignment_info);
             alignment *= gcd(gcd(mod_rem.modulus, mod_rem.remainder), 32);
             if (alignment < 0) {
                 // Can happen if ramp->base is a negative constant
                 alignment = -alignment;
             }
+            if (promised) {
+                alignment = gcd(alignment, promise->second);
+            }
         }
 
-        if (ramp && stride && stride->value == 1) {
+        // The alignment of the start of the buffer, if we know it.
+        int buffer_alignment = (internal && !possibly_misaligned) ? 32 : (promised ? promise->second : 0);
+        int vector_bytes = op->type.bytes() * op->type.width;
+
+        // The offset of a dense stencil tap from the previous
+        // aligned vector.
+        int tap_offset = 0;
+        if (ramp && stride && stride->value == 1 &&
+            buffer_alignment && buffer_alignment % vector_bytes == 0 &&
+            stencil_taps.count(op)) {
+            ModulusRemainder mod_rem = modulus_remainder(ramp->base, alignment_info);
+            if (mod_rem.modulus % ramp->width == 0) {
+                tap_offset = mod_rem.remainder % ramp->width;
+                if (tap_offset < 0) tap_offset += ramp->width;
+            }
+        }
+
+        if (tap_offset) {
+            // Do the two aligned loads that cover the vector, and
+            // shuffle out the lanes we want. The other taps of the
+            // stencil use the same aligned loads, so llvm can share
+            // them and derive each tap with a single shuffle (e.g.
+            // palignr or vext). The lanes loaded outside of the vector
+            // we want are within aligned vectors that contain valid
+            // elements, so they can't cross into an unmapped page.
+            Expr base = simplify(ramp->base - tap_offset);
+            Value *ptr_a = codegen_buffer_pointer(op->name, op->type.element_of(), base);
+            Value *ptr_b = codegen_buffer_pointer(op->name, op->type.element_of(), base + ramp->width);
+            ptr_a = builder->CreatePointerCast(ptr_a, llvm_type_of(op->type)->getPointerTo());
+            ptr_b = builder->CreatePointerCast(ptr_b, llvm_type_of(op->type)->getPointerTo());
+            LoadInst *vec_a = builder->CreateAlignedLoad(ptr_a, vector_bytes);
+            LoadInst *vec_b = builder->CreateAlignedLoad(ptr_b, vector_bytes);
+            add_tbaa_metadata(vec_a, op->name);
+            add_tbaa_metadata(vec_b, op->name);
+
+            vector<Constant *> indices(ramp->width);
+            for (int i = 0; i < ramp->width; i++) {
+                indices[i] = ConstantInt::get(i32, i + tap_offset);
+            }
+            value = builder->CreateShuffleVector(vec_a, vec_b, ConstantVector::get(indices));
+        } else if (ramp && stride && stride->value == 1) {
             Value *ptr = codegen_buffer_pointer(op->name, op->type.element_of(), ramp->base);
             ptr = builder->CreatePointerCast(ptr, llvm_type_of(op->type)->getPointerTo());
             LoadInst *load = builder->CreateAlignedLoad(ptr, alignment);
@@ -1155,16 +1304,53 @@ void CodeGen::visit(const Load *op) {
             }
 
             value = builder->CreateShuffleVector(vec_a, vec_b, ConstantVector::get(indices));
+        } else if (ramp && stride && (stride->value == 3 || stride->value == 4)) {
+            // A channel of a packed rgb or rgba image. Load three or
+            // four vectors worth and then shuffle. If we know where
+            // the base sits within a pixel, start the loads at the
+            // first channel of that pixel, so that the loads of the
+            // other channels are the same and can be shared.
+            int s = stride->value, w = ramp->width;
+            int offset = 0;
+            ModulusRemainder mod_rem = modulus_remainder(ramp->base, alignment_info);
+            if (mod_rem.modulus % s == 0) {
+                offset = mod_rem.remainder % s;
+                if (offset < 0) offset += s;
+            }
+            Expr base = simplify(ramp->base - offset);
+
+            // Don't read beyond the last lane we need: move the last
+            // load back so that it ends there.
+            int shift = s - 1 - offset;
+            vector<Value *> vecs(s);
+            for (int j = 0; j < s; j++) {
+                Expr b = simplify(base + (j*w - (j == s-1 ? shift : 0)));
+                Expr load = Load::make(op->type, op->name, Ramp::make(b, 1, w), op->image, op->param);
+                vecs[j] = codegen(load);
+            }
+            Value *all = concat_vectors(vecs);
+
+            vector<Constant *> indices(w);
+            for (int i = 0; i < w; i++) {
+                int e = offset + i*s;
+                if (e >= (s-1)*w) e += shift;
+                indices[i] = ConstantInt::get(i32, e);
+            }
+            value = builder->CreateShuffleVector(all, UndefValue::get(all->getType()),
+                                                 ConstantVector::get(indices));
         } else if (ramp && stride && stride->value == -1) {
             // Load the vector and then flip it in-place
             Expr base = ramp->base - ramp->width + 1;
 
             // Re-do alignment analysis for the flipped index
-            if (internal && !possibly_misaligned) {
+            if ((internal && !possibly_misaligned) || promised) {
                 alignment = op->type.bytes();
-                ModulusRemainder mod_rem = modulus_remainder(ramp->base - ramp->width + 1);
+                ModulusRemainder mod_rem = modulus_remainder(ramp->base - ramp->width + 1, alignment_info);
                 alignment *= gcd(gcd(mod_rem.modulus, mod_rem.remainder), 32);
                 if (alignment < 0) alignment = -alignment;
+                if (promised) {
+                    alignment = gcd(alignment, promise->second);
+                }
             }
 
             Value *ptr = codegen_buffer_pointer(op->name, op->type.element_of(), base);
@@ -1259,6 +1445,113 @@ llvm::Value *CodeGen::create_broadcast(llvm::Value *v, int width) {
     return builder->CreateShuffleVector(v, undef, zeros);
 }
 
+llvm::Value *CodeGen::slice_vector(llvm::Value *vec, int start, int size) {
+    int width = dyn_cast<VectorType>(vec->getType())->getNumElements();
+    vector<Constant *> indices(size);
+    for (int i = 0; i < size; i++) {
+        if (start + i < width) {
+            indices[i] = ConstantInt::get(i32, start + i);
+        } else {
+            indices[i] = UndefValue::get(i32);
+        }
+    }
+    Value *undef = UndefValue::get(vec->getType());
+    return builder->CreateShuffleVector(vec, undef, ConstantVector::get(indices));
+}
+
+llvm::Value *CodeGen::concat_vectors(const vector<Value *> &vecs) {
+    internal_assert(!vecs.empty());
+    int total = 0;
+    for (size_t i = 0; i < vecs.size(); i++) {
+        total += dyn_cast<VectorType>(vecs[i]->getType())->getNumElements();
+    }
+
+    // Concatenate pairs until there's one vector left, padding with
+    // undef vectors where there's an odd one out.
+    vector<Value *> v = vecs;
+    while (v.size() > 1) {
+        vector<Value *> merged;
+        for (size_t i = 0; i < v.size(); i += 2) {
+            Value *a = v[i];
+            Value *b = i + 1 < v.size() ? v[i+1] : UndefValue::get(a->getType());
+            int width = dyn_cast<VectorType>(a->getType())->getNumElements();
+            vector<Constant *> indices(width * 2);
+            for (int j = 0; j < width * 2; j++) {
+                indices[j] = ConstantInt::get(i32, j);
+            }
+            merged.push_back(builder->CreateShuffleVector(a, b, ConstantVector::get(indices)));
+        }
+        v.swap(merged);
+    }
+
+    if ((int)dyn_cast<VectorType>(v[0]->getType())->getNumElements() != total) {
+        return slice_vector(v[0], 0, total);
+    }
+    return v[0];
+}
+
+Value *CodeGen::float16_to_float32(Value *v) {
+    VectorType *vt = dyn_cast<VectorType>(v->getType());
+    int w = vt ? vt->getNumElements() : 1;
+    Type u16 = UInt(16, w), u32 = UInt(32, w), f32 = Float(32, w);
+
+    string name = unique_name('h');
+    sym_push(name, v);
+    Expr h = Variable::make(u16, name);
+
+    // Move the exponent and mantissa into place, and rebias the
+    // exponent. Infinities and nans need the exponent all ones, and
+    // denormals need renormalizing, which we do by letting the float
+    // unit subtract off the implicit leading one.
+    Expr shifted_exp = make_const(u32, 0x7c00 << 13);
+    Expr bits = cast(u32, h & make_const(u16, 0x7fff)) << make_const(u32, 13);
+    Expr exp = bits & shifted_exp;
+    bits = bits + make_const(u32, (127 - 15) << 23);
+    Expr inf_or_nan = bits + make_const(u32, (128 - 16) << 23);
+    Expr magic = reinterpret(f32, make_const(u32, 113 << 23));
+    Expr denormal = reinterpret(u32, reinterpret(f32, bits + make_const(u32, 1 << 23)) - magic);
+    bits = select(exp == shifted_exp, inf_or_nan,
+                  select(exp == make_zero(u32), denormal, bits));
+    Expr sign = cast(u32, h & make_const(u16, 0x8000)) << make_const(u32, 16);
+    Value *result = codegen(reinterpret(f32, bits | sign));
+
+    sym_pop(name);
+    return result;
+}
+
+Value *CodeGen::float32_to_float16(Value *v) {
+    VectorType *vt = dyn_cast<VectorType>(v->getType());
+    int w = vt ? vt->getNumElements() : 1;
+    Type u16 = UInt(16, w), u32 = UInt(32, w), f32 = Float(32, w);
+
+    string name = unique_name('f');
+    sym_push(name, v);
+    Expr f = Variable::make(f32, name);
+
+    Expr u = reinterpret(u32, f);
+    Expr sign = cast(u16, u >> make_const(u32, 16)) & make_const(u16, 0x8000);
+    u = u & make_const(u32, 0x7fffffff);
+
+    // Too big becomes infinity, and nans stay nans.
+    Expr too_big = select(u > make_const(u32, 255 << 23),
+                          make_const(u32, 0x7e00), make_const(u32, 0x7c00));
+    // Too small for a normal half: let the float unit align the
+    // mantissa and do the rounding, by adding a magic number.
+    Expr magic = make_const(u32, ((127 - 15) + (23 - 10) + 1) << 23);
+    Expr denormal = reinterpret(u32, reinterpret(f32, u) + reinterpret(f32, magic)) - magic;
+    // Otherwise rebias the exponent and round the mantissa to
+    // nearest even.
+    Expr mant_odd = (u >> make_const(u32, 13)) & make_one(u32);
+    Expr normal = (u + make_const(u32, 0xfff - (112 << 23)) + mant_odd) >> make_const(u32, 13);
+
+    Expr bits = select(u >= make_const(u32, (127 + 16) << 23), too_big,
+                       select(u < make_const(u32, 113 << 23), denormal, normal));
+    Value *result = codegen(cast(u16, bits) | sign);
+
+    sym_pop(name);
+    return result;
+}
+
 void CodeGen::visit(const Broadcast *op) {
     value = create_broadcast(codegen(op->value), op->width);
 }
@@ -1334,18 +1627,26 @@ void CodeGen::visit(const Call *op) {
             }
 
         } else if (op->name == Call::interleave_vectors) {
-            internal_assert(op->args.size() == 2);
-            Expr a = op->args[0], b = op->args[1];
-            debug(3) << "Vectors to interleave: " << a << ", " << b << "\n";
+            internal_assert(op->args.size() >= 2 && op->args.size() <= 4)
+                << "Wrong number of args to interleave vectors: " << op->args.size() << "\n";
+            int k = (int)op->args.size();
+            vector<Value *> args(k);
+            for (int i = 0; i < k; i++) {
+                debug(3) << "Vector to interleave: " << op->args[i] << "\n";
+                args[i] = codegen(op->args[i]);
+            }
+            int width = op->args[0].type().width;
 
+            // Concatenate the args, then take one lane from each in
+            // turn. llvm lowers this to pshufbs on x86.
+            Value *all = concat_vectors(args);
             vector<Constant *> indices(op->type.width);
             for (int i = 0; i < op->type.width; i++) {
-                int idx = i/2;
-                if (i % 2 == 1) idx += a.type().width;
-                indices[i] = ConstantInt::get(i32, idx);
+                indices[i] = ConstantInt::get(i32, (i % k) * width + i / k);
             }
 
-            value = builder->CreateShuffleVector(codegen(a), codegen(b), ConstantVector::get(indices));
+            value = builder->CreateShuffleVector(all, UndefValue::get(all->getType()),
+                                                 ConstantVector::get(indices));
 
         } else if (op->name == Call::debug_to_file) {
             internal_assert(op->args.size() == 9);
@@ -1565,6 +1866,24 @@ void CodeGen::visit(const Call *op) {
 
             value = codegen_buffer_pointer(load->name, load->type, load->index);
 
+        } else if (op->name == Call::prefetch) {
+            internal_assert(op->args.size() == 1) << "prefetch takes one argument\n";
+            const Load *load = op->args[0].as<Load>();
+            internal_assert(load) << "The sole argument to prefetch must be a Load node\n";
+            internal_assert(load->index.type().is_scalar()) << "Can't prefetch a vector load\n";
+
+            Value *ptr = codegen_buffer_pointer(load->name, load->type, load->index);
+            ptr = builder->CreatePointerCast(ptr, i8->getPointerTo());
+            llvm::Function *fn = Intrinsic::getDeclaration(module, Intrinsic::prefetch);
+            // A read, with maximal temporal locality, into the data cache.
+            Value *args[] = {ptr, ConstantInt::get(i32, 0), ConstantInt::get(i32, 3), ConstantInt::get(i32, 1)};
+            builder->CreateCall(fn, args);
+            value = ConstantInt::get(i32, 0);
+        } else if (op->name == Call::likely) {
+            // Only a hint for loop partitioning, which should have
+            // removed it already.
+            internal_assert(op->args.size() == 1) << "likely takes one argument\n";
+            value = codegen(op->args[0]);
         } else if (op->name == Call::trace || op->name == Call::trace_expr) {
 
             int int_args = (int)(op->args.size()) - 5;
@@ -1652,6 +1971,31 @@ void CodeGen::visit(const Call *op) {
         } else if (op->name == Call::lerp) {
             internal_assert(op->args.size() == 3);
             value = codegen(lower_lerp(op->args[0], op->args[1], op->args[2]));
+        } else if (op->name == Call::vector_reduce_add ||
+                   op->name == Call::vector_reduce_mul ||
+                   op->name == Call::vector_reduce_min ||
+                   op->name == Call::vector_reduce_max) {
+            internal_assert(op->args.size() == 1);
+            value = codegen(lower_vector_reduce(op->name, op->args[0]));
+        } else if (op->name == Call::atomic_add ||
+                   op->name == Call::atomic_min ||
+                   op->name == Call::atomic_max) {
+            internal_assert(op->args.size() == 2);
+            internal_assert(op->type.is_scalar() && !op->type.is_float())
+                << "Atomic operations are only supported on scalar integers\n";
+            Value *ptr = codegen(op->args[0]);
+            Value *val = codegen(op->args[1]);
+            AtomicRMWInst::BinOp bin_op;
+            if (op->name == Call::atomic_add) {
+                bin_op = AtomicRMWInst::Add;
+            } else if (op->name == Call::atomic_min) {
+                bin_op = op->type.is_uint() ? AtomicRMWInst::UMin : AtomicRMWInst::Min;
+            } else {
+                bin_op = op->type.is_uint() ? AtomicRMWInst::UMax : AtomicRMWInst::Max;
+            }
+            // The end of the enclosing parallel loop synchronizes with
+            // everything else, so no ordering is required.
+            value = builder->CreateAtomicRMW(bin_op, ptr, val, Monotonic);
         } else if (op->name == Call::popcount) {
             internal_assert(op->args.size() == 1);
             std::vector<llvm::Type*> arg_type(1);
@@ -1826,14 +2170,40 @@ void CodeGen::visit(const Call *op) {
             ostringstream ss;
             ss << op->name << 'x' << op->type.width;
             llvm::Function *vec_fn = module->getFunction(ss.str());
+
+            // If there's no version of exactly this width, look for
+            // a narrower one that divides it, and call it on each
+            // slice of the args in turn.
+            int slice_width = op->type.width;
+            while (!vec_fn && slice_width % 2 == 0 && slice_width > 2) {
+                slice_width /= 2;
+                ostringstream slice_ss;
+                slice_ss << op->name << 'x' << slice_width;
+                vec_fn = module->getFunction(slice_ss.str());
+            }
+
             if (vec_fn) {
-                debug(4) << "Creating vector call to " << ss.str() << "\n";
-                CallInst *call = builder->CreateCall(vec_fn, args);
-                if (pure) {
-                    call->setDoesNotAccessMemory();
+                debug(4) << "Creating vector call to " << vec_fn->getName().str()
+                         << " for a vector of width " << op->type.width << "\n";
+                vector<Value *> results;
+                for (int i = 0; i < op->type.width; i += slice_width) {
+                    vector<Value *> arg_slice(args.size());
+                    for (size_t j = 0; j < args.size(); j++) {
+                        if (slice_width < op->type.width &&
+                            args[j]->getType()->isVectorTy()) {
+                            arg_slice[j] = slice_vector(args[j], i, slice_width);
+                        } else {
+                            arg_slice[j] = args[j];
+                        }
+                    }
+                    CallInst *call = builder->CreateCall(vec_fn, arg_slice);
+                    if (pure) {
+                        call->setDoesNotAccessMemory();
+                    }
+                    call->setDoesNotThrow();
+                    results.push_back(call);
                 }
-                call->setDoesNotThrow();
-                value = call;
+                value = concat_vectors(results);
             } else {
                 // Scalarize. Extract each simd lane in turn and do
                 // one scalar call to the function.
@@ -2129,6 +2499,20 @@ void CodeGen::visit(const Store *op) {
         Value *ptr = codegen_buffer_pointer(op->name, value_type, op->index);
         StoreInst *store = builder->CreateAlignedStore(val, ptr, op->value.type().bytes());
         add_tbaa_metadata(store, op->name);
+    } else if (predicate) {
+        // Only store the active lanes.
+        internal_assert((int)dyn_cast<VectorType>(predicate->getType())->getNumElements() == value_type.width)
+            << "Predicated store of a different width than the predicate\n";
+        const Ramp *ramp = op->index.as<Ramp>();
+        #if LLVM_VERSION >= 37
+        if (ramp && is_one(ramp->stride)) {
+            Value *ptr = codegen_buffer_pointer(op->name, value_type.element_of(), ramp->base);
+            ptr = builder->CreatePointerCast(ptr, llvm_type_of(value_type)->getPointerTo());
+            builder->CreateMaskedStore(val, ptr, value_type.bytes(), predicate);
+            return;
+        }
+        #endif
+        codegen_predicated_lanes(op->name, value_type, codegen(op->index), val);
     } else {
         int alignment = op->value.type().bytes();
         const Ramp *ramp = op->index.as<Ramp>();
@@ -2146,8 +2530,11 @@ void CodeGen::visit(const Store *op) {
 
             Value *ptr = codegen_buffer_pointer(op->name, value_type.element_of(), ramp->base);
             Value *ptr2 = builder->CreatePointerCast(ptr, llvm_type_of(value_type)->getPointerTo());
+            map<string, int>::const_iterator promise = host_alignment.find(op->name);
             if (possibly_misaligned) {
                 alignment = op->value.type().element_of().bytes();
+            } else if (promise != host_alignment.end()) {
+                alignment = gcd(alignment, promise->second);
             }
             StoreInst *store = builder->CreateAlignedStore(val, ptr2, alignment);
             add_tbaa_metadata(store, op->name);
@@ -2201,7 +2588,69 @@ void CodeGen::visit(const Provide *op) {
     internal_error << "Provide encountered during codegen\n";
 }
 
+Value *CodeGen::codegen_predicated_lanes(const string &buffer, Halide::Type t,
+                                         Value *index, Value *val) {
+    Value *result = UndefValue::get(llvm_type_of(t));
+    for (int i = 0; i < t.width; i++) {
+        Value *lane = ConstantInt::get(i32, i);
+        BasicBlock *before_bb = builder->GetInsertBlock();
+        BasicBlock *lane_bb = BasicBlock::Create(*context, "active_lane", function);
+        BasicBlock *after_bb = BasicBlock::Create(*context, "after_lane", function);
+        builder->CreateCondBr(builder->CreateExtractElement(predicate, lane), lane_bb, after_bb);
+
+        builder->SetInsertPoint(lane_bb);
+        Value *idx = builder->CreateExtractElement(index, lane);
+        Value *ptr = codegen_buffer_pointer(buffer, t.element_of(), idx);
+        Value *loaded = NULL;
+        if (val) {
+            StoreInst *store = builder->CreateStore(builder->CreateExtractElement(val, lane), ptr);
+            add_tbaa_metadata(store, buffer);
+        } else {
+            LoadInst *load = builder->CreateLoad(ptr);
+            add_tbaa_metadata(load, buffer);
+            loaded = builder->CreateInsertElement(result, load, lane);
+        }
+        lane_bb = builder->GetInsertBlock();
+        builder->CreateBr(after_bb);
+
+        builder->SetInsertPoint(after_bb);
+        if (!val) {
+            PHINode *phi = builder->CreatePHI(result->getType(), 2);
+            phi->addIncoming(result, before_bb);
+            phi->addIncoming(loaded, lane_bb);
+            result = phi;
+        }
+    }
+    return val ? NULL : result;
+}
+
 void CodeGen::visit(const IfThenElse *op) {
+    if (op->condition.type().is_vector()) {
+        // A predicated statement, made by vectorize_loops for the
+        // last vector of a loop with a guarded tail. Skip it if no
+        // lanes are active, and otherwise run it with the loads and
+        // stores masked off in the inactive lanes.
+        internal_assert(!op->else_case.defined() && !predicate)
+            << "Can only predicate an if statement with no else case, outside any other\n";
+        Value *mask = codegen(op->condition);
+        llvm::Type *bits_t = llvm::IntegerType::get(*context, op->condition.type().width);
+        Value *any_active = builder->CreateICmpNE(builder->CreateBitCast(mask, bits_t),
+                                                  ConstantInt::get(bits_t, 0));
+
+        BasicBlock *true_bb = BasicBlock::Create(*context, "predicated_bb", function);
+        BasicBlock *after_bb = BasicBlock::Create(*context, "after_bb", function);
+        builder->CreateCondBr(any_active, true_bb, after_bb);
+
+        builder->SetInsertPoint(true_bb);
+        predicate = mask;
+        codegen(op->then_case);
+        predicate = NULL;
+        builder->CreateBr(after_bb);
+
+        builder->SetInsertPoint(after_bb);
+        return;
+    }
+
     BasicBlock *true_bb = BasicBlock::Create(*context, "true_bb", function);
     BasicBlock *false_bb = BasicBlock::Create(*context, "false_bb", function);
     BasicBlock *after_bb = BasicBlock::Create(*context, "after_bb", function);
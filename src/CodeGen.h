@@ -83,6 +83,12 @@ public:
     virtual bool use_soft_float_abi() const = 0;
     // @}
 
+    /** Whether llvm may fuse floating-point multiplies and adds,
+     * which changes the rounding. Also controls llvm's unsafe
+     * floating-point math, because llvm fuses them under that
+     * too. True by default. */
+    virtual bool allow_fp_op_fusion() const {return true;}
+
     /** Do any required target-specific things to the execution engine
      * and the module prior to jitting. Called by JITCompiledModule
      * just before it jits. Does nothing by default. */
@@ -169,9 +175,11 @@ protected:
     void codegen(Stmt);
 
     /** Take an llvm Value representing a pointer to a buffer_t,
-     * and populate the symbol table with its constituent parts.
+     * and populate the symbol table with its constituent parts. If
+     * alignment is non-zero, the host pointer is checked to
+     * have that alignment in bytes.
      */
-    void unpack_buffer(std::string name, llvm::Value *buffer);
+    void unpack_buffer(std::string name, llvm::Value *buffer, int alignment = 0);
 
     /** Add a definition of buffer_t to the module if it isn't already there. */
     void define_buffer_t();
@@ -189,6 +197,23 @@ protected:
     /** Widen an llvm scalar into an llvm vector with the given number of lanes. */
     llvm::Value *create_broadcast(llvm::Value *, int width);
 
+    /** Extract a contiguous run of lanes from an llvm vector. Lanes
+     * past the end of the vector are undef. */
+    llvm::Value *slice_vector(llvm::Value *vec, int start, int size);
+
+    /** Concatenate llvm vectors of the same type into one wider vector. */
+    llvm::Value *concat_vectors(const std::vector<llvm::Value *> &vecs);
+
+    /** Convert a Float(16) value, which llvm holds as the bits in an
+     * i16 (or vector of them), to float, or back, rounding to
+     * nearest even. The default versions manipulate the
+     * bits with integer ops, which vectorize on any target. Targets
+     * with conversion instructions should override these. */
+    // @{
+    virtual llvm::Value *float16_to_float32(llvm::Value *);
+    virtual llvm::Value *float32_to_float16(llvm::Value *);
+    // @}
+
     /** Given an llvm value representing a pointer to a buffer_t, extract various subfields.
      * The *_ptr variants return a pointer to the struct element, while the basic variants
      * load the actual value. */
@@ -300,6 +325,27 @@ protected:
      * guarantee their alignment) */
     std::set<std::string> might_be_misaligned;
 
+    /** The alignment in bytes of the host pointers of the buffers
+     * that came in from the outside world with an alignment
+     * promise. */
+    std::map<std::string, int> host_alignment;
+
+    /** The dense vector loads that are close enough to another load
+     * from the same buffer in the same loop to share aligned loads
+     * with it. */
+    std::set<const Load *> stencil_taps;
+
+    /** While generating the body of an if statement on a vector
+     * condition, the mask of lanes that are active. Vector loads and
+     * stores only touch memory in the active lanes. NULL elsewhere. */
+    llvm::Value *predicate;
+
+    /** Do a vector load or store one lane at a time, skipping the
+     * lanes that are inactive in the current predicate. Stores if
+     * val is non-NULL, and otherwise returns the loaded vector. */
+    llvm::Value *codegen_predicated_lanes(const std::string &buffer, Type t,
+                                          llvm::Value *index, llvm::Value *val);
+
     llvm::Value *get_user_context() const;
 
 
@@ -1104,7 +1104,8 @@ void CodeGen_ARM::visit(const Select *op) {
 
 void CodeGen_ARM::visit(const Store *op) {
 
-    // A dense store of an interleaving can be done using a vst2 intrinsic
+    // A dense store of an interleaving of two, three or four vectors
+    // can be done using a vst2, vst3 or vst4 intrinsic
     const Ramp *ramp = op->index.as<Ramp>();
 
     // We only deal with ramps here
@@ -1125,9 +1126,10 @@ void CodeGen_ARM::visit(const Store *op) {
     if (is_one(ramp->stride) &&
         call && call->call_type == Call::Intrinsic &&
         call->name == Call::interleave_vectors) {
-        internal_assert(call->args.size() == 2)
-            << "Wrong number of args to interleave vectors: " << call->args.size() << "\n";
-        vector<Value *> args(call->args.size() + 2);
+        int k = (int)call->args.size();
+        internal_assert(k >= 2 && k <= 4)
+            << "Wrong number of args to interleave vectors: " << k << "\n";
+        vector<Value *> args(k + 2);
 
         Type t = call->args[0].type();
         int alignment = t.bytes();
@@ -1141,27 +1143,32 @@ void CodeGen_ARM::visit(const Store *op) {
         }
 
         args[0] = ptr; // The pointer
-        args[1] = codegen(call->args[0]);
-        args[2] = codegen(call->args[1]);
-        args[3] = ConstantInt::get(i32, alignment);
+        for (int i = 0; i < k; i++) {
+            args[i + 1] = codegen(call->args[i]);
+        }
+        args[k + 1] = ConstantInt::get(i32, alignment);
+
+        ostringstream prefix;
+        prefix << "vst" << k << ".";
+        string pre = prefix.str();
 
         Instruction *store = NULL;
         if (t == Int(8, 8) || t == UInt(8, 8)) {
-            store = call_void_intrin("vst2.v8i8", args);
+            store = call_void_intrin(pre + "v8i8", args);
         } else if (t == Int(8, 16) || t == UInt(8, 16)) {
-            store = call_void_intrin("vst2.v16i8", args);
+            store = call_void_intrin(pre + "v16i8", args);
         } else if (t == Int(16, 4) || t == UInt(16, 4)) {
-            store = call_void_intrin("vst2.v4i16", args);
+            store = call_void_intrin(pre + "v4i16", args);
         } else if (t == Int(16, 8) || t == UInt(16, 8)) {
-            store = call_void_intrin("vst2.v8i16", args);
+            store = call_void_intrin(pre + "v8i16", args);
         } else if (t == Int(32, 2) || t == UInt(32, 2)) {
-            store = call_void_intrin("vst2.v2i32", args);
+            store = call_void_intrin(pre + "v2i32", args);
         } else if (t == Int(32, 4) || t == UInt(32, 4)) {
-            store = call_void_intrin("vst2.v4i32", args);
+            store = call_void_intrin(pre + "v4i32", args);
         } else if (t == Float(32, 2)) {
-            store = call_void_intrin("vst2.v2f32", args);
+            store = call_void_intrin(pre + "v2f32", args);
         } else if (t == Float(32, 4)) {
-            store = call_void_intrin("vst2.v4f32", args);
+            store = call_void_intrin(pre + "v4f32", args);
         } else {
             CodeGen::visit(op);
         }
@@ -1325,6 +1332,46 @@ void CodeGen_ARM::visit(const Call *op) {
         e.accept(this);
         return;
     }
+
+    if (target.bits == 32 &&
+        op->call_type == Call::Intrinsic &&
+        (op->name == Call::vector_reduce_add ||
+         op->name == Call::vector_reduce_min ||
+         op->name == Call::vector_reduce_max)) {
+        Type t = op->args[0].type();
+        int vec_bits = t.bits * t.width;
+        bool int_type = (t.is_int() || t.is_uint()) && t.bits <= 32;
+        if ((int_type || t.element_of() == Float(32)) &&
+            (vec_bits == 64 || vec_bits == 128)) {
+            // The neon pairwise ops combine adjacent lanes of the
+            // concatenation of their two 64-bit args. Use one to
+            // halve a 128-bit vector, then keep applying it to the
+            // result to fold all the lanes into the first one.
+            ostringstream ss;
+            if (op->name == Call::vector_reduce_add) {
+                ss << "vpadd";
+            } else {
+                ss << (op->name == Call::vector_reduce_min ? "vpmin" : "vpmax");
+                ss << (t.is_uint() ? "u" : "s");
+            }
+            int lanes = 64 / t.bits;
+            ss << ".v" << lanes << (t.is_float() ? "f" : "i") << t.bits;
+            llvm::Type *half_t = llvm_type_of(t.vector_of(lanes));
+
+            Value *v = codegen(op->args[0]);
+            if (vec_bits == 128) {
+                Value *a = slice_vector(v, 0, lanes);
+                Value *b = slice_vector(v, lanes, lanes);
+                v = call_intrin(half_t, ss.str(), vec(a, b));
+            }
+            for (int l = lanes; l > 1; l /= 2) {
+                v = call_intrin(half_t, ss.str(), vec(v, v));
+            }
+            value = builder->CreateExtractElement(v, ConstantInt::get(i32, 0));
+            return;
+        }
+    }
+
     CodeGen::visit(op);
 }
 
@@ -73,6 +73,8 @@ const string preamble =
     "inline float asin_f32(float x) {return asinf(x);}\n"
     "inline float cos_f32(float x) {return cosf(x);}\n"
     "inline float acos_f32(float x) {return acosf(x);}\n"
+    "inline float fast_sin_f32(float x) {return sinf(x);}\n"
+    "inline float fast_cos_f32(float x) {return cosf(x);}\n"
     "inline float tan_f32(float x) {return tanf(x);}\n"
     "inline float atan_f32(float x) {return atanf(x);}\n"
     "inline float sinh_f32(float x) {return sinhf(x);}\n"
@@ -82,6 +84,7 @@ const string preamble =
     "inline float exp_f32(float x) {return expf(x);}\n"
     "inline float log_f32(float x) {return logf(x);}\n"
     "inline float pow_f32(float x, float y) {return powf(x, y);}\n"
+    "inline float fma_f32(float x, float y, float z) {return fmaf(x, y, z);}\n"
     "inline float floor_f32(float x) {return floorf(x);}\n"
     "inline float ceil_f32(float x) {return ceilf(x);}\n"
     "inline float round_f32(float x) {return roundf(x);}\n"
@@ -100,6 +103,7 @@ const string preamble =
     "inline double exp_f64(double x) {return exp(x);}\n"
     "inline double log_f64(double x) {return log(x);}\n"
     "inline double pow_f64(double x, double y) {return pow(x, y);}\n"
+    "inline double fma_f64(double x, double y, double z) {return fma(x, y, z);}\n"
     "inline double floor_f64(double x) {return floor(x);}\n"
     "inline double ceil_f64(double x) {return ceil(x);}\n"
     "inline double round_f64(double x) {return round(x);}\n"
@@ -755,6 +759,9 @@ void CodeGen_C::visit(const Call *op) {
         } else if (op->name == Call::lerp) {
             Expr e = lower_lerp(op->args[0], op->args[1], op->args[2]);
             rhs << print_expr(e);
+        } else if (op->name == Call::likely) {
+            internal_assert(op->args.size() == 1);
+            rhs << print_expr(op->args[0]);
         } else if (op->name == Call::null_handle) {
             rhs << "NULL";
         } else if (op->name == Call::address_of) {
@@ -767,6 +774,18 @@ void CodeGen_C::visit(const Call *op) {
                 << " + "
                 << print_expr(l->index)
                 << ")";
+        } else if (op->name == Call::prefetch) {
+            const Load *l = op->args[0].as<Load>();
+            internal_assert(op->args.size() == 1 && l);
+            do_indent();
+            stream << "__builtin_prefetch(("
+                   << print_type(l->type)
+                   << " *)"
+                   << print_name(l->name)
+                   << " + "
+                   << print_expr(l->index)
+                   << ");\n";
+            rhs << "0";
         } else if (op->name == Call::return_second) {
             internal_assert(op->args.size() == 2);
             string arg0 = print_expr(op->args[0]);
@@ -851,6 +870,43 @@ void CodeGen_C::visit(const Call *op) {
             internal_assert(op->args.size() == 1);
             string arg = print_expr(op->args[0]);
             rhs << "(" << arg << " > 0 ? " << arg << " : -" << arg << ")";
+        } else if (op->name == Call::atomic_add ||
+                   op->name == Call::atomic_min ||
+                   op->name == Call::atomic_max) {
+            internal_assert(op->args.size() == 2);
+            string type = print_type(op->type);
+            string ptr = "((" + type + " *)" + print_expr(op->args[0]) + ")";
+            string val = print_expr(op->args[1]);
+            // These give the old value, like LLVM's atomicrmw. Write
+            // it to a fresh variable here, so that identical calls
+            // aren't shared by the cache of expressions.
+            string old = unique_name('_');
+            do_indent();
+            if (op->name == Call::atomic_add) {
+                stream << type << " " << old << " = __sync_fetch_and_add("
+                       << ptr << ", " << val << ");\n";
+            } else {
+                // There are no __sync builtins for min and max, so
+                // retry a compare-and-swap until either it succeeds,
+                // or the stored value doesn't need changing.
+                string cmp = (op->name == Call::atomic_min) ? " < " : " > ";
+                string seen = unique_name('_');
+                stream << type << " " << old << " = *" << ptr << ";\n";
+                do_indent();
+                stream << "while (" << val << cmp << old << ") {\n";
+                indent++;
+                do_indent();
+                stream << type << " " << seen << " = __sync_val_compare_and_swap("
+                       << ptr << ", " << old << ", " << val << ");\n";
+                do_indent();
+                stream << "if (" << seen << " == " << old << ") break;\n";
+                do_indent();
+                stream << old << " = " << seen << ";\n";
+                indent--;
+                do_indent();
+                stream << "}\n";
+            }
+            rhs << old;
         } else {
             // TODO: other intrinsics
             internal_error << "Unhandled intrinsic in C backend: " << op->name << '\n';
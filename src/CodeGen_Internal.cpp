@@ -164,7 +164,10 @@ llvm::Type *llvm_type_of(LLVMContext *c, Halide::Type t) {
         if (t.is_float()) {
             switch (t.bits) {
             case 16:
-                return llvm::Type::getHalfTy(*c);
+                // Float(16) is a storage type, and llvm's support for
+                // half varies by backend, so keep the bits in an i16
+                // and convert explicitly (see CodeGen::visit(Cast)).
+                return llvm::Type::getInt16Ty(*c);
             case 32:
                 return llvm::Type::getFloatTy(*c);
             case 64:
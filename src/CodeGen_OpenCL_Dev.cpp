@@ -429,6 +429,8 @@ void CodeGen_OpenCL_Dev::init_module() {
                << "#define sqrt_f32 sqrt \n"
                << "#define sin_f32 sin \n"
                << "#define cos_f32 cos \n"
+               << "#define fast_sin_f32 native_sin \n"
+               << "#define fast_cos_f32 native_cos \n"
                << "#define exp_f32 exp \n"
                << "#define log_f32 log \n"
                << "#define abs_f32 fabs \n"
@@ -436,6 +438,7 @@ void CodeGen_OpenCL_Dev::init_module() {
                << "#define ceil_f32 ceil \n"
                << "#define round_f32 round \n"
                << "#define pow_f32 pow\n"
+               << "#define fma_f32 fma\n"
                << "#define asin_f32 asin \n"
                << "#define acos_f32 acos \n"
                << "#define tan_f32 tan \n"
@@ -463,6 +466,7 @@ void CodeGen_OpenCL_Dev::init_module() {
                << "#define ceil_f64 ceil\n"
                << "#define round_f64 round\n"
                << "#define pow_f64 pow\n"
+               << "#define fma_f64 fma\n"
                << "#define asin_f64 asin\n"
                << "#define acos_f64 acos\n"
                << "#define tan_f64 tan\n"
@@ -69,6 +69,16 @@ CodeGen_Posix::CodeGen_Posix(Target t) :
     wild_u32x8(Variable::make(UInt(32, 8), "*")),
     wild_u64x4(Variable::make(UInt(64, 4), "*")),
 
+    wild_i8x64(Variable::make(Int(8, 64), "*")),
+    wild_i16x32(Variable::make(Int(16, 32), "*")),
+    wild_i32x16(Variable::make(Int(32, 16), "*")),
+    wild_i64x8(Variable::make(Int(64, 8), "*")),
+
+    wild_u8x64(Variable::make(UInt(8, 64), "*")),
+    wild_u16x32(Variable::make(UInt(16, 32), "*")),
+    wild_u32x16(Variable::make(UInt(32, 16), "*")),
+    wild_u64x8(Variable::make(UInt(64, 8), "*")),
+
     wild_f32x2(Variable::make(Float(32, 2), "*")),
 
     wild_f32x4(Variable::make(Float(32, 4), "*")),
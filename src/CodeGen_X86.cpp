@@ -4,11 +4,15 @@
 #include "IROperator.h"
 #include "buffer_t.h"
 #include "IRMatch.h"
+#include "Simplify.h"
 #include "Debug.h"
 #include "Util.h"
 #include "Var.h"
 #include "Param.h"
 #include "IntegerDivisionTable.h"
+#include "Bounds.h"
+#include "Deinterleave.h"
+#include "IRMutator.h"
 #include "LLVM_Headers.h"
 
 namespace Halide {
@@ -30,6 +34,11 @@ CodeGen_X86::CodeGen_X86(Target t) : CodeGen_Posix(t) {
     #if !(WITH_NATIVE_CLIENT)
     user_assert(t.os != Target::NaCl) << "llvm build not configured with native client enabled.\n";
     #endif
+
+    #if LLVM_VERSION < 37
+    user_assert(!(t.features & Target::AVX512))
+        << "AVX-512 requires llvm 3.7 or later. This version of Halide was built with an older llvm.\n";
+    #endif
 }
 
 llvm::Triple CodeGen_X86::get_target_triple() const {
@@ -178,11 +187,15 @@ namespace {
 // losing information. If it can't be done, return an undefined Expr.
 Expr lossless_cast(Type t, Expr e) {
     if (t.can_represent(e.type())) {
-        return e;
+        return cast(t, e);
     }
 
+    // Only a widening cast can be undone. E.g. casting a uint8 to an
+    // int8 wraps, so the int8 isn't the uint8 under another name.
     if (const Cast *c = e.as<Cast>()) {
-        if (t == c->value.type()) {
+        if (!c->type.can_represent(c->value.type())) {
+            return Expr();
+        } else if (t == c->value.type()) {
             return c->value;
         } else if (t.can_represent(c->value.type())) {
             return cast(t, c->value);
@@ -203,7 +216,7 @@ Expr lossless_cast(Type t, Expr e) {
     if (const IntImm *i = e.as<IntImm>()) {
         int x = int_cast_constant(t, i->value);
         if (x == i->value) {
-            return e;
+            return make_const(t, x);
         } else {
             return Expr();
         }
@@ -212,6 +225,110 @@ Expr lossless_cast(Type t, Expr e) {
     return Expr();
 }
 
+
+// Get the value of a constant integer, or a broadcast of one.
+bool const_int_value(Expr e, int *value) {
+    if (const Broadcast *b = e.as<Broadcast>()) {
+        e = b->value;
+    }
+    if (const Cast *c = e.as<Cast>()) {
+        if (c->type.can_represent(c->value.type())) {
+            e = c->value;
+        }
+    }
+    if (const IntImm *i = e.as<IntImm>()) {
+        *value = i->value;
+        return true;
+    }
+    return false;
+}
+
+// Make a vector of twice the width that alternates between the lanes
+// of a and b. If a and b are loads of the even and odd elements of
+// the same dense vector, then that's just a dense load.
+Expr pair_lanes(Expr a, Expr b) {
+    const Load *load_a = a.as<Load>();
+    const Load *load_b = b.as<Load>();
+    const Ramp *ramp_a = load_a ? load_a->index.as<Ramp>() : NULL;
+    const Ramp *ramp_b = load_b ? load_b->index.as<Ramp>() : NULL;
+    if (ramp_a && ramp_b && load_a->name == load_b->name &&
+        is_const(ramp_a->stride, 2) && is_const(ramp_b->stride, 2) &&
+        is_one(simplify(ramp_b->base - ramp_a->base))) {
+        Expr index = Ramp::make(ramp_a->base, 1, ramp_a->width * 2);
+        return Load::make(a.type().vector_of(a.type().width * 2), load_a->name,
+                          index, load_a->image, load_a->param);
+    }
+    return Call::make(a.type().vector_of(a.type().width * 2), Call::interleave_vectors,
+                      vec(a, b), Call::Intrinsic);
+}
+
+}
+
+Value *CodeGen_X86::float16_to_float32(Value *v) {
+    if (!(target.features & Target::F16C)) {
+        return CodeGen_Posix::float16_to_float32(v);
+    }
+
+    VectorType *vt = dyn_cast<VectorType>(v->getType());
+    int w = vt ? vt->getNumElements() : 1;
+    Value *bits = v;
+    if (w == 1) {
+        bits = builder->CreateInsertElement(UndefValue::get(llvm_type_of(UInt(16, 8))),
+                                            bits, ConstantInt::get(i32, 0));
+    }
+
+    // vcvtph2ps takes the halves from an 8-lane vector, and makes
+    // four or eight floats.
+    int chunk = w <= 4 ? 4 : 8;
+    vector<Value *> results;
+    for (int i = 0; i < w; i += chunk) {
+        Value *halves = slice_vector(bits, i, 8);
+        results.push_back(call_intrin(llvm_type_of(Float(32, chunk)),
+                                      chunk == 4 ? "vcvtph2ps.128" : "vcvtph2ps.256",
+                                      vec(halves)));
+    }
+    Value *result = concat_vectors(results);
+    if (w == 1) {
+        return builder->CreateExtractElement(result, ConstantInt::get(i32, 0));
+    } else if (w != (int)results.size() * chunk) {
+        return slice_vector(result, 0, w);
+    } else {
+        return result;
+    }
+}
+
+Value *CodeGen_X86::float32_to_float16(Value *v) {
+    if (!(target.features & Target::F16C)) {
+        return CodeGen_Posix::float32_to_float16(v);
+    }
+
+    VectorType *vt = dyn_cast<VectorType>(v->getType());
+    int w = vt ? vt->getNumElements() : 1;
+    if (w == 1) {
+        v = builder->CreateInsertElement(UndefValue::get(llvm_type_of(Float(32, 4))),
+                                         v, ConstantInt::get(i32, 0));
+    }
+
+    // vcvtps2ph takes four or eight floats, and makes an 8-lane
+    // vector of halves. The rounding mode zero is round to nearest
+    // even.
+    int chunk = w <= 4 ? 4 : 8;
+    Value *rounding = ConstantInt::get(i32, 0);
+    vector<Value *> results;
+    for (int i = 0; i < w; i += chunk) {
+        Value *floats = slice_vector(v, i, chunk);
+        Value *halves = call_intrin(llvm_type_of(UInt(16, 8)),
+                                    chunk == 4 ? "vcvtps2ph.128" : "vcvtps2ph.256",
+                                    vec(floats, rounding));
+        results.push_back(chunk == 4 ? slice_vector(halves, 0, 4) : halves);
+    }
+    Value *result = concat_vectors(results);
+    if (w == 1) {
+        result = builder->CreateExtractElement(result, ConstantInt::get(i32, 0));
+    } else if (w != (int)results.size() * chunk) {
+        result = slice_vector(result, 0, w);
+    }
+    return result;
 }
 
 void CodeGen_X86::visit(const Cast *op) {
@@ -219,7 +336,7 @@ void CodeGen_X86::visit(const Cast *op) {
     vector<Expr> matches;
 
     struct Pattern {
-        bool needs_sse_41;
+        uint64_t required_features;
         bool extern_call;
         bool wide_op;
         Type type;
@@ -228,43 +345,77 @@ void CodeGen_X86::visit(const Cast *op) {
     };
 
     Pattern patterns[] = {
-        {false, false, true, Int(8, 16), "sse2.padds.b",
+        {0, false, true, Int(8, 16), "sse2.padds.b",
          _i8(clamp(wild_i16x16 + wild_i16x16, -128, 127))},
-        {false, false, true, Int(8, 16), "sse2.psubs.b",
+        {0, false, true, Int(8, 16), "sse2.psubs.b",
          _i8(clamp(wild_i16x16 - wild_i16x16, -128, 127))},
-        {false, false, true, UInt(8, 16), "sse2.paddus.b",
+        {0, false, true, UInt(8, 16), "sse2.paddus.b",
          _u8(min(wild_u16x16 + wild_u16x16, 255))},
-        {false, false, true, UInt(8, 16), "sse2.psubus.b",
+        {0, false, true, UInt(8, 16), "sse2.psubus.b",
          _u8(max(wild_i16x16 - wild_i16x16, 0))},
-        {false, false, true, Int(16, 8), "sse2.padds.w",
+        {0, false, true, Int(16, 8), "sse2.padds.w",
          _i16(clamp(wild_i32x8 + wild_i32x8, -32768, 32767))},
-        {false, false, true, Int(16, 8), "sse2.psubs.w",
+        {0, false, true, Int(16, 8), "sse2.psubs.w",
          _i16(clamp(wild_i32x8 - wild_i32x8, -32768, 32767))},
-        {false, false, true, UInt(16, 8), "sse2.paddus.w",
+        {0, false, true, UInt(16, 8), "sse2.paddus.w",
          _u16(min(wild_u32x8 + wild_u32x8, 65535))},
-        {false, false, true, UInt(16, 8), "sse2.psubus.w",
+        {0, false, true, UInt(16, 8), "sse2.psubus.w",
          _u16(max(wild_i32x8 - wild_i32x8, 0))},
-        {false, false, true, Int(16, 8), "sse2.pmulh.w",
+        {0, false, true, Int(16, 8), "sse2.pmulh.w",
          _i16((wild_i32x8 * wild_i32x8) / 65536)},
-        {false, false, true, UInt(16, 8), "sse2.pmulhu.w",
+        {0, false, true, UInt(16, 8), "sse2.pmulhu.w",
          _u16((wild_u32x8 * wild_u32x8) / 65536)},
-        {false, false, true, UInt(8, 16), "sse2.pavg.b",
+        {0, false, true, UInt(8, 16), "sse2.pavg.b",
          _u8(((wild_u16x16 + wild_u16x16) + 1) / 2)},
-        {false, false, true, UInt(16, 8), "sse2.pavg.w",
+        {0, false, true, UInt(16, 8), "sse2.pavg.w",
          _u16(((wild_u32x8 + wild_u32x8) + 1) / 2)},
-        {false, true, false, Int(16, 8), "packssdw",
+        {0, true, false, Int(16, 8), "packssdw",
          _i16(clamp(wild_i32x8, -32768, 32767))},
-        {false, true, false, Int(8, 16), "packsswb",
+        {0, true, false, Int(8, 16), "packsswb",
          _i8(clamp(wild_i16x16, -128, 127))},
-        {false, true, false, UInt(8, 16), "packuswb",
+        {0, true, false, UInt(8, 16), "packuswb",
          _u8(clamp(wild_i16x16, 0, 255))},
-        {true, true, false, UInt(16, 8), "packusdw",
-         _u16(clamp(wild_i32x8, 0, 65535))}
+        {Target::SSE41, true, false, UInt(16, 8), "packusdw",
+         _u16(clamp(wild_i32x8, 0, 65535))},
+
+        // The same again for 256-bit vectors
+        {Target::AVX2, false, true, Int(8, 32), "avx2.padds.b",
+         _i8(clamp(wild_i16x32 + wild_i16x32, -128, 127))},
+        {Target::AVX2, false, true, Int(8, 32), "avx2.psubs.b",
+         _i8(clamp(wild_i16x32 - wild_i16x32, -128, 127))},
+        {Target::AVX2, false, true, UInt(8, 32), "avx2.paddus.b",
+         _u8(min(wild_u16x32 + wild_u16x32, 255))},
+        {Target::AVX2, false, true, UInt(8, 32), "avx2.psubus.b",
+         _u8(max(wild_i16x32 - wild_i16x32, 0))},
+        {Target::AVX2, false, true, Int(16, 16), "avx2.padds.w",
+         _i16(clamp(wild_i32x16 + wild_i32x16, -32768, 32767))},
+        {Target::AVX2, false, true, Int(16, 16), "avx2.psubs.w",
+         _i16(clamp(wild_i32x16 - wild_i32x16, -32768, 32767))},
+        {Target::AVX2, false, true, UInt(16, 16), "avx2.paddus.w",
+         _u16(min(wild_u32x16 + wild_u32x16, 65535))},
+        {Target::AVX2, false, true, UInt(16, 16), "avx2.psubus.w",
+         _u16(max(wild_i32x16 - wild_i32x16, 0))},
+        {Target::AVX2, false, true, Int(16, 16), "avx2.pmulh.w",
+         _i16((wild_i32x16 * wild_i32x16) / 65536)},
+        {Target::AVX2, false, true, UInt(16, 16), "avx2.pmulhu.w",
+         _u16((wild_u32x16 * wild_u32x16) / 65536)},
+        {Target::AVX2, false, true, UInt(8, 32), "avx2.pavg.b",
+         _u8(((wild_u16x32 + wild_u16x32) + 1) / 2)},
+        {Target::AVX2, false, true, UInt(16, 16), "avx2.pavg.w",
+         _u16(((wild_u32x16 + wild_u32x16) + 1) / 2)},
+        {Target::AVX2, true, false, Int(16, 16), "packssdw",
+         _i16(clamp(wild_i32x16, -32768, 32767))},
+        {Target::AVX2, true, false, Int(8, 32), "packsswb",
+         _i8(clamp(wild_i16x32, -128, 127))},
+        {Target::AVX2, true, false, UInt(8, 32), "packuswb",
+         _u8(clamp(wild_i16x32, 0, 255))},
+        {Target::AVX2, true, false, UInt(16, 16), "packusdw",
+         _u16(clamp(wild_i32x16, 0, 65535))}
     };
 
     for (size_t i = 0; i < sizeof(patterns)/sizeof(patterns[0]); i++) {
         const Pattern &pattern = patterns[i];
-        if (!(target.features | Target::SSE41) && pattern.needs_sse_41) continue;
+        if ((target.features & pattern.required_features) != pattern.required_features) continue;
         if (expr_match(pattern.pattern, op, matches)) {
             bool ok = true;
             if (pattern.wide_op) {
@@ -319,6 +470,101 @@ void CodeGen_X86::visit(const Cast *op) {
     */
 }
 
+Value *CodeGen_X86::call_pmadd(const string &intrin, Type result_type, Expr a, Expr b) {
+    // Each native vector of the narrow inputs makes half as many
+    // lanes of the result.
+    int bits = a.type().bits;
+    int width = a.type().width;
+    bool use_avx2 = target.features & Target::AVX2;
+    int chunk = (use_avx2 && width % (256 / bits) == 0) ? 256 / bits : 128 / bits;
+    internal_assert(width % chunk == 0);
+    string prefix = chunk * bits == 256 ? "avx2." : (bits == 8 ? "ssse3." : "sse2.");
+    string suffix = (bits == 8 && chunk * bits == 128) ? ".128" : "";
+
+    Value *va = codegen(a), *vb = codegen(b);
+    vector<Value *> results;
+    for (int i = 0; i < width; i += chunk) {
+        Value *slice_a = chunk == width ? va : slice_vector(va, i, chunk);
+        Value *slice_b = chunk == width ? vb : slice_vector(vb, i, chunk);
+        results.push_back(call_intrin(llvm_type_of(result_type.element_of().vector_of(chunk / 2)),
+                                      prefix + intrin + suffix, vec(slice_a, slice_b)));
+    }
+    return concat_vectors(results);
+}
+
+bool CodeGen_X86::contract_fma(Expr a, Expr b, Expr c, Type t) {
+    if (!t.is_float() || t.is_scalar() ||
+        !(target.features & Target::FMA) ||
+        !(target.features & Target::FMAContract)) {
+        return false;
+    }
+    string name = t.bits == 64 ? "fma_f64" : "fma_f32";
+    value = codegen(Call::make(t, name, vec(a, b, c), Call::Extern));
+    return true;
+}
+
+void CodeGen_X86::visit(const Add *op) {
+    // Fuse a*b + c into an fma, if asked to.
+    if (const Mul *mul = op->a.as<Mul>()) {
+        if (contract_fma(mul->a, mul->b, op->b, op->type)) return;
+    }
+    if (const Mul *mul = op->b.as<Mul>()) {
+        if (contract_fma(mul->a, mul->b, op->a, op->type)) return;
+    }
+
+    // Look for the sum of two widening multiplies, which pmaddwd
+    // computes for 16-bit inputs, and pmaddubsw for unsigned 8-bit
+    // inputs times signed 8-bit constants. Both multiply and add
+    // adjacent pairs of lanes, so we pair up the lanes of the two
+    // multiplies first. Pairing up loads makes loads of twice the
+    // width, which we can't do under a predicate.
+    const Mul *mul_a = predicate ? NULL : op->a.as<Mul>();
+    const Mul *mul_b = predicate ? NULL : op->b.as<Mul>();
+    int width = op->type.width;
+
+    if (mul_a && mul_b && op->type == Int(32, width) && width % 4 == 0) {
+        Type narrow = Int(16, width);
+        Expr a0 = lossless_cast(narrow, mul_a->a), b0 = lossless_cast(narrow, mul_a->b);
+        Expr a1 = lossless_cast(narrow, mul_b->a), b1 = lossless_cast(narrow, mul_b->b);
+        if (a0.defined() && b0.defined() && a1.defined() && b1.defined()) {
+            value = call_pmadd("pmadd.wd", op->type, pair_lanes(a0, a1), pair_lanes(b0, b1));
+            return;
+        }
+    }
+
+    if (mul_a && mul_b && op->type == Int(16, width) && width % 8 == 0 &&
+        (target.features & Target::SSE41)) {
+        Type narrow = UInt(8, width);
+        Expr a0 = lossless_cast(narrow, mul_a->a), a1 = lossless_cast(narrow, mul_b->a);
+        int k0 = 0, k1 = 0;
+        // pmaddubsw saturates the sum of each pair, so only use it
+        // when the constants are small enough that it can't.
+        if (a0.defined() && a1.defined() &&
+            const_int_value(mul_a->b, &k0) && const_int_value(mul_b->b, &k1) &&
+            k0 >= -128 && k0 <= 127 && k1 >= -128 && k1 <= 127 &&
+            255 * (std::abs(k0) + std::abs(k1)) <= 32767) {
+            Expr b0 = Broadcast::make(make_const(Int(8), k0), width);
+            Expr b1 = Broadcast::make(make_const(Int(8), k1), width);
+            value = call_pmadd("pmadd.ub.sw", op->type, pair_lanes(a0, a1), pair_lanes(b0, b1));
+            return;
+        }
+    }
+
+    CodeGen::visit(op);
+}
+
+void CodeGen_X86::visit(const Sub *op) {
+    // Fuse a*b - c and c - a*b into an fma, if asked to.
+    if (const Mul *mul = op->a.as<Mul>()) {
+        if (contract_fma(mul->a, mul->b, -op->b, op->type)) return;
+    }
+    if (const Mul *mul = op->b.as<Mul>()) {
+        if (contract_fma(-mul->a, mul->b, op->a, op->type)) return;
+    }
+
+    CodeGen::visit(op);
+}
+
 void CodeGen_X86::visit(const Div *op) {
 
     user_assert(!is_zero(op->b)) << "Division by constant zero in expression: " << Expr(op) << "\n";
@@ -525,6 +771,284 @@ void CodeGen_X86::visit(const Max *op) {
     }
 }
 
+void CodeGen_X86::visit(const Call *op) {
+    if (op->call_type == Call::Intrinsic &&
+        op->name == Call::vector_reduce_add &&
+        (op->type.is_int() || op->type.is_uint())) {
+        Type t = op->args[0].type();
+        bool use_avx2 = target.features & Target::AVX2;
+
+        // Sums of absolute differences of bytes can use psadbw
+        // directly, and sums of products of 16-bit values can use
+        // pmaddwd directly.
+        Expr arg = op->args[0], a, b;
+        const Cast *widen = arg.as<Cast>();
+        if (widen && widen->type.bits > widen->value.type().bits) {
+            arg = widen->value;
+        }
+        const Call *abs = arg.as<Call>();
+        const Sub *diff = NULL;
+        if (abs && abs->call_type == Call::Intrinsic && abs->name == Call::abs) {
+            diff = abs->args[0].as<Sub>();
+        }
+        const Mul *mul = op->args[0].as<Mul>();
+        int bits = t.bits;
+        if (diff && t.width % 16 == 0) {
+            a = lossless_cast(UInt(8, t.width), diff->a);
+            b = lossless_cast(UInt(8, t.width), diff->b);
+            bits = 8;
+        } else if (mul && t.bits == 32 && t.width % 8 == 0) {
+            a = lossless_cast(Int(16, t.width), mul->a);
+            b = lossless_cast(Int(16, t.width), mul->b);
+            bits = 16;
+        }
+        if (!a.defined() || !b.defined()) {
+            a = op->args[0];
+            b = Expr();
+            bits = t.bits;
+        }
+
+        if ((bits == 8 && t.width % 16 == 0) ||
+            (bits == 16 && t.width % 8 == 0)) {
+            // Reduce to a wider type using psadbw against zero, or
+            // pmaddwd against one. Both sum adjacent lanes into a
+            // wider type, so we only have to combine a few lanes
+            // using shuffles at the end. Overflow wraps modulo the
+            // narrow type either way, so this works for signed and
+            // unsigned types.
+            int chunk = (use_avx2 && t.width % (256 / bits) == 0) ? 256 / bits : 128 / bits;
+            Value *va = codegen(a);
+            Value *vb = b.defined() ? codegen(b) : NULL;
+            Value *sum = NULL;
+            for (int i = 0; i < t.width; i += chunk) {
+                Value *slice = va;
+                Value *other = vb;
+                if (chunk != t.width) {
+                    slice = slice_vector(va, i, chunk);
+                    if (vb) other = slice_vector(vb, i, chunk);
+                }
+                Value *partial;
+                string prefix = chunk * bits == 256 ? "avx2." : "sse2.";
+                if (bits == 8) {
+                    if (!other) other = Constant::getNullValue(slice->getType());
+                    partial = call_intrin(llvm_type_of(Int(64, chunk/8)), prefix + "psad.bw", vec(slice, other));
+                } else {
+                    if (!other) other = ConstantVector::getSplat(chunk, ConstantInt::get(i16, 1));
+                    partial = call_intrin(llvm_type_of(Int(32, chunk/2)), prefix + "pmadd.wd", vec(slice, other));
+                }
+                sum = sum ? builder->CreateAdd(sum, partial) : partial;
+            }
+
+            // Sum the remaining lanes using shuffles
+            int lanes = bits == 8 ? chunk/8 : chunk/2;
+            while (lanes > 1) {
+                lanes /= 2;
+                sum = builder->CreateAdd(slice_vector(sum, 0, lanes),
+                                         slice_vector(sum, lanes, lanes));
+            }
+            sum = builder->CreateExtractElement(sum, ConstantInt::get(i32, 0));
+            value = builder->CreateIntCast(sum, llvm_type_of(op->type), false);
+            return;
+        }
+    }
+
+    if (op->call_type == Call::Intrinsic &&
+        (op->name == Call::vector_reduce_min ||
+         op->name == Call::vector_reduce_max) &&
+        (target.features & Target::SSE41) &&
+        op->args[0].type() == UInt(16, 8)) {
+        // phminposuw finds the min of eight unsigned 16-bit
+        // lanes. Max is the bitwise not of the min of the bitwise
+        // not.
+        Value *v = codegen(op->args[0]);
+        bool is_max = op->name == Call::vector_reduce_max;
+        if (is_max) {
+            v = builder->CreateNot(v);
+        }
+        Value *result = call_intrin(llvm_type_of(UInt(16, 8)), "sse41.phminposuw", vec(v));
+        value = builder->CreateExtractElement(result, ConstantInt::get(i32, 0));
+        if (is_max) {
+            value = builder->CreateNot(value);
+        }
+        return;
+    }
+
+    CodeGen_Posix::visit(op);
+}
+
+namespace {
+
+// Replace the narrow integer values an index is computed from, which
+// are loads, or lanes of vector lets, with variables bounded by their
+// type. The bounds of the index relative to its min are then
+// constants, even though the min itself (e.g. the min coordinate of
+// an input image) usually isn't.
+class BoundNarrowValues : public IRMutator {
+    using IRMutator::visit;
+
+    bool is_narrow(Type t) {
+        return t.is_scalar() && (t.is_int() || t.is_uint()) && t.bits < 32;
+    }
+
+    void replace(Expr e) {
+        string name = unique_name('t');
+        scope.push(name, Interval(make_const(e.type(), e.type().imin()),
+                                  make_const(e.type(), e.type().imax())));
+        expr = Variable::make(e.type(), name);
+    }
+
+    void visit(const Load *op) {
+        if (is_narrow(op->type)) {
+            replace(op);
+        } else {
+            IRMutator::visit(op);
+        }
+    }
+
+    void visit(const Call *op) {
+        if (is_narrow(op->type) && op->call_type == Call::Intrinsic &&
+            op->name == Call::shuffle_vector) {
+            replace(op);
+        } else {
+            IRMutator::visit(op);
+        }
+    }
+
+public:
+    Scope<Interval> scope;
+};
+
+}
+
+void CodeGen_X86::visit(const Load *op) {
+    // Only data-dependent vector loads are handled here. Dense and
+    // strided loads, and predicated loads, use the generic path.
+    if (op->type.is_scalar() || predicate ||
+        op->index.as<Ramp>() || op->index.as<Broadcast>()) {
+        CodeGen_Posix::visit(op);
+        return;
+    }
+
+    Type t = op->type;
+
+    // Lookups into a table of at most 16 bytes can be done in
+    // registers with pshufb, which indexes a vector of bytes with
+    // another one. We need to know the range of the index to do this
+    // safely, so take the union of the bounds of each lane. The table
+    // may start anywhere (e.g. at the min coordinate of an input
+    // image), but must span at most 16 entries.
+    if (t.bits == 8 && (target.features & Target::SSE41)) {
+        Expr base;
+        int min = 0, max = -1;
+        for (int i = 0; i < t.width; i++) {
+            BoundNarrowValues bound;
+            Expr lane = bound.mutate(extract_lane(op->index, i));
+            Interval bounds = bounds_of_expr_in_scope(lane, bound.scope);
+            if (!bounds.min.defined() || !bounds.max.defined()) {
+                max = min - 1;
+                break;
+            }
+            if (i == 0) {
+                base = simplify(bounds.min);
+            }
+            const int *lane_min = as_const_int(simplify(bounds.min - base));
+            const int *lane_max = as_const_int(simplify(bounds.max - base));
+            if (!lane_min || !lane_max) {
+                max = min - 1;
+                break;
+            }
+            min = i == 0 ? *lane_min : std::min(min, *lane_min);
+            max = i == 0 ? *lane_max : std::max(max, *lane_max);
+        }
+        if (max > min && max - min < 16) {
+            int entries = max - min + 1;
+            Expr table_base = simplify(base + min);
+            Expr table_load = Load::make(t.element_of().vector_of(entries), op->name,
+                                         Ramp::make(table_base, 1, entries), op->image, op->param);
+            Value *table = codegen(table_load);
+            if (entries < 16) {
+                vector<Constant *> indices(16);
+                for (int i = 0; i < 16; i++) {
+                    indices[i] = i < entries ? ConstantInt::get(i32, i) : UndefValue::get(i32);
+                }
+                table = builder->CreateShuffleVector(table, UndefValue::get(table->getType()),
+                                                     ConstantVector::get(indices));
+            }
+
+            // The indices relative to the start of the table all fit
+            // in a byte.
+            Value *index = codegen(simplify(op->index - table_base));
+            index = builder->CreateTrunc(index, llvm_type_of(UInt(8, t.width)));
+
+            vector<Value *> results;
+            for (int i = 0; i < t.width; i += 16) {
+                Value *slice = index;
+                if (t.width != 16) {
+                    slice = slice_vector(index, i, 16);
+                }
+                results.push_back(call_intrin(llvm_type_of(UInt(8, 16)), "ssse3.pshuf.b.128", vec(table, slice)));
+            }
+            value = concat_vectors(results);
+            if (t.width % 16) {
+                value = slice_vector(value, 0, t.width);
+            }
+            return;
+        }
+    }
+
+    // AVX2 can gather 32-bit values using 32-bit indices in one
+    // instruction. Narrower types would need to gather a whole 32-bit
+    // word per lane, which could read beyond the end of the buffer,
+    // so they stay scalar.
+    if (t.bits == 32 && (target.features & Target::AVX2) && t.width % 4 == 0) {
+        int chunk = t.width % 8 == 0 ? 8 : 4;
+        string intrin = string("avx2.gather.d.") + (t.is_float() ? "ps" : "d") + (chunk == 8 ? ".256" : "");
+        Value *base = codegen_buffer_pointer(op->name, t.element_of(), make_zero(Int(32)));
+        base = builder->CreatePointerCast(base, i8->getPointerTo());
+        Value *index = codegen(op->index);
+
+        llvm::Type *chunk_t = llvm_type_of(t.element_of().vector_of(chunk));
+        // Gather every lane. The mask is the top bit of each lane.
+        Constant *mask = ConstantVector::getSplat(chunk, ConstantInt::get(i32, -1));
+        mask = ConstantExpr::getBitCast(mask, chunk_t);
+        Value *scale = ConstantInt::get(i8, 4);
+
+        llvm::Function *fn = module->getFunction("llvm.x86." + intrin);
+        if (!fn) {
+            vector<llvm::Type *> arg_types;
+            arg_types.push_back(chunk_t);
+            arg_types.push_back(i8->getPointerTo());
+            arg_types.push_back(llvm_type_of(Int(32, chunk)));
+            arg_types.push_back(chunk_t);
+            arg_types.push_back(i8);
+            FunctionType *func_t = FunctionType::get(chunk_t, arg_types, false);
+            fn = llvm::Function::Create(func_t, llvm::Function::ExternalLinkage, "llvm.x86." + intrin, module);
+        }
+
+        vector<Value *> results;
+        for (int i = 0; i < t.width; i += chunk) {
+            Value *slice = index;
+            if (t.width != chunk) {
+                slice = slice_vector(index, i, chunk);
+            }
+            vector<Value *> args;
+            args.push_back(UndefValue::get(chunk_t));
+            args.push_back(base);
+            args.push_back(slice);
+            args.push_back(mask);
+            args.push_back(scale);
+            CallInst *gather = builder->CreateCall(fn, args);
+            gather->setOnlyReadsMemory();
+            gather->setDoesNotThrow();
+            results.push_back(gather);
+        }
+        value = concat_vectors(results);
+        return;
+    }
+
+    CodeGen_Posix::visit(op);
+}
+
 static bool extern_function_1_was_called = false;
 extern "C" int extern_function_1(float x) {
     extern_function_1_was_called = true;
@@ -668,6 +1192,9 @@ void CodeGen_X86::test() {
 }
 
 string CodeGen_X86::mcpu() const {
+    if (target.features & Target::AVX512_Skylake) return "skx";
+    if (target.features & Target::AVX512) return "knl";
+    if (target.features & Target::AVX2) return "core-avx2";
     if (target.features & Target::AVX) return "corei7-avx";
     // We want SSE4.1 but not SSE4.2, hence "penryn" rather than "corei7"
     if (target.features & Target::SSE41) return "penryn";
@@ -676,7 +1203,44 @@ string CodeGen_X86::mcpu() const {
 }
 
 string CodeGen_X86::mattrs() const {
-    return "";
+    // Spell out the features too, in case the llvm in use doesn't
+    // know the cpu name.
+    vector<string> attrs;
+    if (target.features & Target::AVX2) {
+        attrs.push_back("+avx2");
+    }
+    if (target.features & Target::AVX512) {
+        attrs.push_back("+avx512f");
+        attrs.push_back("+avx512cd");
+    }
+    if (target.features & Target::AVX512_Skylake) {
+        attrs.push_back("+avx512bw");
+        attrs.push_back("+avx512dq");
+        attrs.push_back("+avx512vl");
+    }
+    // core-avx2 implies fma and f16c, so turn them off explicitly if
+    // they weren't asked for. The avx2 and avx512 target strings
+    // always ask for them, so this only matters for targets built
+    // with the feature flags directly.
+    if ((target.features & Target::AVX) && !(target.features & Target::AVX512)) {
+        attrs.push_back((target.features & Target::FMA) ? "+fma" : "-fma");
+        attrs.push_back((target.features & Target::F16C) ? "+f16c" : "-f16c");
+    }
+
+    string result;
+    for (size_t i = 0; i < attrs.size(); i++) {
+        if (i > 0) result += ",";
+        result += attrs[i];
+    }
+    return result;
+}
+
+bool CodeGen_X86::allow_fp_op_fusion() const {
+    // Without fma instructions, there's nothing to fuse. With them,
+    // we only fuse when asked to, so that results don't change with
+    // the host's instruction set. Vector a*b + c is fused explicitly
+    // in visit(Add) and visit(Sub).
+    return !(target.features & Target::FMA) || (target.features & Target::FMAContract);
 }
 
 bool CodeGen_X86::use_soft_float_abi() const {
@@ -40,19 +40,40 @@ protected:
     llvm::Value *call_intrin(llvm::Type *t, const std::string &name, std::vector<llvm::Value *>);
     // @}
 
+    /** Multiply adjacent pairs of lanes of two vectors and add each
+     * pair, using pmaddwd or pmaddubsw, split into native vectors. */
+    llvm::Value *call_pmadd(const std::string &intrin, Type result_type, Expr a, Expr b);
+
+    /** If the target has fma instructions and asks for float math to
+     * be contracted, and t is a float vector type, generate a*b + c
+     * as an fma and return true. Otherwise return false. */
+    bool contract_fma(Expr a, Expr b, Expr c, Type t);
+
+    /** Convert to and from half floats with vcvtph2ps and vcvtps2ph,
+     * if the target has f16c. */
+    // @{
+    llvm::Value *float16_to_float32(llvm::Value *);
+    llvm::Value *float32_to_float16(llvm::Value *);
+    // @}
+
     using CodeGen_Posix::visit;
 
     /** Nodes for which we want to emit specific sse/avx intrinsics */
     // @{
     void visit(const Cast *);
+    void visit(const Add *);
+    void visit(const Sub *);
     void visit(const Div *);
     void visit(const Min *);
     void visit(const Max *);
+    void visit(const Call *);
+    void visit(const Load *);
     // @}
 
     std::string mcpu() const;
     std::string mattrs() const;
     bool use_soft_float_abi() const;
+    bool allow_fp_op_fusion() const;
 };
 
 }}
@@ -0,0 +1,309 @@
+#include <set>
+
+#include "ComputeWith.h"
+#include "Debug.h"
+#include "IRMutator.h"
+#include "IROperator.h"
+#include "FindCalls.h"
+#include "Function.h"
+
+namespace Halide {
+namespace Internal {
+
+using std::map;
+using std::string;
+using std::vector;
+using std::pair;
+using std::make_pair;
+
+namespace {
+
+// One loop of a loop nest being fused, along with the lets and ifs
+// that sit between it and the enclosing loop.
+struct Level {
+    vector<pair<string, Expr> > lets;
+    vector<Expr> conditions;
+    const For *loop;
+};
+
+// Peel the lets and else-less ifs (e.g. from skip_stages) off the
+// top of a statement.
+Stmt peel(Stmt s, Level &level) {
+    while (true) {
+        if (const LetStmt *let = s.as<LetStmt>()) {
+            level.lets.push_back(make_pair(let->name, let->value));
+            s = let->body;
+        } else if (const IfThenElse *if_stmt = s.as<IfThenElse>()) {
+            if (if_stmt->else_case.defined()) break;
+            level.conditions.push_back(if_stmt->condition);
+            s = if_stmt->then_case;
+        } else {
+            return s;
+        }
+    }
+    return s;
+}
+
+// Find the loops of a production from the outermost down to the
+// loop over var.
+bool find_levels(Stmt s, const string &var, vector<Level> &levels) {
+    while (true) {
+        Level level;
+        s = peel(s, level);
+        level.loop = s.as<For>();
+        if (!level.loop) return false;
+        levels.push_back(level);
+        if (ends_with(level.loop->name, "." + var)) {
+            return true;
+        }
+        s = level.loop->body;
+    }
+}
+
+// Replace the produce step of the pipeline of func with a no-op,
+// returning it in produce.
+class TakeProduction : public IRMutator {
+    const string &func;
+
+    using IRMutator::visit;
+
+    void visit(const Pipeline *op) {
+        if (op->name == func && !produce.defined()) {
+            produce = op->produce;
+            stmt = Pipeline::make(op->name, Evaluate::make(0), op->update, op->consume);
+        } else {
+            IRMutator::visit(op);
+        }
+    }
+
+public:
+    Stmt produce;
+    TakeProduction(const string &f) : func(f) {}
+};
+
+// Remove the realization of func from the chain of realizations
+// and productions below a consume step, and take its production
+// out. The lets in the way are moved into lets, and the names of the
+// functions realized in between are added to between. Returns an
+// undefined Stmt if func isn't realized there.
+Stmt remove_realization(Stmt s, const string &func,
+                        vector<pair<string, Expr> > &lets,
+                        vector<string> &between,
+                        const Realize *&realize,
+                        TakeProduction &take) {
+    if (const LetStmt *let = s.as<LetStmt>()) {
+        lets.push_back(make_pair(let->name, let->value));
+        return remove_realization(let->body, func, lets, between, realize, take);
+    } else if (const Realize *r = s.as<Realize>()) {
+        if (r->name == func) {
+            realize = r;
+            return take.mutate(r->body);
+        }
+        between.push_back(r->name);
+        Stmt body = remove_realization(r->body, func, lets, between, realize, take);
+        if (!body.defined()) return body;
+        return Realize::make(r->name, r->types, r->bounds, body);
+    } else if (const Pipeline *p = s.as<Pipeline>()) {
+        Stmt consume = remove_realization(p->consume, func, lets, between, realize, take);
+        if (!consume.defined()) return consume;
+        return Pipeline::make(p->name, p->produce, p->update, consume);
+    }
+    return Stmt();
+}
+
+Stmt wrap_lets(Stmt s, const vector<pair<string, Expr> > &lets) {
+    for (size_t i = lets.size(); i > 0; i--) {
+        s = LetStmt::make(lets[i-1].first, lets[i-1].second, s);
+    }
+    return s;
+}
+
+// Fuse two loop nests from the given level down. The fused loops
+// take their names from the loops of a.
+Stmt fuse_levels(const vector<Level> &a, const vector<Level> &b, size_t i,
+                 Expr cond_a, Expr cond_b) {
+    const For *la = a[i].loop, *lb = b[i].loop;
+    Expr v = Variable::make(Int(32), la->name);
+
+    cond_a = cond_a && v >= la->min && v < la->min + la->extent;
+    cond_b = cond_b && v >= lb->min && v < lb->min + lb->extent;
+
+    Stmt body;
+    if (i + 1 == a.size()) {
+        body = Block::make(IfThenElse::make(likely(cond_a), la->body),
+                           IfThenElse::make(likely(cond_b), lb->body));
+    } else {
+        // The lets between this loop and the next one are hoisted to
+        // the top of the fused body, and the ifs become part of the
+        // guards.
+        for (size_t j = 0; j < a[i+1].conditions.size(); j++) {
+            cond_a = cond_a && a[i+1].conditions[j];
+        }
+        for (size_t j = 0; j < b[i+1].conditions.size(); j++) {
+            cond_b = cond_b && b[i+1].conditions[j];
+        }
+        body = fuse_levels(a, b, i + 1, cond_a, cond_b);
+        body = wrap_lets(body, b[i+1].lets);
+        body = wrap_lets(body, a[i+1].lets);
+    }
+
+    // The loop variable of b is an alias for the fused one.
+    body = LetStmt::make(lb->name, v, body);
+
+    Expr min = Min::make(la->min, lb->min);
+    Expr max = Max::make(la->min + la->extent, lb->min + lb->extent);
+    return For::make(la->name, min, max - min, la->for_type, body);
+}
+
+class FuseComputeWith : public IRMutator {
+    const map<string, Function> &env;
+
+    using IRMutator::visit;
+
+    // Fuse the production of inner with the production of outer,
+    // where inner is realized somewhere in the consume step of
+    // outer. target is whichever of the two the other was
+    // scheduled compute_with.
+    Stmt fuse(const Realize *outer, const string &inner, const string &target,
+              const string &var) {
+        const Function &inner_func = env.find(inner)->second;
+
+        // Dig through to the pipeline of the outer function
+        Level outer_lets;
+        Stmt body = peel(outer->body, outer_lets);
+        const Pipeline *pipeline = body.as<Pipeline>();
+        if (!pipeline || pipeline->name != outer->name || !outer_lets.conditions.empty()) {
+            return Stmt();
+        }
+
+        vector<pair<string, Expr> > lets;
+        vector<string> between;
+        const Realize *inner_realize = NULL;
+        TakeProduction take(inner);
+        Stmt consume = remove_realization(pipeline->consume, inner, lets, between, inner_realize, take);
+        if (!consume.defined()) return Stmt();
+        internal_assert(take.produce.defined());
+
+        // The inner function gets computed before the outer
+        // function is consumed, and before anything realized in
+        // between, so it can't depend on any of them.
+        map<string, Function> calls = find_transitive_calls(inner_func);
+        user_assert(!calls.count(outer->name))
+            << "Can't compute " << inner << " with " << outer->name
+            << ", because " << inner << " calls " << outer->name << ".\n";
+        for (size_t i = 0; i < between.size(); i++) {
+            user_assert(!calls.count(between[i]))
+                << "Can't compute " << inner << " with " << outer->name
+                << ", because " << inner << " calls " << between[i]
+                << ", which is computed in between them.\n";
+        }
+
+        vector<Level> outer_levels, inner_levels;
+        bool found_outer = find_levels(pipeline->produce, var, outer_levels);
+        bool found_inner = find_levels(take.produce, var, inner_levels);
+        user_assert(found_outer && found_inner)
+            << "Can't compute " << inner << " with " << outer->name << " at " << var
+            << ", because the loop nest of " << (found_outer ? inner : outer->name)
+            << " doesn't have a loop over " << var << ".\n";
+        user_assert(outer_levels.size() == inner_levels.size())
+            << "Can't compute " << inner << " with " << outer->name << " at " << var
+            << ", because their loop nests have different numbers of loops"
+            << " outside of " << var << ".\n";
+        for (size_t i = 0; i < outer_levels.size(); i++) {
+            const For *a = outer_levels[i].loop, *b = inner_levels[i].loop;
+            user_assert(a->for_type == b->for_type)
+                << "Can't fuse the loops " << a->name << " and " << b->name
+                << ", because they are of different types.\n";
+            user_assert(a->for_type == For::Serial || a->for_type == For::Parallel)
+                << "Can't fuse the loops " << a->name << " and " << b->name
+                << ", because only serial and parallel loops can be fused.\n";
+        }
+
+        // Name the fused loops after the target
+        bool outer_is_target = outer->name == target;
+        const vector<Level> &a = outer_is_target ? outer_levels : inner_levels;
+        const vector<Level> &b = outer_is_target ? inner_levels : outer_levels;
+
+        Expr cond_a = const_true(), cond_b = const_true();
+        for (size_t j = 0; j < a[0].conditions.size(); j++) {
+            cond_a = cond_a && a[0].conditions[j];
+        }
+        for (size_t j = 0; j < b[0].conditions.size(); j++) {
+            cond_b = cond_b && b[0].conditions[j];
+        }
+        Stmt produce = fuse_levels(a, b, 0, cond_a, cond_b);
+        produce = wrap_lets(produce, b[0].lets);
+        produce = wrap_lets(produce, a[0].lets);
+
+        debug(3) << "Fused the productions of " << outer->name << " and " << inner << "\n";
+
+        // The inner function is now realized around the pipeline of
+        // the outer one.
+        Stmt result = Pipeline::make(pipeline->name, produce, pipeline->update, consume);
+        result = Realize::make(inner_realize->name, inner_realize->types, inner_realize->bounds, result);
+        result = wrap_lets(result, lets);
+        result = wrap_lets(result, outer_lets.lets);
+        return Realize::make(outer->name, outer->types, outer->bounds, result);
+    }
+
+    void visit(const Realize *op) {
+        map<string, Function>::const_iterator iter = env.find(op->name);
+        if (iter != env.end()) {
+            for (map<string, Function>::const_iterator j = env.begin(); j != env.end(); ++j) {
+                // Look for a sibling computed with this function, or
+                // that this function is computed with. Whichever one
+                // is realized outermost does the fusing.
+                const LoopLevel &l = j->second.schedule().fuse_level();
+                if (l.is_inline() || fused.count(j->first)) continue;
+                string other;
+                if (j->first != op->name && l.func == op->name) {
+                    other = j->first;
+                } else if (j->first == op->name) {
+                    other = l.func;
+                } else {
+                    continue;
+                }
+
+                Stmt s = fuse(op, other, l.func, l.var);
+                if (s.defined()) {
+                    fused.insert(j->first);
+                    stmt = mutate(s);
+                    return;
+                }
+            }
+        }
+        IRMutator::visit(op);
+    }
+
+public:
+    std::set<string> fused;
+    FuseComputeWith(const map<string, Function> &e) : env(e) {}
+};
+
+}
+
+Stmt fuse_compute_with(Stmt s, const map<string, Function> &env) {
+    bool any = false;
+    for (map<string, Function>::const_iterator iter = env.begin();
+         iter != env.end(); ++iter) {
+        any = any || !iter->second.schedule().fuse_level().is_inline();
+    }
+    if (!any) return s;
+
+    FuseComputeWith fuser(env);
+    s = fuser.mutate(s);
+
+    for (map<string, Function>::const_iterator iter = env.begin();
+         iter != env.end(); ++iter) {
+        const LoopLevel &l = iter->second.schedule().fuse_level();
+        if (l.is_inline()) continue;
+        user_assert(fuser.fused.count(iter->first))
+            << "Func " << iter->first << " is scheduled to be computed with "
+            << l.func << ", but they aren't computed and stored at the same loop level.\n";
+    }
+
+    return s;
+}
+
+}
+}
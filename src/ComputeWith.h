@@ -0,0 +1,27 @@
+#ifndef HALIDE_COMPUTE_WITH_H
+#define HALIDE_COMPUTE_WITH_H
+
+/** \file
+ * Defines the lowering pass that fuses the loop nests of sibling
+ * functions scheduled with compute_with.
+ */
+
+#include <map>
+
+#include "IR.h"
+
+namespace Halide {
+namespace Internal {
+
+/** Fuse the loop nests of the pure definitions of functions
+ * scheduled with compute_with with the loop nests of their
+ * siblings, down to the requested loop level. The fused loops cover
+ * the union of both ranges, and each body is guarded by its own
+ * range. Should be run after bounds inference and skip_stages, and
+ * before storage flattening. */
+Stmt fuse_compute_with(Stmt s, const std::map<std::string, Function> &env);
+
+}
+}
+
+#endif
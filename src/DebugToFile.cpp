@@ -99,29 +99,47 @@ public:
     DebugToFile(const map<string, Function> &e) : env(e) {}
 };
 
-Stmt debug_to_file(Stmt s, string output, const map<string, Function> &env) {
-    // Temporarily wrap the statement in a realize node for the output function
-    Function out = env.find(output)->second;
-    std::vector<Range> output_bounds;
-    for (int i = 0; i < out.dimensions(); i++) {
-        string dim = int_to_string(i);
-        Expr min    = Variable::make(Int(32), output + ".min." + dim);
-        Expr extent = Variable::make(Int(32), output + ".extent." + dim);
-        output_bounds.push_back(Range(min, extent));
+namespace {
+
+// Strip the dummy realize nodes wrapped around the outputs.
+class RemoveRealizations : public IRMutator {
+    const vector<Function> &funcs;
+
+    using IRMutator::visit;
+
+    void visit(const Realize *op) {
+        for (size_t i = 0; i < funcs.size(); i++) {
+            if (op->name == funcs[i].name()) {
+                stmt = mutate(op->body);
+                return;
+            }
+        }
+        IRMutator::visit(op);
     }
-    s = Realize::make(output, out.output_types(), output_bounds, s);
-    s = DebugToFile(env).mutate(s);
 
-    // Remove the realize node we wrapped around the output
-    if (const Realize *r = s.as<Realize>()) {
-        s = r->body;
-    } else if (const Block *b = s.as<Block>()) {
-        const Realize *r = b->rest.as<Realize>();
-        internal_assert(r);
-        s = Block::make(b->first, r->body);
-    } else {
-        internal_error << "Could not unwrap stmt after debug_to_file\n";
+public:
+    RemoveRealizations(const vector<Function> &f) : funcs(f) {}
+};
+
+}
+
+Stmt debug_to_file(Stmt s, const vector<Function> &outputs, const map<string, Function> &env) {
+    // Temporarily wrap the statement in a realize node for the output functions
+    for (size_t j = 0; j < outputs.size(); j++) {
+        Function out = outputs[j];
+        std::vector<Range> output_bounds;
+        for (int i = 0; i < out.dimensions(); i++) {
+            string dim = int_to_string(i);
+            Expr min    = Variable::make(Int(32), out.name() + ".min." + dim);
+            Expr extent = Variable::make(Int(32), out.name() + ".extent." + dim);
+            output_bounds.push_back(Range(min, extent));
+        }
+        s = Realize::make(out.name(), out.output_types(), output_bounds, s);
     }
+    s = DebugToFile(env).mutate(s);
+
+    // Remove the realize nodes we wrapped around the outputs
+    s = RemoveRealizations(outputs).mutate(s);
 
     return s;
 }
@@ -13,6 +13,8 @@ namespace Internal {
 
 using std::pair;
 using std::make_pair;
+using std::string;
+using std::vector;
 
 class Deinterleaver : public IRMutator {
 public:
@@ -74,7 +76,7 @@ private:
             } else {
                 // Uh-oh, we don't know how to deinterleave this vector expression
                 // Make llvm do it
-                std::vector<Expr> args;
+                vector<Expr> args;
                 args.push_back(op);
                 for (int i = 0; i < new_width; i++) {
                     args.push_back(starting_lane + lane_stride * i);
@@ -98,6 +100,29 @@ private:
         // Don't mutate scalars
         if (op->type.is_scalar()) {
             expr = op;
+        } else if (op->call_type == Call::Intrinsic &&
+                   op->name == Call::interleave_vectors) {
+            // Lane i of an interleaving of k vectors is lane i/k of
+            // arg i%k.
+            int k = (int)op->args.size();
+            if (lane_stride % k == 0) {
+                int old_starting_lane = starting_lane, old_lane_stride = lane_stride;
+                Expr arg = op->args[starting_lane % k];
+                starting_lane /= k;
+                lane_stride /= k;
+                expr = mutate(arg);
+                starting_lane = old_starting_lane;
+                lane_stride = old_lane_stride;
+            } else {
+                vector<Expr> args;
+                args.push_back(op);
+                for (int i = 0; i < new_width; i++) {
+                    args.push_back(starting_lane + lane_stride * i);
+                }
+                Type t = op->type;
+                t.width = new_width;
+                expr = Call::make(t, Call::shuffle_vector, args, Call::Intrinsic);
+            }
         } else {
 
             Type t = op->type;
@@ -162,13 +187,126 @@ Expr extract_lane(Expr e, int lane) {
     return simplify(e);
 }
 
+// Does an expression load from a given buffer?
+class LoadsFrom : public IRVisitor {
+    const string &name;
+
+    using IRVisitor::visit;
+
+    void visit(const Load *op) {
+        IRVisitor::visit(op);
+        if (op->name == name) result = true;
+    }
+public:
+    bool result;
+    LoadsFrom(const string &n) : name(n), result(false) {}
+};
+
+bool loads_from(Expr e, const string &name) {
+    LoadsFrom l(name);
+    e.accept(&l);
+    return l.result;
+}
+
 class Interleaver : public IRMutator {
     Scope<ModulusRemainder> alignment_info;
 
     Scope<int> vector_lets;
 
+    // How many predicated vector tails (ifs with a vector condition)
+    // we're inside of. The predicate has one lane per lane of each
+    // store, so stores there can't be grouped into wider ones.
+    int in_predicated;
+
     using IRMutator::visit;
 
+    void flatten_block(Stmt s, vector<Stmt> &stmts) {
+        if (const Block *b = s.as<Block>()) {
+            flatten_block(b->first, stmts);
+            if (b->rest.defined()) flatten_block(b->rest, stmts);
+        } else if (s.defined()) {
+            stmts.push_back(mutate(s));
+        }
+    }
+
+    // If the stores starting at stmts[i] are a 2-, 3- or 4-way
+    // interleaving, e.g. from an unrolled loop over the channels of
+    // a packed rgb output, make a single dense store of the
+    // interleaved values and return true.
+    bool interleave_stores(const vector<Stmt> &stmts, size_t i, Stmt *result) {
+        const Store *first = stmts[i].as<Store>();
+        const Ramp *first_ramp = first ? first->index.as<Ramp>() : NULL;
+        const int *stride = first_ramp ? as_const_int(first_ramp->stride) : NULL;
+        if (!stride || *stride < 2 || *stride > 4 || i + *stride > stmts.size()) {
+            return false;
+        }
+
+        // The values to interleave, by offset from the lowest base.
+        vector<Expr> values(*stride);
+        int min_offset = 0;
+        for (int j = 0; j < *stride; j++) {
+            const Store *store = stmts[i + j].as<Store>();
+            const Ramp *ramp = store ? store->index.as<Ramp>() : NULL;
+            if (!ramp || store->name != first->name ||
+                !equal(ramp->stride, first_ramp->stride) ||
+                ramp->width != first_ramp->width ||
+                store->value.type() != first->value.type()) {
+                return false;
+            }
+            // We're going to move the stores after all of the values
+            // are computed.
+            if (loads_from(store->value, store->name) ||
+                loads_from(store->index, store->name)) {
+                return false;
+            }
+            const int *offset = as_const_int(simplify(ramp->base - first_ramp->base));
+            if (!offset || *offset <= -*stride || *offset >= *stride) {
+                return false;
+            }
+            min_offset = std::min(min_offset, *offset);
+        }
+
+        for (int j = 0; j < *stride; j++) {
+            const Store *store = stmts[i + j].as<Store>();
+            const Ramp *ramp = store->index.as<Ramp>();
+            int offset = *as_const_int(simplify(ramp->base - first_ramp->base)) - min_offset;
+            if (offset >= *stride || values[offset].defined()) {
+                return false;
+            }
+            values[offset] = store->value;
+        }
+
+        debug(3) << "Detected a " << *stride << "-way interleaved store to " << first->name << "\n";
+        Expr base = simplify(first_ramp->base + min_offset);
+        Type t = first->value.type();
+        Expr value = Call::make(t.vector_of(t.width * (*stride)), Call::interleave_vectors,
+                                values, Call::Intrinsic);
+        *result = Store::make(first->name, value, Ramp::make(base, 1, t.width * (*stride)));
+        return true;
+    }
+
+    void visit(const Block *op) {
+        vector<Stmt> stmts;
+        flatten_block(op, stmts);
+
+        vector<Stmt> result;
+        for (size_t i = 0; i < stmts.size(); i++) {
+            Stmt interleaved;
+            if (!in_predicated && interleave_stores(stmts, i, &interleaved)) {
+                const Ramp *ramp = stmts[i].as<Store>()->index.as<Ramp>();
+                i += *as_const_int(ramp->stride) - 1;
+                result.push_back(interleaved);
+            } else {
+                result.push_back(stmts[i]);
+            }
+        }
+
+        stmt = result.back();
+        for (size_t i = result.size() - 1; i > 0; i--) {
+            stmt = Block::make(result[i-1], stmt);
+        }
+    }
+
     template<typename T, typename Body>
     Body visit_let(const T *op) {
         Expr value = mutate(op->value);
@@ -203,6 +341,16 @@ class Interleaver : public IRMutator {
         return result;
     }
 
+    void visit(const IfThenElse *op) {
+        if (op->condition.type().is_vector()) {
+            in_predicated++;
+            IRMutator::visit(op);
+            in_predicated--;
+        } else {
+            IRMutator::visit(op);
+        }
+    }
+
     void visit(const Let *op) {
         expr = visit_let<Let, Expr>(op);
     }
@@ -251,6 +399,9 @@ class Interleaver : public IRMutator {
             expr = Select::make(condition, true_value, false_value);
         }
     }
+
+public:
+    Interleaver() : in_predicated(0) {}
 };
 
 Stmt rewrite_interleavings(Stmt s) {
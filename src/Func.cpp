@@ -358,7 +358,7 @@ bool var_name_match(string candidate, string var) {
 }
 }
 
-void ScheduleHandle::set_dim_type(Var var, For::ForType t) {
+void ScheduleHandle::set_dim_type(VarOrRVar var, For::ForType t) {
     bool found = false;
     vector<Dim> &dims = schedule.dims();
     for (size_t i = 0; i < dims.size(); i++) {
@@ -391,7 +391,7 @@ std::string ScheduleHandle::dump_argument_list() {
     return oss.str();
 }
 
-ScheduleHandle &ScheduleHandle::split(Var old, Var outer, Var inner, Expr factor) {
+ScheduleHandle &ScheduleHandle::split(VarOrRVar old, Var outer, Var inner, Expr factor, TailStrategy tail) {
     // Replace the old dimension with the new dimensions in the dims list
     bool found = false;
     string inner_name, outer_name, old_name;
@@ -419,13 +419,14 @@ ScheduleHandle &ScheduleHandle::split(Var old, Var outer, Var inner, Expr factor
     }
 
     // Add the split to the splits list
-    Split split = {old_name, outer_name, inner_name, factor, Split::SplitVar};
+    Split split = {old_name, outer_name, inner_name, factor, Split::SplitVar, tail,
+                   TileOrder_RowMajor, false};
     schedule.splits().push_back(split);
     return *this;
 }
 
 
-ScheduleHandle &ScheduleHandle::fuse(Var inner, Var outer, Var fused) {
+ScheduleHandle &ScheduleHandle::fuse(Var inner, Var outer, Var fused, TileOrder order) {
     // Replace the old dimensions with the new dimension in the dims list
     bool found_outer = false, found_inner = false;
     string inner_name, outer_name, fused_name;
@@ -467,7 +468,8 @@ ScheduleHandle &ScheduleHandle::fuse(Var inner, Var outer, Var fused) {
 
 
     // Add the fuse to the splits list
-    Split split = {fused_name, outer_name, inner_name, Expr(), Split::FuseVars};
+    Split split = {fused_name, outer_name, inner_name, Expr(), Split::FuseVars,
+                   TailStrategy_Auto, order, false};
     schedule.splits().push_back(split);
     return *this;
 }
@@ -513,7 +515,8 @@ ScheduleHandle &ScheduleHandle::rename(Var old_var, Var new_var) {
 
     if (old_name.find('.') == string::npos) {
         // If it's a primitive name, add the rename to the splits list.
-        Split split = {old_name, new_name, "", 1, Split::RenameVar};
+        Split split = {old_name, new_name, "", 1, Split::RenameVar,
+                       TailStrategy_Auto, TileOrder_RowMajor, false};
         schedule.splits().push_back(split);
     } else {
         // It's a derived name, so just rewrite the split or rename that defines it.
@@ -565,12 +568,12 @@ ScheduleHandle &ScheduleHandle::parallel(Var var) {
     return *this;
 }
 
-ScheduleHandle &ScheduleHandle::vectorize(Var var) {
+ScheduleHandle &ScheduleHandle::vectorize(VarOrRVar var) {
     set_dim_type(var, For::Vectorized);
     return *this;
 }
 
-ScheduleHandle &ScheduleHandle::unroll(Var var) {
+ScheduleHandle &ScheduleHandle::unroll(VarOrRVar var) {
     set_dim_type(var, For::Unrolled);
     return *this;
 }
@@ -582,30 +585,100 @@ ScheduleHandle &ScheduleHandle::parallel(Var var, Expr factor) {
     return *this;
 }
 
-ScheduleHandle &ScheduleHandle::vectorize(Var var, int factor) {
+ScheduleHandle &ScheduleHandle::parallel_strips(Var var, Var strip, Var row, Expr strips) {
+    split(var, strip, row, strips);
+    schedule.splits().back().by_count = true;
+    parallel(strip);
+    return *this;
+}
+
+ScheduleHandle &ScheduleHandle::vectorize(VarOrRVar var, int factor, TailStrategy tail) {
     Var tmp;
-    split(var, var, tmp, factor);
+    split(var, Var(var.name()), tmp, factor, tail);
     vectorize(tmp);
     return *this;
 }
 
-ScheduleHandle &ScheduleHandle::unroll(Var var, int factor) {
+ScheduleHandle &ScheduleHandle::unroll(VarOrRVar var, int factor, TailStrategy tail) {
     Var tmp;
-    split(var, var, tmp, factor);
+    split(var, Var(var.name()), tmp, factor, tail);
+    unroll(tmp);
+    return *this;
+}
+
+ScheduleHandle &ScheduleHandle::reassociate_floats(bool allow) {
+    schedule.reassociate_floats() = allow;
+    return *this;
+}
+
+ScheduleHandle &ScheduleHandle::interleave_accumulators(VarOrRVar var, int factor,
+                                                        bool reassociate_floats) {
+    Var tmp;
+    split(var, Var(var.name()), tmp, factor);
     unroll(tmp);
+
+    const vector<Dim> &dims = schedule.dims();
+    for (size_t i = 0; i < dims.size(); i++) {
+        if (var_name_match(dims[i].var, tmp.name())) {
+            InterleavedAccumulator acc = {dims[i].var, reassociate_floats};
+            schedule.interleaved_accumulators().push_back(acc);
+        }
+    }
+    return *this;
+}
+
+ScheduleHandle &ScheduleHandle::parallel_scatter(VarOrRVar var, ScatterStrategy strategy) {
+    set_dim_type(var, For::Parallel);
+
+    const vector<Dim> &dims = schedule.dims();
+    for (size_t i = 0; i < dims.size(); i++) {
+        if (var_name_match(dims[i].var, var.name())) {
+            ParallelScatter scatter = {dims[i].var, strategy == Scatter_Atomic};
+            schedule.parallel_scatters().push_back(scatter);
+        }
+    }
     return *this;
 }
 
-ScheduleHandle &ScheduleHandle::tile(Var x, Var y, Var xo, Var yo, Var xi, Var yi, Expr xfactor, Expr yfactor) {
-    split(x, xo, xi, xfactor);
-    split(y, yo, yi, yfactor);
+void ScheduleHandle::add_prefetch(const std::string &name, VarOrRVar var, Expr distance) {
+    const vector<Dim> &dims = schedule.dims();
+    for (size_t i = 0; i < dims.size(); i++) {
+        if (var_name_match(dims[i].var, var.name())) {
+            Prefetch p = {name, dims[i].var, distance};
+            schedule.prefetches().push_back(p);
+            return;
+        }
+    }
+
+    user_error << "Could not find dimension "
+               << var.name()
+               << " within which to prefetch " << name
+               << " in argument list for function\n"
+               << dump_argument_list();
+}
+
+ScheduleHandle &ScheduleHandle::prefetch(Func f, VarOrRVar var, Expr distance) {
+    add_prefetch(f.name(), var, distance);
+    return *this;
+}
+
+ScheduleHandle &ScheduleHandle::prefetch(const ImageParam &image, VarOrRVar var, Expr distance) {
+    add_prefetch(image.name(), var, distance);
+    return *this;
+}
+
+ScheduleHandle &ScheduleHandle::tile(Var x, Var y, Var xo, Var yo, Var xi, Var yi,
+                                     Expr xfactor, Expr yfactor, TailStrategy tail) {
+    split(x, xo, xi, xfactor, tail);
+    split(y, yo, yi, yfactor, tail);
     reorder(xi, yi, xo, yo);
     return *this;
 }
 
-ScheduleHandle &ScheduleHandle::tile(Var x, Var y, Var xi, Var yi, Expr xfactor, Expr yfactor) {
-    split(x, x, xi, xfactor);
-    split(y, y, yi, yfactor);
+ScheduleHandle &ScheduleHandle::tile(Var x, Var y, Var xi, Var yi,
+                                     Expr xfactor, Expr yfactor, TailStrategy tail) {
+    split(x, x, xi, xfactor, tail);
+    split(y, y, yi, yfactor, tail);
     reorder(xi, yi, x, y);
     return *this;
 }
@@ -799,13 +872,13 @@ ScheduleHandle &ScheduleHandle::gpu_tile(Var x, Var y, Var z,
     return *this;
 }
 
-Func &Func::split(Var old, Var outer, Var inner, Expr factor) {
-    ScheduleHandle(func.schedule()).split(old, outer, inner, factor);
+Func &Func::split(Var old, Var outer, Var inner, Expr factor, TailStrategy tail) {
+    ScheduleHandle(func.schedule()).split(old, outer, inner, factor, tail);
     return *this;
 }
 
-Func &Func::fuse(Var inner, Var outer, Var fused) {
-    ScheduleHandle(func.schedule()).fuse(inner, outer, fused);
+Func &Func::fuse(Var inner, Var outer, Var fused, TileOrder order) {
+    ScheduleHandle(func.schedule()).fuse(inner, outer, fused, order);
     return *this;
 }
 
@@ -843,13 +916,18 @@ Func &Func::parallel(Var var, Expr factor) {
     return *this;
 }
 
-Func &Func::vectorize(Var var, int factor) {
-    ScheduleHandle(func.schedule()).vectorize(var, factor);
+Func &Func::parallel_strips(Var var, Var strip, Var row, Expr strips) {
+    ScheduleHandle(func.schedule()).parallel_strips(var, strip, row, strips);
     return *this;
 }
 
-Func &Func::unroll(Var var, int factor) {
-    ScheduleHandle(func.schedule()).unroll(var, factor);
+Func &Func::vectorize(Var var, int factor, TailStrategy tail) {
+    ScheduleHandle(func.schedule()).vectorize(var, factor, tail);
+    return *this;
+}
+
+Func &Func::unroll(Var var, int factor, TailStrategy tail) {
+    ScheduleHandle(func.schedule()).unroll(var, factor, tail);
     return *this;
 }
 
@@ -871,13 +949,25 @@ Func &Func::bound(Var var, Expr min, Expr extent) {
     return *this;
 }
 
-Func &Func::tile(Var x, Var y, Var xo, Var yo, Var xi, Var yi, Expr xfactor, Expr yfactor) {
-    ScheduleHandle(func.schedule()).tile(x, y, xo, yo, xi, yi, xfactor, yfactor);
+Func &Func::prefetch(Func f, Var var, Expr distance) {
+    ScheduleHandle(func.schedule()).prefetch(f, var, distance);
+    return *this;
+}
+
+Func &Func::prefetch(const ImageParam &image, Var var, Expr distance) {
+    ScheduleHandle(func.schedule()).prefetch(image, var, distance);
+    return *this;
+}
+
+Func &Func::tile(Var x, Var y, Var xo, Var yo, Var xi, Var yi,
+                 Expr xfactor, Expr yfactor, TailStrategy tail) {
+    ScheduleHandle(func.schedule()).tile(x, y, xo, yo, xi, yi, xfactor, yfactor, tail);
     return *this;
 }
 
-Func &Func::tile(Var x, Var y, Var xi, Var yi, Expr xfactor, Expr yfactor) {
-    ScheduleHandle(func.schedule()).tile(x, y, xi, yi, xfactor, yfactor);
+Func &Func::tile(Var x, Var y, Var xi, Var yi,
+                 Expr xfactor, Expr yfactor, TailStrategy tail) {
+    ScheduleHandle(func.schedule()).tile(x, y, xi, yi, xfactor, yfactor, tail);
     return *this;
 }
 
@@ -1066,6 +1156,28 @@ Func &Func::reorder_storage(Var x, Var y, Var z, Var w, Var t) {
     return *this;
 }
 
+Func &Func::fold_storage(Var dim, Expr extent) {
+    bool found = false;
+    for (size_t i = 0; i < func.args().size(); i++) {
+        if (dim.name() == func.args()[i]) {
+            found = true;
+        }
+    }
+    user_assert(found)
+        << "Can't fold the storage of " << name()
+        << " over " << dim.name()
+        << " because " << dim.name()
+        << " is not one of the pure variables of " << name() << ".\n";
+    user_assert(extent.defined() && (extent.type().is_int() || extent.type().is_uint()))
+        << "Can't fold the storage of " << name()
+        << " over " << dim.name()
+        << " by " << extent << ", because it isn't an integer.\n";
+
+    FoldedDim fold = {dim.name(), extent};
+    func.schedule().folded_dims().push_back(fold);
+    return *this;
+}
+
 Func &Func::compute_at(Func f, RVar var) {
     return compute_at(f, Var(var.name()));
 }
@@ -1079,6 +1191,18 @@ Func &Func::compute_at(Func f, Var var) {
     return *this;
 }
 
+Func &Func::compute_with(Func f, Var var) {
+    user_assert(f.name() != name())
+        << "Can't compute Func " << name() << " with itself.\n";
+    func.schedule().fuse_level() = LoopLevel(f.name(), var.name());
+    return *this;
+}
+
+Func &Func::async() {
+    func.schedule().async() = true;
+    return *this;
+}
+
 Func &Func::compute_root() {
     func.schedule().compute_level() = LoopLevel::root();
     if (func.schedule().store_level().is_inline()) {
@@ -1526,18 +1650,20 @@ public:
     vector<pair<int, Internal::Parameter> > image_param_args;
     vector<pair<int, Buffer> > image_args;
 
-    InferArguments(const string &o) : output(o) {
+    InferArguments(const vector<string> &o) : outputs(o) {
     }
 
 private:
-    const string &output;
+    vector<string> outputs;
 
     using IRGraphVisitor::visit;
 
     bool already_have(const string &name) {
         // Ignore dependencies on the output buffers
-        if (name == output || starts_with(name, output + ".")) {
-            return true;
+        for (size_t i = 0; i < outputs.size(); i++) {
+            if (name == outputs[i] || starts_with(name, outputs[i] + ".")) {
+                return true;
+            }
         }
         for (size_t i = 0; i < arg_types.size(); i++) {
             if (arg_types[i].name == name) {
@@ -1550,7 +1676,11 @@ private:
     void include_parameter(Internal::Parameter p) {
         if (!p.defined()) return;
         if (already_have(p.name())) return;
-        arg_types.push_back(Argument(p.name(), p.is_buffer(), p.type()));
+        Argument arg(p.name(), p.is_buffer(), p.type());
+        if (p.is_buffer()) {
+            arg.host_alignment = p.host_alignment();
+        }
+        arg_types.push_back(arg);
         if (p.is_buffer()) {
             Buffer b = p.get_buffer();
             int idx = (int)arg_values.size();
@@ -1598,11 +1728,11 @@ private:
 /** Check that all the necessary arguments are in an args vector. Any
  * images in the source that aren't in the args vector are placed in
  * the images_to_embed list. */
-void validate_arguments(const string &output,
+void validate_arguments(const vector<string> &outputs,
                         const vector<Argument> &args,
                         Stmt lowered,
                         vector<Buffer> &images_to_embed) {
-    InferArguments infer_args(output);
+    InferArguments infer_args(outputs);
     lowered.accept(&infer_args);
     const vector<Argument> &required_args = infer_args.arg_types;
 
@@ -1661,7 +1791,7 @@ void Func::compile_to_bitcode(const string &filename, vector<Argument> args, con
     }
 
     vector<Buffer> images_to_embed;
-    validate_arguments(name(), args, lowered, images_to_embed);
+    validate_arguments(vec(name()), args, lowered, images_to_embed);
 
     for (int i = 0; i < outputs(); i++) {
         args.push_back(output_buffers()[i]);
@@ -1685,7 +1815,7 @@ void Func::compile_to_object(const string &filename, vector<Argument> args, cons
     }
 
     vector<Buffer> images_to_embed;
-    validate_arguments(name(), args, lowered, images_to_embed);
+    validate_arguments(vec(name()), args, lowered, images_to_embed);
 
     for (int i = 0; i < outputs(); i++) {
         args.push_back(output_buffers()[i]);
@@ -1716,7 +1846,7 @@ void Func::compile_to_c(const string &filename, vector<Argument> args, const str
     }
 
     vector<Buffer> images_to_embed;
-    validate_arguments(name(), args, lowered, images_to_embed);
+    validate_arguments(vec(name()), args, lowered, images_to_embed);
 
     for (int i = 0; i < outputs(); i++) {
         args.push_back(output_buffers()[i]);
@@ -1778,7 +1908,7 @@ void Func::compile_to_assembly(const string &filename, vector<Argument> args, co
     if (!lowered.defined()) lowered = Halide::Internal::lower(func, target);
 
     vector<Buffer> images_to_embed;
-    validate_arguments(name(), args, lowered, images_to_embed);
+    validate_arguments(vec(name()), args, lowered, images_to_embed);
 
     for (int i = 0; i < outputs(); i++) {
         args.push_back(output_buffers()[i]);
@@ -2138,7 +2268,7 @@ void *Func::compile_jit(const Target &target) {
     }
 
     // Infer arguments
-    InferArguments infer_args(name());
+    InferArguments infer_args(vec(name()));
     lowered.accept(&infer_args);
 
     // Add the user context arg if it isn't there already
@@ -2191,6 +2321,244 @@ void *Func::compile_jit(const Target &target) {
     return compiled_module.function;
 }
 
+// Qualified, because the Internal::Pipeline IR node is also visible
+// here.
+Halide::Pipeline::Pipeline(Func output) : output_funcs(vec(output)), error_handler(NULL),
+                                          user_context(user_context_param()) {
+    user_assert(output.defined()) << "Can't make a Pipeline with an undefined Func.\n";
+}
+
+Halide::Pipeline::Pipeline(const vector<Func> &outputs) : output_funcs(outputs), error_handler(NULL),
+                                                          user_context(user_context_param()) {
+    user_assert(!outputs.empty()) << "Can't make a Pipeline with no outputs.\n";
+    for (size_t i = 0; i < outputs.size(); i++) {
+        user_assert(outputs[i].defined())
+            << "Can't make a Pipeline with an undefined Func as output " << i << ".\n";
+    }
+}
+
+const vector<Func> &Halide::Pipeline::outputs() const {
+    return output_funcs;
+}
+
+vector<string> Halide::Pipeline::output_names() const {
+    vector<string> names;
+    for (size_t i = 0; i < output_funcs.size(); i++) {
+        names.push_back(output_funcs[i].name());
+    }
+    return names;
+}
+
+vector<Argument> Halide::Pipeline::output_arguments() const {
+    vector<Argument> args;
+    for (size_t i = 0; i < output_funcs.size(); i++) {
+        vector<OutputImageParam> bufs = output_funcs[i].output_buffers();
+        args.insert(args.end(), bufs.begin(), bufs.end());
+    }
+    return args;
+}
+
+void Halide::Pipeline::lower(const Target &target) {
+    if (!lowered.defined()) {
+        vector<Function> outputs;
+        for (size_t i = 0; i < output_funcs.size(); i++) {
+            outputs.push_back(output_funcs[i].function());
+        }
+        lowered = Halide::Internal::lower(outputs, target);
+    }
+}
+
+void Halide::Pipeline::compile_to_bitcode(const string &filename, vector<Argument> args, const string &fn_name,
+                                  const Target &target) {
+    lower(target);
+
+    vector<Buffer> images_to_embed;
+    validate_arguments(output_names(), args, lowered, images_to_embed);
+
+    vector<Argument> outputs = output_arguments();
+    args.insert(args.end(), outputs.begin(), outputs.end());
+
+    StmtCompiler cg(target);
+    cg.compile(lowered, fn_name, args, images_to_embed);
+    cg.compile_to_bitcode(filename);
+}
+
+void Halide::Pipeline::compile_to_object(const string &filename, vector<Argument> args, const string &fn_name,
+                                 const Target &target) {
+    lower(target);
+
+    vector<Buffer> images_to_embed;
+    validate_arguments(output_names(), args, lowered, images_to_embed);
+
+    vector<Argument> outputs = output_arguments();
+    args.insert(args.end(), outputs.begin(), outputs.end());
+
+    StmtCompiler cg(target);
+    cg.compile(lowered, fn_name, args, images_to_embed);
+    cg.compile_to_native(filename, false);
+}
+
+void Halide::Pipeline::compile_to_header(const string &filename, vector<Argument> args, const string &fn_name) {
+    vector<Argument> outputs = output_arguments();
+    args.insert(args.end(), outputs.begin(), outputs.end());
+
+    ofstream header(filename.c_str());
+    CodeGen_C cg(header);
+    cg.compile_header(fn_name, args);
+}
+
+void Halide::Pipeline::compile_to_file(const string &filename_prefix, vector<Argument> args,
+                               const Target &target) {
+    compile_to_header(filename_prefix + ".h", args, filename_prefix);
+    compile_to_object(filename_prefix + ".o", args, filename_prefix, target);
+}
+
+void Halide::Pipeline::compile_to_lowered_stmt(const string &filename) {
+    lower(get_host_target());
+
+    ofstream stmt_output(filename.c_str());
+    stmt_output << lowered;
+}
+
+void Halide::Pipeline::set_error_handler(void (*handler)(void *, const char *)) {
+    error_handler = handler;
+    if (compiled_module.set_error_handler) {
+        compiled_module.set_error_handler(handler);
+    }
+}
+
+bool Halide::Pipeline::prepare_to_catch_runtime_errors(void *b) {
+    error_buffer *buf = (error_buffer *)b;
+    buf->end = 0;
+    bool my_user_context_active = false;
+    for (size_t i = 0; i < arg_values.size(); i++) {
+        if (arg_values[i] == user_context.get_address()) {
+            my_user_context_active = true;
+        }
+    }
+    if ((error_handler == &buffered_error_handler ||
+         error_handler == NULL) &&
+        my_user_context_active) {
+        compiled_module.set_error_handler(buffered_error_handler);
+        memset(buf->buf, 0, max_error_buffer_size);
+        user_context.set(buf);
+        return true;
+    }
+    return false;
+}
+
+void *Halide::Pipeline::compile_jit(const Target &target) {
+    lower(target);
+
+    // Infer arguments
+    InferArguments infer_args(output_names());
+    lowered.accept(&infer_args);
+
+    // Add the user context arg if it isn't there already
+    Expr(user_context).accept(&infer_args);
+
+    arg_values = infer_args.arg_values;
+
+    // Then a spot for the address of each output buffer
+    vector<Argument> outputs = output_arguments();
+    for (size_t i = 0; i < outputs.size(); i++) {
+        infer_args.arg_types.push_back(outputs[i]);
+        arg_values.push_back(NULL);
+    }
+    image_param_args = infer_args.image_param_args;
+
+    Target t = target;
+    t.features |= Target::JIT;
+    StmtCompiler cg(t);
+
+    // Name the generated function after the first output
+    string n = "pipeline_" + output_funcs[0].name();
+    for (size_t i = 0; i < n.size(); i++) {
+        if (!isalnum(n[i])) {
+            n[i] = '_';
+        }
+    }
+
+    cg.compile(lowered, n, infer_args.arg_types, vector<Buffer>());
+
+    compiled_module = cg.compile_to_function_pointers();
+
+    return compiled_module.function;
+}
+
+void Halide::Pipeline::realize(Realization dst, const Target &target) {
+    if (!compiled_module.wrapped_function) compile_jit(target);
+
+    internal_assert(compiled_module.wrapped_function);
+
+    // Check the number, type and dimensionality of the buffers
+    size_t expected = 0;
+    for (size_t i = 0; i < output_funcs.size(); i++) {
+        expected += output_funcs[i].outputs();
+    }
+    user_assert(dst.size() == expected)
+        << "Can't realize a Pipeline with " << expected << " output buffers"
+        << " into a Realization of " << dst.size() << " buffers.\n";
+
+    size_t idx = 0;
+    for (size_t i = 0; i < output_funcs.size(); i++) {
+        const Func &f = output_funcs[i];
+        for (int j = 0; j < f.outputs(); j++, idx++) {
+            user_assert(dst[idx].dimensions() == f.dimensions())
+                << "Can't realize Func \"" << f.name()
+                << "\" into Buffer \"" << dst[idx].name()
+                << "\" because Buffer \"" << dst[idx].name()
+                << "\" is " << dst[idx].dimensions() << "-dimensional"
+                << ", but Func \"" << f.name()
+                << "\" is " << f.dimensions() << "-dimensional.\n";
+            user_assert(dst[idx].type() == f.output_types()[j])
+                << "Can't realize Func \"" << f.name()
+                << "\" into Buffer \"" << dst[idx].name()
+                << "\" because Buffer \"" << dst[idx].name()
+                << "\" has type " << dst[idx].type()
+                << ", but Func \"" << f.name()
+                << "\" has type " << f.output_types()[j] << ".\n";
+        }
+    }
+
+    // In case it has changed since the last realization
+    compiled_module.set_error_handler(error_handler);
+
+    // Update the address of the buffers we're realizing into
+    for (size_t i = 0; i < dst.size(); i++) {
+        arg_values[arg_values.size()-dst.size()+i] = dst[i].raw_buffer();
+    }
+
+    // Update the addresses of the image param args
+    for (size_t i = 0; i < image_param_args.size(); i++) {
+        Buffer b = image_param_args[i].second.get_buffer();
+        user_assert(b.defined())
+            << "ImageParam \"" << image_param_args[i].second.name()
+            << "\" is not bound to a buffer.\n";
+        arg_values[image_param_args[i].first] = b.raw_buffer();
+    }
+
+    for (size_t i = 0; i < arg_values.size(); i++) {
+        internal_assert(arg_values[i])
+            << "An argument to a jitted function is null\n";
+    }
+
+    error_buffer buf;
+    bool buffer_runtime_errors = prepare_to_catch_runtime_errors(&buf);
+
+    Internal::debug(2) << "Calling jitted pipeline\n";
+    int exit_status = compiled_module.wrapped_function(&(arg_values[0]));
+    Internal::debug(2) << "Back from jitted pipeline. Exit status was " << exit_status << "\n";
+
+    for (size_t i = 0; i < dst.size(); i++) {
+        dst[i].set_source_module(compiled_module);
+    }
+
+    if (buffer_runtime_errors && exit_status) {
+        halide_runtime_error << buf.buf;
+    }
+}
+
 void Func::test() {
 
     Image<int> input(7, 5);
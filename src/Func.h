@@ -198,29 +198,76 @@ enum GPUAPI {
     GPU_GLSL
 };
 
+/** Ways of avoiding races between the iterations of a parallel
+ * update that scatters into data-dependent sites. See
+ * \ref ScheduleHandle::parallel_scatter */
+enum ScatterStrategy {
+    /** Give each iteration a private copy of the output, and combine
+     * the copies once the loop is done. */
+    Scatter_Privatize,
+
+    /** Update the output directly using atomic read-modify-write
+     * operations. Only integer +=, -=, min, and max updates are
+     * supported. */
+    Scatter_Atomic
+};
+
+class Func;
+
 /** A temporary wrapper around a schedule used for common schedule manipulations */
 class ScheduleHandle {
     Internal::Schedule schedule;
-    void set_dim_type(Var var, Internal::For::ForType t);
+    void set_dim_type(VarOrRVar var, Internal::For::ForType t);
+    void add_prefetch(const std::string &name, VarOrRVar var, Expr distance);
     std::string dump_argument_list();
 public:
     ScheduleHandle(Internal::Schedule s) : schedule(s) {s.touched();}
 
     /** Scheduling calls that control how the domain of this stage is
-     * traversed. See the documentation for Func for the meanings. */
+     * traversed. See the documentation for Func for the meanings.
+     *
+     * In an update stage, split, vectorize, and unroll also accept
+     * the reduction variables. Vectorizing across a reduction
+     * variable asserts that the lanes don't depend on each other,
+     * with one exception: if the update site doesn't depend on the
+     * reduction variable and the update is associative (+=, -=, *=,
+     * min, max), each lane accumulates a partial result and the
+     * lanes are combined once at the end. E.g. to vectorize a sum:
+
+     \code
+     RDom r(0, 1024);
+     Var rxo, rxi;
+     f() = 0;
+     f() += g(r);
+     f.update().split(r, rxo, rxi, 8).vectorize(rxi);
+     \endcode
+
+     * For floating point sums and products this changes the order
+     * of the operations, and hence the rounding, so they are only
+     * combined this way after a call to reassociate_floats. Other
+     * updates of a single site are done one lane at a time. It is an
+     * error to vectorize across a reduction variable when one lane
+     * of the update may read or write a site that another lane
+     * writes. */
     // @{
 
-    EXPORT ScheduleHandle &split(Var old, Var outer, Var inner, Expr factor);
-    EXPORT ScheduleHandle &fuse(Var inner, Var outer, Var fused);
+    EXPORT ScheduleHandle &split(VarOrRVar old, Var outer, Var inner, Expr factor,
+                                 TailStrategy tail = TailStrategy_Auto);
+    EXPORT ScheduleHandle &fuse(Var inner, Var outer, Var fused,
+                                TileOrder order = TileOrder_RowMajor);
     EXPORT ScheduleHandle &serial(Var var);
     EXPORT ScheduleHandle &parallel(Var var);
-    EXPORT ScheduleHandle &vectorize(Var var);
-    EXPORT ScheduleHandle &unroll(Var var);
+    EXPORT ScheduleHandle &vectorize(VarOrRVar var);
+    EXPORT ScheduleHandle &unroll(VarOrRVar var);
     EXPORT ScheduleHandle &parallel(Var var, Expr task_size);
-    EXPORT ScheduleHandle &vectorize(Var var, int factor);
-    EXPORT ScheduleHandle &unroll(Var var, int factor);
-    EXPORT ScheduleHandle &tile(Var x, Var y, Var xo, Var yo, Var xi, Var yi, Expr xfactor, Expr yfactor);
-    EXPORT ScheduleHandle &tile(Var x, Var y, Var xi, Var yi, Expr xfactor, Expr yfactor);
+    EXPORT ScheduleHandle &parallel_strips(Var var, Var strip, Var row, Expr strips);
+    EXPORT ScheduleHandle &vectorize(VarOrRVar var, int factor, TailStrategy tail = TailStrategy_Auto);
+    EXPORT ScheduleHandle &unroll(VarOrRVar var, int factor, TailStrategy tail = TailStrategy_Auto);
+    EXPORT ScheduleHandle &reassociate_floats(bool allow = true);
+    EXPORT ScheduleHandle &tile(Var x, Var y, Var xo, Var yo, Var xi, Var yi, Expr xfactor, Expr yfactor,
+                                TailStrategy tail = TailStrategy_Auto);
+    EXPORT ScheduleHandle &tile(Var x, Var y, Var xi, Var yi, Expr xfactor, Expr yfactor,
+                                TailStrategy tail = TailStrategy_Auto);
     EXPORT ScheduleHandle &reorder(const std::vector<VarOrRVar> &vars);
     EXPORT ScheduleHandle &reorder(VarOrRVar x, VarOrRVar y);
     EXPORT ScheduleHandle &reorder(VarOrRVar x, VarOrRVar y, VarOrRVar z);
@@ -268,6 +315,58 @@ public:
                                     Expr x_size, Expr y_size, Expr z_size, GPUAPI gpu_api = GPU_Default);
     // @}
 
+    /** Split a dimension of an associative update (+=, -=, *=, min,
+     * max) by the given factor, and unroll the inner dimension into
+     * that many independent partial results, which are combined once
+     * the loops over which the update site is constant are
+     * done. This breaks up the single chain of dependent operations
+     * that a serial reduction otherwise compiles to. E.g.:
+
+     \code
+     RDom r(0, 1024);
+     f(x) = 0;
+     f(x) += g(x, r);
+     f.update().interleave_accumulators(r, 4);
+     \endcode
+
+     * For floating point sums and products this changes the order of
+     * the operations, and hence the rounding, so it is only done if
+     * reassociate_floats is true. After this call, var refers to the
+     * outer dimension of the split. */
+    EXPORT ScheduleHandle &interleave_accumulators(VarOrRVar var, int factor,
+                                                   bool reassociate_floats = false);
+
+    /** Run a dimension of an associative update (+=, -=, *=, min,
+     * max) that scatters into data-dependent sites, such as a
+     * histogram, in parallel. Ordinarily this is a race
+     * condition. With Scatter_Privatize, each iteration accumulates
+     * into its own copy of the entire output, so the dimension should
+     * have few iterations, e.g. the outer dimension of a split:
+
+     \code
+     RDom r(0, input.width(), 0, input.height());
+     Var ryo, ryi;
+     hist(x) = 0;
+     hist(clamp(input(r.x, r.y), 0, 255)) += 1;
+     hist.update().split(r.y, ryo, ryi, 64).parallel_scatter(ryo);
+     \endcode
+
+     * With Scatter_Atomic, the output is updated in place using
+     * atomic operations, which is better for large outputs that each
+     * iteration only touches sparsely. For floating point sums and
+     * products, privatization changes the order of the operations,
+     * and hence the rounding. */
+    EXPORT ScheduleHandle &parallel_scatter(VarOrRVar var,
+                                            ScatterStrategy strategy = Scatter_Privatize);
+
+    /** Prefetch the region of a function or image that this stage
+     * will need the given number of iterations of the loop over var
+     * later, at the start of each iteration. See \ref Func::prefetch */
+    // @{
+    EXPORT ScheduleHandle &prefetch(Func f, VarOrRVar var, Expr distance = 1);
+    EXPORT ScheduleHandle &prefetch(const ImageParam &image, VarOrRVar var, Expr distance = 1);
+    // @}
+
     // These calls are for legacy compatibility only.
     EXPORT ScheduleHandle &cuda_threads(Var thread_x) {
         return gpu_threads(thread_x);
@@ -794,13 +893,45 @@ public:
      * given names, where the inner dimension iterates from 0 to
      * factor-1. The inner and outer subdimensions can then be dealt
      * with using the other scheduling calls. It's ok to reuse the old
-     * variable name as either the inner or outer variable. */
-    EXPORT Func &split(Var old, Var outer, Var inner, Expr factor);
+     * variable name as either the inner or outer variable.
+     *
+     * If the factor doesn't divide the extent, the tail strategy
+     * says what to do with the last partial tile. E.g. for a
+     * vectorized loop over an image whose width is 13, shifting the
+     * last vector inward requires the width to be at least 8 and
+     * computes three points twice, while guarding with an if
+     * computes one full vector and then the last five points one at
+     * a time:
+
+     \code
+     f.split(x, xo, xi, 8, TailStrategy_GuardWithIf).vectorize(xi);
+     \endcode
+
+     * See \ref TailStrategy for the other options. */
+    EXPORT Func &split(Var old, Var outer, Var inner, Expr factor,
+                       TailStrategy tail = TailStrategy_Auto);
 
     /** Join two dimensions into a single fused dimenion. The fused
      * dimension covers the product of the extents of the inner and
-     * outer dimensions given. */
-    EXPORT Func &fuse(Var inner, Var outer, Var fused);
+     * outer dimensions given.
+     *
+     * The order says how the fused dimension traverses the two. When
+     * fusing the outer dimensions of a tiling, a Morton or Hilbert
+     * order visits the tiles so that consecutive tiles are close in
+     * both dimensions, and so share more of their inputs in cache,
+     * whether the fused loop is serial or parallel:
+
+     \code
+     f.tile(x, y, xo, yo, xi, yi, 64, 64)
+      .fuse(xo, yo, t, TileOrder_Hilbert)
+      .parallel(t);
+     \endcode
+
+     * These orders traverse the smallest power-of-two square that
+     * covers both dimensions, and skip the points outside of them,
+     * so they suit dimensions of similar extent. */
+    EXPORT Func &fuse(Var inner, Var outer, Var fused,
+                      TileOrder order = TileOrder_RowMajor);
 
 
     /** Mark a dimension to be traversed serially. This is the default. */
@@ -817,6 +948,26 @@ public:
      * manually. */
     EXPORT Func &parallel(Var var, Expr task_size);
 
+    /** Split a dimension into the given number of strips of equal
+     * size, and parallelize over the strips. The rows within each
+     * strip are traversed serially, so a producer stored per strip
+     * and computed per row still gets the sliding window
+     * optimization: each strip warms up its own buffer on its first
+     * row, and then computes only the new values on each row after
+     * that, in storage folded down to the rows in flight. E.g. a
+     * separable blur that both slides and uses all the cores:
+
+     \code
+     blur_y.parallel_strips(y, strip, row, 8);
+     blur_x.store_at(blur_y, strip).compute_at(blur_y, row);
+     \endcode
+
+     * More strips means more parallelism, but also more redundant
+     * warm-up rows and more buffers in flight. If the strips don't
+     * divide the extent, the last strip is shifted inward (see
+     * \ref TailStrategy). */
+    EXPORT Func &parallel_strips(Var var, Var strip, Var row, Expr strips);
+
     /** Mark a dimension to be computed all-at-once as a single
      * vector. The dimension should have constant extent -
      * e.g. because it is the inner dimension following a split by a
@@ -836,13 +987,13 @@ public:
      * size. The variable to be vectorized should be the innermost
      * one. After this call, var refers to the outer dimension of the
      * split. */
-    EXPORT Func &vectorize(Var var, int factor);
+    EXPORT Func &vectorize(Var var, int factor, TailStrategy tail = TailStrategy_Auto);
 
     /** Split a dimension by the given factor, then unroll the inner
      * dimension. This is how you unroll a loop of unknown size by
      * some constant factor. After this call, var refers to the outer
      * dimension of the split. */
-    EXPORT Func &unroll(Var var, int factor);
+    EXPORT Func &unroll(Var var, int factor, TailStrategy tail = TailStrategy_Auto);
 
     /** Statically declare that the range over which a function should
      * be evaluated is given by the second and third arguments. This
@@ -854,14 +1005,37 @@ public:
      * runtime error will occur when you try to run your pipeline. */
     EXPORT Func &bound(Var var, Expr min, Expr extent);
 
+    /** At the start of each iteration of the loop over var, issue
+     * software prefetches for the region of the given function or
+     * image that the iteration distance iterations later will
+     * load. This helps access patterns the hardware prefetchers miss,
+     * such as walking down the columns of a wide image. E.g.:
+
+     \code
+     ImageParam in(UInt(8), 2);
+     Func f;
+     f(x, y) = in(x, y*2) + in(x, y*2+1);
+     f.prefetch(in, y, 2);
+     \endcode
+
+     * Each prefetched row costs one prefetch instruction per cache
+     * line, so var should be a loop that touches a modest region per
+     * iteration. */
+    // @{
+    EXPORT Func &prefetch(Func f, Var var, Expr distance = 1);
+    EXPORT Func &prefetch(const ImageParam &image, Var var, Expr distance = 1);
+    // @}
+
     /** Split two dimensions at once by the given factors, and then
      * reorder the resulting dimensions to be xi, yi, xo, yo from
      * innermost outwards. This gives a tiled traversal. */
-    EXPORT Func &tile(Var x, Var y, Var xo, Var yo, Var xi, Var yi, Expr xfactor, Expr yfactor);
+    EXPORT Func &tile(Var x, Var y, Var xo, Var yo, Var xi, Var yi, Expr xfactor, Expr yfactor,
+                      TailStrategy tail = TailStrategy_Auto);
 
     /** A shorter form of tile, which reuses the old variable names as
      * the new outer dimensions */
-    EXPORT Func &tile(Var x, Var y, Var xi, Var yi, Expr xfactor, Expr yfactor);
+    EXPORT Func &tile(Var x, Var y, Var xi, Var yi, Expr xfactor, Expr yfactor,
+                      TailStrategy tail = TailStrategy_Auto);
 
     /** Reorder variables to have the given nesting order, from
      * innermost out */
@@ -1212,6 +1386,23 @@ public:
     EXPORT Func &reorder_storage(Var x, Var y, Var z, Var w, Var t);
     // @}
 
+    /** Store only the given number of values of this function along
+     * the given dimension, as a circular buffer. Storage folding
+     * already does this when it can prove it's safe and can bound
+     * the number of values in use at once. Use this when it can't,
+     * or to pick a factor that isn't a power of two. E.g. a blur with
+     * a runtime radius:
+
+     \code
+     blur_x.store_root().compute_at(blur_y, y).fold_storage(y, 2*radius + 1);
+     \endcode
+
+     * Values must not be overwritten while they are still needed. If
+     * the number of values in use at once can be bounded, this is
+     * checked when the pipeline runs. A factor that isn't a
+     * constant power of two costs an integer modulo per access. */
+    EXPORT Func &fold_storage(Var dim, Expr extent);
+
     /** Compute this function as needed for each unique value of the
      * given var for the given calling function f.
      *
@@ -1288,6 +1479,46 @@ public:
      * to the version of compute_at that takes a Var. */
     EXPORT Func &compute_at(Func f, RVar var);
 
+    /** Fuse the loop nest of this function with the loop nest of a
+     * sibling function f, from the outermost loop down to and
+     * including the loop over var. Both functions must be computed
+     * and stored at the same loop level, neither may call the
+     * other, and both loop nests must have the same number of loops
+     * down to var. Only the pure definitions are fused; update steps
+     * are computed afterwards as usual. For example, to compute two
+     * statistics of an input in a single sweep over it:
+     *
+     \code
+     Func f, g, h;
+     Var x, y;
+     f(x, y) = in(x, y) * 2;
+     g(x, y) = in(x, y) + 1;
+     h(x, y) = f(x, y) + g(x, y);
+     f.compute_root();
+     g.compute_root().compute_with(f, y);
+     \endcode
+     *
+     * is equivalent to
+     *
+     \code
+     for (int y = 0; y < height; y++) {
+         for (int x = 0; x < width; x++) {
+             f[y][x] = in[y][x] * 2;
+         }
+         for (int x = 0; x < width; x++) {
+             g[y][x] = in[y][x] + 1;
+         }
+     }
+     ...
+     \endcode
+     *
+     * The fused loops run over the union of the two functions'
+     * ranges, and each body is guarded by its own range. The guards
+     * are marked as likely, so loop partitioning removes them from
+     * the steady state when the ranges differ. The loops being fused
+     * must be serial or parallel, and of the same type. */
+    EXPORT Func &compute_with(Func f, Var var);
+
     /** Compute all of this function once ahead of time. Reusing
      * the example in \ref Func::compute_at :
      *
@@ -1429,6 +1660,26 @@ public:
      * outside the outermost loop. */
     EXPORT Func &store_root();
 
+    /** Compute this function on another thread, one iteration of
+     * its compute_at loop ahead of its consumer. While the consumer
+     * works on the region of this function needed by iteration i,
+     * the region needed by iteration i+1 is being computed into a
+     * second buffer, so stages with different bottlenecks (e.g. a
+     * memory-bound unpacking feeding a compute-bound filter) overlap:
+
+     \code
+     unpack.compute_at(filter, yo).async();
+     \endcode
+
+     * The two buffers are allocated once, outside the loop, large
+     * enough for the region any iteration needs. The producer and
+     * consumer meet at the end of each iteration, so the iterations
+     * should be large enough to amortize that. The function must be
+     * stored at the same level it's computed at, the loop must be
+     * serial, and any other functions computed at that loop must
+     * be realized inside this one. */
+    EXPORT Func &async();
+
     /** Aggressively inline all uses of this function. This is the
      * default schedule, so you're unlikely to need to call this. For
      * a reduction, that means it gets computed as close to the
@@ -1515,6 +1766,125 @@ public:
 
 };
 
+/** A collection of output Funcs that are compiled together into a
+ * single pipeline. Each output gets its own output buffer(s), and the
+ * outputs are computed one after the other in a single call. Funcs
+ * that more than one output depends on are shared: a producer
+ * scheduled compute_root is computed once for all of the outputs,
+ * instead of once per call to realize. An output may also consume
+ * another output, in which case it is computed after it. E.g. to
+ * compute a full-resolution result and a preview of it in one pass:
+
+ \code
+ Func f, full, preview;
+ f(x, y) = ...;
+ f.compute_root();
+ full(x, y) = f(x, y);
+ preview(x, y) = (f(2*x, 2*y) + f(2*x+1, 2*y+1)) / 2;
+ std::vector<Func> outputs;
+ outputs.push_back(full);
+ outputs.push_back(preview);
+ Image<float> full_im(1024, 1024), preview_im(512, 512);
+ Pipeline(outputs).realize(Realization(full_im, preview_im));
+ \endcode
+ */
+class Pipeline {
+    /** The output Funcs, in the order their buffers are passed. */
+    std::vector<Func> output_funcs;
+
+    /** The lowered imperative form of the pipeline. Cached here so
+     * that recompilation for different targets doesn't require
+     * re-lowering */
+    Internal::Stmt lowered;
+
+    /** A JIT-compiled version of the pipeline. */
+    Internal::JITCompiledModule compiled_module;
+
+    /** The current error handler used for realizing this
+     * pipeline. May be NULL. Only relevant when jitting. */
+    void (*error_handler)(void *user_context, const char *);
+
+    /** Pointers to current values of the automatically inferred
+     * arguments (buffers and scalars), followed by the output
+     * buffers. Only relevant when jitting. */
+    std::vector<const void *> arg_values;
+
+    /** The arg_values that need to be rebound on every call if the
+     * image params change. */
+    std::vector<std::pair<int, Internal::Parameter> > image_param_args;
+
+    /** A context to use for JIT-realizations of this pipeline. */
+    Param<void *> user_context;
+
+    // Catch runtime errors in JIT-compiled code, as Func does.
+    bool prepare_to_catch_runtime_errors(void *buf);
+
+    /** The names of the output Funcs. */
+    std::vector<std::string> output_names() const;
+
+    /** The output buffers of all of the outputs, in order. */
+    std::vector<Argument> output_arguments() const;
+
+    /** Lower the pipeline, if it hasn't been lowered already. */
+    void lower(const Target &target);
+
+public:
+    /** Make a pipeline with a single output. */
+    EXPORT Pipeline(Func output);
+
+    /** Make a pipeline with several outputs. */
+    EXPORT Pipeline(const std::vector<Func> &outputs);
+
+    /** Get the output Funcs of the pipeline. */
+    EXPORT const std::vector<Func> &outputs() const;
+
+    /** Evaluate the pipeline into some existing buffers. The
+     * Realization holds the buffers of the outputs in order. An
+     * output that returns a Tuple takes one buffer per element. The
+     * buffers of a single output must all be the same size, but
+     * different outputs may be different sizes. */
+    EXPORT void realize(Realization dst, const Target &target = get_jit_target_from_environment());
+
+    /** Statically compile the pipeline to llvm bitcode, with the
+     * given filename (which should probably end in .bc), type
+     * signature, and C function name. The output buffers of all of
+     * the outputs are appended to the arguments, in order. */
+    EXPORT void compile_to_bitcode(const std::string &filename, std::vector<Argument> args,
+                                   const std::string &fn_name,
+                                   const Target &target = get_target_from_environment());
+
+    /** Statically compile the pipeline to an object file, with the
+     * given filename (which should probably end in .o or .obj), type
+     * signature, and C function name. The output buffers of all of
+     * the outputs are appended to the arguments, in order. */
+    EXPORT void compile_to_object(const std::string &filename, std::vector<Argument> args,
+                                  const std::string &fn_name,
+                                  const Target &target = get_target_from_environment());
+
+    /** Emit a header file with the given filename for the pipeline,
+     * to go with the object file generated by compile_to_object. */
+    EXPORT void compile_to_header(const std::string &filename, std::vector<Argument> args,
+                                  const std::string &fn_name);
+
+    /** Compile to an object file and header pair, with the given
+     * arguments. Also names the C function to match the first
+     * argument. */
+    EXPORT void compile_to_file(const std::string &filename_prefix, std::vector<Argument> args,
+                                const Target &target = get_target_from_environment());
+
+    /** Write out an internal representation of lowered code. */
+    EXPORT void compile_to_lowered_stmt(const std::string &filename);
+
+    /** Eagerly jit compile the pipeline. This normally happens on
+     * the first call to realize. */
+    EXPORT void *compile_jit(const Target &target = get_jit_target_from_environment());
+
+    /** Set the error handler function that be called in the case of
+     * runtime errors during halide pipelines. See \ref
+     * Func::set_error_handler */
+    EXPORT void set_error_handler(void (*handler)(void *, const char *));
+};
+
  /** JIT-Compile and run enough code to evaluate a Halide
   * expression. This can be thought of as a scalar version of
   * \ref Func::realize */
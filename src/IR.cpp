@@ -108,6 +108,15 @@ const string Call::return_second = "return_second";
 const string Call::if_then_else = "if_then_else";
 const string Call::glsl_texture_load = "glsl_texture_load";
 const string Call::glsl_texture_store = "glsl_texture_store";
+const string Call::vector_reduce_add = "vector_reduce_add";
+const string Call::vector_reduce_mul = "vector_reduce_mul";
+const string Call::vector_reduce_min = "vector_reduce_min";
+const string Call::vector_reduce_max = "vector_reduce_max";
+const string Call::atomic_add = "atomic_add";
+const string Call::atomic_min = "atomic_min";
+const string Call::atomic_max = "atomic_max";
+const string Call::prefetch = "prefetch";
+const string Call::likely = "likely";
 
 }
 }
@@ -983,7 +983,16 @@ struct Call : public ExprNode<Call> {
         trace,
         glsl_texture_load,
         glsl_texture_store,
-        trace_expr;
+        trace_expr,
+        vector_reduce_add,
+        vector_reduce_mul,
+        vector_reduce_min,
+        vector_reduce_max,
+        atomic_add,
+        atomic_min,
+        atomic_max,
+        prefetch,
+        likely;
 
     // If it's a call to another halide function, this call node
     // holds onto a pointer to that function.
@@ -192,6 +192,14 @@ void match_types(Expr &a, Expr &b) {
     user_assert(!a.type().is_handle() && !b.type().is_handle())
         << "Can't do arithmetic on opaque pointer types\n";
 
+    // Float(16) is a storage type. Arithmetic on it is done in Float(32).
+    if (a.type().is_float() && a.type().bits < 32) {
+        a = cast(Float(32, a.type().width), a);
+    }
+    if (b.type().is_float() && b.type().bits < 32) {
+        b = cast(Float(32, b.type().width), b);
+    }
+
     if (a.type() == b.type()) return;
 
     const int *a_int_imm = as_const_int(a);
@@ -342,7 +350,7 @@ Expr halide_exp(Expr x_full) {
         x_full = simplify(x_full);
         const float * f = as_const_float(x_full);
         if (f) {
-            return logf(*f);
+            return expf(*f);
         }
     }
 
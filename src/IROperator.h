@@ -97,7 +97,10 @@ EXPORT Expr const_false(int width = 1);
  * casting rules. For the purposes of casting, a boolean type is
  * UInt(1). We use the following procedure:
  *
- * If the types already match, do nothing.
+ * First, any Float(16) is cast to Float(32), because Float(16) is
+ * only a storage type.
+ *
+ * Then, if the types already match, do nothing.
  *
  * Then, if one type is a vector and the other is a scalar, the scalar
  * is broadcast to match the vector width, and we continue.
@@ -203,6 +206,9 @@ inline Expr operator-(Expr a, Expr b) {
  * 200, because 56 + 200 == 0 */
 inline Expr operator-(Expr a) {
     user_assert(a.defined()) << "operator- of undefined Expr\n";
+    if (a.type().is_float() && a.type().bits < 32) {
+        a = cast(Float(32, a.type().width), a);
+    }
     return Internal::Sub::make(Internal::make_zero(a.type()), a);
 }
 
@@ -372,6 +378,9 @@ inline Expr abs(Expr a) {
     Type t = a.type();
     if (t.is_int()) {
         t.code = Type::UInt;
+    } else if (t.is_float() && t.bits < 32) {
+        t.bits = 32;
+        a = cast(t, a);
     } else if (t.is_uint()) {
         user_warning << "Warning: abs of an unsigned type is a no-op\n";
         return a;
@@ -476,8 +485,9 @@ inline Expr select(Expr c1, Expr v1,
 // @}
 
 /** Return the sine of a floating-point expression. If the argument is
- * not floating-point, it is cast to Float(32). Does not vectorize
- * well. */
+ * not floating-point, it is cast to Float(32). On x86 and ARM,
+ * Float(32) sines vectorize cleanly, and are accurate to within a few
+ * ulps for |x| < 8192. Float(64) sines do not vectorize well. */
 inline Expr sin(Expr x) {
     user_assert(x.defined()) << "sin of undefined Expr\n";
     if (x.type() == Float(64)) {
@@ -500,7 +510,9 @@ inline Expr asin(Expr x) {
 }
 
 /** Return the cosine of a floating-point expression. If the argument
- * is not floating-point, it is cast to Float(32). Does not vectorize
+ * is not floating-point, it is cast to Float(32). On x86 and ARM,
+ * Float(32) cosines vectorize cleanly, and are accurate to within a
+ * few ulps for |x| < 8192. Float(64) cosines do not vectorize
  * well. */
 inline Expr cos(Expr x) {
     user_assert(x.defined()) << "cos of undefined Expr\n";
@@ -654,6 +666,25 @@ inline Expr hypot(Expr x, Expr y) {
     return sqrt(x*x + y*y);
 }
 
+/** Return x*y + z, computed with a single rounding at the end. If the
+ * arguments are not floating-point, they are cast to Float(32). Uses
+ * the fused multiply-add instructions on targets that have them
+ * (Target::FMA on x86), and otherwise calls the system fma function,
+ * which is exact but slow. */
+inline Expr fma(Expr x, Expr y, Expr z) {
+    user_assert(x.defined() && y.defined() && z.defined()) << "fma of undefined Expr\n";
+    if (x.type() == Float(64)) {
+        y = cast<double>(y);
+        z = cast<double>(z);
+        return Internal::Call::make(Float(64), "fma_f64", vec(x, y, z), Internal::Call::Extern);
+    } else {
+        x = cast<float>(x);
+        y = cast<float>(y);
+        z = cast<float>(z);
+        return Internal::Call::make(Float(32), "fma_f32", vec(x, y, z), Internal::Call::Extern);
+    }
+}
+
 /** Return the exponential of a floating-point expression. If the
  * argument is not floating-point, it is cast to Float(32). For
  * Float(64) arguments, this calls the system exp function, and does
@@ -736,6 +767,22 @@ inline Expr fast_pow(Expr x, Expr y) {
     return select(x == 0.0f, 0.0f, fast_exp(fast_log(x) * y));
 }
 
+/** Fast approximate sine for Float(32). Accurate to about 5e-5 for
+ * |x| < 100, and returns nonsense for |x| >= 2^30. Vectorizes cleanly
+ * on x86 and ARM. On GPUs, uses the hardware's approximate sine. */
+inline Expr fast_sin(Expr x) {
+    user_assert(x.defined()) << "fast_sin of undefined Expr\n";
+    return Internal::Call::make(Float(32), "fast_sin_f32", vec(cast<float>(x)), Internal::Call::Extern);
+}
+
+/** Fast approximate cosine for Float(32). Accurate to about 5e-5 for
+ * |x| < 100, and returns nonsense for |x| >= 2^30. Vectorizes cleanly
+ * on x86 and ARM. On GPUs, uses the hardware's approximate cosine. */
+inline Expr fast_cos(Expr x) {
+    user_assert(x.defined()) << "fast_cos of undefined Expr\n";
+    return Internal::Call::make(Float(32), "fast_cos_f32", vec(cast<float>(x)), Internal::Call::Extern);
+}
+
 /** Return the greatest whole number less than or equal to a
  * floating-point expression. If the argument is not floating-point,
  * it is cast to Float(32). The return value is still in floating
@@ -1178,6 +1225,25 @@ inline Expr undef() {
     return undef(type_of<T>());
 }
 
+/** Mark an expression as the one that is usually taken, so that loop
+ * partitioning can split loops into a steady state where it is always
+ * taken, and a prologue and epilogue where it might not be. E.g. in
+ * the interior of an image, this select never takes its first
+ * branch:
+
+ \code
+ f(x) = select(x < 0 || x >= width, 0, likely(in(clamp(x, 0, width-1))));
+ \endcode
+
+ * The condition of the select, and the clamp, are simplified away in
+ * the steady state. likely can also mark one side of a min or max, or
+ * a boolean condition that is usually true. It does not change the
+ * value of the expression. */
+inline Expr likely(Expr e) {
+    return Internal::Call::make(e.type(), Internal::Call::likely,
+                                vec(e), Internal::Call::Intrinsic);
+}
+
 }
 
 
@@ -115,8 +115,8 @@ void JITCompiledModule::compile_module(CodeGen *cg, llvm::Module *m, const strin
     TargetOptions options;
     options.LessPreciseFPMADOption = true;
     options.NoFramePointerElim = false;
-    options.AllowFPOpFusion = FPOpFusion::Fast;
-    options.UnsafeFPMath = true;
+    options.AllowFPOpFusion = cg->allow_fp_op_fusion() ? FPOpFusion::Fast : FPOpFusion::Standard;
+    options.UnsafeFPMath = cg->allow_fp_op_fusion();
     options.NoInfsFPMath = true;
     options.NoNaNsFPMath = true;
     options.HonorSignDependentRoundingFPMathOption = false;
@@ -0,0 +1,291 @@
+#include "LoopCarry.h"
+#include "IRMutator.h"
+#include "IRVisitor.h"
+#include "IREquality.h"
+#include "IROperator.h"
+#include "Simplify.h"
+#include "Substitute.h"
+#include "ExprUsesVar.h"
+#include "Scope.h"
+#include "CodeGen_GPU_Dev.h"
+#include "Debug.h"
+#include "Util.h"
+
+namespace Halide {
+namespace Internal {
+
+using std::set;
+using std::string;
+using std::vector;
+
+namespace {
+
+bool is_atomic(const Call *op) {
+    return (op->call_type == Call::Intrinsic &&
+            (op->name == Call::atomic_add ||
+             op->name == Call::atomic_min ||
+             op->name == Call::atomic_max));
+}
+
+// Is this a call to an intrinsic that uses the address of its Load
+// argument rather than its value? Those Loads must stay Loads.
+bool uses_load_address(const Call *op) {
+    return (is_atomic(op) ||
+            (op->call_type == Call::Intrinsic &&
+             (op->name == Call::address_of || op->name == Call::prefetch)));
+}
+
+class ContainsLoop : public IRVisitor {
+    using IRVisitor::visit;
+
+    void visit(const For *) {
+        result = true;
+    }
+
+public:
+    bool result;
+    ContainsLoop() : result(false) {}
+};
+
+// Find the buffers stored to, and the variables defined, in a loop body.
+class FindDefinitions : public IRVisitor {
+    using IRVisitor::visit;
+
+    void visit(const Store *op) {
+        IRVisitor::visit(op);
+        stores.insert(op->name);
+    }
+
+    void visit(const Call *op) {
+        IRVisitor::visit(op);
+        // Atomics store through the address of their first argument.
+        if (is_atomic(op)) {
+            const Call *addr = op->args[0].as<Call>();
+            const Load *site = addr ? addr->args[0].as<Load>() : NULL;
+            internal_assert(site) << "Atomic update of something other than a Load\n";
+            stores.insert(site->name);
+        }
+    }
+
+    void visit(const LetStmt *op) {
+        IRVisitor::visit(op);
+        lets.push(op->name, 0);
+    }
+
+    void visit(const Let *op) {
+        IRVisitor::visit(op);
+        lets.push(op->name, 0);
+    }
+
+public:
+    set<string> stores;
+    Scope<int> lets;
+};
+
+// Find the distinct loads that happen in every iteration of a loop,
+// regardless of any conditions in it. It's only safe to do those
+// loads ahead of time.
+class FindUnconditionalLoads : public IRVisitor {
+    using IRVisitor::visit;
+
+    void visit(const Load *op) {
+        IRVisitor::visit(op);
+        for (size_t i = 0; i < loads.size(); i++) {
+            if (equal(loads[i], op)) return;
+        }
+        loads.push_back(op);
+    }
+
+    void visit(const Select *op) {
+        op->condition.accept(this);
+    }
+
+    void visit(const IfThenElse *op) {
+        op->condition.accept(this);
+    }
+
+    void visit(const Call *op) {
+        if (op->call_type == Call::Intrinsic && op->name == Call::if_then_else) {
+            op->args[0].accept(this);
+        } else if (uses_load_address(op)) {
+            // Don't look inside. Carrying one of these Loads would
+            // replace it with a Variable, which has no address.
+        } else {
+            IRVisitor::visit(op);
+        }
+    }
+
+public:
+    vector<Expr> loads;
+};
+
+class ReplaceLoads : public IRMutator {
+    const vector<Expr> &loads;
+    const vector<string> &names;
+
+    using IRMutator::visit;
+
+    void visit(const Load *op) {
+        for (size_t i = 0; i < loads.size(); i++) {
+            if (!names[i].empty() && equal(loads[i], op)) {
+                expr = Variable::make(op->type, names[i]);
+                return;
+            }
+        }
+        IRMutator::visit(op);
+    }
+
+    void visit(const Call *op) {
+        if (uses_load_address(op)) {
+            expr = op;
+        } else {
+            IRMutator::visit(op);
+        }
+    }
+
+public:
+    ReplaceLoads(const vector<Expr> &l, const vector<string> &n) : loads(l), names(n) {}
+};
+
+Stmt make_block(const vector<Stmt> &stmts, Stmt last) {
+    for (size_t i = stmts.size(); i > 0; i--) {
+        last = last.defined() ? Block::make(stmts[i-1], last) : stmts[i-1];
+    }
+    return last;
+}
+
+class LoopCarry : public IRMutator {
+    int max_carried_values;
+
+    using IRMutator::visit;
+
+    // Can this load be done in the previous iteration instead?
+    bool can_carry(const Load *load, const For *loop, const FindDefinitions &defs) {
+        if (defs.stores.count(load->name) ||
+            expr_uses_vars(load->index, defs.lets) ||
+            !expr_uses_var(load->index, loop->name)) {
+            return false;
+        }
+        // Don't reason about indices that are themselves loaded.
+        FindUnconditionalLoads nested;
+        load->index.accept(&nested);
+        return nested.loads.empty();
+    }
+
+    void visit(const For *op) {
+        if (CodeGen_GPU_Dev::is_gpu_var(op->name)) {
+            // Leave kernels alone. Device code doesn't have a stack
+            // to put the carried values on.
+            stmt = op;
+            return;
+        }
+
+        ContainsLoop contains_loop;
+        op->body.accept(&contains_loop);
+        if (op->for_type != For::Serial || contains_loop.result) {
+            IRMutator::visit(op);
+            return;
+        }
+
+        FindDefinitions defs;
+        op->body.accept(&defs);
+        FindUnconditionalLoads finder;
+        op->body.accept(&finder);
+        const vector<Expr> &loads = finder.loads;
+
+        // For each load, find the load that loads the value it will
+        // need in the next iteration.
+        Expr next = Variable::make(Int(32), op->name) + 1;
+        vector<int> source(loads.size(), -1);
+        int carried = 0;
+        for (size_t i = 0; i < loads.size() && carried < max_carried_values; i++) {
+            const Load *a = loads[i].as<Load>();
+            if (!can_carry(a, op, defs)) continue;
+            Expr next_index = substitute(op->name, next, a->index);
+            for (size_t j = 0; j < loads.size(); j++) {
+                const Load *b = loads[j].as<Load>();
+                if (i == j || a->name != b->name || a->type != b->type ||
+                    !can_carry(b, op, defs)) {
+                    continue;
+                }
+                if (is_zero(simplify(next_index - b->index))) {
+                    source[i] = (int)j;
+                    carried++;
+                    break;
+                }
+            }
+        }
+
+        if (carried == 0) {
+            IRMutator::visit(op);
+            return;
+        }
+
+        // Name the carried loads, and the loads they're carried from.
+        vector<string> value_names(loads.size()), scratch_names(loads.size());
+        for (size_t i = 0; i < loads.size(); i++) {
+            if (source[i] < 0) continue;
+            scratch_names[i] = unique_name(op->name + ".carry", false);
+            if (value_names[i].empty()) {
+                value_names[i] = unique_name(op->name + ".tap", false);
+            }
+            if (value_names[source[i]].empty()) {
+                value_names[source[i]] = unique_name(op->name + ".tap", false);
+            }
+        }
+
+        Stmt body = ReplaceLoads(loads, value_names).mutate(op->body);
+
+        // At the end of each iteration, rotate the values along, and
+        // before the loop, fill in the values for the first
+        // iteration.
+        vector<Stmt> rotate, init;
+        for (size_t i = 0; i < loads.size(); i++) {
+            if (source[i] < 0) continue;
+            const Load *load = loads[i].as<Load>();
+            Expr index = load->type.is_vector() ? Ramp::make(0, 1, load->type.width) : Expr(0);
+            Expr value = Variable::make(load->type, value_names[source[i]]);
+            rotate.push_back(Store::make(scratch_names[i], value, index));
+            init.push_back(Store::make(scratch_names[i], substitute(op->name, op->min, loads[i]), index));
+        }
+        body = Block::make(body, make_block(rotate, Stmt()));
+
+        for (size_t i = loads.size(); i > 0; i--) {
+            const Load *load = loads[i-1].as<Load>();
+            if (value_names[i-1].empty()) continue;
+            Expr value = loads[i-1];
+            if (source[i-1] >= 0) {
+                Expr index = load->type.is_vector() ? Ramp::make(0, 1, load->type.width) : Expr(0);
+                value = Load::make(load->type, scratch_names[i-1], index, Buffer(), Parameter());
+            }
+            body = LetStmt::make(value_names[i-1], value, body);
+        }
+
+        // Skip the whole thing if the loop doesn't run, as the
+        // initial loads might then be out of bounds.
+        Stmt result = For::make(op->name, op->min, op->extent, op->for_type, body);
+        result = make_block(init, result);
+        result = IfThenElse::make(op->extent > 0, result);
+        for (size_t i = 0; i < loads.size(); i++) {
+            if (source[i] < 0) continue;
+            const Load *load = loads[i].as<Load>();
+            result = Allocate::make(scratch_names[i], load->type.element_of(),
+                                    vec<Expr>(load->type.width), result);
+        }
+
+        debug(3) << "Carrying " << carried << " loaded values across iterations of " << op->name << "\n";
+        stmt = result;
+    }
+
+public:
+    LoopCarry(int m) : max_carried_values(m) {}
+};
+
+}
+
+Stmt loop_carry(Stmt s, int max_carried_values) {
+    return LoopCarry(max_carried_values).mutate(s);
+}
+
+}
+}
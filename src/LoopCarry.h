@@ -0,0 +1,32 @@
+#ifndef HALIDE_LOOP_CARRY_H
+#define HALIDE_LOOP_CARRY_H
+
+/** \file
+ * Defines the lowering pass that carries loaded values over to the
+ * next iteration of innermost loops, instead of loading them again.
+ */
+
+#include "IR.h"
+
+namespace Halide {
+namespace Internal {
+
+/** Find loads in innermost serial loops that load the same value as
+ * another load did in the previous iteration, and carry that value
+ * over instead of loading it again. E.g. in
+ *
+ \code
+ for (y, 0, h) { out[y] = f[y-1] + f[y] + f[y+1] }
+ \endcode
+ *
+ * only f[y+1] needs to be loaded in each iteration, with the other
+ * two taps rotated through a small scratch buffer that llvm can keep
+ * in registers. At most max_carried_values loads per loop are
+ * carried. Should be run after vectorization, so that the carried
+ * values are whole vectors. */
+Stmt loop_carry(Stmt s, int max_carried_values = 8);
+
+}
+}
+
+#endif
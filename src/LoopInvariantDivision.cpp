@@ -0,0 +1,251 @@
+#include "LoopInvariantDivision.h"
+#include "IRMutator.h"
+#include "IRVisitor.h"
+#include "IREquality.h"
+#include "IROperator.h"
+#include "ExprUsesVar.h"
+#include "Scope.h"
+#include "CodeGen_GPU_Dev.h"
+#include "Debug.h"
+#include "Util.h"
+
+namespace Halide {
+namespace Internal {
+
+using std::pair;
+using std::make_pair;
+using std::string;
+using std::vector;
+
+namespace {
+
+// Could an expression give a different value when evaluated somewhere
+// else with the same variables in scope?
+class ReadsState : public IRVisitor {
+    using IRVisitor::visit;
+
+    void visit(const Load *) {
+        result = true;
+    }
+
+    void visit(const Call *op) {
+        IRVisitor::visit(op);
+        if (op->call_type != Call::Intrinsic) {
+            result = true;
+        }
+    }
+
+public:
+    bool result;
+    ReadsState() : result(false) {}
+};
+
+bool reads_state(Expr e) {
+    ReadsState r;
+    e.accept(&r);
+    return r.result;
+}
+
+// The scalars needed to divide by some denominator, computed using
+// the algorithm in figure 4.1 of "Division by Invariant Integers
+// using Multiplication" by Granlund and Montgomery. With l =
+// ceil(log2(d)), the quotient of an unsigned n-bit x is:
+//
+// t = (x * mul) >> n
+// q = (t + ((x - t) >> shift1)) >> shift2
+//
+// where mul = 2^n * (2^l - d) / d + 1, shift1 = min(l, 1), and
+// shift2 = max(l - 1, 0). Signed division uses the unsigned
+// quotient of the absolute values.
+struct Divisor {
+    Expr denominator;
+    Expr mul, shift1, shift2, sign;
+};
+
+struct LoopInfo {
+    // The variables defined in the loop, outside of any inner loops.
+    Scope<int> defined;
+    // The lets to wrap around the loop, in order.
+    vector<pair<string, Expr> > lets;
+    vector<Divisor> divisors;
+};
+
+class LoopInvariantDivision : public IRMutator {
+    vector<LoopInfo> loops;
+    int gpu_loops;
+
+    using IRMutator::visit;
+
+    Expr make_let(LoopInfo &loop, Expr value) {
+        string name = unique_name('d');
+        loop.lets.push_back(make_pair(name, value));
+        return Variable::make(value.type(), name);
+    }
+
+    Divisor get_divisor(LoopInfo &loop, Expr d) {
+        for (size_t i = 0; i < loop.divisors.size(); i++) {
+            if (equal(loop.divisors[i].denominator, d)) {
+                return loop.divisors[i];
+            }
+        }
+
+        Type t = d.type();
+        int n = t.bits;
+        Type u = UInt(n), wide = UInt(64);
+
+        Divisor div;
+        div.denominator = d;
+
+        Expr abs_d = d;
+        if (t.is_int()) {
+            div.sign = make_let(loop, select(d < 0, make_const(t, -1), make_zero(t)));
+            abs_d = cast(u, select(d < 0, make_zero(t) - d, d));
+        }
+        // Division by zero is undefined, but it shouldn't fault out
+        // here, where it might not have been evaluated at all.
+        abs_d = make_let(loop, max(abs_d, make_one(u)));
+
+        Expr l = make_let(loop, make_const(u, n) - count_leading_zeros(abs_d - make_one(u)));
+        Expr two_to_the_l = make_one(wide) << cast(wide, l);
+        Expr mul = ((two_to_the_l - cast(wide, abs_d)) << make_const(wide, n)) / cast(wide, abs_d);
+        div.mul = make_let(loop, cast(u, mul + make_one(wide)));
+        div.shift1 = make_let(loop, min(l, make_one(u)));
+        div.shift2 = make_let(loop, max(l, make_one(u)) - make_one(u));
+
+        loop.divisors.push_back(div);
+        return div;
+    }
+
+    // Find the outermost loop in which the denominator of a vector
+    // division doesn't vary. Returns NULL if it varies in the
+    // innermost loop, or if this isn't a division we handle.
+    LoopInfo *hoisting_loop(Expr b, Type t) {
+        const Broadcast *broadcast = b.as<Broadcast>();
+        if (!broadcast || loops.empty() || gpu_loops ||
+            !(t.is_int() || t.is_uint()) ||
+            (t.bits != 8 && t.bits != 16 && t.bits != 32) ||
+            is_const(broadcast->value) || reads_state(broadcast->value)) {
+            return NULL;
+        }
+
+        size_t k = loops.size();
+        while (k > 0 && !expr_uses_vars(broadcast->value, loops[k-1].defined)) {
+            k--;
+        }
+        if (k == loops.size()) {
+            return NULL;
+        }
+        return &loops[k];
+    }
+
+    // Make the quotient of x and the denominator. x should be a
+    // variable, because it's used more than once.
+    Expr quotient(Expr x, const Divisor &div) {
+        Type t = x.type();
+        int n = t.bits;
+        Type u = UInt(n, t.width), wide = UInt(n * 2, t.width);
+
+        // For signed division, flip the bits of the numerator so that
+        // we can do an unsigned division, and flip them back
+        // afterwards. This rounds towards negative infinity, which is
+        // what Halide's division does.
+        Expr num = x, flip;
+        if (t.is_int()) {
+            Expr sign = Broadcast::make(div.sign, t.width);
+            Expr zero = make_zero(t);
+            flip = select(x < zero, ~sign, select(x > zero, sign, zero));
+            // Negate the numerator if the denominator is negative.
+            num = (x ^ sign) - sign;
+            num = cast(u, num ^ flip);
+        }
+
+        // Multiply-keep-high-half
+        Expr mul = Broadcast::make(div.mul, t.width);
+        Expr result = cast(wide, num) * cast(wide, mul);
+        if (n < 32) result = result / (1 << n);
+        else result = result >> n;
+        result = cast(u, result);
+
+        Expr shift1 = Broadcast::make(div.shift1, t.width);
+        Expr shift2 = Broadcast::make(div.shift2, t.width);
+        result = (result + ((num - result) >> shift1)) >> shift2;
+
+        if (t.is_int()) {
+            result = cast(t, result) ^ flip;
+        }
+        return result;
+    }
+
+    void visit(const Div *op) {
+        LoopInfo *loop = hoisting_loop(op->b, op->type);
+        if (!loop) {
+            IRMutator::visit(op);
+            return;
+        }
+        const Broadcast *b = op->b.as<Broadcast>();
+        Divisor div = get_divisor(*loop, b->value);
+        string name = unique_name('n');
+        Expr x = Variable::make(op->type, name);
+        expr = Let::make(name, mutate(op->a), quotient(x, div));
+    }
+
+    void visit(const Mod *op) {
+        LoopInfo *loop = hoisting_loop(op->b, op->type);
+        if (!loop) {
+            IRMutator::visit(op);
+            return;
+        }
+        const Broadcast *b = op->b.as<Broadcast>();
+        Divisor div = get_divisor(*loop, b->value);
+        string name = unique_name('n');
+        Expr x = Variable::make(op->type, name);
+        expr = Let::make(name, mutate(op->a), x - quotient(x, div) * op->b);
+    }
+
+    void visit(const Let *op) {
+        if (!loops.empty()) loops.back().defined.push(op->name, 0);
+        IRMutator::visit(op);
+    }
+
+    void visit(const LetStmt *op) {
+        if (!loops.empty()) loops.back().defined.push(op->name, 0);
+        IRMutator::visit(op);
+    }
+
+    void visit(const For *op) {
+        bool gpu = CodeGen_GPU_Dev::is_gpu_var(op->name);
+        if (gpu) gpu_loops++;
+        loops.push_back(LoopInfo());
+        loops.back().defined.push(op->name, 0);
+
+        Stmt body = mutate(op->body);
+
+        vector<pair<string, Expr> > lets = loops.back().lets;
+        loops.pop_back();
+        if (gpu) gpu_loops--;
+
+        if (body.same_as(op->body)) {
+            stmt = op;
+        } else {
+            stmt = For::make(op->name, op->min, op->extent, op->for_type, body);
+        }
+
+        for (size_t i = lets.size(); i > 0; i--) {
+            debug(3) << "Hoisting divisor " << lets[i-1].first << " = " << lets[i-1].second
+                     << " out of loop " << op->name << "\n";
+            stmt = LetStmt::make(lets[i-1].first, lets[i-1].second, stmt);
+        }
+    }
+
+public:
+    LoopInvariantDivision() : gpu_loops(0) {}
+};
+
+}
+
+Stmt loop_invariant_division(Stmt s) {
+    return LoopInvariantDivision().mutate(s);
+}
+
+}
+}
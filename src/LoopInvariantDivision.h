@@ -0,0 +1,27 @@
+#ifndef HALIDE_LOOP_INVARIANT_DIVISION_H
+#define HALIDE_LOOP_INVARIANT_DIVISION_H
+
+/** \file
+ * Defines the lowering pass that replaces vector integer division by
+ * loop-invariant values with multiplies and shifts.
+ */
+
+#include "IR.h"
+
+namespace Halide {
+namespace Internal {
+
+/** Find vector integer divisions and mods of 8, 16, or 32-bit values
+ * by a broadcast of a scalar that isn't a constant (e.g. a Param),
+ * and rewrite them as a multiply-keep-high-half and two shifts. The
+ * multiplier and shifts depend only on the denominator, so they are
+ * computed once as scalars, outside of the outermost loop in which
+ * the denominator doesn't vary. Division by a constant is already
+ * handled this way in codegen, and otherwise vector division is done
+ * one lane at a time. Should be run after vectorization. */
+Stmt loop_invariant_division(Stmt s);
+
+}
+}
+
+#endif
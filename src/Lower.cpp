@@ -6,6 +6,7 @@
 #include "Lower.h"
 #include "IROperator.h"
 #include "IRMutator.h"
+#include "IRVisitor.h"
 #include "Substitute.h"
 #include "Function.h"
 #include "Bounds.h"
@@ -18,6 +19,9 @@
 #include "BoundsInference.h"
 #include "VectorizeLoops.h"
 #include "UnrollLoops.h"
+#include "ParallelScatter.h"
+#include "Prefetch.h"
+#include "PartitionLoops.h"
 #include "SlidingWindow.h"
 #include "StorageFolding.h"
 #include "RemoveTrivialForLoops.h"
@@ -26,6 +30,11 @@
 #include "EarlyFree.h"
 #include "UniquifyVariableNames.h"
 #include "SkipStages.h"
+#include "ComputeWith.h"
+#include "AsyncProducers.h"
+#include "LoopCarry.h"
+#include "LoopInvariantDivision.h"
+#include "NarrowIntegerTypes.h"
 #include "CSE.h"
 #include "SpecializeClampedRamps.h"
 #include "RemoveUndef.h"
@@ -83,6 +92,152 @@ struct Container {
     string name;
     Expr value;
 };
+
+// Gather the even bits of a non-negative value into its low half.
+Expr compact_even_bits(Expr v) {
+    v = v & 0x55555555;
+    v = (v | (v / 2)) & 0x33333333;
+    v = (v | (v / 4)) & 0x0f0f0f0f;
+    v = (v | (v / 16)) & 0x00ff00ff;
+    v = (v | (v / 256)) & 0x0000ffff;
+    return v;
+}
+
+// Define x_name and y_name as the coordinates of the point at
+// position d along a space-filling curve over a square of the given
+// power-of-two side. Returns the lets that do so, outermost first.
+vector<pair<string, Expr> > decode_tile_order(TileOrder order, Expr d, Expr side,
+                                              const string &prefix,
+                                              const string &x_name,
+                                              const string &y_name) {
+    vector<pair<string, Expr> > lets;
+    if (order == TileOrder_Morton) {
+        lets.push_back(make_pair(x_name, compact_even_bits(d)));
+        lets.push_back(make_pair(y_name, compact_even_bits(d / 2)));
+        return lets;
+    }
+
+    internal_assert(order == TileOrder_Hilbert);
+    // Walk up the levels of the curve, from squares of side 1,
+    // rotating and reflecting the point found so far into the
+    // quadrant the next two bits of d select. Each level is a let,
+    // so the expressions don't grow exponentially. Levels beyond the
+    // side of the square must leave the point alone.
+    Expr x = 0, y = 0, t = d;
+    for (int level = 0; level < 16; level++) {
+        int s = 1 << level;
+        Expr active = s < side;
+        Expr rx = (t / 2) % 2;
+        Expr ry = (t + rx) % 2;
+        Expr flip = (rx == 1);
+        Expr fx = select(flip, s - 1 - x, x);
+        Expr fy = select(flip, s - 1 - y, y);
+        Expr nx = select(ry == 0, fy, x) + s * rx;
+        Expr ny = select(ry == 0, fx, y) + s * ry;
+
+        string n = prefix + ".hilbert" + int_to_string(level);
+        bool last = (level == 15);
+        string xn = last ? x_name : n + ".x";
+        string yn = last ? y_name : n + ".y";
+        lets.push_back(make_pair(xn, select(active, nx, x)));
+        lets.push_back(make_pair(yn, select(active, ny, y)));
+        x = Variable::make(Int(32), xn);
+        y = Variable::make(Int(32), yn);
+        if (!last) {
+            lets.push_back(make_pair(n + ".t", t / 4));
+            t = Variable::make(Int(32), n + ".t");
+        }
+    }
+    return lets;
+}
+
+// Find the calls to a function in some expressions.
+class FindCallsTo : public IRVisitor {
+    using IRVisitor::visit;
+
+    void visit(const Call *op) {
+        IRVisitor::visit(op);
+        if (op->call_type == Call::Halide && op->name == name) {
+            calls.push_back(op);
+        }
+    }
+public:
+    const string &name;
+    vector<const Call *> calls;
+    FindCallsTo(const string &n) : name(n) {}
+};
+
+bool uses_any(Expr e, const vector<string> &vars) {
+    for (size_t i = 0; i < vars.size(); i++) {
+        if (expr_uses_var(e, vars[i])) return true;
+    }
+    return false;
+}
+
+// Is the site read by a call the same as the site written, in
+// every lane?
+bool same_site(const vector<Expr> &args, const vector<Expr> &site) {
+    for (size_t i = 0; i < site.size(); i++) {
+        if (!is_zero(simplify(args[i] - site[i]))) return false;
+    }
+    return true;
+}
+
+// Does the site read by a call differ from the site written in some
+// dimension, by a constant that doesn't depend on the vectorized
+// variables?
+bool distinct_site(const vector<Expr> &args, const vector<Expr> &site,
+                   const vector<string> &vars) {
+    for (size_t i = 0; i < site.size(); i++) {
+        if (uses_any(args[i], vars) || uses_any(site[i], vars)) continue;
+        const int *diff = as_const_int(simplify(args[i] - site[i]));
+        if (diff && *diff != 0) return true;
+    }
+    return false;
+}
+
+// Check that vectorizing an update across the given reduction
+// variables can't make one lane read or write a site that another
+// lane writes.
+bool lanes_are_independent(const string &func,
+                           const vector<Expr> &site,
+                           const vector<Expr> &values,
+                           const vector<string> &vars) {
+    bool one_site = true;
+    for (size_t i = 0; i < site.size(); i++) {
+        if (uses_any(site[i], vars)) one_site = false;
+    }
+
+    if (!one_site) {
+        // Each lane must write a different site, so there must be a
+        // dimension that moves by a non-zero constant with the
+        // (single) vectorized variable.
+        if (vars.size() != 1) return false;
+        bool distinct_writes = false;
+        Expr next = Variable::make(Int(32), vars[0]) + 1;
+        for (size_t i = 0; i < site.size(); i++) {
+            if (!expr_uses_var(site[i], vars[0])) continue;
+            const int *step = as_const_int(simplify(substitute(vars[0], next, site[i]) - site[i]));
+            if (step && *step != 0) distinct_writes = true;
+        }
+        if (!distinct_writes) return false;
+    }
+
+    // Every lane may read its own site. When every lane updates the
+    // same site, the lanes are combined or applied in order, so
+    // that's fine too. Other reads must be of sites no lane writes.
+    FindCallsTo finder(func);
+    for (size_t i = 0; i < values.size(); i++) {
+        values[i].accept(&finder);
+    }
+    for (size_t i = 0; i < finder.calls.size(); i++) {
+        const vector<Expr> &args = finder.calls[i]->args;
+        if (!same_site(args, site) && !distinct_site(args, site, vars)) {
+            return false;
+        }
+    }
+    return true;
+}
 }
 
 // Build a loop nest about a provide node using a schedule
@@ -91,7 +246,8 @@ Stmt build_provide_loop_nest(Function f,
                              const vector<Expr> &site,
                              const vector<Expr> &values,
                              const Schedule &s,
-                             bool is_update) {
+                             bool is_update,
+                             const ReductionDomain &rdom) {
 
     // We'll build it from inside out, starting from a store node,
     // then wrapping it in for loops.
@@ -106,8 +262,46 @@ Stmt build_provide_loop_nest(Function f,
         known_size_dims[s.bounds()[i].var] = s.bounds()[i].extent;
     }
 
+    // The reduction variables, and the loop variables derived from
+    // them by splitting, renaming, and fusing. The reduction domain
+    // also tells us their sizes.
+    set<string> rvars;
+    // The reduction variables each of those loop variables derive from.
+    map<string, set<string> > rvar_sources;
+    if (rdom.defined()) {
+        for (size_t i = 0; i < rdom.domain().size(); i++) {
+            const ReductionVariable &rv = rdom.domain()[i];
+            rvars.insert(rv.var);
+            rvar_sources[rv.var].insert(rv.var);
+            known_size_dims[rv.var] = rv.extent;
+        }
+    }
+
+    // Conditions that must hold for the provide to be executed.
+    vector<Expr> guards;
+
+    // Conditions that skip whole iterations of a loop. These go just
+    // inside the containers that define the values they use, rather
+    // than around the provide.
+    vector<Expr> loop_guards;
+
     vector<Split> splits = s.splits();
 
+    // Splits given the number of outer iterations get the smallest
+    // factor that needs no more than that many.
+    for (size_t i = 0; i < splits.size(); i++) {
+        Split &split = splits[i];
+        if (!split.is_split() || !split.by_count) continue;
+        for (size_t j = 0; j < i; j++) {
+            user_assert(!(splits[j].is_split() && splits[j].outer == split.old_var))
+                << "Can't split " << split.old_var << " of " << f.name()
+                << " into strips, because it is the outer dimension of another split.\n";
+        }
+        Expr old_extent = Variable::make(Int(32), prefix + split.old_var + ".loop_extent");
+        split.factor = max((old_extent + split.factor - 1) / split.factor, 1);
+        split.by_count = false;
+    }
+
     // Rebalance the split tree to make the outermost split first.
     for (size_t i = 0; i < splits.size(); i++) {
         for (size_t j = i+1; j < splits.size(); j++) {
@@ -170,6 +364,22 @@ Stmt build_provide_loop_nest(Function f,
     for (size_t i = 0; i < splits.size(); i++) {
         const Split &split = splits[i];
         Expr outer = Variable::make(Int(32), prefix + split.outer);
+        if (split.is_fuse()) {
+            if (rvars.count(split.inner) || rvars.count(split.outer)) {
+                rvars.insert(split.old_var);
+                set<string> &sources = rvar_sources[split.old_var];
+                sources.insert(rvar_sources[split.inner].begin(), rvar_sources[split.inner].end());
+                sources.insert(rvar_sources[split.outer].begin(), rvar_sources[split.outer].end());
+            }
+        } else if (rvars.count(split.old_var)) {
+            rvars.insert(split.outer);
+            rvar_sources[split.outer] = rvar_sources[split.old_var];
+            if (split.is_split()) {
+                rvars.insert(split.inner);
+                rvar_sources[split.inner] = rvar_sources[split.old_var];
+            }
+        }
+
         if (split.is_split()) {
             Expr inner = Variable::make(Int(32), prefix + split.inner);
             Expr old_max = Variable::make(Int(32), prefix + split.old_var + ".loop_max");
@@ -179,6 +389,19 @@ Stmt build_provide_loop_nest(Function f,
 
             Expr base = outer * split.factor + old_min;
 
+            bool is_rvar = rvars.count(split.old_var);
+            TailStrategy tail = split.tail;
+            if (tail == TailStrategy_Auto) {
+                if (is_rvar) {
+                    tail = TailStrategy_GuardWithIf;
+                } else if (is_update) {
+                    tail = TailStrategy_RoundUp;
+                } else {
+                    tail = TailStrategy_ShiftInward;
+                }
+            }
+
+            bool guarded = false;
             map<string, Expr>::iterator iter = known_size_dims.find(split.old_var);
             if ((iter != known_size_dims.end()) &&
                 is_zero(simplify(iter->second % split.factor))) {
@@ -186,18 +409,47 @@ Stmt build_provide_loop_nest(Function f,
                 // We have proved that the split factor divides the
                 // old extent. No need to adjust the base.
                 known_size_dims[split.outer] = iter->second / split.factor;
-            } else if (!is_update) {
+            } else if (tail == TailStrategy_ShiftInward) {
+                user_assert(!is_update)
+                    << "Can't split " << split.old_var << " of an update of "
+                    << f.name() << " with TailStrategy_ShiftInward, because "
+                    << "the update would be applied more than once to some sites.\n";
+
                 // Adjust the base downwards to not compute off the
                 // end of the realization.
-
                 base = Min::make(base, old_max + (1 - split.factor));
 
+            } else if (tail == TailStrategy_GuardWithIf) {
+                // Guard the provide so that it doesn't run off the
+                // end of the realization or the reduction domain. The
+                // old var is kept as a let, so that bounds inference
+                // can see that the guard clamps it. The guard is
+                // usually true, so loop partitioning can remove it
+                // from all but the last iteration.
+                guards.push_back(likely(Variable::make(Int(32), prefix + split.old_var) <= old_max));
+                guarded = true;
+
+            } else {
+                // Round up. Compute off the end of the realization,
+                // which allocation bounds inference will then make
+                // room for.
+                user_assert(!is_rvar)
+                    << "Can't split the reduction variable " << split.old_var
+                    << " of " << f.name() << " with TailStrategy_RoundUp, because "
+                    << "the update would run off the end of the reduction domain.\n";
             }
 
             string base_name = prefix + split.inner + ".base";
             Expr base_var = Variable::make(Int(32), base_name);
-            //stmt = LetStmt::make(prefix + split.old_var, base_var + inner, stmt);
-            stmt = substitute(prefix + split.old_var, base_var + inner, stmt);
+            if (guarded) {
+                stmt = LetStmt::make(prefix + split.old_var, base_var + inner, stmt);
+            } else {
+                //stmt = LetStmt::make(prefix + split.old_var, base_var + inner, stmt);
+                stmt = substitute(prefix + split.old_var, base_var + inner, stmt);
+                for (size_t j = 0; j < guards.size(); j++) {
+                    guards[j] = substitute(prefix + split.old_var, base_var + inner, guards[j]);
+                }
+            }
 
             // Don't put the let here, put it just inside the loop over outer
             stmt = LetStmt::make(base_name, base, stmt);
@@ -212,17 +464,66 @@ Stmt build_provide_loop_nest(Function f,
             Expr inner = fused % inner_extent + inner_min;
             Expr outer = fused / inner_extent + outer_min;
 
+            vector<pair<string, Expr> > decode_lets;
+            if (split.order != TileOrder_RowMajor) {
+                // Traverse the square that covers both dimensions
+                // along a space-filling curve, skipping the points
+                // outside of them.
+                Expr outer_extent = Variable::make(Int(32), prefix + split.outer + ".loop_extent");
+                Expr side = Variable::make(Int(32), prefix + split.old_var + ".tile_side");
+                string inner_name = prefix + split.inner + ".tile";
+                string outer_name = prefix + split.outer + ".tile";
+                decode_lets = decode_tile_order(split.order, fused, side,
+                                                prefix + split.old_var,
+                                                inner_name, outer_name);
+                Expr inner_tile = Variable::make(Int(32), inner_name);
+                Expr outer_tile = Variable::make(Int(32), outer_name);
+                loop_guards.push_back(inner_tile < inner_extent && outer_tile < outer_extent);
+                // The clamps don't change anything within the guard,
+                // but let bounds inference see the range of each
+                // dimension through the bit twiddling.
+                inner = clamp(inner_tile, 0, inner_extent - 1) + inner_min;
+                outer = clamp(outer_tile, 0, outer_extent - 1) + outer_min;
+            }
+
             //stmt = LetStmt::make(prefix + split.inner, inner, stmt);
             //stmt = LetStmt::make(prefix + split.outer, outer, stmt);
             stmt = substitute(prefix + split.inner, inner, stmt);
             stmt = substitute(prefix + split.outer, outer, stmt);
+            for (size_t j = 0; j < guards.size(); j++) {
+                guards[j] = substitute(prefix + split.inner, inner, guards[j]);
+                guards[j] = substitute(prefix + split.outer, outer, guards[j]);
+            }
+            for (size_t j = decode_lets.size(); j > 0; j--) {
+                stmt = LetStmt::make(decode_lets[j-1].first, decode_lets[j-1].second, stmt);
+            }
 
         } else {
             // stmt = LetStmt::make(prefix + split.old_var, outer, stmt);
             stmt = substitute(prefix + split.old_var, outer, stmt);
+            for (size_t j = 0; j < guards.size(); j++) {
+                guards[j] = substitute(prefix + split.old_var, outer, guards[j]);
+            }
         }
     }
 
+    // Vectorizing across a reduction variable runs several
+    // iterations of the update at once, which is only safe if they
+    // don't depend on each other.
+    for (size_t i = 0; i < s.dims().size(); i++) {
+        const Dim &dim = s.dims()[i];
+        if (dim.for_type != For::Vectorized || !rvars.count(dim.var)) continue;
+        vector<string> sources;
+        const set<string> &from = rvar_sources[dim.var];
+        for (set<string>::const_iterator iter = from.begin(); iter != from.end(); ++iter) {
+            sources.push_back(prefix + *iter);
+        }
+        user_assert(lanes_are_independent(f.name(), site, values, sources))
+            << "Can't vectorize " << dim.var << " of the update of " << f.name()
+            << ", because one lane of the update may read or write a site "
+            << "that another lane writes.\n";
+    }
+
     // All containing lets and fors. Outermost first.
     vector<Container> nest;
 
@@ -240,6 +541,11 @@ Stmt build_provide_loop_nest(Function f,
         stmt = let->body;
     }
 
+    // Guard the innermost statement
+    for (size_t i = 0; i < guards.size(); i++) {
+        stmt = IfThenElse::make(guards[i], stmt, Stmt());
+    }
+
     // Resort the containers vector so that lets are as far outwards
     // as possible. Use reverse insertion sort. Start at the first letstmt.
     for (int i = (int)s.dims().size(); i < (int)nest.size(); i++) {
@@ -257,8 +563,18 @@ Stmt build_provide_loop_nest(Function f,
         }
     }
 
-    // Rewrap the statement in the containing lets and fors.
+    // Rewrap the statement in the containing lets and fors. Put each
+    // loop guard just inside the innermost container it depends on,
+    // so points off the edge of a space-filling curve skip the whole
+    // body of the fused loop.
+    vector<bool> placed(loop_guards.size(), false);
     for (int i = (int)nest.size() - 1; i >= 0; i--) {
+        for (size_t j = 0; j < loop_guards.size(); j++) {
+            if (!placed[j] && expr_uses_var(loop_guards[j], nest[i].name)) {
+                stmt = IfThenElse::make(loop_guards[j], stmt, Stmt());
+                placed[j] = true;
+            }
+        }
         if (nest[i].value.defined()) {
             stmt = LetStmt::make(nest[i].name, nest[i].value, stmt);
         } else {
@@ -268,6 +584,9 @@ Stmt build_provide_loop_nest(Function f,
             stmt = For::make(nest[i].name, min, extent, dim.for_type, stmt);
         }
     }
+    for (size_t j = 0; j < loop_guards.size(); j++) {
+        internal_assert(placed[j]) << "Loop guard " << loop_guards[j] << " uses no loop variable\n";
+    }
 
     // Define the bounds on the split dimensions using the bounds
     // on the function args
@@ -290,9 +609,19 @@ Stmt build_provide_loop_nest(Function f,
             Expr inner_extent = Variable::make(Int(32), prefix + split.inner + ".loop_extent");
             Expr outer_extent = Variable::make(Int(32), prefix + split.outer + ".loop_extent");
             Expr fused_extent = inner_extent * outer_extent;
+            string side_name = prefix + split.old_var + ".tile_side";
+            Expr side = Variable::make(Int(32), side_name);
+            if (split.order != TileOrder_RowMajor) {
+                fused_extent = side * side;
+            }
             stmt = LetStmt::make(prefix + split.old_var + ".loop_min", 0, stmt);
             stmt = LetStmt::make(prefix + split.old_var + ".loop_max", fused_extent - 1, stmt);
             stmt = LetStmt::make(prefix + split.old_var + ".loop_extent", fused_extent, stmt);
+            if (split.order != TileOrder_RowMajor) {
+                // The smallest power of two no less than either extent
+                Expr biggest = max(max(inner_extent, outer_extent), 1);
+                stmt = LetStmt::make(side_name, 1 << (32 - count_leading_zeros(biggest - 1)), stmt);
+            }
         } else {
             // rename
             stmt = LetStmt::make(prefix + split.outer + ".loop_min", old_var_min, stmt);
@@ -321,7 +650,7 @@ Stmt build_provide_loop_nest(Function f,
         const Variable *var = eq ? eq->a.as<Variable>() : c.as<Variable>();
 
         Stmt then_case =
-            build_provide_loop_nest(f, prefix, site, values, sched, is_update);
+            build_provide_loop_nest(f, prefix, site, values, sched, is_update, rdom);
 
         if (var && eq) {
             then_case = simplify_exprs(substitute(var->name, eq->b, then_case));
@@ -481,7 +810,7 @@ Stmt build_produce(Function f) {
             site.push_back(Variable::make(Int(32), prefix + f.args()[i]));
         }
 
-        return build_provide_loop_nest(f, prefix, site, values, f.schedule(), false);
+        return build_provide_loop_nest(f, prefix, site, values, f.schedule(), false, ReductionDomain());
     }
 }
 
@@ -510,7 +839,7 @@ vector<Stmt> build_update(Function f) {
             debug(2) << "Reduction site " << i << " = " << s << "\n";
         }
 
-        Stmt loop = build_provide_loop_nest(f, prefix, site, values, r.schedule, true);
+        Stmt loop = build_provide_loop_nest(f, prefix, site, values, r.schedule, true, r.domain);
 
         // Now define the bounds on the reduction domain
         if (r.domain.defined()) {
@@ -675,12 +1004,25 @@ private:
 
         Stmt body = for_loop->body;
 
-        // Dig through any let statements
+        // Dig through any let statements, and any guard that skips
+        // whole iterations of the loop, so that the realization is
+        // skipped too.
         vector<pair<string, Expr> > lets;
         while (const LetStmt *l = body.as<LetStmt>()) {
             lets.push_back(make_pair(l->name, l->value));
             body = l->body;
         }
+        Expr guard;
+        vector<pair<string, Expr> > guarded_lets;
+        const IfThenElse *if_stmt = body.as<IfThenElse>();
+        if (if_stmt && !if_stmt->else_case.defined()) {
+            guard = if_stmt->condition;
+            body = if_stmt->then_case;
+            while (const LetStmt *l = body.as<LetStmt>()) {
+                guarded_lets.push_back(make_pair(l->name, l->value));
+                body = l->body;
+            }
+        }
 
         // Can't schedule extern things inside a vector for loop
         if (func.has_extern_definition() &&
@@ -717,7 +1059,13 @@ private:
             found_store_level = true;
         }
 
-        // Reinstate the let statements
+        // Reinstate the guard and the let statements
+        for (size_t i = guarded_lets.size(); i > 0; i--) {
+            body = LetStmt::make(guarded_lets[i - 1].first, guarded_lets[i - 1].second, body);
+        }
+        if (guard.defined()) {
+            body = IfThenElse::make(guard, body, Stmt());
+        }
         for (size_t i = lets.size(); i > 0; i--) {
             body = LetStmt::make(lets[i - 1].first, lets[i - 1].second, body);
         }
@@ -796,7 +1144,7 @@ public:
     }
 };
 
-vector<string> realization_order(string output, const map<string, Function> &env, map<string, set<string> > &graph) {
+vector<string> realization_order(const vector<string> &outputs, const map<string, Function> &env, map<string, set<string> > &graph) {
     // Make a DAG representing the pipeline. Each function maps to the set describing its inputs.
     // Populate the graph
     for (map<string, Function>::const_iterator iter = env.begin();
@@ -811,10 +1159,11 @@ vector<string> realization_order(string output, const map<string, Function> &env
 
     vector<string> result;
     set<string> result_set;
+    size_t outputs_scheduled = 0;
 
     while (true) {
         // Find a function not in result_set, for which all its inputs are
-        // in result_set. Stop when we reach the output function.
+        // in result_set. Stop when we have reached all the output functions.
         bool scheduled_something = false;
         // Inject a dummy use of this var in case asserts are off.
         (void)scheduled_something;
@@ -836,7 +1185,10 @@ vector<string> realization_order(string output, const map<string, Function> &env
                     result_set.insert(f);
                     result.push_back(f);
                     debug(4) << "Realization order: " << f << "\n";
-                    if (f == output) return result;
+                    if (std::find(outputs.begin(), outputs.end(), f) != outputs.end() &&
+                        ++outputs_scheduled == outputs.size()) {
+                        return result;
+                    }
                 }
             }
         }
@@ -860,6 +1212,22 @@ Stmt create_initial_loop_nest(Function f, const Target &t) {
     }
 }
 
+// Generate the loop nests of several outputs, one after the other in
+// realization order, so that an output that consumes another comes
+// after it.
+Stmt create_initial_loop_nest(const vector<Function> &outputs,
+                              const vector<string> &order, const Target &t) {
+    Stmt s;
+    for (size_t i = 0; i < order.size(); i++) {
+        for (size_t j = 0; j < outputs.size(); j++) {
+            if (outputs[j].name() != order[i]) continue;
+            Stmt nest = create_initial_loop_nest(outputs[j], t);
+            s = s.defined() ? Block::make(s, nest) : nest;
+        }
+    }
+    return s;
+}
+
 class ComputeLegalSchedules : public IRVisitor {
 public:
     struct Site {
@@ -1097,6 +1465,7 @@ void validate_schedule(Function f, Stmt s, bool is_output) {
 }
 
 Stmt schedule_functions(Stmt s, const vector<string> &order,
+                        const vector<string> &outputs,
                         const map<string, Function> &env,
                         const map<string, set<string> > &graph, const Target &t) {
 
@@ -1106,11 +1475,12 @@ Stmt schedule_functions(Stmt s, const vector<string> &order,
 
     for (size_t i = order.size(); i > 0; i--) {
         Function f = env.find(order[i-1])->second;
+        bool is_output = std::find(outputs.begin(), outputs.end(), f.name()) != outputs.end();
 
-        validate_schedule(f, s, i == order.size());
+        validate_schedule(f, s, is_output);
 
-        // We don't actually want to schedule the output function here.
-        if (i == order.size()) continue;
+        // We don't actually want to schedule the output functions here.
+        if (is_output) continue;
 
         if (f.has_pure_definition() &&
             !f.has_reduction_definition() &&
@@ -1204,7 +1574,7 @@ Stmt add_parameter_checks(Stmt s, const Target &t) {
 // inserted. The second is a piece of code which will rewrite the
 // buffer_t sizes, mins, and strides in order to satisfy the
 // requirements.
-Stmt add_image_checks(Stmt s, Function f, const Target &t, const FuncValueBounds &fb) {
+Stmt add_image_checks(Stmt s, const vector<Function> &outputs, const Target &t, const FuncValueBounds &fb) {
 
     bool no_asserts = t.features & Target::NoAsserts;
     bool no_bounds_query = t.features & Target::NoBoundsQuery;
@@ -1215,15 +1585,18 @@ Stmt add_image_checks(Stmt s, Function f, const Target &t, const FuncValueBounds
     map<string, FindBuffers::Result> bufs = finder.buffers;
 
     // Add the output buffer(s)
-    for (size_t i = 0; i < f.values().size(); i++) {
-        FindBuffers::Result output_buffer;
-        output_buffer.type = f.values()[i].type();
-        output_buffer.param = f.output_buffers()[i];
-        output_buffer.dimensions = f.dimensions();
-        if (f.values().size() > 1) {
-            bufs[f.name() + '.' + int_to_string(i)] = output_buffer;
-        } else {
-            bufs[f.name()] = output_buffer;
+    for (size_t j = 0; j < outputs.size(); j++) {
+        Function f = outputs[j];
+        for (size_t i = 0; i < f.values().size(); i++) {
+            FindBuffers::Result output_buffer;
+            output_buffer.type = f.values()[i].type();
+            output_buffer.param = f.output_buffers()[i];
+            output_buffer.dimensions = f.dimensions();
+            if (f.values().size() > 1) {
+                bufs[f.name() + '.' + int_to_string(i)] = output_buffer;
+            } else {
+                bufs[f.name()] = output_buffer;
+            }
         }
     }
 
@@ -1283,22 +1656,28 @@ Stmt add_image_checks(Stmt s, Function f, const Target &t, const FuncValueBounds
         Type type = iter->second.type;
         int dimensions = iter->second.dimensions;
 
-        // Detect if this is one of the outputs of a multi-output pipeline.
+        // Detect if this is one of the outputs of a multi-output
+        // (Tuple) Func, and which output Func it belongs to.
         bool is_output_buffer = false;
         bool is_secondary_output_buffer = false;
-        for (size_t i = 0; i < f.output_buffers().size(); i++) {
-            if (param.defined() &&
-                param.same_as(f.output_buffers()[i])) {
-                is_output_buffer = true;
-                if (i > 0) {
-                    is_secondary_output_buffer = true;
+        Function output;
+        for (size_t j = 0; j < outputs.size(); j++) {
+            const Function &f = outputs[j];
+            for (size_t i = 0; i < f.output_buffers().size(); i++) {
+                if (param.defined() &&
+                    param.same_as(f.output_buffers()[i])) {
+                    is_output_buffer = true;
+                    output = f;
+                    if (i > 0) {
+                        is_secondary_output_buffer = true;
+                    }
                 }
             }
         }
 
         // If we're one of multiple output buffers, we should use the
         // region inferred for the output Func.
-        string buffer_name = is_output_buffer ? f.name() : name;
+        string buffer_name = is_output_buffer ? output.name() : name;
 
         Box touched = boxes[buffer_name];
         internal_assert((int)(touched.size()) == dimensions);
@@ -1481,8 +1860,8 @@ Stmt add_image_checks(Stmt s, Function f, const Target &t, const FuncValueBounds
                     stride_constrained = image.stride(i);
                 }
 
-                min_constrained = Variable::make(Int(32), f.name() + ".0.min." + dim);
-                extent_constrained = Variable::make(Int(32), f.name() + ".0.extent." + dim);
+                min_constrained = Variable::make(Int(32), output.name() + ".0.min." + dim);
+                extent_constrained = Variable::make(Int(32), output.name() + ".0.extent." + dim);
             } else if (image.defined() && (int)i < image.dimensions()) {
                 stride_constrained = image.stride(i);
                 extent_constrained = image.extent(i);
@@ -1629,25 +2008,39 @@ Stmt add_image_checks(Stmt s, Function f, const Target &t, const FuncValueBounds
 }
 
 Stmt lower(Function f, const Target &t) {
+    return lower(vec(f), t);
+}
+
+Stmt lower(const vector<Function> &outputs, const Target &t) {
+    internal_assert(!outputs.empty());
 
     // Compute an environment
-    map<string, Function> env = find_transitive_calls(f);
+    map<string, Function> env;
+    vector<string> output_names;
+    for (size_t i = 0; i < outputs.size(); i++) {
+        const Function &f = outputs[i];
+        user_assert(std::find(output_names.begin(), output_names.end(), f.name()) == output_names.end())
+            << "Func " << f.name() << " appears more than once in the outputs of a Pipeline\n";
+        output_names.push_back(f.name());
+        map<string, Function> calls = find_transitive_calls(f);
+        env.insert(calls.begin(), calls.end());
+    }
 
     // Compute a realization order
     map<string, set<string> > graph;
-    vector<string> order = realization_order(f.name(), env, graph);
-    Stmt s = create_initial_loop_nest(f, t);
+    vector<string> order = realization_order(output_names, env, graph);
+    Stmt s = create_initial_loop_nest(outputs, order, t);
 
     debug(2) << "Initial statement: " << '\n' << s << '\n';
-    s = schedule_functions(s, order, env, graph, t);
+    s = schedule_functions(s, order, output_names, env, graph, t);
     debug(2) << "All realizations injected:\n" << s << '\n';
 
     debug(1) << "Injecting tracing...\n";
-    s = inject_tracing(s, env, f);
+    s = inject_tracing(s, env, outputs);
     debug(2) << "Tracing injected:\n" << s << '\n';
 
     debug(1) << "Injecting profiling...\n";
-    s = inject_profiling(s, f.name());
+    s = inject_profiling(s, outputs[0].name());
     debug(2) << "Profiling injected:\n" << s << '\n';
 
     debug(1) << "Adding checks for parameters\n";
@@ -1662,14 +2055,14 @@ Stmt lower(Function f, const Target &t) {
     // The checks will be in terms of the symbols defined by bounds
     // inference.
     debug(1) << "Adding checks for images\n";
-    s = add_image_checks(s, f, t, func_bounds);
+    s = add_image_checks(s, outputs, t, func_bounds);
     debug(2) << "Image checks injected:\n" << s << '\n';
 
     // This pass injects nested definitions of variable names, so we
     // can't simplify statements from here until we fix them up. (We
     // can still simplify Exprs).
     debug(1) << "Performing computation bounds inference...\n";
-    s = bounds_inference(s, order, env, func_bounds);
+    s = bounds_inference(s, outputs, order, env, func_bounds);
     debug(2) << "Computation bounds inference:\n" << s << '\n';
 
     debug(1) << "Performing sliding window optimization...\n";
@@ -1680,6 +2073,10 @@ Stmt lower(Function f, const Target &t) {
     s = allocation_bounds_inference(s, env, func_bounds);
     debug(2) << "Allocation bounds inference:\n" << s << '\n';
 
+    debug(1) << "Making producers async...\n";
+    s = async_producers(s, env);
+    debug(2) << "Async producers:\n" << s << '\n';
+
     // This uniquifies the variable names, so we're good to simplify
     // after this point. This lets later passes assume syntactic
     // equivalence means semantic equivalence.
@@ -1688,11 +2085,15 @@ Stmt lower(Function f, const Target &t) {
     debug(2) << "Uniquified variable names: \n" << s << "\n\n";
 
     debug(1) << "Performing storage folding optimization...\n";
-    s = storage_folding(s);
+    s = storage_folding(s, env);
     debug(2) << "Storage folding:\n" << s << '\n';
 
+    debug(1) << "Injecting prefetches...\n";
+    s = inject_prefetches(s, env);
+    debug(2) << "Injected prefetches:\n" << s << '\n';
+
     debug(1) << "Injecting debug_to_file calls...\n";
-    s = debug_to_file(s, order[order.size()-1], env);
+    s = debug_to_file(s, outputs, env);
     debug(2) << "Injected debug_to_file calls:\n" << s << '\n';
 
     debug(1) << "Simplifying...\n"; // without removing dead lets, because storage flattening needs the strides
@@ -1700,9 +2101,13 @@ Stmt lower(Function f, const Target &t) {
     debug(2) << "Simplified: \n" << s << "\n\n";
 
     debug(1) << "Dynamically skipping stages...\n";
-    s = skip_stages(s, order);
+    s = skip_stages(s, order, output_names);
     debug(2) << "Dynamically skipped stages: \n" << s << "\n\n";
 
+    debug(1) << "Fusing loop nests computed with each other...\n";
+    s = fuse_compute_with(s, env);
+    debug(2) << "Fused loop nests: \n" << s << "\n\n";
+
     if (t.features & Target::OpenGL) {
         debug(1) << "Injecting OpenGL texture intrinsics...\n";
         s = inject_opengl_intrinsics(s);
@@ -1713,6 +2118,13 @@ Stmt lower(Function f, const Target &t) {
     s = storage_flattening(s, env);
     debug(2) << "Storage flattening: \n" << s << "\n\n";
 
+    if (!(t.features & Target::OpenGL)) {
+        // OpenGL textures keep the types of the Funcs they hold.
+        debug(1) << "Narrowing integer types...\n";
+        s = narrow_integer_types(s, env, func_bounds);
+        debug(2) << "Narrowed integer types: \n" << s << "\n\n";
+    }
+
     if (t.has_gpu_feature() || t.features & Target::OpenGL) {
         debug(1) << "Injecting host <-> dev buffer copies...\n";
         s = inject_host_dev_buffer_copies(s);
@@ -1735,6 +2147,14 @@ Stmt lower(Function f, const Target &t) {
     s = remove_trivial_for_loops(s);
     debug(2) << "Simplified: \n" << s << "\n\n";
 
+    debug(1) << "Making parallel scatters race-free...\n";
+    s = parallel_scatter(s, env);
+    debug(2) << "Race-free parallel scatters: \n" << s << "\n\n";
+
+    debug(1) << "Interleaving accumulators...\n";
+    s = interleave_accumulators(s, env);
+    debug(2) << "Interleaved accumulators: \n" << s << "\n\n";
+
     debug(1) << "Unrolling...\n";
     s = unroll_loops(s);
     debug(2) << "Unrolled: \n" << s << "\n\n";
@@ -1743,8 +2163,15 @@ Stmt lower(Function f, const Target &t) {
     s = simplify(s);
     debug(2) << "Simplified: \n" << s << "\n\n";
 
+    debug(1) << "Partitioning loops to simplify boundary conditions...\n";
+    s = partition_loops(s);
+    s = simplify(s);
+    debug(2) << "Partitioned loops: \n" << s << "\n\n";
+
     debug(1) << "Vectorizing...\n";
-    s = vectorize_loops(s);
+    // AVX-512 can mask off the inactive lanes of the last vector of a
+    // guarded loop, so it need not be scalarized.
+    s = vectorize_loops(s, env, t.arch == Target::X86 && (t.features & Target::AVX512));
     debug(2) << "Vectorized: \n" << s << "\n\n";
 
     debug(1) << "Simplifying...\n";
@@ -1760,6 +2187,14 @@ Stmt lower(Function f, const Target &t) {
     s = rewrite_interleavings(s);
     debug(2) << "Rewrote vector interleavings: \n" << s << "\n\n";
 
+    debug(1) << "Hoisting loop-invariant divisors...\n";
+    s = loop_invariant_division(s);
+    debug(2) << "Hoisted loop-invariant divisors: \n" << s << "\n\n";
+
+    debug(1) << "Carrying loaded values across loop iterations...\n";
+    s = loop_carry(s);
+    debug(2) << "Lowering after carrying loaded values:\n" << s << "\n\n";
+
     debug(1) << "Injecting early frees...\n";
     s = inject_early_frees(s);
     debug(2) << "Injected early frees: \n" << s << "\n\n";
@@ -18,6 +18,14 @@ namespace Internal {
  * on. Some stages of lowering may be target-specific. */
 Stmt lower(Function f, const Target &t);
 
+/** Given several halide functions with schedules, create a statement
+ * that evaluates all of them in a single pass. Functions that more
+ * than one of the outputs depend on are shared between them, so a
+ * producer scheduled compute_root is only computed once. The
+ * outputs are computed one after the other, in an order in which
+ * any output that consumes another comes after it. */
+Stmt lower(const std::vector<Function> &outputs, const Target &t);
+
 void lower_test();
 
 }
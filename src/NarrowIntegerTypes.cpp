@@ -0,0 +1,353 @@
+#include "NarrowIntegerTypes.h"
+#include "IRMutator.h"
+#include "IRVisitor.h"
+#include "IROperator.h"
+#include "Function.h"
+#include "Simplify.h"
+#include "Scope.h"
+#include "Debug.h"
+#include "Util.h"
+
+namespace Halide {
+namespace Internal {
+
+using std::map;
+using std::string;
+using std::vector;
+
+namespace {
+
+// Are the bounds constants that fit in the given type?
+bool fits_in(Interval bounds, Type t) {
+    if (!bounds.min.defined() || !bounds.max.defined()) return false;
+    const int *min = as_const_int(simplify(bounds.min));
+    const int *max = as_const_int(simplify(bounds.max));
+    return min && max && *min >= t.imin() && *max <= t.imax();
+}
+
+// The narrowest integer type that holds all values in the bounds, or
+// the given type if there isn't a narrower one.
+Type narrowest_type_for(Interval bounds, Type t) {
+    Type candidates[] = {UInt(8), Int(8), UInt(16), Int(16)};
+    for (int i = 0; i < 4; i++) {
+        if (candidates[i].bits < t.bits && fits_in(bounds, candidates[i])) {
+            return candidates[i];
+        }
+    }
+    return t;
+}
+
+// Is a buffer's buffer_t used for anything other than its own
+// definition? E.g. by an extern stage.
+class UsesBufferT : public IRVisitor {
+    using IRVisitor::visit;
+
+    void visit(const Variable *op) {
+        if (op->name == name) result = true;
+    }
+public:
+    string name;
+    bool result;
+    UsesBufferT(const string &n) : name(n + ".buffer"), result(false) {}
+};
+
+// Store an allocation in a narrower type, converting as it's stored
+// and loaded.
+class NarrowAllocation : public IRMutator {
+    const string &name;
+    Type narrow;
+
+    using IRMutator::visit;
+
+    void visit(const Load *op) {
+        if (op->name == name) {
+            Expr index = mutate(op->index);
+            expr = Cast::make(op->type, Load::make(narrow, op->name, index, op->image, op->param));
+        } else {
+            IRMutator::visit(op);
+        }
+    }
+
+    void visit(const Store *op) {
+        if (op->name == name) {
+            stmt = Store::make(op->name, cast(narrow, mutate(op->value)), mutate(op->index));
+        } else {
+            IRMutator::visit(op);
+        }
+    }
+
+    void visit(const Call *op) {
+        // These take the address of a Load, so it can't be wrapped
+        // in a cast.
+        const Load *load = op->args.empty() ? NULL : op->args[0].as<Load>();
+        if (op->call_type == Call::Intrinsic &&
+            (op->name == Call::address_of || op->name == Call::prefetch) &&
+            load && load->name == name) {
+            vector<Expr> args = op->args;
+            args[0] = Load::make(narrow, load->name, mutate(load->index), load->image, load->param);
+            expr = Call::make(op->type, op->name, args, op->call_type,
+                              op->func, op->value_index, op->image, op->param);
+        } else if (op->call_type == Call::Intrinsic &&
+                   op->name == Call::create_buffer_t) {
+            // Fix the element size of our own buffer_t.
+            IRMutator::visit(op);
+            const Call *c = expr.as<Call>();
+            const Call *address = c->args[0].as<Call>();
+            load = address ? address->args[0].as<Load>() : NULL;
+            if (load && load->name == name) {
+                vector<Expr> args = c->args;
+                args[1] = narrow.bytes();
+                expr = Call::make(c->type, c->name, args, c->call_type,
+                                  c->func, c->value_index, c->image, c->param);
+            }
+        } else {
+            IRMutator::visit(op);
+        }
+    }
+
+public:
+    NarrowAllocation(const string &n, Type t) : name(n), narrow(t) {}
+};
+
+class NarrowStorage : public IRMutator {
+    const map<string, Function> &env;
+    const FuncValueBounds &func_bounds;
+
+    using IRMutator::visit;
+
+    // Find the bounds on the values stored in a buffer made by
+    // storage flattening.
+    bool value_bounds(const string &buffer, Interval *bounds) {
+        string func = buffer;
+        int idx = 0;
+        map<string, Function>::const_iterator iter = env.find(func);
+        if (iter == env.end()) {
+            size_t dot = buffer.rfind('.');
+            if (dot == string::npos) return false;
+            func = buffer.substr(0, dot);
+            idx = atoi(buffer.c_str() + dot + 1);
+            iter = env.find(func);
+            if (iter == env.end() || iter->second.outputs() < 2) return false;
+        }
+        if (!iter->second.debug_file().empty()) return false;
+
+        FuncValueBounds::const_iterator b = func_bounds.find(std::make_pair(func, idx));
+        if (b == func_bounds.end()) return false;
+        *bounds = b->second;
+        return true;
+    }
+
+    void visit(const Allocate *op) {
+        Interval bounds;
+        Type t = op->type;
+        if ((t.is_int() || t.is_uint()) && t.bits > 8 &&
+            value_bounds(op->name, &bounds)) {
+            Type narrow = narrowest_type_for(bounds, t);
+            if (narrow != t) {
+                // Look for uses of the buffer_t other than its
+                // definition, which is the LetStmt just inside the
+                // Allocate.
+                const LetStmt *let = op->body.as<LetStmt>();
+                UsesBufferT uses(op->name);
+                if (let && let->name == op->name + ".buffer") {
+                    let->body.accept(&uses);
+                } else {
+                    op->body.accept(&uses);
+                }
+                if (!uses.result) {
+                    debug(1) << "Storing " << op->name << " as " << narrow
+                             << " instead of " << t << "\n";
+                    Stmt body = NarrowAllocation(op->name, narrow).mutate(op->body);
+                    stmt = Allocate::make(op->name, narrow, op->extents, mutate(body));
+                    return;
+                }
+            }
+        }
+        IRMutator::visit(op);
+    }
+
+public:
+    NarrowStorage(const map<string, Function> &e, const FuncValueBounds &fb) :
+        env(e), func_bounds(fb) {}
+};
+
+// Does an expression contain a multiplication or a division? 8-bit
+// vector multiplies are missing or slow on most targets.
+class HasMulOrDiv : public IRVisitor {
+    using IRVisitor::visit;
+
+    void visit(const Mul *) {result = true;}
+    void visit(const Div *) {result = true;}
+    void visit(const Mod *) {result = true;}
+public:
+    bool result;
+    HasMulOrDiv() : result(false) {}
+};
+
+// Compute the values that are cast to narrow integer types in the
+// narrowest type that holds every intermediate value. E.g. a uint8
+// blur written with int32 math can be done in uint16.
+class NarrowExpressions : public IRMutator {
+    const FuncValueBounds &func_bounds;
+    Scope<Interval> scope;
+
+    using IRMutator::visit;
+
+    Interval bounds_of(Expr e) {
+        return bounds_of_expr_in_scope(e, scope, func_bounds);
+    }
+
+    // Make the bounds of a let-bound value to push. Only keep
+    // constant bounds, so the expressions don't grow as lets nest.
+    Interval let_bounds(const string &name, Expr value) {
+        Expr var = Variable::make(value.type(), name);
+        if (value.type().is_scalar() && (value.type().is_int() || value.type().is_uint())) {
+            Interval b = bounds_of(value);
+            if (b.min.defined() && b.max.defined()) {
+                b.min = simplify(b.min);
+                b.max = simplify(b.max);
+                if (is_const(b.min) && is_const(b.max)) {
+                    return b;
+                }
+            }
+        }
+        return Interval(var, var);
+    }
+
+    // Rewrite e to compute the same value in type t, or return an
+    // undefined Expr if some intermediate value might not fit.
+    Expr narrow_to(Expr e, Type t) {
+        if (!fits_in(bounds_of(e), t)) {
+            return Expr();
+        }
+
+        if (is_const(e)) {
+            return cast(t, e);
+        } else if (const Cast *c = e.as<Cast>()) {
+            if (t.can_represent(c->value.type())) {
+                // Skip the widening cast.
+                return cast(t, c->value);
+            }
+        } else if (const Add *op = e.as<Add>()) {
+            Expr a = narrow_to(op->a, t), b = narrow_to(op->b, t);
+            if (a.defined() && b.defined()) return Add::make(a, b);
+        } else if (const Sub *op = e.as<Sub>()) {
+            Expr a = narrow_to(op->a, t), b = narrow_to(op->b, t);
+            if (a.defined() && b.defined()) return Sub::make(a, b);
+        } else if (const Mul *op = e.as<Mul>()) {
+            Expr a = narrow_to(op->a, t), b = narrow_to(op->b, t);
+            if (a.defined() && b.defined()) return Mul::make(a, b);
+        } else if (const Div *op = e.as<Div>()) {
+            Expr a = narrow_to(op->a, t), b = narrow_to(op->b, t);
+            if (a.defined() && b.defined()) return Div::make(a, b);
+        } else if (const Mod *op = e.as<Mod>()) {
+            Expr a = narrow_to(op->a, t), b = narrow_to(op->b, t);
+            if (a.defined() && b.defined()) return Mod::make(a, b);
+        } else if (const Min *op = e.as<Min>()) {
+            Expr a = narrow_to(op->a, t), b = narrow_to(op->b, t);
+            if (a.defined() && b.defined()) return Min::make(a, b);
+        } else if (const Max *op = e.as<Max>()) {
+            Expr a = narrow_to(op->a, t), b = narrow_to(op->b, t);
+            if (a.defined() && b.defined()) return Max::make(a, b);
+        } else if (const Select *op = e.as<Select>()) {
+            Expr a = narrow_to(op->true_value, t), b = narrow_to(op->false_value, t);
+            if (a.defined() && b.defined()) return Select::make(op->condition, a, b);
+        }
+
+        // Compute it in its own type, and then cast it. The cast
+        // can't lose anything, because the value fits.
+        return cast(t, e);
+    }
+
+    void visit(const Cast *op) {
+        Type from = op->value.type(), to = op->type;
+        if (op->type.is_scalar() &&
+            (to.is_int() || to.is_uint()) &&
+            (from.is_int() || from.is_uint()) &&
+            from.bits > to.bits && to.bits >= 8) {
+
+            HasMulOrDiv mul;
+            op->value.accept(&mul);
+
+            Type candidates[] = {UInt(8), Int(8), UInt(16), Int(16)};
+            for (int i = 0; i < 4; i++) {
+                Type t = candidates[i];
+                if (t.bits >= from.bits || t.bits < to.bits ||
+                    (t.bits == 8 && mul.result)) {
+                    continue;
+                }
+                Expr narrowed = narrow_to(op->value, t);
+                // Don't count just casting the whole thing as
+                // progress.
+                if (narrowed.defined() && !narrowed.as<Cast>()) {
+                    debug(2) << "Computing " << op->value << " as " << t << "\n";
+                    count++;
+                    expr = (t == to) ? narrowed : Cast::make(to, narrowed);
+                    return;
+                }
+            }
+        }
+        IRMutator::visit(op);
+    }
+
+    void visit(const Let *op) {
+        Expr value = mutate(op->value);
+        scope.push(op->name, let_bounds(op->name, op->value));
+        Expr body = mutate(op->body);
+        scope.pop(op->name);
+        if (value.same_as(op->value) && body.same_as(op->body)) {
+            expr = op;
+        } else {
+            expr = Let::make(op->name, value, body);
+        }
+    }
+
+    void visit(const LetStmt *op) {
+        Expr value = mutate(op->value);
+        scope.push(op->name, let_bounds(op->name, op->value));
+        Stmt body = mutate(op->body);
+        scope.pop(op->name);
+        if (value.same_as(op->value) && body.same_as(op->body)) {
+            stmt = op;
+        } else {
+            stmt = LetStmt::make(op->name, value, body);
+        }
+    }
+
+    void visit(const For *op) {
+        Expr min = mutate(op->min), extent = mutate(op->extent);
+        Interval b = bounds_of(op->min);
+        Interval e = bounds_of(op->extent);
+        Interval loop_bounds(b.min, (b.max.defined() && e.max.defined()) ? b.max + e.max - 1 : Expr());
+        Expr var = Variable::make(Int(32), op->name);
+        if (!fits_in(loop_bounds, Int(32))) {
+            loop_bounds = Interval(var, var);
+        }
+        scope.push(op->name, loop_bounds);
+        Stmt body = mutate(op->body);
+        scope.pop(op->name);
+        if (min.same_as(op->min) && extent.same_as(op->extent) && body.same_as(op->body)) {
+            stmt = op;
+        } else {
+            stmt = For::make(op->name, min, extent, op->for_type, body);
+        }
+    }
+
+public:
+    int count;
+    NarrowExpressions(const FuncValueBounds &fb) : func_bounds(fb), count(0) {}
+};
+
+}
+
+Stmt narrow_integer_types(Stmt s, const map<string, Function> &env,
+                          const FuncValueBounds &func_bounds) {
+    s = NarrowStorage(env, func_bounds).mutate(s);
+    NarrowExpressions narrow(func_bounds);
+    s = narrow.mutate(s);
+    debug(1) << "Narrowed " << narrow.count << " expressions to 8 or 16 bits\n";
+    return s;
+}
+
+}
+}
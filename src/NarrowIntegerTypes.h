@@ -0,0 +1,36 @@
+#ifndef HALIDE_NARROW_INTEGER_TYPES_H
+#define HALIDE_NARROW_INTEGER_TYPES_H
+
+/** \file
+ * Defines the lowering pass that stores and computes integer values
+ * in the narrowest type that can hold them.
+ */
+
+#include <map>
+
+#include "IR.h"
+#include "Bounds.h"
+
+namespace Halide {
+namespace Internal {
+
+class Function;
+
+/** Use the bounds on the values of Funcs and expressions to narrow
+ * integer types where it can't change the results. Internal
+ * allocations of Funcs whose values are known to fit in 8 or 16 bits
+ * are stored in that type, and expressions that are cast to a
+ * narrower type (e.g. a uint8 pipeline written with int32 math) are
+ * computed in 8 or 16 bits when every intermediate value fits. This
+ * lets the vectorizer use more lanes. The bounds come from the types
+ * of loads, from constants, and from the ranges given to Params with
+ * Param::set_range. What was narrowed is reported at debug level
+ * 1. Should be run after storage flattening and before
+ * vectorization. */
+Stmt narrow_integer_types(Stmt s, const std::map<std::string, Function> &env,
+                          const FuncValueBounds &func_bounds);
+
+}
+}
+
+#endif
@@ -0,0 +1,218 @@
+#include "ParallelScatter.h"
+#include "IRMutator.h"
+#include "IROperator.h"
+#include "AssociativeUpdate.h"
+#include "Function.h"
+
+namespace Halide {
+namespace Internal {
+
+using std::map;
+using std::string;
+using std::vector;
+
+namespace {
+
+struct ScatterLoop {
+    string func;
+    bool atomic;
+};
+
+// Replace the associative updates of a buffer with updates of a
+// private copy of it, or with atomic operations on it.
+class RewriteScatter : public IRMutator {
+    const string &buffer;
+    const string &replacement;
+    Expr base;
+    bool atomic;
+
+    using IRMutator::visit;
+
+    void visit(const Store *op) {
+        if (op->name != buffer) {
+            IRMutator::visit(op);
+            return;
+        }
+
+        string op_reduce;
+        Expr self, other;
+        user_assert(match_associative_update(op, &op_reduce, &self, &other))
+            << "Can't run the update of " << buffer << " in parallel, because "
+            << "it isn't of the form " << buffer << "(...) += value (or -=, *=, min, max), "
+            << "where value doesn't depend on " << buffer << ".\n";
+        user_assert(update == NULL || op_reduce == reduce_op)
+            << "Can't run the update of " << buffer << " in parallel, because "
+            << "it combines values with more than one operator.\n";
+        update = op;
+        reduce_op = op_reduce;
+
+        Expr index = mutate(op->index);
+        other = mutate(other);
+        Type t = op->value.type();
+
+        if (atomic) {
+            user_assert(!t.is_float() && reduce_op != Call::vector_reduce_mul)
+                << "Can't update " << buffer << " atomically. Atomic scatters only "
+                << "support integer +=, -=, min, and max.\n";
+            if (op->value.as<Sub>()) {
+                other = make_zero(t) - other;
+            }
+            string atomic_op;
+            if (reduce_op == Call::vector_reduce_add) {
+                atomic_op = Call::atomic_add;
+            } else if (reduce_op == Call::vector_reduce_min) {
+                atomic_op = Call::atomic_min;
+            } else {
+                atomic_op = Call::atomic_max;
+            }
+            Expr site = Load::make(t, buffer, index, Buffer(), Parameter());
+            Expr addr = Call::make(Handle(), Call::address_of, vec(site), Call::Intrinsic);
+            stmt = Evaluate::make(Call::make(t, atomic_op, vec(addr, other), Call::Intrinsic));
+        } else {
+            index = base + index;
+            Expr partial = Load::make(t, replacement, index, Buffer(), Parameter());
+            stmt = Store::make(replacement, associative_combine(reduce_op, partial, other), index);
+        }
+    }
+
+    void visit(const Load *op) {
+        user_assert(op->name != buffer)
+            << "Can't run the update of " << buffer << " in parallel, because "
+            << "it loads from " << buffer << " other than at the site being updated.\n";
+        IRMutator::visit(op);
+    }
+
+    void visit(const For *op) {
+        user_assert(!atomic || op->for_type != For::Vectorized)
+            << "Can't update " << buffer << " atomically within the vectorized loop "
+            << op->name << ".\n";
+        IRMutator::visit(op);
+    }
+
+public:
+    const Store *update;
+    string reduce_op;
+
+    RewriteScatter(const string &b, const string &r, Expr base, bool a) :
+        buffer(b), replacement(r), base(base), atomic(a), update(NULL) {}
+};
+
+class PrivatizeScatters : public IRMutator {
+    const map<string, ScatterLoop> &marked;
+    const map<string, Function> &env;
+
+    using IRMutator::visit;
+
+    void visit(const For *op) {
+        map<string, ScatterLoop>::const_iterator iter = marked.find(op->name);
+        if (iter == marked.end() || op->for_type != For::Parallel) {
+            IRMutator::visit(op);
+            return;
+        }
+
+        const ScatterLoop &loop = iter->second;
+        const Function &f = env.find(loop.func)->second;
+        user_assert(f.outputs() == 1)
+            << "Can't run the update of " << f.name() << " in parallel, because "
+            << "it has more than one value.\n";
+
+        string buffer = f.name();
+        string private_name = unique_name(buffer + ".private", false);
+        Expr loop_var = Variable::make(Int(32), op->name);
+
+        // The size of one private copy of the realization of the
+        // function, which uses the same strides.
+        Expr size = 1;
+        vector<Expr> mins(f.args().size()), extents(f.args().size()), strides(f.args().size());
+        for (size_t i = 0; i < f.args().size(); i++) {
+            string dim = int_to_string(i);
+            mins[i] = Variable::make(Int(32), buffer + ".min." + dim);
+            extents[i] = Variable::make(Int(32), buffer + ".extent." + dim);
+            strides[i] = Variable::make(Int(32), buffer + ".stride." + dim);
+            size += (extents[i] - 1) * strides[i];
+        }
+        string size_name = private_name + ".size";
+        Expr size_var = Variable::make(Int(32), size_name);
+        Expr base = (loop_var - op->min) * size_var;
+
+        RewriteScatter rewrite(buffer, private_name, base, loop.atomic);
+        Stmt body = rewrite.mutate(op->body);
+
+        if (loop.atomic || rewrite.update == NULL) {
+            stmt = For::make(op->name, op->min, op->extent, op->for_type, body);
+            return;
+        }
+
+        const Store *update = rewrite.update;
+        const string &reduce_op = rewrite.reduce_op;
+        Type t = update->value.type();
+
+        // Initialize this iteration's private copy.
+        string init_var = private_name + ".i";
+        Stmt init = Store::make(private_name, associative_identity(reduce_op, t),
+                                base + Variable::make(Int(32), init_var));
+        init = For::make(init_var, 0, size_var, For::Serial, init);
+        body = Block::make(init, body);
+        Stmt scatter = For::make(op->name, op->min, op->extent, op->for_type, body);
+
+        // Combine the private copies into the function, one at a time.
+        string slice_var = private_name + ".slice";
+        vector<string> site_vars(f.args().size());
+        Expr index = 0;
+        for (size_t i = 0; i < f.args().size(); i++) {
+            site_vars[i] = private_name + "." + f.args()[i];
+            index += (Variable::make(Int(32), site_vars[i]) - mins[i]) * strides[i];
+        }
+        Expr partial_index = Variable::make(Int(32), slice_var) * size_var + index;
+        Expr partial = Load::make(t, private_name, partial_index, Buffer(), Parameter());
+        Expr self = Load::make(t, buffer, index, Buffer(), Parameter());
+        Stmt merge = Store::make(buffer, rebuild_associative_update(update, reduce_op, self, partial), index);
+        for (size_t i = 0; i < f.args().size(); i++) {
+            merge = For::make(site_vars[i], mins[i], extents[i], For::Serial, merge);
+        }
+        merge = For::make(slice_var, 0, op->extent, For::Serial, merge);
+
+        stmt = Block::make(scatter, merge);
+        stmt = Allocate::make(private_name, t, vec(op->extent, size_var), stmt);
+        stmt = LetStmt::make(size_name, size, stmt);
+    }
+
+public:
+    PrivatizeScatters(const map<string, ScatterLoop> &m, const map<string, Function> &e) :
+        marked(m), env(e) {}
+};
+
+void find_parallel_scatters(const Function &f, int stage, const Schedule &s,
+                            map<string, ScatterLoop> *marked) {
+    const vector<ParallelScatter> &scatters = s.parallel_scatters();
+    for (size_t i = 0; i < scatters.size(); i++) {
+        string loop_name = f.name() + ".s" + int_to_string(stage) + "." + scatters[i].var;
+        ScatterLoop loop = {f.name(), scatters[i].atomic};
+        (*marked)[loop_name] = loop;
+    }
+    for (size_t i = 0; i < s.specializations().size(); i++) {
+        find_parallel_scatters(f, stage, s.specializations()[i].schedule, marked);
+    }
+}
+
+}
+
+Stmt parallel_scatter(Stmt s, const map<string, Function> &env) {
+    map<string, ScatterLoop> marked;
+    for (map<string, Function>::const_iterator iter = env.begin();
+         iter != env.end(); ++iter) {
+        const Function &f = iter->second;
+        for (size_t i = 0; i < f.reductions().size(); i++) {
+            find_parallel_scatters(f, (int)(i+1), f.reductions()[i].schedule, &marked);
+        }
+    }
+
+    if (marked.empty()) {
+        return s;
+    }
+
+    return PrivatizeScatters(marked, env).mutate(s);
+}
+
+}
+}
@@ -0,0 +1,26 @@
+#ifndef HALIDE_PARALLEL_SCATTER_H
+#define HALIDE_PARALLEL_SCATTER_H
+
+/** \file
+ * Defines the lowering pass that makes parallel updates that scatter
+ * into data-dependent sites race-free.
+ */
+
+#include <map>
+
+#include "IR.h"
+
+namespace Halide {
+namespace Internal {
+
+/** Take a statement with parallel for loops marked as scattering by
+ * the schedules of the functions in the environment, and either give
+ * each iteration a private copy of the function being updated, which
+ * is combined into the function once the loop is done, or rewrite
+ * the updates to use atomic read-modify-write operations. */
+Stmt parallel_scatter(Stmt s, const std::map<std::string, Function> &env);
+
+}
+}
+
+#endif
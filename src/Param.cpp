@@ -1,4 +1,5 @@
 #include "Param.h"
+#include "IROperator.h"
 
 
 namespace Halide {
@@ -75,6 +76,27 @@ OutputImageParam &OutputImageParam::set_bounds(int dim, Expr min, Expr extent) {
     return set_min(dim, min).set_extent(dim, extent);
 }
 
+OutputImageParam &OutputImageParam::set_host_alignment(int bytes) {
+    param.set_host_alignment(bytes);
+    return *this;
+}
+
+OutputImageParam &OutputImageParam::set_stride_multiple(int dim, int multiple) {
+    user_assert(multiple > 0) << "Stride multiple must be positive\n";
+    Expr s = stride(dim);
+    return set_stride(dim, ((s + (multiple - 1)) / multiple) * multiple);
+}
+
+OutputImageParam &OutputImageParam::set_min_multiple(int dim, int multiple) {
+    user_assert(multiple > 0) << "Min multiple must be positive\n";
+    Expr m = min(dim);
+    Expr rounded = (m / multiple) * multiple;
+    if (!param.extent_constraint(dim).defined()) {
+        set_extent(dim, extent(dim) + (m - rounded));
+    }
+    return set_min(dim, rounded);
+}
+
 int OutputImageParam::dimensions() const {
     return dims;
 }
@@ -119,7 +141,9 @@ Internal::Parameter OutputImageParam::parameter() const {
 }
 
 OutputImageParam::operator Argument() const {
-    return Argument(name(), true, type());
+    Argument arg(name(), true, type());
+    arg.host_alignment = param.host_alignment();
+    return arg;
 }
 
 OutputImageParam::operator ExternFuncArgument() const {
@@ -198,6 +198,32 @@ public:
     /** Set the min and extent in one call. */
     EXPORT OutputImageParam &set_bounds(int dim, Expr min, Expr extent);
 
+    /** Promise that the host pointer of images passed in is aligned
+     * to the given number of bytes, which must be a power of
+     * two. Together with strides and mins that are multiples of the
+     * vector width, this lets vector loads and stores of this image
+     * be aligned. The promise is checked once on entry to the
+     * pipeline. */
+    EXPORT OutputImageParam &set_host_alignment(int bytes);
+
+    /** Require the stride in a given dimension to be a multiple of
+     * the given number of elements. This replaces any other
+     * constraint on the stride. When querying bounds, the proposed
+     * stride is rounded up to a multiple. E.g. to make each row of an
+     * 8-bit image start on a 16-byte boundary:
+     \code
+     im.set_host_alignment(16).set_stride_multiple(1, 16);
+     \endcode
+     */
+    EXPORT OutputImageParam &set_stride_multiple(int dim, int multiple);
+
+    /** Require the min in a given dimension to be a multiple of the
+     * given number. This replaces any other constraint on the
+     * min. When querying bounds, the proposed min is rounded down to
+     * a multiple, and if the extent is unconstrained, the proposed
+     * extent grows to compensate. */
+    EXPORT OutputImageParam &set_min_multiple(int dim, int multiple);
+
     /** Get the dimensionality of this image parameter */
     EXPORT int dimensions() const;
 
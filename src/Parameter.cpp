@@ -15,7 +15,8 @@ struct ParameterContents {
     Expr extent_constraint[4];
     Expr stride_constraint[4];
     Expr min_value, max_value;
-    ParameterContents(Type t, bool b, const std::string &n) : type(t), is_buffer(b), name(n), buffer(Buffer()), data(0) {
+    int host_alignment;
+    ParameterContents(Type t, bool b, const std::string &n) : type(t), is_buffer(b), name(n), buffer(Buffer()), data(0), host_alignment(0) {
         // stride_constraint[0] defaults to 1. This is important for
         // dense vectorization. You can unset it by setting it to a
         // null expression. (param.set_stride(0, Expr());)
@@ -137,6 +138,19 @@ Expr Parameter::stride_constraint(int dim) const {
     return contents.ptr->stride_constraint[dim];
 }
 
+void Parameter::set_host_alignment(int bytes) {
+    check_is_buffer();
+    user_assert(bytes >= 0 && (bytes & (bytes - 1)) == 0)
+        << "Can't promise that the host pointer of " << name()
+        << " is aligned to " << bytes << " bytes, because that isn't a power of two\n";
+    contents.ptr->host_alignment = bytes;
+}
+
+int Parameter::host_alignment() const {
+    check_is_buffer();
+    return contents.ptr->host_alignment;
+}
+
 void Parameter::set_min_value(Expr e) {
     check_is_scalar();
     user_assert(e.type() == contents.ptr->type)
@@ -97,6 +97,14 @@ public:
     EXPORT Expr stride_constraint(int dim) const;
     //@}
 
+    /** Get and set the alignment in bytes promised for the host
+     * pointer of a buffer parameter. Zero means nothing is
+     * promised. (see OutputImageParam::set_host_alignment) */
+    //@{
+    EXPORT void set_host_alignment(int bytes);
+    EXPORT int host_alignment() const;
+    //@}
+
     /** Get and set constraints for scalar parameters. These are used
      * directly by Param, so they must be exported. */
     // @{
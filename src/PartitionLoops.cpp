@@ -0,0 +1,554 @@
+#include "PartitionLoops.h"
+#include "IRMutator.h"
+#include "IROperator.h"
+#include "Bounds.h"
+#include "ExprUsesVar.h"
+#include "Substitute.h"
+#include "Simplify.h"
+#include "Scope.h"
+#include "CodeGen_GPU_Dev.h"
+
+namespace Halide {
+namespace Internal {
+
+using std::string;
+using std::vector;
+using std::map;
+
+namespace {
+
+bool is_likely(Expr e) {
+    const Call *c = e.as<Call>();
+    return c && c->call_type == Call::Intrinsic && c->name == Call::likely;
+}
+
+Expr strip_likely(Expr e) {
+    if (is_likely(e)) {
+        return e.as<Call>()->args[0];
+    }
+    return e;
+}
+
+// Write e as coeff * var + rest, where rest doesn't depend on
+// var. Returns false if e isn't of that form.
+bool linear_in(Expr e, const string &var, int *coeff, Expr *rest) {
+    if (!expr_uses_var(e, var)) {
+        *coeff = 0;
+        *rest = e;
+        return true;
+    }
+
+    int ca, cb;
+    Expr ra, rb;
+    if (e.as<Variable>()) {
+        *coeff = 1;
+        *rest = make_zero(e.type());
+        return true;
+    } else if (const Add *add = e.as<Add>()) {
+        if (!linear_in(add->a, var, &ca, &ra) ||
+            !linear_in(add->b, var, &cb, &rb)) return false;
+        *coeff = ca + cb;
+        *rest = ra + rb;
+        return true;
+    } else if (const Sub *sub = e.as<Sub>()) {
+        if (!linear_in(sub->a, var, &ca, &ra) ||
+            !linear_in(sub->b, var, &cb, &rb)) return false;
+        *coeff = ca - cb;
+        *rest = ra - rb;
+        return true;
+    } else if (const Mul *mul = e.as<Mul>()) {
+        const int *k = as_const_int(mul->b);
+        if (!k || !linear_in(mul->a, var, &ca, &ra)) return false;
+        *coeff = ca * (*k);
+        *rest = ra * (*k);
+        return true;
+    }
+    return false;
+}
+
+// A way to simplify an expression or statement in the steady state
+// of a loop, and the range of the loop variable over which it holds.
+struct Simplification {
+    bool ok;
+    // Lower and upper bounds on the loop variable.
+    vector<Expr> mins, maxs;
+    Expr expr_replacement;
+    Stmt stmt_replacement;
+};
+
+// Apply the simplifications found to the body of a loop, to make the
+// steady state. Also collects the ranges of the loop variable over
+// which the simplifications applied are valid.
+class MakeSteadyState : public IRMutator {
+    using IRMutator::visit;
+
+    const map<const IRNode *, Simplification> &simplifications;
+
+    bool replace(const IRNode *op) {
+        map<const IRNode *, Simplification>::const_iterator iter = simplifications.find(op);
+        if (iter == simplifications.end() || !iter->second.ok) {
+            return false;
+        }
+        const Simplification &s = iter->second;
+        mins.insert(mins.end(), s.mins.begin(), s.mins.end());
+        maxs.insert(maxs.end(), s.maxs.begin(), s.maxs.end());
+        if (iter->second.expr_replacement.defined()) {
+            // The steady state doesn't need the likely any more, and
+            // it would hide the value from the mins and maxes around
+            // it, e.g. the clamp around the select in a boundary
+            // condition.
+            expr = mutate(strip_likely(iter->second.expr_replacement));
+        } else {
+            stmt = mutate(iter->second.stmt_replacement);
+        }
+        return true;
+    }
+
+    void visit(const Min *op) {
+        if (!replace(op)) IRMutator::visit(op);
+    }
+
+    void visit(const Max *op) {
+        if (!replace(op)) IRMutator::visit(op);
+    }
+
+    void visit(const Select *op) {
+        if (!replace(op)) IRMutator::visit(op);
+    }
+
+    void visit(const IfThenElse *op) {
+        if (!replace(op)) IRMutator::visit(op);
+    }
+
+public:
+    vector<Expr> mins, maxs;
+
+    MakeSteadyState(const map<const IRNode *, Simplification> &s) : simplifications(s) {}
+};
+
+// Find the mins, maxes, selects, and ifs in the body of a loop that
+// simplify for some range of the loop variable.
+class FindSimplifications : public IRVisitor {
+    using IRVisitor::visit;
+
+    string loop_var;
+
+    // Lets inside the loop that depend on the loop variable, and
+    // their values in terms of it.
+    Scope<Expr> expanded;
+
+    // The bounds of the other variables defined inside the loop.
+    Scope<Interval> bounds;
+
+    // Everything defined inside the loop.
+    Scope<int> inner;
+
+    // How many load or store indices, or call arguments, we're
+    // inside of. Mins and maxes there are boundary conditions, like
+    // clamping a coordinate to an image. Elsewhere they're more
+    // likely part of the computation, and don't go away near the
+    // middle of the loop.
+    int in_index;
+
+    Expr expand(Expr e) {
+        for (Scope<Expr>::iterator iter = expanded.begin(); iter != expanded.end(); ++iter) {
+            e = substitute(iter.name(), iter.value(), e);
+        }
+        return e;
+    }
+
+    // Find the range of the loop variable over which d <= 0 for all
+    // values of the variables defined inside the loop.
+    bool constrain(Expr d, vector<Expr> &mins, vector<Expr> &maxs) {
+        d = expand(d);
+        if (d.type() != Int(32)) return false;
+
+        int coeff;
+        Expr rest;
+        if (!linear_in(d, loop_var, &coeff, &rest) || coeff == 0) return false;
+
+        Expr r = bounds_of_expr_in_scope(rest, bounds).max;
+        if (!r.defined() ||
+            expr_uses_var(r, loop_var) ||
+            expr_uses_vars(r, inner)) {
+            return false;
+        }
+
+        if (coeff > 0) {
+            // coeff * v + r <= 0 when v <= floor(-r / coeff)
+            maxs.push_back(simplify((-r) / coeff));
+        } else {
+            // -k * v + r <= 0 when v >= ceil(r / k)
+            int k = -coeff;
+            mins.push_back(simplify((r + (k - 1)) / k));
+        }
+        return true;
+    }
+
+    // Find the range of the loop variable over which a condition
+    // has the given value.
+    bool require(Expr cond, bool value, vector<Expr> &mins, vector<Expr> &maxs) {
+        if (is_likely(cond)) {
+            return require(strip_likely(cond), value, mins, maxs);
+        } else if (const And *a = cond.as<And>()) {
+            return (value &&
+                    require(a->a, true, mins, maxs) &&
+                    require(a->b, true, mins, maxs));
+        } else if (const Or *o = cond.as<Or>()) {
+            return (!value &&
+                    require(o->a, false, mins, maxs) &&
+                    require(o->b, false, mins, maxs));
+        } else if (const Not *n = cond.as<Not>()) {
+            return require(n->a, !value, mins, maxs);
+        } else if (const LT *lt = cond.as<LT>()) {
+            return (value ?
+                    constrain(lt->a - lt->b + 1, mins, maxs) :
+                    constrain(lt->b - lt->a, mins, maxs));
+        } else if (const LE *le = cond.as<LE>()) {
+            return (value ?
+                    constrain(le->a - le->b, mins, maxs) :
+                    constrain(le->b - le->a + 1, mins, maxs));
+        } else if (const GT *gt = cond.as<GT>()) {
+            return require(gt->b < gt->a, value, mins, maxs);
+        } else if (const GE *ge = cond.as<GE>()) {
+            return require(ge->b <= ge->a, value, mins, maxs);
+        }
+        return false;
+    }
+
+    void record(const IRNode *op, bool ok, const vector<Expr> &mins, const vector<Expr> &maxs,
+                Expr expr_replacement, Stmt stmt_replacement) {
+        map<const IRNode *, Simplification>::iterator iter = simplifications.find(op);
+        if (iter == simplifications.end()) {
+            Simplification s;
+            s.ok = ok;
+            s.expr_replacement = expr_replacement;
+            s.stmt_replacement = stmt_replacement;
+            iter = simplifications.insert(std::make_pair(op, s)).first;
+        } else {
+            iter->second.ok = iter->second.ok && ok;
+        }
+        Simplification &s = iter->second;
+        s.mins.insert(s.mins.end(), mins.begin(), mins.end());
+        s.maxs.insert(s.maxs.end(), maxs.begin(), maxs.end());
+    }
+
+    void visit_min_or_max(const IRNode *op, Expr a, Expr b, bool is_min) {
+        // The steady state takes the side marked as likely, or else
+        // the side that depends on the loop variable. E.g. for
+        // clamp(x, 0, w-1), the steady state is the interior.
+        Expr preferred, other;
+        if (is_likely(a)) {
+            preferred = a;
+            other = b;
+        } else if (is_likely(b)) {
+            preferred = b;
+            other = a;
+        } else if (in_index == 0) {
+            return;
+        } else {
+            bool a_varies = expr_uses_var(expand(a), loop_var);
+            bool b_varies = expr_uses_var(expand(b), loop_var);
+            if (a_varies && !b_varies) {
+                preferred = a;
+                other = b;
+            } else if (b_varies && !a_varies) {
+                preferred = b;
+                other = a;
+            } else {
+                return;
+            }
+        }
+
+        // Use the steady state of each side, so that e.g. a clamp
+        // of a select that is likely to be its first argument can
+        // simplify too. This is only valid where the
+        // simplifications inside hold as well.
+        MakeSteadyState steady(simplifications);
+        Expr p = steady.mutate(strip_likely(preferred));
+        Expr o = steady.mutate(strip_likely(other));
+        vector<Expr> mins = steady.mins, maxs = steady.maxs;
+        bool ok = constrain(is_min ? p - o : o - p, mins, maxs);
+        record(op, ok, mins, maxs, preferred, Stmt());
+    }
+
+    void visit(const Load *op) {
+        in_index++;
+        IRVisitor::visit(op);
+        in_index--;
+    }
+
+    void visit(const Store *op) {
+        op->value.accept(this);
+        in_index++;
+        op->index.accept(this);
+        in_index--;
+    }
+
+    void visit(const Call *op) {
+        bool access = (op->call_type == Call::Halide || op->call_type == Call::Image);
+        if (access) in_index++;
+        IRVisitor::visit(op);
+        if (access) in_index--;
+    }
+
+    void visit(const Min *op) {
+        IRVisitor::visit(op);
+        visit_min_or_max(op, op->a, op->b, true);
+    }
+
+    void visit(const Max *op) {
+        IRVisitor::visit(op);
+        visit_min_or_max(op, op->a, op->b, false);
+    }
+
+    void visit(const Select *op) {
+        IRVisitor::visit(op);
+
+        bool value;
+        Expr replacement;
+        if (is_likely(op->condition) || is_likely(op->true_value)) {
+            value = true;
+            replacement = op->true_value;
+        } else if (is_likely(op->false_value)) {
+            value = false;
+            replacement = op->false_value;
+        } else {
+            return;
+        }
+
+        vector<Expr> mins, maxs;
+        bool ok = require(op->condition, value, mins, maxs);
+        record(op, ok, mins, maxs, replacement, Stmt());
+    }
+
+    void visit(const IfThenElse *op) {
+        IRVisitor::visit(op);
+
+        if (!is_likely(op->condition)) return;
+
+        vector<Expr> mins, maxs;
+        bool ok = require(op->condition, true, mins, maxs);
+        record(op, ok, mins, maxs, Expr(), op->then_case);
+    }
+
+    template<typename LetOrLetStmt>
+    void visit_let(const LetOrLetStmt *op) {
+        op->value.accept(this);
+
+        Expr value = expand(op->value);
+        bool varies = expr_uses_var(value, loop_var);
+        if (varies) {
+            expanded.push(op->name, value);
+        } else {
+            bounds.push(op->name, bounds_of_expr_in_scope(op->value, bounds));
+        }
+        inner.push(op->name, 0);
+
+        op->body.accept(this);
+
+        inner.pop(op->name);
+        if (varies) {
+            expanded.pop(op->name);
+        } else {
+            bounds.pop(op->name);
+        }
+    }
+
+    void visit(const Let *op) {
+        visit_let(op);
+    }
+
+    void visit(const LetStmt *op) {
+        visit_let(op);
+    }
+
+    void visit(const For *op) {
+        op->min.accept(this);
+        op->extent.accept(this);
+
+        // Inner loops with bounds that depend on the loop variable
+        // are unbounded as far as we're concerned.
+        Interval i;
+        if (!expr_uses_var(expand(op->min), loop_var) &&
+            !expr_uses_var(expand(op->extent), loop_var)) {
+            i.min = bounds_of_expr_in_scope(op->min, bounds).min;
+            i.max = bounds_of_expr_in_scope(op->min + op->extent - 1, bounds).max;
+        }
+        bounds.push(op->name, i);
+        inner.push(op->name, 0);
+
+        op->body.accept(this);
+
+        inner.pop(op->name);
+        bounds.pop(op->name);
+    }
+
+public:
+    map<const IRNode *, Simplification> simplifications;
+
+    FindSimplifications(const string &v) : loop_var(v), in_index(0) {}
+};
+
+// Give the loops in a copy of a loop body their own names, by adding
+// a tag to them. GPU loops keep their names, which say what they're
+// bound to.
+class RenameLoops : public IRMutator {
+    using IRMutator::visit;
+
+    const string &tag;
+
+    void visit(const For *op) {
+        if (CodeGen_GPU_Dev::is_gpu_var(op->name)) {
+            IRMutator::visit(op);
+            return;
+        }
+        string name = op->name + "." + tag;
+        Stmt body = substitute(op->name, Variable::make(Int(32), name), mutate(op->body));
+        stmt = For::make(name, mutate(op->min), mutate(op->extent), op->for_type, body);
+    }
+
+public:
+    RenameLoops(const string &t) : tag(t) {}
+};
+
+// Each partitioned loop has up to three copies of its body, so
+// partitioning nested loops multiplies the code size. Only partition
+// this many levels of a loop nest, starting from the innermost.
+const int max_partition_depth = 2;
+
+class PartitionLoops : public IRMutator {
+    using IRMutator::visit;
+
+    // GPU kernels need their loop nests left as they are.
+    bool in_gpu_loop;
+
+    // The most levels of partitioned loops nested within the last
+    // statement mutated.
+    int depth;
+
+    // Make a copy of a loop over part of the range of the original,
+    // with its own name. The loops inside get their own names too,
+    // e.g. the loop over f.s0.x inside the prologue of the loop over
+    // f.s0.y becomes f.s0.x.y_prologue.
+    Stmt make_part(const For *op, const string &suffix, Expr min, Expr extent, Stmt body) {
+        string name = op->name + "." + suffix;
+        body = substitute(op->name, Variable::make(Int(32), name), body);
+        size_t dot = op->name.rfind('.');
+        string var = dot == string::npos ? op->name : op->name.substr(dot + 1);
+        body = RenameLoops(var + "_" + suffix).mutate(body);
+        return For::make(name, min, extent, op->for_type, body);
+    }
+
+    void visit(const For *op) {
+        bool old_in_gpu_loop = in_gpu_loop;
+        bool is_gpu_loop = CodeGen_GPU_Dev::is_gpu_var(op->name);
+        in_gpu_loop = in_gpu_loop || is_gpu_loop;
+        int old_depth = depth;
+        depth = 0;
+        Stmt body = mutate(op->body);
+        int inner_depth = depth;
+        depth = std::max(old_depth, inner_depth);
+        in_gpu_loop = old_in_gpu_loop;
+
+        if (in_gpu_loop || is_gpu_loop ||
+            inner_depth >= max_partition_depth ||
+            (op->for_type != For::Serial && op->for_type != For::Parallel)) {
+            if (body.same_as(op->body)) {
+                stmt = op;
+            } else {
+                stmt = For::make(op->name, op->min, op->extent, op->for_type, body);
+            }
+            return;
+        }
+
+        FindSimplifications finder(op->name);
+        body.accept(&finder);
+
+        vector<Expr> mins, maxs;
+        bool any = false;
+        for (map<const IRNode *, Simplification>::iterator iter = finder.simplifications.begin();
+             iter != finder.simplifications.end(); ++iter) {
+            const Simplification &s = iter->second;
+            if (!s.ok) continue;
+            any = true;
+            mins.insert(mins.end(), s.mins.begin(), s.mins.end());
+            maxs.insert(maxs.end(), s.maxs.begin(), s.maxs.end());
+        }
+
+        if (!any) {
+            if (body.same_as(op->body)) {
+                stmt = op;
+            } else {
+                stmt = For::make(op->name, op->min, op->extent, op->for_type, body);
+            }
+            return;
+        }
+
+        debug(3) << "Partitioning loop over " << op->name << "\n";
+        depth = std::max(old_depth, inner_depth + 1);
+
+        Stmt steady = MakeSteadyState(finder.simplifications).mutate(body);
+
+        // The steady state runs from the last of the lower bounds to
+        // the first of the upper bounds, clamped to the loop.
+        Expr loop_end = op->min + op->extent;
+        Expr prologue_end = op->min;
+        for (size_t i = 0; i < mins.size(); i++) {
+            prologue_end = Max::make(prologue_end, mins[i]);
+        }
+        prologue_end = Min::make(prologue_end, loop_end);
+
+        string prologue_end_name = op->name + ".prologue_end";
+        string epilogue_start_name = op->name + ".epilogue_start";
+        Expr prologue_end_var = Variable::make(Int(32), prologue_end_name);
+        Expr epilogue_start_var = Variable::make(Int(32), epilogue_start_name);
+
+        Expr epilogue_start = loop_end;
+        for (size_t i = 0; i < maxs.size(); i++) {
+            epilogue_start = Min::make(epilogue_start, maxs[i] + 1);
+        }
+        epilogue_start = Max::make(epilogue_start, prologue_end_var);
+
+        Stmt s = For::make(op->name, prologue_end_var, epilogue_start_var - prologue_end_var,
+                           op->for_type, steady);
+        if (!mins.empty()) {
+            Stmt prologue = make_part(op, "prologue", op->min, prologue_end_var - op->min, body);
+            s = Block::make(prologue, s);
+        }
+        if (!maxs.empty()) {
+            Stmt epilogue = make_part(op, "epilogue", epilogue_start_var,
+                                      loop_end - epilogue_start_var, body);
+            s = Block::make(s, epilogue);
+        }
+        s = LetStmt::make(epilogue_start_name, simplify(epilogue_start), s);
+        s = LetStmt::make(prologue_end_name, simplify(prologue_end), s);
+        stmt = s;
+    }
+
+public:
+    PartitionLoops() : in_gpu_loop(false), depth(0) {}
+};
+
+class StripLikely : public IRMutator {
+    using IRMutator::visit;
+
+    void visit(const Call *op) {
+        if (op->call_type == Call::Intrinsic && op->name == Call::likely) {
+            expr = mutate(op->args[0]);
+        } else {
+            IRMutator::visit(op);
+        }
+    }
+};
+
+}
+
+Stmt partition_loops(Stmt s) {
+    s = PartitionLoops().mutate(s);
+    s = StripLikely().mutate(s);
+    return s;
+}
+
+}
+}
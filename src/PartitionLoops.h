@@ -0,0 +1,26 @@
+#ifndef HALIDE_PARTITION_LOOPS_H
+#define HALIDE_PARTITION_LOOPS_H
+
+/** \file
+ * Defines a lowering pass that partitions loop bodies into three
+ * to handle boundary conditions: A prologue, a simplified
+ * steady-state, and an epilogue.
+ */
+
+#include "IR.h"
+
+namespace Halide {
+namespace Internal {
+
+/** Partitions serial and parallel loops into a prologue, a steady
+ * state, and an epilogue. Clamps that depend linearly on the loop
+ * variable, and selects, ifs, mins, and maxes marked with likely, are
+ * replaced by the value they take in the steady state. Removes all
+ * calls to likely. Should be run before vectorization, so that the
+ * loads in the steady state become dense vector loads. */
+Stmt partition_loops(Stmt s);
+
+}
+}
+
+#endif
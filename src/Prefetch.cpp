@@ -0,0 +1,194 @@
+#include "Prefetch.h"
+#include "IRMutator.h"
+#include "IROperator.h"
+#include "Bounds.h"
+#include "Simplify.h"
+#include "Substitute.h"
+#include "Function.h"
+
+namespace Halide {
+namespace Internal {
+
+using std::map;
+using std::string;
+using std::vector;
+
+namespace {
+
+// Find a call to the named function or image, to use as a template
+// for the calls that prefetch it.
+class FindCall : public IRVisitor {
+    const string &name;
+
+    using IRVisitor::visit;
+
+    void visit(const Call *op) {
+        IRVisitor::visit(op);
+        if (!call && op->name == name &&
+            (op->call_type == Call::Halide || op->call_type == Call::Image)) {
+            call = op;
+        }
+    }
+public:
+    const Call *call;
+    FindCall(const string &n) : name(n), call(NULL) {}
+};
+
+// Is the named function realized within a statement?
+class FindRealize : public IRVisitor {
+    const string &name;
+
+    using IRVisitor::visit;
+
+    void visit(const Realize *op) {
+        IRVisitor::visit(op);
+        if (op->name == name) {
+            found = true;
+        }
+    }
+public:
+    bool found;
+    FindRealize(const string &n) : name(n), found(false) {}
+};
+
+class InjectPrefetches : public IRMutator {
+    const map<string, vector<Prefetch> > &prefetches;
+
+    using IRMutator::visit;
+
+    // Make a stmt that prefetches a box of the function or image
+    // called by a call node, one cache line at a time.
+    Stmt prefetch_box(const Call *call, const Box &box) {
+        const int cache_line = 64;
+        int elems_per_line = std::max(1, cache_line / call->type.bytes());
+
+        vector<string> vars(box.size());
+        vector<Expr> args(box.size());
+        for (size_t i = 0; i < box.size(); i++) {
+            vars[i] = call->name + ".prefetch." + int_to_string(i);
+            args[i] = Variable::make(Int(32), vars[i]);
+        }
+        if (!args.empty()) {
+            args[0] = box[0].min + args[0] * elems_per_line;
+        }
+
+        Expr site = Call::make(call->type, call->name, args, call->call_type,
+                               call->func, call->value_index, call->image, call->param);
+        Stmt s = Evaluate::make(Call::make(Int(32), Call::prefetch, vec(site), Call::Intrinsic));
+
+        for (size_t i = 0; i < box.size(); i++) {
+            Expr min = box[i].min, extent = box[i].max - box[i].min + 1;
+            if (i == 0) {
+                min = 0;
+                extent = (extent + elems_per_line - 1) / elems_per_line;
+            }
+            s = For::make(vars[i], simplify(min), simplify(extent), For::Serial, s);
+        }
+        return s;
+    }
+
+    void visit(const For *op) {
+        Stmt body = mutate(op->body);
+
+        map<string, vector<Prefetch> >::const_iterator iter = prefetches.find(op->name);
+        if (iter == prefetches.end()) {
+            if (body.same_as(op->body)) {
+                stmt = op;
+            } else {
+                stmt = For::make(op->name, op->min, op->extent, op->for_type, body);
+            }
+            return;
+        }
+
+        user_assert(op->for_type != For::Vectorized)
+            << "Can't prefetch within the vectorized loop " << op->name << "\n";
+
+        Stmt prefetch;
+        for (size_t i = 0; i < iter->second.size(); i++) {
+            const Prefetch &p = iter->second[i];
+
+            // A function computed within the loop doesn't exist yet
+            // for the later iterations. The things it reads can still
+            // be prefetched, because the region of them needed
+            // includes what it reads.
+            FindRealize realize(p.name);
+            op->body.accept(&realize);
+            user_assert(!realize.found)
+                << "Can't prefetch " << p.name << " within " << op->name
+                << ", because " << p.name << " is computed within that loop. "
+                << "Prefetch the functions or images it reads instead.\n";
+
+            FindCall find(p.name);
+            op->body.accept(&find);
+            if (!find.call) {
+                user_warning << "Warning: Not prefetching " << p.name << " within "
+                             << op->name << ", because it isn't used there.\n";
+                continue;
+            }
+
+            Box box = box_required(op->body, p.name);
+            bool bounded = true;
+            for (size_t j = 0; j < box.size(); j++) {
+                bounded = bounded && box[j].min.defined() && box[j].max.defined();
+            }
+            if (!bounded) {
+                user_warning << "Warning: Not prefetching " << p.name << " within "
+                             << op->name << ", because the region of it needed is unbounded.\n";
+                continue;
+            }
+
+            // Prefetch the region needed distance iterations from now.
+            Expr ahead = Variable::make(Int(32), op->name) + p.distance;
+            for (size_t j = 0; j < box.size(); j++) {
+                box[j].min = substitute(op->name, ahead, box[j].min);
+                box[j].max = substitute(op->name, ahead, box[j].max);
+            }
+
+            Stmt s = prefetch_box(find.call, box);
+            prefetch = prefetch.defined() ? Block::make(prefetch, s) : s;
+        }
+
+        if (prefetch.defined()) {
+            body = Block::make(prefetch, body);
+        }
+        stmt = For::make(op->name, op->min, op->extent, op->for_type, body);
+    }
+
+public:
+    InjectPrefetches(const map<string, vector<Prefetch> > &p) : prefetches(p) {}
+};
+
+void find_prefetches(const string &prefix, const Schedule &s,
+                     map<string, vector<Prefetch> > *prefetches) {
+    for (size_t i = 0; i < s.prefetches().size(); i++) {
+        const Prefetch &p = s.prefetches()[i];
+        (*prefetches)[prefix + p.var].push_back(p);
+    }
+    for (size_t i = 0; i < s.specializations().size(); i++) {
+        find_prefetches(prefix, s.specializations()[i].schedule, prefetches);
+    }
+}
+
+}
+
+Stmt inject_prefetches(Stmt s, const map<string, Function> &env) {
+    map<string, vector<Prefetch> > prefetches;
+    for (map<string, Function>::const_iterator iter = env.begin();
+         iter != env.end(); ++iter) {
+        const Function &f = iter->second;
+        find_prefetches(f.name() + ".s0.", f.schedule(), &prefetches);
+        for (size_t i = 0; i < f.reductions().size(); i++) {
+            find_prefetches(f.name() + ".s" + int_to_string(i+1) + ".",
+                            f.reductions()[i].schedule, &prefetches);
+        }
+    }
+
+    if (prefetches.empty()) {
+        return s;
+    }
+
+    return InjectPrefetches(prefetches).mutate(s);
+}
+
+}
+}
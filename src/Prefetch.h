@@ -0,0 +1,25 @@
+#ifndef HALIDE_PREFETCH_H
+#define HALIDE_PREFETCH_H
+
+/** \file
+ * Defines the lowering pass that injects software prefetches
+ */
+
+#include <map>
+
+#include "IR.h"
+
+namespace Halide {
+namespace Internal {
+
+/** Inject prefetches of the regions of functions and images that
+ * later iterations of loops will need, as requested by the
+ * schedules of the functions in the environment. Should be run after
+ * bounds inference, so that the prefetches don't expand the regions
+ * that get computed, and before storage flattening. */
+Stmt inject_prefetches(Stmt s, const std::map<std::string, Function> &env);
+
+}
+}
+
+#endif
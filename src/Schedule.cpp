@@ -10,15 +10,21 @@ namespace Internal {
 struct ScheduleContents {
     mutable RefCount ref_count;
 
-    LoopLevel store_level, compute_level;
+    LoopLevel store_level, compute_level, fuse_level;
     std::vector<Split> splits;
     std::vector<Dim> dims;
     std::vector<std::string> storage_dims;
     std::vector<Bound> bounds;
+    std::vector<FoldedDim> folded_dims;
+    std::vector<InterleavedAccumulator> interleaved_accumulators;
+    std::vector<ParallelScatter> parallel_scatters;
+    std::vector<Prefetch> prefetches;
     std::vector<Specialization> specializations;
     bool touched;
+    bool async;
+    bool reassociate_floats;
 
-    ScheduleContents() : touched(false) {};
+    ScheduleContents() : touched(false), async(false), reassociate_floats(false) {};
 };
 
 
@@ -42,6 +48,22 @@ bool Schedule::touched() const {
     return contents.ptr->touched;
 }
 
+bool &Schedule::async() {
+    return contents.ptr->async;
+}
+
+bool Schedule::async() const {
+    return contents.ptr->async;
+}
+
+bool &Schedule::reassociate_floats() {
+    return contents.ptr->reassociate_floats;
+}
+
+bool Schedule::reassociate_floats() const {
+    return contents.ptr->reassociate_floats;
+}
+
 const std::vector<Split> &Schedule::splits() const {
     return contents.ptr->splits;
 }
@@ -74,6 +96,38 @@ const std::vector<Bound> &Schedule::bounds() const {
     return contents.ptr->bounds;
 }
 
+std::vector<FoldedDim> &Schedule::folded_dims() {
+    return contents.ptr->folded_dims;
+}
+
+const std::vector<FoldedDim> &Schedule::folded_dims() const {
+    return contents.ptr->folded_dims;
+}
+
+std::vector<InterleavedAccumulator> &Schedule::interleaved_accumulators() {
+    return contents.ptr->interleaved_accumulators;
+}
+
+const std::vector<InterleavedAccumulator> &Schedule::interleaved_accumulators() const {
+    return contents.ptr->interleaved_accumulators;
+}
+
+std::vector<ParallelScatter> &Schedule::parallel_scatters() {
+    return contents.ptr->parallel_scatters;
+}
+
+const std::vector<ParallelScatter> &Schedule::parallel_scatters() const {
+    return contents.ptr->parallel_scatters;
+}
+
+std::vector<Prefetch> &Schedule::prefetches() {
+    return contents.ptr->prefetches;
+}
+
+const std::vector<Prefetch> &Schedule::prefetches() const {
+    return contents.ptr->prefetches;
+}
+
 const std::vector<Specialization> &Schedule::specializations() const {
     return contents.ptr->specializations;
 }
@@ -106,6 +160,14 @@ const LoopLevel &Schedule::compute_level() const {
     return contents.ptr->compute_level;
 }
 
+LoopLevel &Schedule::fuse_level() {
+    return contents.ptr->fuse_level;
+}
+
+const LoopLevel &Schedule::fuse_level() const {
+    return contents.ptr->fuse_level;
+}
+
 
 }
 }
@@ -10,6 +10,54 @@
 #include <vector>
 
 namespace Halide {
+
+/** Different ways to handle a split whose factor doesn't divide the
+ * extent of the dimension being split. See \ref Func::split */
+enum TailStrategy {
+    /** Shift the last tile inward for pure definitions, round up for
+     * the pure variables of updates, and guard with an if for
+     * reduction variables. */
+    TailStrategy_Auto = 0,
+
+    /** Shift the last iteration of the outer loop inward, so that it
+     * overlaps the previous one and recomputes some values. Keeps
+     * the inner loop free of conditions, but requires the extent to
+     * be at least the split factor, and can't be used for updates,
+     * which aren't safe to recompute. */
+    TailStrategy_ShiftInward,
+
+    /** Wrap the body in an if that skips the points beyond the
+     * end. Works for any definition and extent. If the inner
+     * dimension is vectorized, the full vectors are computed as
+     * vectors and only the last one is computed a lane at a time. */
+    TailStrategy_GuardWithIf,
+
+    /** Round the extent up to a multiple of the split factor and
+     * compute the extra points. Internal allocations are padded to
+     * fit. An output buffer or input image must already be large
+     * enough, so this is best used when the caller pads their
+     * buffers. Can't be used for reduction variables. */
+    TailStrategy_RoundUp
+};
+
+/** Different orders in which to traverse two dimensions fused into
+ * one. See \ref Func::fuse */
+enum TileOrder {
+    /** Traverse the inner dimension for each value of the outer
+     * one. This is the default. */
+    TileOrder_RowMajor = 0,
+
+    /** Traverse a Morton (Z-order) curve, which visits the squares of
+     * each power-of-two size one at a time, so neighboring iterations
+     * tend to be neighbors in both dimensions. Cheap to decode. */
+    TileOrder_Morton,
+
+    /** Traverse a Hilbert curve, which, unlike the Morton curve,
+     * only ever steps to an adjacent point. Has somewhat better
+     * locality than Morton order, but costs more to decode. */
+    TileOrder_Hilbert
+};
+
 namespace Internal {
 
 /** A reference to a site in a Halide statement at the top of the
@@ -78,6 +126,20 @@ struct Split {
     // split, it joins the outer and inner into the old_var.
     SplitType split_type;
 
+    // What to do when the factor doesn't divide the extent of the
+    // old_var. Only meaningful for splits.
+    TailStrategy tail;
+
+    // The order in which to traverse the inner and outer
+    // dimensions. Only meaningful for fuses.
+    TileOrder order;
+
+    // If true, factor is the number of iterations of the outer loop
+    // instead of the extent of the inner one, and the inner extent
+    // is derived from the extent of the old_var during
+    // lowering. Only meaningful for splits.
+    bool by_count;
+
     bool is_rename() const {return split_type == RenameVar;}
     bool is_split() const {return split_type == SplitVar;}
     bool is_fuse() const {return split_type == FuseVars;}
@@ -93,6 +155,39 @@ struct Bound {
     Expr min, extent;
 };
 
+/** An unrolled dimension of an update whose iterations should each
+ * accumulate into their own partial result. */
+struct InterleavedAccumulator {
+    std::string var;
+    // Whether floating point sums and products may be reassociated.
+    bool reassociate_floats;
+};
+
+/** A parallel dimension of an update that scatters into
+ * data-dependent sites, and so must avoid races between the
+ * iterations. */
+struct ParallelScatter {
+    std::string var;
+    // Whether to use atomic read-modify-write operations instead of
+    // a private copy of the output per iteration.
+    bool atomic;
+};
+
+/** A request to prefetch the region of a function or image that
+ * an iteration of a loop will need some number of iterations
+ * later. */
+struct Prefetch {
+    std::string name, var;
+    Expr distance;
+};
+
+/** A dimension of the storage of a function that is folded down to
+ * a circular buffer of the given extent. See \ref Func::fold_storage */
+struct FoldedDim {
+    std::string var;
+    Expr factor;
+};
+
 struct ScheduleContents;
 
 struct Specialization {
@@ -157,6 +252,35 @@ public:
     std::vector<Bound> &bounds();
     // @}
 
+    /** The unrolled dimensions of an update that should use
+     * independent partial results. See
+     * \ref ScheduleHandle::interleave_accumulators */
+    // @{
+    const std::vector<InterleavedAccumulator> &interleaved_accumulators() const;
+    std::vector<InterleavedAccumulator> &interleaved_accumulators();
+    // @}
+
+    /** The parallel dimensions of an update that scatter into
+     * data-dependent sites. See \ref ScheduleHandle::parallel_scatter */
+    // @{
+    const std::vector<ParallelScatter> &parallel_scatters() const;
+    std::vector<ParallelScatter> &parallel_scatters();
+    // @}
+
+    /** The dimensions of the storage of this function to fold
+     * down to circular buffers. See \ref Func::fold_storage */
+    // @{
+    const std::vector<FoldedDim> &folded_dims() const;
+    std::vector<FoldedDim> &folded_dims();
+    // @}
+
+    /** The functions and images to prefetch within this
+     * stage. See \ref ScheduleHandle::prefetch */
+    // @{
+    const std::vector<Prefetch> &prefetches() const;
+    std::vector<Prefetch> &prefetches();
+    // @}
+
     /** You may create several specialized versions of a func with
      * different schedules. They trigger when the condition is
      * true. See \ref Func::specialize */
@@ -178,6 +302,30 @@ public:
     LoopLevel &compute_level();
     // @}
 
+    /** Whether this function should be computed on another thread,
+     * one iteration of its compute_level ahead of its
+     * consumer. See \ref Func::async */
+    // @{
+    bool &async();
+    bool async() const;
+    // @}
+
+    /** Whether vectorizing this stage across a reduction variable
+     * may reassociate floating point sums and products. See
+     * \ref ScheduleHandle::reassociate_floats */
+    // @{
+    bool &reassociate_floats();
+    bool reassociate_floats() const;
+    // @}
+
+    /** The sibling function and loop level down to which the loop
+     * nest of this function is fused with the sibling's. Inline
+     * (the default) means not fused. See \ref Func::compute_with */
+    // @{
+    const LoopLevel &fuse_level() const;
+    LoopLevel &fuse_level();
+    // @}
+
 };
 
 }
@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "SkipStages.h"
 #include "Debug.h"
 #include "IRMutator.h"
@@ -375,10 +377,12 @@ public:
     MightBeSkippable(string f) : func(f), guarded(false), result(false), found_call(false) {}
 };
 
-Stmt skip_stages(Stmt stmt, const vector<string> &order) {
-    // Don't consider the last stage, because it's the output, so it's
-    // never skippable.
-    for (size_t i = order.size()-1; i > 0; i--) {
+Stmt skip_stages(Stmt stmt, const vector<string> &order, const vector<string> &outputs) {
+    for (size_t i = order.size(); i > 0; i--) {
+        // Don't consider the outputs, which are never skippable.
+        if (std::find(outputs.begin(), outputs.end(), order[i-1]) != outputs.end()) {
+            continue;
+        }
         debug(2) << "skip_stages checking " << order[i-1] << "\n";
         MightBeSkippable check(order[i-1]);
         stmt.accept(&check);
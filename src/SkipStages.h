@@ -14,8 +14,10 @@ namespace Internal {
  * to check that tells us they won't be used. Does this by aanalyzing
  * all reads of each buffer allocated, and inferring some condition
  * that tells us if the reads occur. If the condition is non-trivial,
- * inject ifs that guard the production. */
-Stmt skip_stages(Stmt s, const std::vector<std::string> &order);
+ * inject ifs that guard the production. The outputs are never
+ * skipped. */
+Stmt skip_stages(Stmt s, const std::vector<std::string> &order,
+                 const std::vector<std::string> &outputs);
 
 }
 }
@@ -299,6 +299,12 @@ class SlidingWindowOnFunction : public IRMutator {
 
         if (op->for_type == For::Serial || op->for_type == For::Unrolled) {
             new_body = SlidingWindowOnFunctionAndLoop(func, op->name, op->min).mutate(new_body);
+        } else {
+            // Sliding needs the iterations in order. To slide within
+            // a parallel loop, split it into strips (see
+            // Func::parallel_strips) and store per strip.
+            debug(3) << "Not sliding " << func.name() << " over " << op->name
+                     << " because it isn't a serial loop\n";
         }
 
         if (new_body.same_as(op->body)) {
@@ -16,6 +16,9 @@ namespace Internal {
 /** Perform sliding window optimizations on a halide
  * statement. I.e. don't bother computing points in a function that
  * have provably already been computed by a previous iteration.
+ * Only serial loops are slid over. A function stored per strip of
+ * a parallel loop (see Func::parallel_strips) slides over the serial
+ * loop within each strip.
  */
 Stmt sliding_window(Stmt s, const std::map<std::string, Function> &env);
 
@@ -6,6 +6,9 @@
 #include "IRPrinter.h"
 #include "Debug.h"
 #include "Derivative.h"
+#include "Substitute.h"
+#include "ExprUsesVar.h"
+#include "Function.h"
 
 namespace Halide {
 namespace Internal {
@@ -13,12 +16,26 @@ namespace Internal {
 using std::string;
 using std::vector;
 using std::map;
+using std::pair;
+using std::make_pair;
 
-// Fold the storage of a function in a particular dimension by a particular factor
+// Fold the storage of a function in a particular dimension by a
+// particular factor. If the factor is known to be a power of two, the
+// coordinates are masked instead of taken modulo the factor, which is
+// cheaper when the factor isn't a constant.
 class FoldStorageOfFunction : public IRMutator {
     string func;
     int dim;
     Expr factor;
+    bool power_of_two;
+
+    Expr fold(Expr arg) {
+        if (power_of_two) {
+            return arg & (factor - 1);
+        } else {
+            return arg % factor;
+        }
+    }
 
     using IRMutator::visit;
 
@@ -29,7 +46,7 @@ class FoldStorageOfFunction : public IRMutator {
         if (op->name == func && op->call_type == Call::Halide) {
             vector<Expr> args = op->args;
             internal_assert(dim < (int)args.size());
-            args[dim] = args[dim] % factor;
+            args[dim] = fold(args[dim]);
             expr = Call::make(op->type, op->name, args, op->call_type,
                               op->func, op->value_index, op->image, op->param);
         }
@@ -41,22 +58,36 @@ class FoldStorageOfFunction : public IRMutator {
         internal_assert(op);
         if (op->name == func) {
             vector<Expr> args = op->args;
-            args[dim] = args[dim] % factor;
+            args[dim] = fold(args[dim]);
             stmt = Provide::make(op->name, op->values, args);
         }
     }
 
 public:
-    FoldStorageOfFunction(string f, int d, Expr e) :
-        func(f), dim(d), factor(e) {}
+    FoldStorageOfFunction(string f, int d, Expr e, bool p = false) :
+        func(f), dim(d), factor(e), power_of_two(p) {}
 };
 
 // Attempt to fold the storage of a particular function in a statement
 class AttemptStorageFoldingOfFunction : public IRMutator {
     string func;
 
+    // The lets between the realization and the current site. A fold
+    // factor that depends on them must be rewritten in terms of
+    // their values before it can be used at the realization.
+    vector<pair<string, Expr> > lets;
+    Scope<int> inner_lets;
+
     using IRMutator::visit;
 
+    void visit(const LetStmt *op) {
+        lets.push_back(make_pair(op->name, op->value));
+        inner_lets.push(op->name, 0);
+        IRMutator::visit(op);
+        inner_lets.pop(op->name);
+        lets.pop_back();
+    }
+
     void visit(const Pipeline *op) {
         if (op->name == func) {
             // Can't proceed into the pipeline for this func
@@ -104,7 +135,9 @@ class AttemptStorageFoldingOfFunction : public IRMutator {
                 Expr max_extent = bounds_of_expr_in_scope(extent, scope).max;
                 scope.pop(op->name);
 
-                max_extent = simplify(max_extent);
+                if (max_extent.defined()) {
+                    max_extent = simplify(max_extent);
+                }
 
                 const IntImm *max_extent_int = max_extent.as<IntImm>();
                 if (max_extent_int) {
@@ -116,10 +149,44 @@ class AttemptStorageFoldingOfFunction : public IRMutator {
 
                     dim_folded = (int)i - 1;
                     fold_factor = factor;
+                    footprint = extent + 1;
                     stmt = FoldStorageOfFunction(func, (int)i - 1, factor).mutate(result);
                     return;
+                }
+
+                // The extent isn't a constant, but it may still be
+                // computable at the realization, e.g. if it depends
+                // on a Param. Then round it up to a power of two at
+                // runtime.
+                if (max_extent.defined()) {
+                    for (size_t j = lets.size(); j > 0; j--) {
+                        if (expr_uses_var(max_extent, lets[j-1].first)) {
+                            max_extent = substitute(lets[j-1].first, lets[j-1].second, max_extent);
+                        }
+                    }
+                    max_extent = simplify(max_extent);
+                }
+
+                if (max_extent.defined() &&
+                    max_extent.type() == Int(32) &&
+                    !expr_uses_vars(max_extent, inner_lets) &&
+                    !expr_uses_var(max_extent, op->name)) {
+                    debug(3) << "Proceeding with a fold factor computed at runtime from "
+                             << max_extent << "\n";
+
+                    // The smallest power of two greater than the extent
+                    Expr clamped = Max::make(max_extent, 1);
+                    fold_factor_value = 1 << (32 - count_leading_zeros(clamped));
+                    fold_factor_name = func + ".fold_factor";
+
+                    dim_folded = (int)i - 1;
+                    fold_factor = Variable::make(Int(32), fold_factor_name);
+                    footprint = max_extent + 1;
+                    stmt = FoldStorageOfFunction(func, (int)i - 1, fold_factor, true).mutate(result);
+                    return;
                 } else {
                     debug(3) << "Not folding because extent not bounded by a constant\n"
+                             << "or by a value known where " << func << " is realized\n"
                              << "extent = " << extent << "\n"
                              << "max extent = " << max_extent << "\n";
                 }
@@ -136,7 +203,13 @@ class AttemptStorageFoldingOfFunction : public IRMutator {
 
 public:
     int dim_folded;
-    Expr fold_factor;
+    // The extent of the folded dimension, and the largest extent of
+    // it any iteration of the loop touches.
+    Expr fold_factor, footprint;
+    // If the fold factor is computed at runtime, it's stored in a
+    // variable defined just outside the realization.
+    string fold_factor_name;
+    Expr fold_factor_value;
     AttemptStorageFoldingOfFunction(string f) : func(f), dim_folded(-1) {}
 };
 
@@ -163,8 +236,53 @@ private:
 
 // Look for opportunities for storage folding in a statement
 class StorageFolding : public IRMutator {
+    const map<string, Function> &env;
+
     using IRMutator::visit;
 
+    // Fold the dimensions the schedule asks to be folded.
+    void fold_explicitly(const Realize *op, const Function &f, Stmt body) {
+        const vector<FoldedDim> &folds = f.schedule().folded_dims();
+        Region bounds = op->bounds;
+
+        // If the analysis can bound the footprint, check at runtime
+        // that the requested fold factor is large enough.
+        AttemptStorageFoldingOfFunction folder(op->name);
+        folder.mutate(body);
+
+        vector<Stmt> checks;
+        for (size_t i = 0; i < folds.size(); i++) {
+            int dim = -1;
+            for (int j = 0; j < f.dimensions(); j++) {
+                if (f.args()[j] == folds[i].var) dim = j;
+            }
+            internal_assert(dim >= 0);
+
+            Expr factor = cast<int>(folds[i].factor);
+            debug(3) << "Folding " << op->name << " over " << folds[i].var
+                     << " by " << factor << " as scheduled\n";
+
+            if (folder.dim_folded == dim) {
+                Expr footprint = folder.footprint;
+                if (!folder.fold_factor_name.empty()) {
+                    footprint = substitute(folder.fold_factor_name, folder.fold_factor_value, footprint);
+                }
+                checks.push_back(AssertStmt::make(footprint <= factor,
+                                                  "The storage of " + op->name + " was folded over " +
+                                                  folds[i].var + " by %d, but %d values are in use at once",
+                                                  vec<Expr>(factor, footprint)));
+            }
+
+            body = FoldStorageOfFunction(op->name, dim, factor).mutate(body);
+            bounds[dim] = Range(0, factor);
+        }
+
+        stmt = Realize::make(op->name, op->types, bounds, body);
+        for (size_t i = 0; i < checks.size(); i++) {
+            stmt = Block::make(checks[i], stmt);
+        }
+    }
+
     void visit(const Realize *op) {
         Stmt body = mutate(op->body);
 
@@ -172,13 +290,22 @@ class StorageFolding : public IRMutator {
         IsBufferSpecial special(op->name);
         op->accept(&special);
 
+        map<string, Function>::const_iterator iter = env.find(op->name);
+        bool explicit_fold = (iter != env.end() &&
+                              !iter->second.schedule().folded_dims().empty());
+
         if (special.special) {
+            user_assert(!explicit_fold)
+                << "Can't fold the storage of " << op->name
+                << ", because its buffer is accessed directly (e.g. by an extern stage).\n";
             debug(3) << "Not attempting to fold " << op->name << " because it is referenced by an intrinsic\n";
             if (body.same_as(op->body)) {
                 stmt = op;
             } else {
                 stmt = Realize::make(op->name, op->types, op->bounds, body);
             }
+        } else if (explicit_fold) {
+            fold_explicitly(op, iter->second, body);
         } else {
             debug(3) << "Attempting to fold " << op->name << "\n";
             Stmt new_body = folder.mutate(body);
@@ -196,13 +323,20 @@ class StorageFolding : public IRMutator {
                 bounds[folder.dim_folded] = Range(0, folder.fold_factor);
 
                 stmt = Realize::make(op->name, op->types, bounds, new_body);
+
+                if (!folder.fold_factor_name.empty()) {
+                    stmt = LetStmt::make(folder.fold_factor_name, folder.fold_factor_value, stmt);
+                }
             }
         }
     }
+
+public:
+    StorageFolding(const map<string, Function> &e) : env(e) {}
 };
 
-Stmt storage_folding(Stmt s) {
-    return StorageFolding().mutate(s);
+Stmt storage_folding(Stmt s, const map<string, Function> &env) {
+    return StorageFolding(env).mutate(s);
 }
 
 }
@@ -6,6 +6,8 @@
  * down to smaller circular buffers when possible
  */
 
+#include <map>
+
 #include "IR.h"
 
 namespace Halide {
@@ -22,9 +24,12 @@ namespace Internal {
  \endcode
  *
  * We can store f as a circular buffer of size two, instead of
- * allocating space for all of it.
+ * allocating space for all of it. The size of the circular buffer is
+ * rounded up to a power of two. If it isn't a constant, it's computed
+ * where the function is realized. Dimensions folded explicitly with
+ * Func::fold_storage are folded as requested instead.
  */
-Stmt storage_folding(Stmt s);
+Stmt storage_folding(Stmt s, const std::map<std::string, Function> &env);
 
 }
 }
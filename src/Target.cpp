@@ -1,6 +1,10 @@
 #include <iostream>
 #include <string>
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 #include "Target.h"
 #include "Debug.h"
 #include "Error.h"
@@ -43,6 +47,23 @@ static void cpuid(int info[4], int infoType, int extra) {
 }
 #endif
 #endif
+
+// Read an extended control register, to check which register state
+// the OS saves across context switches.
+#ifdef _MSC_VER
+static uint64_t xgetbv(int index) {
+    return _xgetbv(index);
+}
+#else
+static uint64_t xgetbv(int index) {
+    uint32_t eax, edx;
+    __asm__ __volatile__ (
+        ".byte 0x0f, 0x01, 0xd0 \n\t"
+        : "=a" (eax), "=d" (edx)
+        : "c" (index));
+    return ((uint64_t)edx << 32) | eax;
+}
+#endif
 #endif
 }
 
@@ -85,19 +106,39 @@ Target get_host_target() {
         << ", " << info[3]
         << std::dec << "\n";
 
+    bool have_fma = info[2] & (1 << 12);
+
     uint64_t features = 0;
     if (have_sse41) features |= Target::SSE41;
     if (have_avx)   features |= Target::AVX;
+    if (have_avx && have_fma) features |= Target::FMA;
+    if (have_avx && have_f16) features |= Target::F16C;
 
     if (use_64_bits && have_avx && have_f16 && have_rdrand) {
         // So far, so good.  AVX2?
         // Call cpuid with eax=7, ecx=0
         int info2[4];
         cpuid(info2, 7, 0);
-        bool have_avx2 = info[1] & (1 << 5);
+        bool have_avx2 = info2[1] & (1 << 5);
         if (have_avx2) {
             features |= Target::AVX2;
         }
+
+        // AVX-512 also needs the OS to save the opmask and zmm
+        // registers (XCR0 bits 5-7) as well as xmm and ymm (bits 1-2).
+        bool have_osxsave = info[2] & (1 << 27);
+        bool have_avx512f = info2[1] & (1 << 16);
+        bool have_avx512dq = info2[1] & (1 << 17);
+        bool have_avx512cd = info2[1] & (1 << 28);
+        bool have_avx512bw = info2[1] & (1 << 30);
+        bool have_avx512vl = info2[1] & (1U << 31);
+        if (have_avx2 && have_osxsave && have_avx512f && have_avx512cd &&
+            (xgetbv(0) & 0xe6) == 0xe6) {
+            features |= Target::AVX512;
+            if (have_avx512dq && have_avx512bw && have_avx512vl) {
+                features |= Target::AVX512_Skylake;
+            }
+        }
     }
 
     return Target(os, arch, bits, features);
@@ -170,7 +211,8 @@ Target parse_target_string(const std::string &target) {
                    << "Where arch is x86-32, x86-64, arm-32, arm-64, pnacl, "
                    << "and os is linux, windows, osx, nacl, ios, or android. "
                    << "If arch or os are omitted, they default to the host. "
-                   << "Features include sse41, avx, avx2, armv7s, aarch64, cuda, "
+                   << "Features include sse41, avx, avx2, avx512, avx512_skylake, fma, f16c, "
+                   << "fma_contract, armv7s, aarch64, cuda, "
                    << "opencl, spir, spir64, no_asserts, no_bounds_query, and gpu_debug.\n"
                    << "HL_TARGET can also begin with \"host\", which sets the "
                    << "host's architecture, os, and feature set, with the "
@@ -250,7 +292,22 @@ bool Target::merge_string(const std::string &target) {
         } else if (tok == "avx") {
             features |= (Target::SSE41 | Target::AVX);
         } else if (tok == "avx2") {
-            features |= (Target::SSE41 | Target::AVX | Target::AVX2);
+            // Every cpu with avx2 also has fma and f16c.
+            features |= (Target::SSE41 | Target::AVX | Target::AVX2 |
+                         Target::FMA | Target::F16C);
+        } else if (tok == "avx512") {
+            features |= (Target::SSE41 | Target::AVX | Target::AVX2 |
+                         Target::FMA | Target::F16C | Target::AVX512);
+        } else if (tok == "avx512_skylake") {
+            features |= (Target::SSE41 | Target::AVX | Target::AVX2 |
+                         Target::FMA | Target::F16C |
+                         Target::AVX512 | Target::AVX512_Skylake);
+        } else if (tok == "fma") {
+            features |= (Target::SSE41 | Target::AVX | Target::FMA);
+        } else if (tok == "f16c") {
+            features |= (Target::SSE41 | Target::AVX | Target::F16C);
+        } else if (tok == "fma_contract") {
+            features |= Target::FMAContract;
         } else if (tok == "armv7s") {
             features |= Target::ARMv7s;
         } else if (tok == "aarch64") {
@@ -311,7 +368,8 @@ std::string Target::to_string() const {
   };
   const char* const feature_names[] = {
     "jit", "sse41", "avx", "avx2", "cuda", "opencl", "opengl", "gpu_debug",
-    "no_asserts", "no_bounds_query", "armv7s", "aarch64", "cl_doubles"
+    "no_asserts", "no_bounds_query", "armv7s", "aarch64", "cl_doubles",
+    "avx512", "avx512_skylake", "fma", "f16c", "fma_contract"
   };
   string result = string(arch_names[arch])
       + "-" + Internal::int_to_string(bits)
@@ -402,12 +460,16 @@ DECLARE_LL_INITMOD(arm)
 DECLARE_LL_INITMOD(posix_math)
 DECLARE_LL_INITMOD(pnacl_math)
 DECLARE_LL_INITMOD(ptx_dev)
+DECLARE_LL_INITMOD(vector_math)
 #if WITH_PTX
 DECLARE_LL_INITMOD(ptx_compute_20)
 DECLARE_LL_INITMOD(ptx_compute_30)
 DECLARE_LL_INITMOD(ptx_compute_35)
 #endif
 DECLARE_LL_INITMOD(x86_avx)
+DECLARE_LL_INITMOD(x86_avx2)
+DECLARE_LL_INITMOD(x86_avx512)
+DECLARE_LL_INITMOD(x86_fma)
 DECLARE_LL_INITMOD(x86)
 DECLARE_LL_INITMOD(x86_sse41)
 
@@ -554,12 +616,24 @@ llvm::Module *get_initial_module_for_target(Target t, llvm::LLVMContext *c) {
     if (t.arch == Target::ARM) {
         modules.push_back(get_initmod_arm_ll(c));
     }
+    if (t.arch == Target::X86 || t.arch == Target::ARM) {
+        modules.push_back(get_initmod_vector_math_ll(c));
+    }
     if (t.features & Target::SSE41) {
         modules.push_back(get_initmod_x86_sse41_ll(c));
     }
     if (t.features & Target::AVX) {
         modules.push_back(get_initmod_x86_avx_ll(c));
     }
+    if (t.features & Target::AVX2) {
+        modules.push_back(get_initmod_x86_avx2_ll(c));
+    }
+    if (t.features & Target::FMA) {
+        modules.push_back(get_initmod_x86_fma_ll(c));
+    }
+    if (t.features & Target::AVX512) {
+        modules.push_back(get_initmod_x86_avx512_ll(c));
+    }
     if (t.features & Target::CUDA) {
         if (t.features & Target::GPUDebug) {
             modules.push_back(get_initmod_cuda_debug(c, bits_64));
@@ -8,6 +8,7 @@
 #include <stdint.h>
 #include <string>
 #include "Util.h"
+#include "Type.h"
 
 namespace llvm {
 class Module;
@@ -43,7 +44,12 @@ struct Target {
                    NoBoundsQuery = 1 << 9, /// Disable the bounds querying functionality.
                    ARMv7s    = 1 << 10,  /// Generate code for ARMv7s. Only relevant for 32-bit ARM.
                    AArch64Backend = 1 << 11, /// Use AArch64 LLVM target rather than ARM64. Only relevant for 64-bit ARM.
-                   CLDoubles = 1 << 12 /// Enable double support on OpenCL targets
+                   CLDoubles = 1 << 12, /// Enable double support on OpenCL targets
+                   AVX512    = 1 << 13, /// Use AVX-512 foundation and conflict detection instructions. Only relevant on x86.
+                   AVX512_Skylake = 1 << 14, /// Also use the AVX-512 BW, DQ and VL subsets found on Skylake-SP and later. Only relevant on x86.
+                   FMA       = 1 << 15, /// Use fused multiply-add instructions for fma(). Only relevant on x86.
+                   F16C      = 1 << 16, /// Use the half-float conversion instructions. Only relevant on x86.
+                   FMAContract = 1 << 17 /// Fuse a*b + c in vectorized float code into a fused multiply-add, which changes the rounding. Needs FMA.
 
     };
 
@@ -57,6 +63,30 @@ struct Target {
         return (features & (CUDA|OpenCL));
     }
 
+    /** Get the natural vector width in bytes for this target, i.e.
+     * the width of the widest vector register. */
+    int natural_vector_bytes() const {
+        if (arch == X86) {
+            if (features & AVX512) return 64;
+            if (features & AVX) return 32;
+        }
+        return 16;
+    }
+
+    /** Get the number of lanes of the given type that fill a vector
+     * register of the natural width for this target. Use this when
+     * choosing vectorization factors, e.g.
+     * f.vectorize(x, target.natural_vector_size(Float(32))) */
+    int natural_vector_size(Type t) const {
+        return natural_vector_bytes() / t.bytes();
+    }
+
+    /** \copydoc natural_vector_size(Type) const */
+    template<typename data_t>
+    int natural_vector_size() const {
+        return natural_vector_size(type_of<data_t>());
+    }
+
     bool operator==(const Target &other) const {
       return os == other.os &&
           arch == other.arch &&
@@ -18,16 +18,23 @@ using std::string;
 class InjectTracing : public IRMutator {
 public:
     const map<string, Function> &env;
-    Function output;
+    const vector<Function> &outputs;
     int global_level;
     InjectTracing(const map<string, Function> &e,
-                  Function o) : env(e),
-                                output(o),
-                                global_level(tracing_level()) {}
+                  const vector<Function> &o) : env(e),
+                                               outputs(o),
+                                               global_level(tracing_level()) {}
 
 private:
     using IRMutator::visit;
 
+    bool is_output(Function f) const {
+        for (size_t i = 0; i < outputs.size(); i++) {
+            if (f.same_as(outputs[i])) return true;
+        }
+        return false;
+    }
+
     void visit(const Call *op) {
 
         // Calls inside of an address_of don't count, but we want to
@@ -66,7 +73,7 @@ private:
         }
 
         Function f = op->func;
-        bool inlined = !f.same_as(output) && f.schedule().compute_level().is_inline();
+        bool inlined = !is_output(f) && f.schedule().compute_level().is_inline();
 
         if (f.is_tracing_loads() || (global_level > 2 && !inlined)) {
 
@@ -92,7 +99,7 @@ private:
         map<string, Function>::const_iterator iter = env.find(op->name);
         if (iter == env.end()) return;
         Function f = iter->second;
-        bool inlined = !f.same_as(output) && f.schedule().compute_level().is_inline();
+        bool inlined = !is_output(f) && f.schedule().compute_level().is_inline();
 
         if (f.is_tracing_stores() || (global_level > 1 && !inlined)) {
             // Wrap each expr in a tracing call
@@ -211,29 +218,54 @@ private:
     }
 };
 
-Stmt inject_tracing(Stmt s, const map<string, Function> &env, Function output) {
+namespace {
+
+// Strip the dummy realize nodes wrapped around the outputs.
+class RemoveRealizations : public IRMutator {
+    const vector<Function> &funcs;
+
+    using IRMutator::visit;
+
+    void visit(const Realize *op) {
+        for (size_t i = 0; i < funcs.size(); i++) {
+            if (op->name == funcs[i].name()) {
+                stmt = mutate(op->body);
+                return;
+            }
+        }
+        IRMutator::visit(op);
+    }
+
+public:
+    RemoveRealizations(const vector<Function> &f) : funcs(f) {}
+};
+
+}
+
+Stmt inject_tracing(Stmt s, const map<string, Function> &env, const vector<Function> &outputs) {
     Stmt original = s;
-    InjectTracing tracing(env, output);
+    InjectTracing tracing(env, outputs);
 
     // Add a dummy realize block for the output buffers
-    Region output_region;
-    Parameter output_buf = output.output_buffers()[0];
-    internal_assert(output_buf.is_buffer());
-    for (int i = 0; i < output.dimensions(); i++) {
-        string d = int_to_string(i);
-        Expr min = Variable::make(Int(32), output_buf.name() + ".min." + d);
-        Expr extent = Variable::make(Int(32), output_buf.name() + ".extent." + d);
-        output_region.push_back(Range(min, extent));
+    for (size_t j = 0; j < outputs.size(); j++) {
+        Function output = outputs[j];
+        Region output_region;
+        Parameter output_buf = output.output_buffers()[0];
+        internal_assert(output_buf.is_buffer());
+        for (int i = 0; i < output.dimensions(); i++) {
+            string d = int_to_string(i);
+            Expr min = Variable::make(Int(32), output_buf.name() + ".min." + d);
+            Expr extent = Variable::make(Int(32), output_buf.name() + ".extent." + d);
+            output_region.push_back(Range(min, extent));
+        }
+        s = Realize::make(output.name(), output.output_types(), output_region, s);
     }
-    s = Realize::make(output.name(), output.output_types(), output_region, s);
 
     // Inject tracing calls
     s = tracing.mutate(s);
 
-    // Strip off the dummy realize block
-    const Realize *r = s.as<Realize>();
-    internal_assert(r);
-    s = r->body;
+    // Strip off the dummy realize blocks
+    s = RemoveRealizations(outputs).mutate(s);
 
     // Unless tracing was a no-op, add a call to shut down the trace
     // (which flushes the output stream)
@@ -7,6 +7,7 @@
 
 #include "IR.h"
 #include <map>
+#include <vector>
 
 namespace Halide {
 namespace Internal {
@@ -15,7 +16,8 @@ namespace Internal {
  * tracing functions at interesting points, such as
  * allocations. Should be done before storage flattening, but after
  * all bounds inference. */
-Stmt inject_tracing(Stmt, const std::map<std::string, Function> &env, Function output);
+Stmt inject_tracing(Stmt, const std::map<std::string, Function> &env,
+                    const std::vector<Function> &outputs);
 
 }
 }
@@ -110,7 +110,10 @@ inline Type UInt(int bits, int width = 1) {
     return t;
 }
 
-/** Construct a floating-point type */
+/** Construct a floating-point type. Float(16) is a half-precision
+ * storage type: use it to halve the footprint of large intermediate
+ * buffers. Arithmetic on it is done in Float(32), so cast to it when
+ * storing, and loads of it are widened as needed. */
 inline Type Float(int bits, int width = 1) {
     Type t;
     t.code = Type::Float;
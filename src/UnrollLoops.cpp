@@ -3,10 +3,17 @@
 #include "IROperator.h"
 #include "Simplify.h"
 #include "Substitute.h"
+#include "AssociativeUpdate.h"
+#include "ExprUsesVar.h"
+#include "Function.h"
 
 namespace Halide {
 namespace Internal {
 
+using std::map;
+using std::string;
+using std::vector;
+
 class UnrollLoops : public IRMutator {
     using IRMutator::visit;
 
@@ -42,5 +49,259 @@ Stmt unroll_loops(Stmt s) {
     return UnrollLoops().mutate(s);
 }
 
+namespace {
+
+// Rewrite associative updates in the bodies of marked unrolled loops
+// to accumulate into one partial result per iteration, then move the
+// initialization and combination of the partial results out through
+// the enclosing loops and lets that the update site doesn't depend
+// on.
+class InterleaveAccumulators : public IRMutator {
+    // The marked loops, and whether they may reassociate floats.
+    const map<string, bool> &marked;
+
+    // The partial results introduced by the most recently visited
+    // marked loop, which haven't been combined into the update site
+    // yet.
+    struct Pending {
+        string name, reduce_op;
+        Stmt stmt;
+        const Store *update;
+        Expr self;
+        int count;
+    };
+    vector<Pending> pending;
+
+    // Whether the stmt being mutated is the body of a loop or let
+    // that the partial results may be moved outside of.
+    bool may_hoist;
+
+    using IRMutator::visit;
+
+    // Wrap a stmt containing the pending partial results in their
+    // allocation, initialization, and final combination.
+    Stmt combine_partial_results(Stmt s) {
+        Pending p = pending.back();
+        pending.pop_back();
+        Type t = p.update->value.type();
+
+        vector<Expr> partial(p.count);
+        Stmt init;
+        for (int i = p.count - 1; i >= 0; i--) {
+            partial[i] = Load::make(t, p.name, i, Buffer(), Parameter());
+            init = Block::make(Store::make(p.name, associative_identity(p.reduce_op, t), i), init);
+        }
+
+        // Combine the partial results pairwise.
+        while (partial.size() > 1) {
+            vector<Expr> next;
+            for (size_t i = 0; i + 1 < partial.size(); i += 2) {
+                next.push_back(associative_combine(p.reduce_op, partial[i], partial[i+1]));
+            }
+            if (partial.size() & 1) {
+                next.push_back(partial.back());
+            }
+            partial.swap(next);
+        }
+
+        Expr value = rebuild_associative_update(p.update, p.reduce_op, p.self, partial[0]);
+        Stmt update = Store::make(p.update->name, value, p.update->index);
+
+        s = Block::make(init, Block::make(s, update));
+        return Allocate::make(p.name, t, vec(Expr(p.count)), s);
+    }
+
+    // Can the pending partial results move outside of a loop or let
+    // with the given name, whose body is the given stmt?
+    bool can_hoist_past(const string &name, Stmt body) {
+        return (!pending.empty() &&
+                body.same_as(pending.back().stmt) &&
+                !expr_uses_var(pending.back().update->index, name));
+    }
+
+    Stmt mutate_hoistable_body(Stmt body) {
+        may_hoist = true;
+        return mutate(body);
+    }
+
+    void visit(const LetStmt *op) {
+        Stmt body = mutate_hoistable_body(op->body);
+        bool hoist = (can_hoist_past(op->name, body) &&
+                      !loads_from(op->value, pending.back().update->name));
+        if (!pending.empty() && body.same_as(pending.back().stmt) && !hoist) {
+            body = combine_partial_results(body);
+        }
+        if (body.same_as(op->body)) {
+            stmt = op;
+        } else {
+            stmt = LetStmt::make(op->name, op->value, body);
+        }
+        if (hoist) {
+            pending.back().stmt = stmt;
+        }
+    }
+
+    void visit(const For *op) {
+        map<string, bool>::const_iterator iter = marked.find(op->name);
+        if (iter != marked.end() && op->for_type == For::Unrolled) {
+            stmt = interleave(op, iter->second);
+            if (stmt.defined()) {
+                return;
+            }
+        }
+
+        Stmt body = mutate_hoistable_body(op->body);
+        bool hoist = ((op->for_type == For::Serial || op->for_type == For::Unrolled) &&
+                      can_hoist_past(op->name, body));
+        if (!pending.empty() && body.same_as(pending.back().stmt) && !hoist) {
+            body = combine_partial_results(body);
+        }
+        if (body.same_as(op->body)) {
+            stmt = op;
+        } else {
+            stmt = For::make(op->name, op->min, op->extent, op->for_type, body);
+        }
+        if (hoist) {
+            pending.back().stmt = stmt;
+        }
+    }
+
+    // Rewrite the body of a marked loop. Returns an undefined stmt if
+    // the body isn't a suitable associative update.
+    Stmt interleave(const For *op, bool reassociate_floats) {
+        const IntImm *extent = simplify(op->extent).as<IntImm>();
+        if (!extent || extent->value <= 1) {
+            return Stmt();
+        }
+
+        // Peel off any lets and a guard wrapping the update.
+        vector<Stmt> containers;
+        Stmt body = op->body;
+        while (true) {
+            if (const LetStmt *let = body.as<LetStmt>()) {
+                containers.push_back(body);
+                body = let->body;
+            } else if (const IfThenElse *if_stmt = body.as<IfThenElse>()) {
+                if (if_stmt->else_case.defined()) {
+                    return Stmt();
+                }
+                containers.push_back(body);
+                body = if_stmt->then_case;
+            } else {
+                break;
+            }
+        }
+
+        const Store *update = body.as<Store>();
+        string reduce_op;
+        Expr self, other;
+        if (!update || !match_associative_update(update, &reduce_op, &self, &other) ||
+            update->value.type().is_vector() ||
+            expr_uses_var(update->index, op->name)) {
+            return Stmt();
+        }
+
+        for (size_t i = 0; i < containers.size(); i++) {
+            if (const LetStmt *let = containers[i].as<LetStmt>()) {
+                if (expr_uses_var(update->index, let->name) ||
+                    loads_from(let->value, update->name)) {
+                    return Stmt();
+                }
+            } else {
+                const IfThenElse *if_stmt = containers[i].as<IfThenElse>();
+                if (loads_from(if_stmt->condition, update->name)) {
+                    return Stmt();
+                }
+            }
+        }
+
+        if (update->value.type().is_float() &&
+            reduce_op != Call::vector_reduce_min &&
+            reduce_op != Call::vector_reduce_max &&
+            !reassociate_floats) {
+            user_warning << "Warning: Not interleaving the accumulators of "
+                         << update->name << " over " << op->name
+                         << ", because it would reassociate a floating point reduction. "
+                         << "Pass reassociate_floats = true to interleave_accumulators to allow this.\n";
+            return Stmt();
+        }
+
+        Pending p;
+        p.name = unique_name(update->name + ".partial", false);
+        p.reduce_op = reduce_op;
+        p.update = update;
+        p.self = self;
+        p.count = extent->value;
+
+        Type t = update->value.type();
+        Expr idx = simplify(Variable::make(Int(32), op->name) - op->min);
+        Expr partial = Load::make(t, p.name, idx, Buffer(), Parameter());
+        body = Store::make(p.name, associative_combine(reduce_op, partial, other), idx);
+
+        for (size_t i = containers.size(); i > 0; i--) {
+            if (const LetStmt *let = containers[i-1].as<LetStmt>()) {
+                body = LetStmt::make(let->name, let->value, body);
+            } else {
+                const IfThenElse *if_stmt = containers[i-1].as<IfThenElse>();
+                body = IfThenElse::make(if_stmt->condition, body);
+            }
+        }
+
+        p.stmt = For::make(op->name, op->min, op->extent, op->for_type, body);
+        pending.push_back(p);
+        return p.stmt;
+    }
+
+public:
+    InterleaveAccumulators(const map<string, bool> &m) : marked(m), may_hoist(false) {}
+
+    using IRMutator::mutate;
+
+    Stmt mutate(Stmt s) {
+        bool hoistable = may_hoist;
+        may_hoist = false;
+        size_t old_pending = pending.size();
+        Stmt result = IRMutator::mutate(s);
+        // Anything other than a loop or let that the partial results
+        // can move out of must combine them into the update site.
+        if (!hoistable && pending.size() > old_pending &&
+            result.same_as(pending.back().stmt)) {
+            result = combine_partial_results(result);
+        }
+        return result;
+    }
+};
+
+void find_interleaved_accumulators(const Function &f, int stage, const Schedule &s,
+                                   map<string, bool> *marked) {
+    const vector<InterleavedAccumulator> &accs = s.interleaved_accumulators();
+    for (size_t i = 0; i < accs.size(); i++) {
+        string loop_name = f.name() + ".s" + int_to_string(stage) + "." + accs[i].var;
+        (*marked)[loop_name] = (*marked)[loop_name] || accs[i].reassociate_floats;
+    }
+    for (size_t i = 0; i < s.specializations().size(); i++) {
+        find_interleaved_accumulators(f, stage, s.specializations()[i].schedule, marked);
+    }
+}
+
+}
+
+Stmt interleave_accumulators(Stmt s, const map<string, Function> &env) {
+    map<string, bool> marked;
+    for (map<string, Function>::const_iterator iter = env.begin();
+         iter != env.end(); ++iter) {
+        const Function &f = iter->second;
+        for (size_t i = 0; i < f.reductions().size(); i++) {
+            find_interleaved_accumulators(f, (int)(i+1), f.reductions()[i].schedule, &marked);
+        }
+    }
+
+    if (marked.empty()) {
+        return s;
+    }
+
+    return InterleaveAccumulators(marked).mutate(s);
+}
+
 }
 }
@@ -5,6 +5,8 @@
  * Defines the lowering pass that unrolls loops marked as such
  */
 
+#include <map>
+
 #include "IR.h"
 
 namespace Halide {
@@ -15,6 +17,14 @@ namespace Internal {
  * the loop. */
 Stmt unroll_loops(Stmt);
 
+/** Take a statement with unrolled for loops marked as interleaved
+ * accumulators by the schedules of the functions in the environment,
+ * and give each iteration of each such loop its own partial result
+ * for the associative update in its body. The partial results are
+ * initialized and combined into the update site outside of the
+ * outermost enclosing serial loop over which the site is constant. */
+Stmt interleave_accumulators(Stmt s, const std::map<std::string, Function> &env);
+
 }
 }
 
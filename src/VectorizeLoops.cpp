@@ -2,19 +2,145 @@
 
 #include "VectorizeLoops.h"
 #include "IRMutator.h"
+#include "IRVisitor.h"
 #include "Scope.h"
 #include "IRPrinter.h"
 #include "Deinterleave.h"
 #include "Substitute.h"
 #include "IROperator.h"
+#include "ExprUsesVar.h"
+#include "AssociativeUpdate.h"
+#include "Simplify.h"
+#include "Function.h"
 
 namespace Halide {
 namespace Internal {
 
+using std::map;
+using std::set;
 using std::string;
 using std::vector;
 
+Expr lower_vector_reduce(const string &reduce_op, Expr v) {
+    int width = v.type().width;
+    Type t = v.type().element_of();
+
+    // Repeatedly combine the top half of the vector with the bottom
+    // half until the number of lanes is odd.
+    while (width > 1 && width % 2 == 0) {
+        int half = width / 2;
+        vector<Expr> lo_args(half + 1), hi_args(half + 1);
+        lo_args[0] = hi_args[0] = v;
+        for (int i = 0; i < half; i++) {
+            lo_args[i+1] = i;
+            hi_args[i+1] = i + half;
+        }
+        Expr lo = Call::make(t.vector_of(half), Call::shuffle_vector, lo_args, Call::Intrinsic);
+        Expr hi = Call::make(t.vector_of(half), Call::shuffle_vector, hi_args, Call::Intrinsic);
+        v = associative_combine(reduce_op, lo, hi);
+        width = half;
+    }
+
+    // Then mop up the remaining lanes one at a time.
+    Expr result;
+    for (int i = 0; i < width; i++) {
+        Expr lane = v;
+        if (width > 1) {
+            lane = Call::make(t, Call::shuffle_vector, vec(v, Expr(i)), Call::Intrinsic);
+        }
+        result = result.defined() ? associative_combine(reduce_op, result, lane) : lane;
+    }
+    return result;
+}
+
+// Check if a vectorized statement can be run under a predicate, with
+// its vector loads and stores masked off in the inactive lanes. Any
+// other effect would happen regardless of the predicate, so we only
+// allow lets, blocks, scalar ifs, vector stores, and calls without
+// side-effects.
+class CanPredicate : public IRVisitor {
+    using IRVisitor::visit;
+
+    void visit(const Store *op) {
+        if (op->value.type().is_scalar()) {
+            result = false;
+        } else {
+            IRVisitor::visit(op);
+        }
+    }
+
+    void visit(const Call *op) {
+        if (op->call_type == Call::Intrinsic &&
+            (op->name == Call::debug_to_file ||
+             op->name == Call::rewrite_buffer ||
+             op->name == Call::set_host_dirty ||
+             op->name == Call::set_dev_dirty ||
+             op->name == Call::trace ||
+             op->name == Call::trace_expr ||
+             op->name == Call::glsl_texture_store ||
+             op->name == Call::atomic_add ||
+             op->name == Call::atomic_min ||
+             op->name == Call::atomic_max)) {
+            result = false;
+        } else {
+            IRVisitor::visit(op);
+        }
+    }
+
+    void visit(const IfThenElse *op) {
+        if (op->condition.type().is_vector()) {
+            result = false;
+        } else {
+            IRVisitor::visit(op);
+        }
+    }
+
+    // Integer division by zero traps, and the lanes that are off the
+    // end are still computed. A divisor that's the same in every lane
+    // is fine, because the active lanes divide by it too, but one
+    // that varies (e.g. loaded from a buffer) might be zero only in
+    // an inactive lane.
+    void check_divisor(Type t, Expr b) {
+        if (t.is_vector() && !t.is_float() && !b.as<Broadcast>()) {
+            result = false;
+        }
+    }
+
+    void visit(const Div *op) {
+        check_divisor(op->type, op->b);
+        IRVisitor::visit(op);
+    }
+
+    void visit(const Mod *op) {
+        check_divisor(op->type, op->b);
+        IRVisitor::visit(op);
+    }
+
+    void visit(const For *) {result = false;}
+    void visit(const Allocate *) {result = false;}
+    void visit(const Free *) {result = false;}
+    void visit(const AssertStmt *) {result = false;}
+    void visit(const Pipeline *) {result = false;}
+    void visit(const Realize *) {result = false;}
+    void visit(const Provide *) {result = false;}
+
+public:
+    bool result;
+    CanPredicate() : result(true) {}
+};
+
+bool can_predicate(Stmt s) {
+    CanPredicate check;
+    s.accept(&check);
+    return check.result;
+}
+
 class VectorizeLoops : public IRMutator {
+    bool predicate_tails;
+    // The prefixes of the loops of update stages that may
+    // reassociate floating point sums and products.
+    const set<string> &reassociating;
+
     class VectorSubs : public IRMutator {
         string var;
         Expr replacement;
@@ -24,6 +150,9 @@ class VectorizeLoops : public IRMutator {
         bool scalarized;
         int scalar_lane;
 
+        bool predicate_tails;
+        bool reassociate_floats;
+
         Expr widen(Expr e, int width) {
             if (e.type().width == width) {
                 return e;
@@ -243,6 +372,42 @@ class VectorizeLoops : public IRMutator {
         void visit(const Store *op) {
             Expr value = mutate(op->value);
             Expr index = mutate(op->index);
+
+            if (value.type().is_vector() && index.type().is_scalar() &&
+                !internal_allocations.contains(op->name)) {
+                // Every lane would store to the same site. This
+                // happens when vectorizing across a reduction
+                // variable that the update site doesn't depend
+                // on. If the update is an associative combination of
+                // the site with some other value, combine the lanes
+                // of that value horizontally and do a single scalar
+                // update. Otherwise, fall back to updating the site
+                // once per lane in order.
+                string reduce_op;
+                Expr self, other;
+                bool associative = match_associative_update(op, &reduce_op, &self, &other);
+                if (associative && op->value.type().is_float() &&
+                    reduce_op != Call::vector_reduce_min &&
+                    reduce_op != Call::vector_reduce_max &&
+                    !reassociate_floats) {
+                    user_warning << "Warning: Updating " << op->name
+                                 << " one lane at a time in the loop over " << var
+                                 << ", because combining the lanes would reassociate a "
+                                 << "floating point reduction. Call reassociate_floats() "
+                                 << "on the update to allow this.\n";
+                    associative = false;
+                }
+                if (associative) {
+                    other = widen(mutate(other), replacement.type().width);
+                    Expr reduced = Call::make(other.type().element_of(), reduce_op,
+                                              vec(other), Call::Intrinsic);
+                    stmt = Store::make(op->name, rebuild_associative_update(op, reduce_op, self, reduced), op->index);
+                } else {
+                    stmt = scalarize(op);
+                }
+                return;
+            }
+
             // Internal allocations always get vectorized.
             if (internal_allocations.contains(op->name)) {
                 int width = replacement.type().width;
@@ -280,9 +445,31 @@ class VectorizeLoops : public IRMutator {
             if (width > 1) {
                 // It's an if statement on a vector of
                 // conditions. We'll have to scalarize and make
-                // multiple copies of the if statement.
-                debug(3) << "Scalarizing if then else\n";
-                stmt = scalarize(op);
+                // multiple copies of the if statement. If the
+                // condition is monotonic across the lanes, as it is
+                // for the guard of a split with
+                // TailStrategy_GuardWithIf, we can first check if
+                // it's true in the first and last lanes, and if so
+                // run the then case as a vector. Only the last vector
+                // of the loop will then be scalarized. On targets with
+                // masked loads and stores, the last vector can instead
+                // run the then case as a vector under a predicate.
+                Expr all_true = all_lanes_true(cond);
+                if (all_true.defined()) {
+                    debug(3) << "Vectorizing if then else when all lanes are true\n";
+                    Stmt then_case = mutate(op->then_case);
+                    Stmt tail;
+                    if (predicate_tails && !op->else_case.defined() && can_predicate(then_case)) {
+                        debug(3) << "Predicating the remaining lanes\n";
+                        tail = IfThenElse::make(cond, then_case);
+                    } else {
+                        tail = scalarize(op);
+                    }
+                    stmt = IfThenElse::make(all_true, then_case, tail);
+                } else {
+                    debug(3) << "Scalarizing if then else\n";
+                    stmt = scalarize(op);
+                }
             } else {
                 // It's an if statement on a scalar, we're ok to vectorize the innards.
                 debug(3) << "Not scalarizing if then else\n";
@@ -366,6 +553,62 @@ class VectorizeLoops : public IRMutator {
             stmt = Allocate::make(op->name, op->type, new_extents, body);
         }
 
+        // Substitute in the values of the vector lets in scope.
+        Expr expand_lets(Expr e) {
+            for (Scope<Expr>::iterator iter = scope.begin(); iter != scope.end(); ++iter) {
+                e = substitute(iter.name(), iter.value(), e);
+            }
+            return e;
+        }
+
+        // Make a scalar condition that is true only if every lane of a
+        // vector condition is true, or return an undefined Expr if we
+        // can't do that cheaply. Comparisons between vectors whose
+        // difference is a ramp change monotonically across the lanes,
+        // so it suffices to check the first and last lanes.
+        Expr all_lanes_true(Expr cond) {
+            if (const And *a = cond.as<And>()) {
+                Expr ta = all_lanes_true(a->a), tb = all_lanes_true(a->b);
+                if (!ta.defined() || !tb.defined()) return Expr();
+                return ta && tb;
+            }
+
+            Expr lhs, rhs;
+            bool strict = false;
+            if (const LE *le = cond.as<LE>()) {
+                lhs = le->a; rhs = le->b;
+            } else if (const LT *lt = cond.as<LT>()) {
+                lhs = lt->a; rhs = lt->b; strict = true;
+            } else if (const GE *ge = cond.as<GE>()) {
+                lhs = ge->b; rhs = ge->a;
+            } else if (const GT *gt = cond.as<GT>()) {
+                lhs = gt->b; rhs = gt->a; strict = true;
+            } else {
+                return Expr();
+            }
+
+            if (!lhs.type().is_int()) return Expr();
+
+            // Compute lhs - rhs, which must be <= 0 (or < 0) in every lane.
+            Expr diff = simplify(expand_lets(lhs) - expand_lets(rhs));
+            Expr first, last;
+            if (const Ramp *r = diff.as<Ramp>()) {
+                first = r->base;
+                last = r->base + r->stride * (r->width - 1);
+            } else if (const Broadcast *b = diff.as<Broadcast>()) {
+                first = last = b->value;
+            } else {
+                return Expr();
+            }
+
+            Expr zero = make_zero(first.type());
+            if (strict) {
+                return simplify(first < zero && last < zero);
+            } else {
+                return simplify(first <= zero && last <= zero);
+            }
+        }
+
         Stmt scalarize(Stmt s) {
             Stmt result;
             int width = replacement.type().width;
@@ -407,8 +650,9 @@ class VectorizeLoops : public IRMutator {
         }
 
     public:
-        VectorSubs(string v, Expr r) : var(v), replacement(r),
-                                       scalarized(false), scalar_lane(0) {
+        VectorSubs(string v, Expr r, bool p, bool f) : var(v), replacement(r),
+                                                       scalarized(false), scalar_lane(0),
+                                                       predicate_tails(p), reassociate_floats(f) {
         }
     };
 
@@ -427,7 +671,15 @@ class VectorizeLoops : public IRMutator {
             // Replace the var with a ramp within the body
             Expr for_var = Variable::make(Int(32), for_loop->name);
             Expr replacement = Ramp::make(for_var, 1, extent->value);
-            Stmt body = VectorSubs(for_loop->name, replacement).mutate(for_loop->body);
+            bool reassociate_floats = false;
+            for (set<string>::const_iterator iter = reassociating.begin();
+                 iter != reassociating.end(); ++iter) {
+                if (starts_with(for_loop->name, *iter)) {
+                    reassociate_floats = true;
+                }
+            }
+            Stmt body = VectorSubs(for_loop->name, replacement,
+                                   predicate_tails, reassociate_floats).mutate(for_loop->body);
 
             // The for loop becomes a simple let statement
             stmt = LetStmt::make(for_loop->name, for_loop->min, body);
@@ -437,10 +689,107 @@ class VectorizeLoops : public IRMutator {
         }
     }
 
+public:
+    VectorizeLoops(bool p, const set<string> &r) : predicate_tails(p), reassociating(r) {}
+};
+
+// Vectorizing an associative update across a reduction variable
+// that the update site doesn't depend on leaves a horizontal
+// reduction of a vector in the body of the update. If that body is
+// the entire body of a serial loop that also doesn't change the
+// site, we can instead keep a vector of partial results for the
+// duration of the loop, and only combine the lanes once at the end.
+class HoistVectorReductions : public IRMutator {
+    using IRMutator::visit;
+
+    void visit(const For *op) {
+        IRMutator::visit(op);
+        const For *loop = stmt.as<For>();
+        if (!loop || loop->for_type != For::Serial) {
+            return;
+        }
+
+        // Dig through any lets to find the update
+        vector<std::pair<string, Expr> > lets;
+        Stmt body = loop->body;
+        while (const LetStmt *let = body.as<LetStmt>()) {
+            lets.push_back(std::make_pair(let->name, let->value));
+            body = let->body;
+        }
+
+        const Store *store = body.as<Store>();
+        if (!store) return;
+
+        string reduce_op;
+        Expr self, other;
+        if (!match_associative_update(store, &reduce_op, &self, &other)) {
+            return;
+        }
+
+        const Call *reduce = other.as<Call>();
+        if (!reduce ||
+            reduce->call_type != Call::Intrinsic ||
+            reduce->name != reduce_op) {
+            return;
+        }
+
+        // The site must be the same on every iteration.
+        if (expr_uses_var(store->index, loop->name)) {
+            return;
+        }
+        for (size_t i = 0; i < lets.size(); i++) {
+            if (expr_uses_var(store->index, lets[i].first)) {
+                return;
+            }
+        }
+
+        debug(3) << "Hoisting horizontal reduction out of loop over " << loop->name << "\n";
+
+        Expr v = reduce->args[0];
+        Type t = v.type();
+        string acc_name = unique_name(store->name + ".accumulator", false);
+        Expr acc_index = Ramp::make(0, 1, t.width);
+        Expr acc = Load::make(t, acc_name, acc_index, Buffer(), Parameter());
+
+        Stmt update = Store::make(acc_name, associative_combine(reduce_op, acc, v), acc_index);
+        for (size_t i = lets.size(); i > 0; i--) {
+            update = LetStmt::make(lets[i-1].first, lets[i-1].second, update);
+        }
+
+        Stmt init = Store::make(acc_name, associative_identity(reduce_op, t), acc_index);
+        Stmt new_loop = For::make(loop->name, loop->min, loop->extent, loop->for_type, update);
+        Expr reduced = Call::make(t.element_of(), reduce_op, vec(acc), Call::Intrinsic);
+        Stmt final = Store::make(store->name, rebuild_associative_update(store, reduce_op, self, reduced), store->index);
+
+        stmt = Block::make(init, Block::make(new_loop, final));
+        stmt = Allocate::make(acc_name, t.element_of(), vec(Expr(t.width)), stmt);
+    }
 };
 
-Stmt vectorize_loops(Stmt s) {
-    return VectorizeLoops().mutate(s);
+namespace {
+void find_reassociating_stages(const string &prefix, const Schedule &s, set<string> *stages) {
+    if (s.reassociate_floats()) {
+        stages->insert(prefix);
+    }
+    for (size_t i = 0; i < s.specializations().size(); i++) {
+        find_reassociating_stages(prefix, s.specializations()[i].schedule, stages);
+    }
+}
+}
+
+Stmt vectorize_loops(Stmt s, const map<string, Function> &env, bool predicate_tails) {
+    set<string> reassociating;
+    for (map<string, Function>::const_iterator iter = env.begin();
+         iter != env.end(); ++iter) {
+        const Function &f = iter->second;
+        for (size_t i = 0; i < f.reductions().size(); i++) {
+            string prefix = f.name() + ".s" + int_to_string(i+1) + ".";
+            find_reassociating_stages(prefix, f.reductions()[i].schedule, &reassociating);
+        }
+    }
+
+    s = VectorizeLoops(predicate_tails, reassociating).mutate(s);
+    return HoistVectorReductions().mutate(s);
 }
 
 }
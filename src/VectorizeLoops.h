@@ -5,16 +5,40 @@
  * Defines the lowering pass that vectorizes loops marked as such
  */
 
+#include <map>
+
 #include "IR.h"
 
 namespace Halide {
 namespace Internal {
 
+class Function;
+
 /** Take a statement with for loops marked for vectorization, and turn
  * them into single statements that operate on vectors. The loops in
  * question must have constant extent.
+ *
+ * If predicate_tails is true, the last vector of a loop guarded with
+ * an if (e.g. by TailStrategy::GuardWithIf) is run as a vector with
+ * its loads and stores masked off in the inactive lanes, rather than
+ * one lane at a time. This is expressed as an if statement with a
+ * vector condition and no else case, which codegen knows how to
+ * predicate. Only useful on targets with masked loads and stores,
+ * such as AVX-512.
+ *
+ * Floating point sums and products across a reduction variable are
+ * only combined horizontally in update stages that allow
+ * reassociation (see ScheduleHandle::reassociate_floats). Otherwise
+ * they're applied one lane at a time.
  */
-Stmt vectorize_loops(Stmt);
+Stmt vectorize_loops(Stmt, const std::map<std::string, Function> &env,
+                     bool predicate_tails = false);
+
+/** Build Halide IR that combines the lanes of a vector using the
+ * associative operator named by one of the Call::vector_reduce_*
+ * intrinsics. Used by codegen targets that don't have a native
+ * horizontal reduction for the type in question. */
+Expr lower_vector_reduce(const std::string &reduce_op, Expr v);
 
 }
 }
@@ -37,6 +37,16 @@ define weak_odr double @cos_f64(double %x) nounwind uwtable readnone alwaysinlin
        ret double %y
 }
 
+define weak_odr float @fast_sin_f32(float %x) nounwind uwtable readnone alwaysinline {
+       %y = tail call float @sinf(float %x) nounwind readnone
+       ret float %y
+}
+
+define weak_odr float @fast_cos_f32(float %x) nounwind uwtable readnone alwaysinline {
+       %y = tail call float @cosf(float %x) nounwind readnone
+       ret float %y
+}
+
 declare float @expf(float) nounwind readnone
 declare double @exp(double) nounwind readnone
 
@@ -128,6 +138,19 @@ define weak_odr double @pow_f64(double %x, double %y) nounwind uwtable readnone
        ret double %z
 }
 
+declare float @fmaf(float, float, float) nounwind readnone
+declare double @fma(double, double, double) nounwind readnone
+
+define weak_odr float @fma_f32(float %x, float %y, float %z) nounwind uwtable readnone alwaysinline {
+       %w = tail call float @fmaf(float %x, float %y, float %z) nounwind readnone
+       ret float %w
+}
+
+define weak_odr double @fma_f64(double %x, double %y, double %z) nounwind uwtable readnone alwaysinline {
+       %w = tail call double @fma(double %x, double %y, double %z) nounwind readnone
+       ret double %w
+}
+
 declare float @asinf(float) nounwind readnone
 declare double @asin(double) nounwind readnone
 
@@ -37,6 +37,18 @@ define weak_odr double @cos_f64(double %x) nounwind uwtable readnone alwaysinlin
        ret double %y
 }
 
+; Scalar code gets no benefit from the approximations in
+; vector_math.ll, so the fast variants are the full ones.
+define weak_odr float @fast_sin_f32(float %x) nounwind uwtable readnone alwaysinline {
+       %y = tail call float @llvm.sin.f32(float %x) nounwind readnone
+       ret float %y
+}
+
+define weak_odr float @fast_cos_f32(float %x) nounwind uwtable readnone alwaysinline {
+       %y = tail call float @llvm.cos.f32(float %x) nounwind readnone
+       ret float %y
+}
+
 declare float @llvm.exp.f32(float) nounwind readnone
 declare double @llvm.exp.f64(double) nounwind readnone
 
@@ -133,6 +145,19 @@ define weak_odr double @pow_f64(double %x, double %y) nounwind uwtable readnone
        ret double %z
 }
 
+declare float @llvm.fma.f32(float, float, float) nounwind readnone
+declare double @llvm.fma.f64(double, double, double) nounwind readnone
+
+define weak_odr float @fma_f32(float %x, float %y, float %z) nounwind uwtable readnone alwaysinline {
+       %w = tail call float @llvm.fma.f32(float %x, float %y, float %z) nounwind readnone
+       ret float %w
+}
+
+define weak_odr double @fma_f64(double %x, double %y, double %z) nounwind uwtable readnone alwaysinline {
+       %w = tail call double @llvm.fma.f64(double %x, double %y, double %z) nounwind readnone
+       ret double %w
+}
+
 declare float @asinf(float) nounwind readnone
 declare double @asin(double) nounwind readnone
 
@@ -73,6 +73,19 @@ define weak_odr double @cos_f64(double %x) nounwind uwtable readnone alwaysinlin
        ret double %y
 }
 
+declare float @__nv_fast_sinf(float) nounwind readnone
+declare float @__nv_fast_cosf(float) nounwind readnone
+
+define weak_odr float @fast_sin_f32(float %x) nounwind uwtable readnone alwaysinline {
+       %y = tail call float @__nv_fast_sinf(float %x) nounwind readnone
+       ret float %y
+}
+
+define weak_odr float @fast_cos_f32(float %x) nounwind uwtable readnone alwaysinline {
+       %y = tail call float @__nv_fast_cosf(float %x) nounwind readnone
+       ret float %y
+}
+
 declare float @__nv_expf(float) nounwind readnone
 declare double @__nv_exp(double) nounwind readnone
 
@@ -166,6 +179,19 @@ define weak_odr double @pow_f64(double %x, double %y) nounwind uwtable readnone
        ret double %z
 }
 
+declare float @__nv_fmaf(float, float, float) nounwind readnone
+declare double @__nv_fma(double, double, double) nounwind readnone
+
+define weak_odr float @fma_f32(float %x, float %y, float %z) nounwind uwtable readnone alwaysinline {
+       %w = tail call float @__nv_fmaf(float %x, float %y, float %z) nounwind readnone
+       ret float %w
+}
+
+define weak_odr double @fma_f64(double %x, double %y, double %z) nounwind uwtable readnone alwaysinline {
+       %w = tail call double @__nv_fma(double %x, double %y, double %z) nounwind readnone
+       ret double %w
+}
+
 declare float @__nv_asinf(float) nounwind readnone
 declare double @__nv_asin(double) nounwind readnone
 
@@ -0,0 +1,686 @@
+; Vectorized sine and cosine for Float(32). Codegen calls foo_f32xN in
+; place of the scalar foo_f32 when it finds it, so with these, a
+; vectorized sin or cos no longer becomes one libm call per lane.
+;
+; sin_f32xN and cos_f32xN are the Cephes sinf and cosf: the argument is
+; reduced to [-pi/4, pi/4] by a multiple of pi/4 subtracted in three
+; parts, and one of two minimax polynomials evaluated, depending on the
+; octant. They are accurate to within a few ulps for |x| < 8192, and lose
+; accuracy gradually beyond that. Arguments of magnitude 2^30 or more,
+; infinities and nans return nan.
+;
+; fast_sin_f32xN and fast_cos_f32xN reduce the argument in one part and
+; use shorter polynomials. They are accurate to about 5e-5 for |x| < 100,
+; and return nonsense for arguments of magnitude 2^30 or more.
+
+define weak_odr <2 x float> @sin_f32x2(<2 x float> %x) nounwind readnone alwaysinline {
+       %bits = bitcast <2 x float> %x to <2 x i32>
+       %sign = and <2 x i32> %bits, <i32 -2147483648, i32 -2147483648>
+       %abs_bits = and <2 x i32> %bits, <i32 2147483647, i32 2147483647>
+       %abs_x = bitcast <2 x i32> %abs_bits to <2 x float>
+       %in_range = fcmp olt <2 x float> %abs_x, <float 0x41D0000000000000, float 0x41D0000000000000>
+       %xa = select <2 x i1> %in_range, <2 x float> %abs_x, <2 x float> zeroinitializer
+       %octant_f = fmul <2 x float> %xa, <float 0x3FF45F3060000000, float 0x3FF45F3060000000>
+       %octant_i = fptosi <2 x float> %octant_f to <2 x i32>
+       %octant_plus_one = add <2 x i32> %octant_i, <i32 1, i32 1>
+       %j = and <2 x i32> %octant_plus_one, <i32 -2, i32 -2>
+       %y = sitofp <2 x i32> %j to <2 x float>
+       %y_dp1 = fmul <2 x float> %y, <float 0x3FE9200000000000, float 0x3FE9200000000000>
+       %z1 = fsub <2 x float> %xa, %y_dp1
+       %y_dp2 = fmul <2 x float> %y, <float 0x3F2FB40000000000, float 0x3F2FB40000000000>
+       %z2 = fsub <2 x float> %z1, %y_dp2
+       %y_dp3 = fmul <2 x float> %y, <float 0x3E64442D20000000, float 0x3E64442D20000000>
+       %z = fsub <2 x float> %z2, %y_dp3
+       %zz = fmul <2 x float> %z, %z
+       %sin_p1 = fmul <2 x float> %zz, <float 0xBF29943F20000000, float 0xBF29943F20000000>
+       %sin_p2 = fadd <2 x float> %sin_p1, <float 0x3F811073C0000000, float 0x3F811073C0000000>
+       %sin_p3 = fmul <2 x float> %sin_p2, %zz
+       %sin_p4 = fadd <2 x float> %sin_p3, <float 0xBFC5555460000000, float 0xBFC5555460000000>
+       %sin_p5 = fmul <2 x float> %sin_p4, %zz
+       %sin_p6 = fmul <2 x float> %sin_p5, %z
+       %sin_poly = fadd <2 x float> %sin_p6, %z
+       %cos_p0 = fmul <2 x float> %zz, <float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000>
+       %cos_p1 = fadd <2 x float> %cos_p0, <float 0xBF56C0C340000000, float 0xBF56C0C340000000>
+       %cos_p1a = fmul <2 x float> %cos_p1, %zz
+       %cos_p2 = fadd <2 x float> %cos_p1a, <float 0x3FA55554A0000000, float 0x3FA55554A0000000>
+       %cos_p3 = fmul <2 x float> %cos_p2, %zz
+       %cos_p4 = fmul <2 x float> %cos_p3, %zz
+       %half_zz = fmul <2 x float> %zz, <float 0x3FE0000000000000, float 0x3FE0000000000000>
+       %cos_p5 = fsub <2 x float> %cos_p4, %half_zz
+       %cos_poly = fadd <2 x float> %cos_p5, <float 0x3FF0000000000000, float 0x3FF0000000000000>
+       %j_and_2 = and <2 x i32> %j, <i32 2, i32 2>
+       %odd_quadrant = icmp ne <2 x i32> %j_and_2, zeroinitializer
+       %poly = select <2 x i1> %odd_quadrant, <2 x float> %cos_poly, <2 x float> %sin_poly
+       %j_and_4 = and <2 x i32> %j, <i32 4, i32 4>
+       %flip = shl <2 x i32> %j_and_4, <i32 29, i32 29>
+       %poly_bits = bitcast <2 x float> %poly to <2 x i32>
+       %result_sign = xor <2 x i32> %sign, %flip
+       %result_bits = xor <2 x i32> %poly_bits, %result_sign
+       %result = bitcast <2 x i32> %result_bits to <2 x float>
+       %checked = select <2 x i1> %in_range, <2 x float> %result, <2 x float> <float 0x7FF8000000000000, float 0x7FF8000000000000>
+       ret <2 x float> %checked
+}
+
+define weak_odr <2 x float> @cos_f32x2(<2 x float> %x) nounwind readnone alwaysinline {
+       %bits = bitcast <2 x float> %x to <2 x i32>
+       %abs_bits = and <2 x i32> %bits, <i32 2147483647, i32 2147483647>
+       %abs_x = bitcast <2 x i32> %abs_bits to <2 x float>
+       %in_range = fcmp olt <2 x float> %abs_x, <float 0x41D0000000000000, float 0x41D0000000000000>
+       %xa = select <2 x i1> %in_range, <2 x float> %abs_x, <2 x float> zeroinitializer
+       %octant_f = fmul <2 x float> %xa, <float 0x3FF45F3060000000, float 0x3FF45F3060000000>
+       %octant_i = fptosi <2 x float> %octant_f to <2 x i32>
+       %octant_plus_one = add <2 x i32> %octant_i, <i32 1, i32 1>
+       %j = and <2 x i32> %octant_plus_one, <i32 -2, i32 -2>
+       %y = sitofp <2 x i32> %j to <2 x float>
+       %y_dp1 = fmul <2 x float> %y, <float 0x3FE9200000000000, float 0x3FE9200000000000>
+       %z1 = fsub <2 x float> %xa, %y_dp1
+       %y_dp2 = fmul <2 x float> %y, <float 0x3F2FB40000000000, float 0x3F2FB40000000000>
+       %z2 = fsub <2 x float> %z1, %y_dp2
+       %y_dp3 = fmul <2 x float> %y, <float 0x3E64442D20000000, float 0x3E64442D20000000>
+       %z = fsub <2 x float> %z2, %y_dp3
+       %zz = fmul <2 x float> %z, %z
+       %sin_p1 = fmul <2 x float> %zz, <float 0xBF29943F20000000, float 0xBF29943F20000000>
+       %sin_p2 = fadd <2 x float> %sin_p1, <float 0x3F811073C0000000, float 0x3F811073C0000000>
+       %sin_p3 = fmul <2 x float> %sin_p2, %zz
+       %sin_p4 = fadd <2 x float> %sin_p3, <float 0xBFC5555460000000, float 0xBFC5555460000000>
+       %sin_p5 = fmul <2 x float> %sin_p4, %zz
+       %sin_p6 = fmul <2 x float> %sin_p5, %z
+       %sin_poly = fadd <2 x float> %sin_p6, %z
+       %cos_p0 = fmul <2 x float> %zz, <float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000>
+       %cos_p1 = fadd <2 x float> %cos_p0, <float 0xBF56C0C340000000, float 0xBF56C0C340000000>
+       %cos_p1a = fmul <2 x float> %cos_p1, %zz
+       %cos_p2 = fadd <2 x float> %cos_p1a, <float 0x3FA55554A0000000, float 0x3FA55554A0000000>
+       %cos_p3 = fmul <2 x float> %cos_p2, %zz
+       %cos_p4 = fmul <2 x float> %cos_p3, %zz
+       %half_zz = fmul <2 x float> %zz, <float 0x3FE0000000000000, float 0x3FE0000000000000>
+       %cos_p5 = fsub <2 x float> %cos_p4, %half_zz
+       %cos_poly = fadd <2 x float> %cos_p5, <float 0x3FF0000000000000, float 0x3FF0000000000000>
+       %j_and_2 = and <2 x i32> %j, <i32 2, i32 2>
+       %odd_quadrant = icmp ne <2 x i32> %j_and_2, zeroinitializer
+       %poly = select <2 x i1> %odd_quadrant, <2 x float> %sin_poly, <2 x float> %cos_poly
+       %j_plus_2 = add <2 x i32> %j, <i32 2, i32 2>
+       %j_and_4 = and <2 x i32> %j_plus_2, <i32 4, i32 4>
+       %flip = shl <2 x i32> %j_and_4, <i32 29, i32 29>
+       %poly_bits = bitcast <2 x float> %poly to <2 x i32>
+       %result_bits = xor <2 x i32> %poly_bits, %flip
+       %result = bitcast <2 x i32> %result_bits to <2 x float>
+       %checked = select <2 x i1> %in_range, <2 x float> %result, <2 x float> <float 0x7FF8000000000000, float 0x7FF8000000000000>
+       ret <2 x float> %checked
+}
+
+define weak_odr <2 x float> @fast_sin_f32x2(<2 x float> %x) nounwind readnone alwaysinline {
+       %bits = bitcast <2 x float> %x to <2 x i32>
+       %sign = and <2 x i32> %bits, <i32 -2147483648, i32 -2147483648>
+       %abs_bits = and <2 x i32> %bits, <i32 2147483647, i32 2147483647>
+       %abs_x = bitcast <2 x i32> %abs_bits to <2 x float>
+       %octant_f = fmul <2 x float> %abs_x, <float 0x3FF45F3060000000, float 0x3FF45F3060000000>
+       %octant_i = fptosi <2 x float> %octant_f to <2 x i32>
+       %octant_plus_one = add <2 x i32> %octant_i, <i32 1, i32 1>
+       %j = and <2 x i32> %octant_plus_one, <i32 -2, i32 -2>
+       %y = sitofp <2 x i32> %j to <2 x float>
+       %y_pio4 = fmul <2 x float> %y, <float 0x3FE921FB60000000, float 0x3FE921FB60000000>
+       %z = fsub <2 x float> %abs_x, %y_pio4
+       %zz = fmul <2 x float> %z, %z
+       %sin_p1 = fmul <2 x float> %zz, <float 0x3F811073C0000000, float 0x3F811073C0000000>
+       %sin_p2 = fadd <2 x float> %sin_p1, <float 0xBFC5555460000000, float 0xBFC5555460000000>
+       %sin_p3 = fmul <2 x float> %sin_p2, %zz
+       %sin_p4 = fmul <2 x float> %sin_p3, %z
+       %sin_poly = fadd <2 x float> %sin_p4, %z
+       %cos_p1 = fmul <2 x float> %zz, <float 0xBF56C0C340000000, float 0xBF56C0C340000000>
+       %cos_p2 = fadd <2 x float> %cos_p1, <float 0x3FA55554A0000000, float 0x3FA55554A0000000>
+       %cos_p3 = fmul <2 x float> %cos_p2, %zz
+       %cos_p4 = fmul <2 x float> %cos_p3, %zz
+       %half_zz = fmul <2 x float> %zz, <float 0x3FE0000000000000, float 0x3FE0000000000000>
+       %cos_p5 = fsub <2 x float> %cos_p4, %half_zz
+       %cos_poly = fadd <2 x float> %cos_p5, <float 0x3FF0000000000000, float 0x3FF0000000000000>
+       %j_and_2 = and <2 x i32> %j, <i32 2, i32 2>
+       %odd_quadrant = icmp ne <2 x i32> %j_and_2, zeroinitializer
+       %poly = select <2 x i1> %odd_quadrant, <2 x float> %cos_poly, <2 x float> %sin_poly
+       %j_and_4 = and <2 x i32> %j, <i32 4, i32 4>
+       %flip = shl <2 x i32> %j_and_4, <i32 29, i32 29>
+       %poly_bits = bitcast <2 x float> %poly to <2 x i32>
+       %result_sign = xor <2 x i32> %sign, %flip
+       %result_bits = xor <2 x i32> %poly_bits, %result_sign
+       %result = bitcast <2 x i32> %result_bits to <2 x float>
+       ret <2 x float> %result
+}
+
+define weak_odr <2 x float> @fast_cos_f32x2(<2 x float> %x) nounwind readnone alwaysinline {
+       %bits = bitcast <2 x float> %x to <2 x i32>
+       %abs_bits = and <2 x i32> %bits, <i32 2147483647, i32 2147483647>
+       %abs_x = bitcast <2 x i32> %abs_bits to <2 x float>
+       %octant_f = fmul <2 x float> %abs_x, <float 0x3FF45F3060000000, float 0x3FF45F3060000000>
+       %octant_i = fptosi <2 x float> %octant_f to <2 x i32>
+       %octant_plus_one = add <2 x i32> %octant_i, <i32 1, i32 1>
+       %j = and <2 x i32> %octant_plus_one, <i32 -2, i32 -2>
+       %y = sitofp <2 x i32> %j to <2 x float>
+       %y_pio4 = fmul <2 x float> %y, <float 0x3FE921FB60000000, float 0x3FE921FB60000000>
+       %z = fsub <2 x float> %abs_x, %y_pio4
+       %zz = fmul <2 x float> %z, %z
+       %sin_p1 = fmul <2 x float> %zz, <float 0x3F811073C0000000, float 0x3F811073C0000000>
+       %sin_p2 = fadd <2 x float> %sin_p1, <float 0xBFC5555460000000, float 0xBFC5555460000000>
+       %sin_p3 = fmul <2 x float> %sin_p2, %zz
+       %sin_p4 = fmul <2 x float> %sin_p3, %z
+       %sin_poly = fadd <2 x float> %sin_p4, %z
+       %cos_p1 = fmul <2 x float> %zz, <float 0xBF56C0C340000000, float 0xBF56C0C340000000>
+       %cos_p2 = fadd <2 x float> %cos_p1, <float 0x3FA55554A0000000, float 0x3FA55554A0000000>
+       %cos_p3 = fmul <2 x float> %cos_p2, %zz
+       %cos_p4 = fmul <2 x float> %cos_p3, %zz
+       %half_zz = fmul <2 x float> %zz, <float 0x3FE0000000000000, float 0x3FE0000000000000>
+       %cos_p5 = fsub <2 x float> %cos_p4, %half_zz
+       %cos_poly = fadd <2 x float> %cos_p5, <float 0x3FF0000000000000, float 0x3FF0000000000000>
+       %j_and_2 = and <2 x i32> %j, <i32 2, i32 2>
+       %odd_quadrant = icmp ne <2 x i32> %j_and_2, zeroinitializer
+       %poly = select <2 x i1> %odd_quadrant, <2 x float> %sin_poly, <2 x float> %cos_poly
+       %j_plus_2 = add <2 x i32> %j, <i32 2, i32 2>
+       %j_and_4 = and <2 x i32> %j_plus_2, <i32 4, i32 4>
+       %flip = shl <2 x i32> %j_and_4, <i32 29, i32 29>
+       %poly_bits = bitcast <2 x float> %poly to <2 x i32>
+       %result_bits = xor <2 x i32> %poly_bits, %flip
+       %result = bitcast <2 x i32> %result_bits to <2 x float>
+       ret <2 x float> %result
+}
+
+define weak_odr <4 x float> @sin_f32x4(<4 x float> %x) nounwind readnone alwaysinline {
+       %bits = bitcast <4 x float> %x to <4 x i32>
+       %sign = and <4 x i32> %bits, <i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648>
+       %abs_bits = and <4 x i32> %bits, <i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647>
+       %abs_x = bitcast <4 x i32> %abs_bits to <4 x float>
+       %in_range = fcmp olt <4 x float> %abs_x, <float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000>
+       %xa = select <4 x i1> %in_range, <4 x float> %abs_x, <4 x float> zeroinitializer
+       %octant_f = fmul <4 x float> %xa, <float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000>
+       %octant_i = fptosi <4 x float> %octant_f to <4 x i32>
+       %octant_plus_one = add <4 x i32> %octant_i, <i32 1, i32 1, i32 1, i32 1>
+       %j = and <4 x i32> %octant_plus_one, <i32 -2, i32 -2, i32 -2, i32 -2>
+       %y = sitofp <4 x i32> %j to <4 x float>
+       %y_dp1 = fmul <4 x float> %y, <float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000>
+       %z1 = fsub <4 x float> %xa, %y_dp1
+       %y_dp2 = fmul <4 x float> %y, <float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000>
+       %z2 = fsub <4 x float> %z1, %y_dp2
+       %y_dp3 = fmul <4 x float> %y, <float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000>
+       %z = fsub <4 x float> %z2, %y_dp3
+       %zz = fmul <4 x float> %z, %z
+       %sin_p1 = fmul <4 x float> %zz, <float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000>
+       %sin_p2 = fadd <4 x float> %sin_p1, <float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000>
+       %sin_p3 = fmul <4 x float> %sin_p2, %zz
+       %sin_p4 = fadd <4 x float> %sin_p3, <float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000>
+       %sin_p5 = fmul <4 x float> %sin_p4, %zz
+       %sin_p6 = fmul <4 x float> %sin_p5, %z
+       %sin_poly = fadd <4 x float> %sin_p6, %z
+       %cos_p0 = fmul <4 x float> %zz, <float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000>
+       %cos_p1 = fadd <4 x float> %cos_p0, <float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000>
+       %cos_p1a = fmul <4 x float> %cos_p1, %zz
+       %cos_p2 = fadd <4 x float> %cos_p1a, <float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000>
+       %cos_p3 = fmul <4 x float> %cos_p2, %zz
+       %cos_p4 = fmul <4 x float> %cos_p3, %zz
+       %half_zz = fmul <4 x float> %zz, <float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000>
+       %cos_p5 = fsub <4 x float> %cos_p4, %half_zz
+       %cos_poly = fadd <4 x float> %cos_p5, <float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000>
+       %j_and_2 = and <4 x i32> %j, <i32 2, i32 2, i32 2, i32 2>
+       %odd_quadrant = icmp ne <4 x i32> %j_and_2, zeroinitializer
+       %poly = select <4 x i1> %odd_quadrant, <4 x float> %cos_poly, <4 x float> %sin_poly
+       %j_and_4 = and <4 x i32> %j, <i32 4, i32 4, i32 4, i32 4>
+       %flip = shl <4 x i32> %j_and_4, <i32 29, i32 29, i32 29, i32 29>
+       %poly_bits = bitcast <4 x float> %poly to <4 x i32>
+       %result_sign = xor <4 x i32> %sign, %flip
+       %result_bits = xor <4 x i32> %poly_bits, %result_sign
+       %result = bitcast <4 x i32> %result_bits to <4 x float>
+       %checked = select <4 x i1> %in_range, <4 x float> %result, <4 x float> <float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000>
+       ret <4 x float> %checked
+}
+
+define weak_odr <4 x float> @cos_f32x4(<4 x float> %x) nounwind readnone alwaysinline {
+       %bits = bitcast <4 x float> %x to <4 x i32>
+       %abs_bits = and <4 x i32> %bits, <i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647>
+       %abs_x = bitcast <4 x i32> %abs_bits to <4 x float>
+       %in_range = fcmp olt <4 x float> %abs_x, <float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000>
+       %xa = select <4 x i1> %in_range, <4 x float> %abs_x, <4 x float> zeroinitializer
+       %octant_f = fmul <4 x float> %xa, <float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000>
+       %octant_i = fptosi <4 x float> %octant_f to <4 x i32>
+       %octant_plus_one = add <4 x i32> %octant_i, <i32 1, i32 1, i32 1, i32 1>
+       %j = and <4 x i32> %octant_plus_one, <i32 -2, i32 -2, i32 -2, i32 -2>
+       %y = sitofp <4 x i32> %j to <4 x float>
+       %y_dp1 = fmul <4 x float> %y, <float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000>
+       %z1 = fsub <4 x float> %xa, %y_dp1
+       %y_dp2 = fmul <4 x float> %y, <float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000>
+       %z2 = fsub <4 x float> %z1, %y_dp2
+       %y_dp3 = fmul <4 x float> %y, <float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000>
+       %z = fsub <4 x float> %z2, %y_dp3
+       %zz = fmul <4 x float> %z, %z
+       %sin_p1 = fmul <4 x float> %zz, <float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000>
+       %sin_p2 = fadd <4 x float> %sin_p1, <float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000>
+       %sin_p3 = fmul <4 x float> %sin_p2, %zz
+       %sin_p4 = fadd <4 x float> %sin_p3, <float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000>
+       %sin_p5 = fmul <4 x float> %sin_p4, %zz
+       %sin_p6 = fmul <4 x float> %sin_p5, %z
+       %sin_poly = fadd <4 x float> %sin_p6, %z
+       %cos_p0 = fmul <4 x float> %zz, <float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000>
+       %cos_p1 = fadd <4 x float> %cos_p0, <float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000>
+       %cos_p1a = fmul <4 x float> %cos_p1, %zz
+       %cos_p2 = fadd <4 x float> %cos_p1a, <float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000>
+       %cos_p3 = fmul <4 x float> %cos_p2, %zz
+       %cos_p4 = fmul <4 x float> %cos_p3, %zz
+       %half_zz = fmul <4 x float> %zz, <float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000>
+       %cos_p5 = fsub <4 x float> %cos_p4, %half_zz
+       %cos_poly = fadd <4 x float> %cos_p5, <float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000>
+       %j_and_2 = and <4 x i32> %j, <i32 2, i32 2, i32 2, i32 2>
+       %odd_quadrant = icmp ne <4 x i32> %j_and_2, zeroinitializer
+       %poly = select <4 x i1> %odd_quadrant, <4 x float> %sin_poly, <4 x float> %cos_poly
+       %j_plus_2 = add <4 x i32> %j, <i32 2, i32 2, i32 2, i32 2>
+       %j_and_4 = and <4 x i32> %j_plus_2, <i32 4, i32 4, i32 4, i32 4>
+       %flip = shl <4 x i32> %j_and_4, <i32 29, i32 29, i32 29, i32 29>
+       %poly_bits = bitcast <4 x float> %poly to <4 x i32>
+       %result_bits = xor <4 x i32> %poly_bits, %flip
+       %result = bitcast <4 x i32> %result_bits to <4 x float>
+       %checked = select <4 x i1> %in_range, <4 x float> %result, <4 x float> <float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000>
+       ret <4 x float> %checked
+}
+
+define weak_odr <4 x float> @fast_sin_f32x4(<4 x float> %x) nounwind readnone alwaysinline {
+       %bits = bitcast <4 x float> %x to <4 x i32>
+       %sign = and <4 x i32> %bits, <i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648>
+       %abs_bits = and <4 x i32> %bits, <i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647>
+       %abs_x = bitcast <4 x i32> %abs_bits to <4 x float>
+       %octant_f = fmul <4 x float> %abs_x, <float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000>
+       %octant_i = fptosi <4 x float> %octant_f to <4 x i32>
+       %octant_plus_one = add <4 x i32> %octant_i, <i32 1, i32 1, i32 1, i32 1>
+       %j = and <4 x i32> %octant_plus_one, <i32 -2, i32 -2, i32 -2, i32 -2>
+       %y = sitofp <4 x i32> %j to <4 x float>
+       %y_pio4 = fmul <4 x float> %y, <float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000>
+       %z = fsub <4 x float> %abs_x, %y_pio4
+       %zz = fmul <4 x float> %z, %z
+       %sin_p1 = fmul <4 x float> %zz, <float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000>
+       %sin_p2 = fadd <4 x float> %sin_p1, <float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000>
+       %sin_p3 = fmul <4 x float> %sin_p2, %zz
+       %sin_p4 = fmul <4 x float> %sin_p3, %z
+       %sin_poly = fadd <4 x float> %sin_p4, %z
+       %cos_p1 = fmul <4 x float> %zz, <float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000>
+       %cos_p2 = fadd <4 x float> %cos_p1, <float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000>
+       %cos_p3 = fmul <4 x float> %cos_p2, %zz
+       %cos_p4 = fmul <4 x float> %cos_p3, %zz
+       %half_zz = fmul <4 x float> %zz, <float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000>
+       %cos_p5 = fsub <4 x float> %cos_p4, %half_zz
+       %cos_poly = fadd <4 x float> %cos_p5, <float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000>
+       %j_and_2 = and <4 x i32> %j, <i32 2, i32 2, i32 2, i32 2>
+       %odd_quadrant = icmp ne <4 x i32> %j_and_2, zeroinitializer
+       %poly = select <4 x i1> %odd_quadrant, <4 x float> %cos_poly, <4 x float> %sin_poly
+       %j_and_4 = and <4 x i32> %j, <i32 4, i32 4, i32 4, i32 4>
+       %flip = shl <4 x i32> %j_and_4, <i32 29, i32 29, i32 29, i32 29>
+       %poly_bits = bitcast <4 x float> %poly to <4 x i32>
+       %result_sign = xor <4 x i32> %sign, %flip
+       %result_bits = xor <4 x i32> %poly_bits, %result_sign
+       %result = bitcast <4 x i32> %result_bits to <4 x float>
+       ret <4 x float> %result
+}
+
+define weak_odr <4 x float> @fast_cos_f32x4(<4 x float> %x) nounwind readnone alwaysinline {
+       %bits = bitcast <4 x float> %x to <4 x i32>
+       %abs_bits = and <4 x i32> %bits, <i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647>
+       %abs_x = bitcast <4 x i32> %abs_bits to <4 x float>
+       %octant_f = fmul <4 x float> %abs_x, <float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000>
+       %octant_i = fptosi <4 x float> %octant_f to <4 x i32>
+       %octant_plus_one = add <4 x i32> %octant_i, <i32 1, i32 1, i32 1, i32 1>
+       %j = and <4 x i32> %octant_plus_one, <i32 -2, i32 -2, i32 -2, i32 -2>
+       %y = sitofp <4 x i32> %j to <4 x float>
+       %y_pio4 = fmul <4 x float> %y, <float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000>
+       %z = fsub <4 x float> %abs_x, %y_pio4
+       %zz = fmul <4 x float> %z, %z
+       %sin_p1 = fmul <4 x float> %zz, <float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000>
+       %sin_p2 = fadd <4 x float> %sin_p1, <float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000>
+       %sin_p3 = fmul <4 x float> %sin_p2, %zz
+       %sin_p4 = fmul <4 x float> %sin_p3, %z
+       %sin_poly = fadd <4 x float> %sin_p4, %z
+       %cos_p1 = fmul <4 x float> %zz, <float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000>
+       %cos_p2 = fadd <4 x float> %cos_p1, <float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000>
+       %cos_p3 = fmul <4 x float> %cos_p2, %zz
+       %cos_p4 = fmul <4 x float> %cos_p3, %zz
+       %half_zz = fmul <4 x float> %zz, <float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000>
+       %cos_p5 = fsub <4 x float> %cos_p4, %half_zz
+       %cos_poly = fadd <4 x float> %cos_p5, <float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000>
+       %j_and_2 = and <4 x i32> %j, <i32 2, i32 2, i32 2, i32 2>
+       %odd_quadrant = icmp ne <4 x i32> %j_and_2, zeroinitializer
+       %poly = select <4 x i1> %odd_quadrant, <4 x float> %sin_poly, <4 x float> %cos_poly
+       %j_plus_2 = add <4 x i32> %j, <i32 2, i32 2, i32 2, i32 2>
+       %j_and_4 = and <4 x i32> %j_plus_2, <i32 4, i32 4, i32 4, i32 4>
+       %flip = shl <4 x i32> %j_and_4, <i32 29, i32 29, i32 29, i32 29>
+       %poly_bits = bitcast <4 x float> %poly to <4 x i32>
+       %result_bits = xor <4 x i32> %poly_bits, %flip
+       %result = bitcast <4 x i32> %result_bits to <4 x float>
+       ret <4 x float> %result
+}
+
+define weak_odr <8 x float> @sin_f32x8(<8 x float> %x) nounwind readnone alwaysinline {
+       %bits = bitcast <8 x float> %x to <8 x i32>
+       %sign = and <8 x i32> %bits, <i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648>
+       %abs_bits = and <8 x i32> %bits, <i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647>
+       %abs_x = bitcast <8 x i32> %abs_bits to <8 x float>
+       %in_range = fcmp olt <8 x float> %abs_x, <float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000>
+       %xa = select <8 x i1> %in_range, <8 x float> %abs_x, <8 x float> zeroinitializer
+       %octant_f = fmul <8 x float> %xa, <float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000>
+       %octant_i = fptosi <8 x float> %octant_f to <8 x i32>
+       %octant_plus_one = add <8 x i32> %octant_i, <i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1>
+       %j = and <8 x i32> %octant_plus_one, <i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2>
+       %y = sitofp <8 x i32> %j to <8 x float>
+       %y_dp1 = fmul <8 x float> %y, <float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000>
+       %z1 = fsub <8 x float> %xa, %y_dp1
+       %y_dp2 = fmul <8 x float> %y, <float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000>
+       %z2 = fsub <8 x float> %z1, %y_dp2
+       %y_dp3 = fmul <8 x float> %y, <float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000>
+       %z = fsub <8 x float> %z2, %y_dp3
+       %zz = fmul <8 x float> %z, %z
+       %sin_p1 = fmul <8 x float> %zz, <float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000>
+       %sin_p2 = fadd <8 x float> %sin_p1, <float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000>
+       %sin_p3 = fmul <8 x float> %sin_p2, %zz
+       %sin_p4 = fadd <8 x float> %sin_p3, <float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000>
+       %sin_p5 = fmul <8 x float> %sin_p4, %zz
+       %sin_p6 = fmul <8 x float> %sin_p5, %z
+       %sin_poly = fadd <8 x float> %sin_p6, %z
+       %cos_p0 = fmul <8 x float> %zz, <float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000>
+       %cos_p1 = fadd <8 x float> %cos_p0, <float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000>
+       %cos_p1a = fmul <8 x float> %cos_p1, %zz
+       %cos_p2 = fadd <8 x float> %cos_p1a, <float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000>
+       %cos_p3 = fmul <8 x float> %cos_p2, %zz
+       %cos_p4 = fmul <8 x float> %cos_p3, %zz
+       %half_zz = fmul <8 x float> %zz, <float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000>
+       %cos_p5 = fsub <8 x float> %cos_p4, %half_zz
+       %cos_poly = fadd <8 x float> %cos_p5, <float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000>
+       %j_and_2 = and <8 x i32> %j, <i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2>
+       %odd_quadrant = icmp ne <8 x i32> %j_and_2, zeroinitializer
+       %poly = select <8 x i1> %odd_quadrant, <8 x float> %cos_poly, <8 x float> %sin_poly
+       %j_and_4 = and <8 x i32> %j, <i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4>
+       %flip = shl <8 x i32> %j_and_4, <i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29>
+       %poly_bits = bitcast <8 x float> %poly to <8 x i32>
+       %result_sign = xor <8 x i32> %sign, %flip
+       %result_bits = xor <8 x i32> %poly_bits, %result_sign
+       %result = bitcast <8 x i32> %result_bits to <8 x float>
+       %checked = select <8 x i1> %in_range, <8 x float> %result, <8 x float> <float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000>
+       ret <8 x float> %checked
+}
+
+define weak_odr <8 x float> @cos_f32x8(<8 x float> %x) nounwind readnone alwaysinline {
+       %bits = bitcast <8 x float> %x to <8 x i32>
+       %abs_bits = and <8 x i32> %bits, <i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647>
+       %abs_x = bitcast <8 x i32> %abs_bits to <8 x float>
+       %in_range = fcmp olt <8 x float> %abs_x, <float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000>
+       %xa = select <8 x i1> %in_range, <8 x float> %abs_x, <8 x float> zeroinitializer
+       %octant_f = fmul <8 x float> %xa, <float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000>
+       %octant_i = fptosi <8 x float> %octant_f to <8 x i32>
+       %octant_plus_one = add <8 x i32> %octant_i, <i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1>
+       %j = and <8 x i32> %octant_plus_one, <i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2>
+       %y = sitofp <8 x i32> %j to <8 x float>
+       %y_dp1 = fmul <8 x float> %y, <float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000>
+       %z1 = fsub <8 x float> %xa, %y_dp1
+       %y_dp2 = fmul <8 x float> %y, <float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000>
+       %z2 = fsub <8 x float> %z1, %y_dp2
+       %y_dp3 = fmul <8 x float> %y, <float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000>
+       %z = fsub <8 x float> %z2, %y_dp3
+       %zz = fmul <8 x float> %z, %z
+       %sin_p1 = fmul <8 x float> %zz, <float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000>
+       %sin_p2 = fadd <8 x float> %sin_p1, <float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000>
+       %sin_p3 = fmul <8 x float> %sin_p2, %zz
+       %sin_p4 = fadd <8 x float> %sin_p3, <float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000>
+       %sin_p5 = fmul <8 x float> %sin_p4, %zz
+       %sin_p6 = fmul <8 x float> %sin_p5, %z
+       %sin_poly = fadd <8 x float> %sin_p6, %z
+       %cos_p0 = fmul <8 x float> %zz, <float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000>
+       %cos_p1 = fadd <8 x float> %cos_p0, <float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000>
+       %cos_p1a = fmul <8 x float> %cos_p1, %zz
+       %cos_p2 = fadd <8 x float> %cos_p1a, <float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000>
+       %cos_p3 = fmul <8 x float> %cos_p2, %zz
+       %cos_p4 = fmul <8 x float> %cos_p3, %zz
+       %half_zz = fmul <8 x float> %zz, <float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000>
+       %cos_p5 = fsub <8 x float> %cos_p4, %half_zz
+       %cos_poly = fadd <8 x float> %cos_p5, <float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000>
+       %j_and_2 = and <8 x i32> %j, <i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2>
+       %odd_quadrant = icmp ne <8 x i32> %j_and_2, zeroinitializer
+       %poly = select <8 x i1> %odd_quadrant, <8 x float> %sin_poly, <8 x float> %cos_poly
+       %j_plus_2 = add <8 x i32> %j, <i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2>
+       %j_and_4 = and <8 x i32> %j_plus_2, <i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4>
+       %flip = shl <8 x i32> %j_and_4, <i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29>
+       %poly_bits = bitcast <8 x float> %poly to <8 x i32>
+       %result_bits = xor <8 x i32> %poly_bits, %flip
+       %result = bitcast <8 x i32> %result_bits to <8 x float>
+       %checked = select <8 x i1> %in_range, <8 x float> %result, <8 x float> <float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000>
+       ret <8 x float> %checked
+}
+
+define weak_odr <8 x float> @fast_sin_f32x8(<8 x float> %x) nounwind readnone alwaysinline {
+       %bits = bitcast <8 x float> %x to <8 x i32>
+       %sign = and <8 x i32> %bits, <i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648>
+       %abs_bits = and <8 x i32> %bits, <i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647>
+       %abs_x = bitcast <8 x i32> %abs_bits to <8 x float>
+       %octant_f = fmul <8 x float> %abs_x, <float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000>
+       %octant_i = fptosi <8 x float> %octant_f to <8 x i32>
+       %octant_plus_one = add <8 x i32> %octant_i, <i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1>
+       %j = and <8 x i32> %octant_plus_one, <i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2>
+       %y = sitofp <8 x i32> %j to <8 x float>
+       %y_pio4 = fmul <8 x float> %y, <float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000>
+       %z = fsub <8 x float> %abs_x, %y_pio4
+       %zz = fmul <8 x float> %z, %z
+       %sin_p1 = fmul <8 x float> %zz, <float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000>
+       %sin_p2 = fadd <8 x float> %sin_p1, <float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000>
+       %sin_p3 = fmul <8 x float> %sin_p2, %zz
+       %sin_p4 = fmul <8 x float> %sin_p3, %z
+       %sin_poly = fadd <8 x float> %sin_p4, %z
+       %cos_p1 = fmul <8 x float> %zz, <float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000>
+       %cos_p2 = fadd <8 x float> %cos_p1, <float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000>
+       %cos_p3 = fmul <8 x float> %cos_p2, %zz
+       %cos_p4 = fmul <8 x float> %cos_p3, %zz
+       %half_zz = fmul <8 x float> %zz, <float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000>
+       %cos_p5 = fsub <8 x float> %cos_p4, %half_zz
+       %cos_poly = fadd <8 x float> %cos_p5, <float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000>
+       %j_and_2 = and <8 x i32> %j, <i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2>
+       %odd_quadrant = icmp ne <8 x i32> %j_and_2, zeroinitializer
+       %poly = select <8 x i1> %odd_quadrant, <8 x float> %cos_poly, <8 x float> %sin_poly
+       %j_and_4 = and <8 x i32> %j, <i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4>
+       %flip = shl <8 x i32> %j_and_4, <i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29>
+       %poly_bits = bitcast <8 x float> %poly to <8 x i32>
+       %result_sign = xor <8 x i32> %sign, %flip
+       %result_bits = xor <8 x i32> %poly_bits, %result_sign
+       %result = bitcast <8 x i32> %result_bits to <8 x float>
+       ret <8 x float> %result
+}
+
+define weak_odr <8 x float> @fast_cos_f32x8(<8 x float> %x) nounwind readnone alwaysinline {
+       %bits = bitcast <8 x float> %x to <8 x i32>
+       %abs_bits = and <8 x i32> %bits, <i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647>
+       %abs_x = bitcast <8 x i32> %abs_bits to <8 x float>
+       %octant_f = fmul <8 x float> %abs_x, <float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000>
+       %octant_i = fptosi <8 x float> %octant_f to <8 x i32>
+       %octant_plus_one = add <8 x i32> %octant_i, <i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1>
+       %j = and <8 x i32> %octant_plus_one, <i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2>
+       %y = sitofp <8 x i32> %j to <8 x float>
+       %y_pio4 = fmul <8 x float> %y, <float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000>
+       %z = fsub <8 x float> %abs_x, %y_pio4
+       %zz = fmul <8 x float> %z, %z
+       %sin_p1 = fmul <8 x float> %zz, <float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000>
+       %sin_p2 = fadd <8 x float> %sin_p1, <float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000>
+       %sin_p3 = fmul <8 x float> %sin_p2, %zz
+       %sin_p4 = fmul <8 x float> %sin_p3, %z
+       %sin_poly = fadd <8 x float> %sin_p4, %z
+       %cos_p1 = fmul <8 x float> %zz, <float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000>
+       %cos_p2 = fadd <8 x float> %cos_p1, <float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000>
+       %cos_p3 = fmul <8 x float> %cos_p2, %zz
+       %cos_p4 = fmul <8 x float> %cos_p3, %zz
+       %half_zz = fmul <8 x float> %zz, <float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000>
+       %cos_p5 = fsub <8 x float> %cos_p4, %half_zz
+       %cos_poly = fadd <8 x float> %cos_p5, <float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000>
+       %j_and_2 = and <8 x i32> %j, <i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2>
+       %odd_quadrant = icmp ne <8 x i32> %j_and_2, zeroinitializer
+       %poly = select <8 x i1> %odd_quadrant, <8 x float> %sin_poly, <8 x float> %cos_poly
+       %j_plus_2 = add <8 x i32> %j, <i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2>
+       %j_and_4 = and <8 x i32> %j_plus_2, <i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4>
+       %flip = shl <8 x i32> %j_and_4, <i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29>
+       %poly_bits = bitcast <8 x float> %poly to <8 x i32>
+       %result_bits = xor <8 x i32> %poly_bits, %flip
+       %result = bitcast <8 x i32> %result_bits to <8 x float>
+       ret <8 x float> %result
+}
+
+define weak_odr <16 x float> @sin_f32x16(<16 x float> %x) nounwind readnone alwaysinline {
+       %bits = bitcast <16 x float> %x to <16 x i32>
+       %sign = and <16 x i32> %bits, <i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648>
+       %abs_bits = and <16 x i32> %bits, <i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647>
+       %abs_x = bitcast <16 x i32> %abs_bits to <16 x float>
+       %in_range = fcmp olt <16 x float> %abs_x, <float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000>
+       %xa = select <16 x i1> %in_range, <16 x float> %abs_x, <16 x float> zeroinitializer
+       %octant_f = fmul <16 x float> %xa, <float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000>
+       %octant_i = fptosi <16 x float> %octant_f to <16 x i32>
+       %octant_plus_one = add <16 x i32> %octant_i, <i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1>
+       %j = and <16 x i32> %octant_plus_one, <i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2>
+       %y = sitofp <16 x i32> %j to <16 x float>
+       %y_dp1 = fmul <16 x float> %y, <float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000>
+       %z1 = fsub <16 x float> %xa, %y_dp1
+       %y_dp2 = fmul <16 x float> %y, <float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000>
+       %z2 = fsub <16 x float> %z1, %y_dp2
+       %y_dp3 = fmul <16 x float> %y, <float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000>
+       %z = fsub <16 x float> %z2, %y_dp3
+       %zz = fmul <16 x float> %z, %z
+       %sin_p1 = fmul <16 x float> %zz, <float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000>
+       %sin_p2 = fadd <16 x float> %sin_p1, <float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000>
+       %sin_p3 = fmul <16 x float> %sin_p2, %zz
+       %sin_p4 = fadd <16 x float> %sin_p3, <float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000>
+       %sin_p5 = fmul <16 x float> %sin_p4, %zz
+       %sin_p6 = fmul <16 x float> %sin_p5, %z
+       %sin_poly = fadd <16 x float> %sin_p6, %z
+       %cos_p0 = fmul <16 x float> %zz, <float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000>
+       %cos_p1 = fadd <16 x float> %cos_p0, <float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000>
+       %cos_p1a = fmul <16 x float> %cos_p1, %zz
+       %cos_p2 = fadd <16 x float> %cos_p1a, <float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000>
+       %cos_p3 = fmul <16 x float> %cos_p2, %zz
+       %cos_p4 = fmul <16 x float> %cos_p3, %zz
+       %half_zz = fmul <16 x float> %zz, <float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000>
+       %cos_p5 = fsub <16 x float> %cos_p4, %half_zz
+       %cos_poly = fadd <16 x float> %cos_p5, <float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000>
+       %j_and_2 = and <16 x i32> %j, <i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2>
+       %odd_quadrant = icmp ne <16 x i32> %j_and_2, zeroinitializer
+       %poly = select <16 x i1> %odd_quadrant, <16 x float> %cos_poly, <16 x float> %sin_poly
+       %j_and_4 = and <16 x i32> %j, <i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4>
+       %flip = shl <16 x i32> %j_and_4, <i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29>
+       %poly_bits = bitcast <16 x float> %poly to <16 x i32>
+       %result_sign = xor <16 x i32> %sign, %flip
+       %result_bits = xor <16 x i32> %poly_bits, %result_sign
+       %result = bitcast <16 x i32> %result_bits to <16 x float>
+       %checked = select <16 x i1> %in_range, <16 x float> %result, <16 x float> <float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000>
+       ret <16 x float> %checked
+}
+
+define weak_odr <16 x float> @cos_f32x16(<16 x float> %x) nounwind readnone alwaysinline {
+       %bits = bitcast <16 x float> %x to <16 x i32>
+       %abs_bits = and <16 x i32> %bits, <i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647>
+       %abs_x = bitcast <16 x i32> %abs_bits to <16 x float>
+       %in_range = fcmp olt <16 x float> %abs_x, <float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000, float 0x41D0000000000000>
+       %xa = select <16 x i1> %in_range, <16 x float> %abs_x, <16 x float> zeroinitializer
+       %octant_f = fmul <16 x float> %xa, <float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000>
+       %octant_i = fptosi <16 x float> %octant_f to <16 x i32>
+       %octant_plus_one = add <16 x i32> %octant_i, <i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1>
+       %j = and <16 x i32> %octant_plus_one, <i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2>
+       %y = sitofp <16 x i32> %j to <16 x float>
+       %y_dp1 = fmul <16 x float> %y, <float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000, float 0x3FE9200000000000>
+       %z1 = fsub <16 x float> %xa, %y_dp1
+       %y_dp2 = fmul <16 x float> %y, <float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000, float 0x3F2FB40000000000>
+       %z2 = fsub <16 x float> %z1, %y_dp2
+       %y_dp3 = fmul <16 x float> %y, <float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000, float 0x3E64442D20000000>
+       %z = fsub <16 x float> %z2, %y_dp3
+       %zz = fmul <16 x float> %z, %z
+       %sin_p1 = fmul <16 x float> %zz, <float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000, float 0xBF29943F20000000>
+       %sin_p2 = fadd <16 x float> %sin_p1, <float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000>
+       %sin_p3 = fmul <16 x float> %sin_p2, %zz
+       %sin_p4 = fadd <16 x float> %sin_p3, <float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000>
+       %sin_p5 = fmul <16 x float> %sin_p4, %zz
+       %sin_p6 = fmul <16 x float> %sin_p5, %z
+       %sin_poly = fadd <16 x float> %sin_p6, %z
+       %cos_p0 = fmul <16 x float> %zz, <float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000, float 0x3EF99EB9C0000000>
+       %cos_p1 = fadd <16 x float> %cos_p0, <float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000>
+       %cos_p1a = fmul <16 x float> %cos_p1, %zz
+       %cos_p2 = fadd <16 x float> %cos_p1a, <float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000>
+       %cos_p3 = fmul <16 x float> %cos_p2, %zz
+       %cos_p4 = fmul <16 x float> %cos_p3, %zz
+       %half_zz = fmul <16 x float> %zz, <float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000>
+       %cos_p5 = fsub <16 x float> %cos_p4, %half_zz
+       %cos_poly = fadd <16 x float> %cos_p5, <float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000>
+       %j_and_2 = and <16 x i32> %j, <i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2>
+       %odd_quadrant = icmp ne <16 x i32> %j_and_2, zeroinitializer
+       %poly = select <16 x i1> %odd_quadrant, <16 x float> %sin_poly, <16 x float> %cos_poly
+       %j_plus_2 = add <16 x i32> %j, <i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2>
+       %j_and_4 = and <16 x i32> %j_plus_2, <i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4>
+       %flip = shl <16 x i32> %j_and_4, <i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29>
+       %poly_bits = bitcast <16 x float> %poly to <16 x i32>
+       %result_bits = xor <16 x i32> %poly_bits, %flip
+       %result = bitcast <16 x i32> %result_bits to <16 x float>
+       %checked = select <16 x i1> %in_range, <16 x float> %result, <16 x float> <float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000, float 0x7FF8000000000000>
+       ret <16 x float> %checked
+}
+
+define weak_odr <16 x float> @fast_sin_f32x16(<16 x float> %x) nounwind readnone alwaysinline {
+       %bits = bitcast <16 x float> %x to <16 x i32>
+       %sign = and <16 x i32> %bits, <i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648, i32 -2147483648>
+       %abs_bits = and <16 x i32> %bits, <i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647>
+       %abs_x = bitcast <16 x i32> %abs_bits to <16 x float>
+       %octant_f = fmul <16 x float> %abs_x, <float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000>
+       %octant_i = fptosi <16 x float> %octant_f to <16 x i32>
+       %octant_plus_one = add <16 x i32> %octant_i, <i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1>
+       %j = and <16 x i32> %octant_plus_one, <i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2>
+       %y = sitofp <16 x i32> %j to <16 x float>
+       %y_pio4 = fmul <16 x float> %y, <float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000>
+       %z = fsub <16 x float> %abs_x, %y_pio4
+       %zz = fmul <16 x float> %z, %z
+       %sin_p1 = fmul <16 x float> %zz, <float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000>
+       %sin_p2 = fadd <16 x float> %sin_p1, <float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000>
+       %sin_p3 = fmul <16 x float> %sin_p2, %zz
+       %sin_p4 = fmul <16 x float> %sin_p3, %z
+       %sin_poly = fadd <16 x float> %sin_p4, %z
+       %cos_p1 = fmul <16 x float> %zz, <float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000>
+       %cos_p2 = fadd <16 x float> %cos_p1, <float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000>
+       %cos_p3 = fmul <16 x float> %cos_p2, %zz
+       %cos_p4 = fmul <16 x float> %cos_p3, %zz
+       %half_zz = fmul <16 x float> %zz, <float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000>
+       %cos_p5 = fsub <16 x float> %cos_p4, %half_zz
+       %cos_poly = fadd <16 x float> %cos_p5, <float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000>
+       %j_and_2 = and <16 x i32> %j, <i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2>
+       %odd_quadrant = icmp ne <16 x i32> %j_and_2, zeroinitializer
+       %poly = select <16 x i1> %odd_quadrant, <16 x float> %cos_poly, <16 x float> %sin_poly
+       %j_and_4 = and <16 x i32> %j, <i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4>
+       %flip = shl <16 x i32> %j_and_4, <i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29>
+       %poly_bits = bitcast <16 x float> %poly to <16 x i32>
+       %result_sign = xor <16 x i32> %sign, %flip
+       %result_bits = xor <16 x i32> %poly_bits, %result_sign
+       %result = bitcast <16 x i32> %result_bits to <16 x float>
+       ret <16 x float> %result
+}
+
+define weak_odr <16 x float> @fast_cos_f32x16(<16 x float> %x) nounwind readnone alwaysinline {
+       %bits = bitcast <16 x float> %x to <16 x i32>
+       %abs_bits = and <16 x i32> %bits, <i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647, i32 2147483647>
+       %abs_x = bitcast <16 x i32> %abs_bits to <16 x float>
+       %octant_f = fmul <16 x float> %abs_x, <float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000, float 0x3FF45F3060000000>
+       %octant_i = fptosi <16 x float> %octant_f to <16 x i32>
+       %octant_plus_one = add <16 x i32> %octant_i, <i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1>
+       %j = and <16 x i32> %octant_plus_one, <i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2, i32 -2>
+       %y = sitofp <16 x i32> %j to <16 x float>
+       %y_pio4 = fmul <16 x float> %y, <float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000, float 0x3FE921FB60000000>
+       %z = fsub <16 x float> %abs_x, %y_pio4
+       %zz = fmul <16 x float> %z, %z
+       %sin_p1 = fmul <16 x float> %zz, <float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000, float 0x3F811073C0000000>
+       %sin_p2 = fadd <16 x float> %sin_p1, <float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000, float 0xBFC5555460000000>
+       %sin_p3 = fmul <16 x float> %sin_p2, %zz
+       %sin_p4 = fmul <16 x float> %sin_p3, %z
+       %sin_poly = fadd <16 x float> %sin_p4, %z
+       %cos_p1 = fmul <16 x float> %zz, <float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000, float 0xBF56C0C340000000>
+       %cos_p2 = fadd <16 x float> %cos_p1, <float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000, float 0x3FA55554A0000000>
+       %cos_p3 = fmul <16 x float> %cos_p2, %zz
+       %cos_p4 = fmul <16 x float> %cos_p3, %zz
+       %half_zz = fmul <16 x float> %zz, <float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000, float 0x3FE0000000000000>
+       %cos_p5 = fsub <16 x float> %cos_p4, %half_zz
+       %cos_poly = fadd <16 x float> %cos_p5, <float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000, float 0x3FF0000000000000>
+       %j_and_2 = and <16 x i32> %j, <i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2>
+       %odd_quadrant = icmp ne <16 x i32> %j_and_2, zeroinitializer
+       %poly = select <16 x i1> %odd_quadrant, <16 x float> %sin_poly, <16 x float> %cos_poly
+       %j_plus_2 = add <16 x i32> %j, <i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2, i32 2>
+       %j_and_4 = and <16 x i32> %j_plus_2, <i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4, i32 4>
+       %flip = shl <16 x i32> %j_and_4, <i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29, i32 29>
+       %poly_bits = bitcast <16 x float> %poly to <16 x i32>
+       %result_bits = xor <16 x i32> %poly_bits, %flip
+       %result = bitcast <16 x i32> %result_bits to <16 x float>
+       ret <16 x float> %result
+}
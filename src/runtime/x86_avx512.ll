@@ -0,0 +1,80 @@
+; AVX-512 has no specific intrinsics for these that are stable across
+; llvm versions, so we use the generic ones, which llvm lowers to the
+; 512-bit instructions when avx512f is enabled.
+
+declare <16 x float> @llvm.sqrt.v16f32(<16 x float>) nounwind readnone
+declare <16 x float> @llvm.floor.v16f32(<16 x float>) nounwind readnone
+declare <16 x float> @llvm.ceil.v16f32(<16 x float>) nounwind readnone
+declare <16 x float> @llvm.nearbyint.v16f32(<16 x float>) nounwind readnone
+declare <8 x double> @llvm.sqrt.v8f64(<8 x double>) nounwind readnone
+declare <8 x double> @llvm.floor.v8f64(<8 x double>) nounwind readnone
+declare <8 x double> @llvm.ceil.v8f64(<8 x double>) nounwind readnone
+declare <8 x double> @llvm.nearbyint.v8f64(<8 x double>) nounwind readnone
+declare <16 x float> @llvm.fma.v16f32(<16 x float>, <16 x float>, <16 x float>) nounwind readnone
+declare <8 x double> @llvm.fma.v8f64(<8 x double>, <8 x double>, <8 x double>) nounwind readnone
+
+define weak_odr <16 x float> @sqrt_f32x16(<16 x float> %arg) nounwind alwaysinline {
+   %1 = tail call <16 x float> @llvm.sqrt.v16f32(<16 x float> %arg) nounwind
+   ret <16 x float> %1
+}
+
+define weak_odr <16 x float> @round_f32x16(<16 x float> %arg) nounwind alwaysinline {
+   %1 = tail call <16 x float> @llvm.nearbyint.v16f32(<16 x float> %arg) nounwind
+   ret <16 x float> %1
+}
+
+define weak_odr <16 x float> @ceil_f32x16(<16 x float> %arg) nounwind alwaysinline {
+   %1 = tail call <16 x float> @llvm.ceil.v16f32(<16 x float> %arg) nounwind
+   ret <16 x float> %1
+}
+
+define weak_odr <16 x float> @floor_f32x16(<16 x float> %arg) nounwind alwaysinline {
+   %1 = tail call <16 x float> @llvm.floor.v16f32(<16 x float> %arg) nounwind
+   ret <16 x float> %1
+}
+
+define weak_odr <16 x float> @abs_f32x16(<16 x float> %x) nounwind uwtable readnone alwaysinline {
+  %arg = bitcast <16 x float> %x to <16 x i32>
+  %mask = lshr <16 x i32> <i32 -1, i32 -1, i32 -1, i32 -1, i32 -1, i32 -1, i32 -1, i32 -1, i32 -1, i32 -1, i32 -1, i32 -1, i32 -1, i32 -1, i32 -1, i32 -1>, <i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1>
+  %masked = and <16 x i32> %arg, %mask
+  %result = bitcast <16 x i32> %masked to <16 x float>
+  ret <16 x float> %result
+}
+
+define weak_odr <8 x double> @sqrt_f64x8(<8 x double> %arg) nounwind alwaysinline {
+   %1 = tail call <8 x double> @llvm.sqrt.v8f64(<8 x double> %arg) nounwind
+   ret <8 x double> %1
+}
+
+define weak_odr <8 x double> @round_f64x8(<8 x double> %arg) nounwind alwaysinline {
+   %1 = tail call <8 x double> @llvm.nearbyint.v8f64(<8 x double> %arg) nounwind
+   ret <8 x double> %1
+}
+
+define weak_odr <8 x double> @ceil_f64x8(<8 x double> %arg) nounwind alwaysinline {
+   %1 = tail call <8 x double> @llvm.ceil.v8f64(<8 x double> %arg) nounwind
+   ret <8 x double> %1
+}
+
+define weak_odr <8 x double> @floor_f64x8(<8 x double> %arg) nounwind alwaysinline {
+   %1 = tail call <8 x double> @llvm.floor.v8f64(<8 x double> %arg) nounwind
+   ret <8 x double> %1
+}
+
+define weak_odr <8 x double> @abs_f64x8(<8 x double> %x) nounwind uwtable readnone alwaysinline {
+  %arg = bitcast <8 x double> %x to <8 x i64>
+  %mask = lshr <8 x i64> <i64 -1, i64 -1, i64 -1, i64 -1, i64 -1, i64 -1, i64 -1, i64 -1>, <i64 1, i64 1, i64 1, i64 1, i64 1, i64 1, i64 1, i64 1>
+  %masked = and <8 x i64> %arg, %mask
+  %result = bitcast <8 x i64> %masked to <8 x double>
+  ret <8 x double> %result
+}
+
+define weak_odr <16 x float> @fma_f32x16(<16 x float> %x, <16 x float> %y, <16 x float> %z) nounwind alwaysinline {
+   %1 = tail call <16 x float> @llvm.fma.v16f32(<16 x float> %x, <16 x float> %y, <16 x float> %z) nounwind
+   ret <16 x float> %1
+}
+
+define weak_odr <8 x double> @fma_f64x8(<8 x double> %x, <8 x double> %y, <8 x double> %z) nounwind alwaysinline {
+   %1 = tail call <8 x double> @llvm.fma.v8f64(<8 x double> %x, <8 x double> %y, <8 x double> %z) nounwind
+   ret <8 x double> %1
+}
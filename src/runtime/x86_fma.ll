@@ -0,0 +1,24 @@
+declare <4 x float> @llvm.fma.v4f32(<4 x float>, <4 x float>, <4 x float>) nounwind readnone
+declare <8 x float> @llvm.fma.v8f32(<8 x float>, <8 x float>, <8 x float>) nounwind readnone
+declare <2 x double> @llvm.fma.v2f64(<2 x double>, <2 x double>, <2 x double>) nounwind readnone
+declare <4 x double> @llvm.fma.v4f64(<4 x double>, <4 x double>, <4 x double>) nounwind readnone
+
+define weak_odr <4 x float> @fma_f32x4(<4 x float> %x, <4 x float> %y, <4 x float> %z) nounwind alwaysinline {
+   %1 = tail call <4 x float> @llvm.fma.v4f32(<4 x float> %x, <4 x float> %y, <4 x float> %z) nounwind
+   ret <4 x float> %1
+}
+
+define weak_odr <8 x float> @fma_f32x8(<8 x float> %x, <8 x float> %y, <8 x float> %z) nounwind alwaysinline {
+   %1 = tail call <8 x float> @llvm.fma.v8f32(<8 x float> %x, <8 x float> %y, <8 x float> %z) nounwind
+   ret <8 x float> %1
+}
+
+define weak_odr <2 x double> @fma_f64x2(<2 x double> %x, <2 x double> %y, <2 x double> %z) nounwind alwaysinline {
+   %1 = tail call <2 x double> @llvm.fma.v2f64(<2 x double> %x, <2 x double> %y, <2 x double> %z) nounwind
+   ret <2 x double> %1
+}
+
+define weak_odr <4 x double> @fma_f64x4(<4 x double> %x, <4 x double> %y, <4 x double> %z) nounwind alwaysinline {
+   %1 = tail call <4 x double> @llvm.fma.v4f64(<4 x double> %x, <4 x double> %y, <4 x double> %z) nounwind
+   ret <4 x double> %1
+}
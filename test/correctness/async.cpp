@@ -0,0 +1,71 @@
+#include <stdio.h>
+#include <Halide.h>
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    const int W = 100, H = 77;
+
+    Image<uint8_t> input(W + 2, H + 2);
+    for (int y = 0; y < input.height(); y++) {
+        for (int x = 0; x < input.width(); x++) {
+            input(x, y) = (uint8_t)(x * 7 + y * 13);
+        }
+    }
+
+    {
+        // An unpacking stage feeding a filter, computed a strip of
+        // rows ahead of it. The strips overlap, and don't divide the
+        // height.
+        Var x, y, yo, yi;
+        Func unpack, filter;
+        unpack(x, y) = cast<int>(input(x, y)) * 3;
+        filter(x, y) = unpack(x, y) + unpack(x + 2, y + 1) + unpack(x + 1, y + 2);
+
+        filter.split(y, yo, yi, 8);
+        unpack.compute_at(filter, yo).async();
+
+        Image<int> out = filter.realize(W, H);
+
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                int correct = 3 * (input(x, y) + input(x + 2, y + 1) + input(x + 1, y + 2));
+                if (out(x, y) != correct) {
+                    printf("out(%d, %d) = %d instead of %d\n", x, y, out(x, y), correct);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    {
+        // A producer with an update, computed per row of a consumer
+        // that is itself computed per strip of the output.
+        Var x, y;
+        Func f, g, h;
+        f(x, y) = cast<int>(input(x, y));
+        f(x, 0) = 5;
+        g(x, y) = f(x, y) * 2 + f(x + 1, y);
+        h(x, y) = g(x, y) - 1;
+
+        f.compute_at(g, y).async();
+        g.compute_at(h, y);
+
+        Image<int> out = h.realize(W, H);
+
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                int f0 = y == 0 ? 5 : input(x, y);
+                int f1 = y == 0 ? 5 : input(x + 1, y);
+                int correct = f0 * 2 + f1 - 1;
+                if (out(x, y) != correct) {
+                    printf("out(%d, %d) = %d instead of %d\n", x, y, out(x, y), correct);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,264 @@
+#include <Halide.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+using namespace Halide;
+
+// Some pipelines over widths that don't divide the vector width, with
+// the tails guarded, so that the last vector of each row runs under a
+// predicate when targeting AVX-512.
+Func make_float_pipeline(ImageParam in) {
+    Var x, y;
+    Func f;
+    f(x, y) = sqrt(abs(in(x, y))) * 3.0f + floor(in(x, y) / 4.0f);
+    f.vectorize(x, 16, TailStrategy_GuardWithIf);
+    return f;
+}
+
+Func make_int_pipeline(ImageParam in) {
+    Var x, y;
+    Func f;
+    Expr wide = cast<int16_t>(in(x, y)) * 3 - cast<int16_t>(in(x + 1, y));
+    f(x, y) = cast<uint8_t>(clamp(wide, 0, 255));
+    f.vectorize(x, 64, TailStrategy_GuardWithIf);
+    return f;
+}
+
+// A division stored to every other element of the output. Dividing by
+// a constant, the tail is predicated, including the strided store. A
+// divisor loaded from a buffer may be zero beyond the end of the row,
+// and the lanes off the end would still divide, so then the tail must
+// be scalarized instead.
+Func make_div_pipeline(ImageParam in, ImageParam divisor, bool constant) {
+    Var x, y;
+    Func f;
+    f(x, y) = in(x, y) / (constant ? cast<uint8_t>(7) : divisor(x, y));
+    f.output_buffer().set_stride(0, 2);
+    f.vectorize(x, 64, TailStrategy_GuardWithIf);
+    return f;
+}
+
+// A packed rgb output with the channels unrolled. The stores of the
+// three channels are grouped into dense ones, except within the
+// predicated tail.
+Func make_rgb_pipeline(ImageParam in) {
+    Var x, y, c;
+    Func f;
+    f(x, y, c) = in(x, y) + cast<uint8_t>(c * 50);
+    f.output_buffer().set_stride(0, 3).set_stride(2, 1).set_bounds(2, 0, 3);
+    f.reorder(c, x, y).bound(c, 0, 3).unroll(c);
+    f.vectorize(x, 16, TailStrategy_GuardWithIf);
+    return f;
+}
+
+bool contains(const char *filename, const char *str) {
+    FILE *f = fopen(filename, "r");
+    if (!f) return false;
+    char line[1024];
+    bool found = false;
+    while (!found && fgets(line, sizeof(line), f)) {
+        found = strstr(line, str) != NULL;
+    }
+    fclose(f);
+    return found;
+}
+
+int main(int argc, char **argv) {
+    Target host = get_jit_target_from_environment();
+    if (host.arch != Target::X86 || host.bits != 64) {
+        printf("Not targeting x86-64. Skipping test.\n");
+        return 0;
+    }
+
+    Target avx512 = host;
+    avx512.features &= ~Target::JIT;
+    avx512.features |= (Target::SSE41 | Target::AVX | Target::AVX2 |
+                        Target::AVX512 | Target::AVX512_Skylake);
+
+    if (avx512.natural_vector_size<float>() != 16 ||
+        avx512.natural_vector_size<uint8_t>() != 64) {
+        printf("Wrong natural vector size for AVX-512\n");
+        return -1;
+    }
+
+    // We can always generate the code, even if we can't run it.
+    {
+        ImageParam in(Float(32), 2);
+        std::vector<Argument> args(1, in);
+        make_float_pipeline(in).compile_to_assembly("avx512_float.s", args, avx512);
+        if (!contains("avx512_float.s", "zmm")) {
+            printf("Didn't use 512-bit vectors for the float pipeline\n");
+            return -1;
+        }
+        if (!contains("avx512_float.s", "{%k")) {
+            printf("Didn't use a mask register for the tail of the float pipeline\n");
+            return -1;
+        }
+    }
+
+    {
+        ImageParam in(UInt(8), 2);
+        std::vector<Argument> args(1, in);
+        make_rgb_pipeline(in).compile_to_assembly("avx512_rgb.s", args, avx512);
+    }
+
+    {
+        ImageParam in(UInt(8), 2), divisor(UInt(8), 2);
+        std::vector<Argument> args;
+        args.push_back(in);
+        args.push_back(divisor);
+        make_div_pipeline(in, divisor, true).compile_to_assembly("avx512_div_constant.s", args, avx512);
+        make_div_pipeline(in, divisor, false).compile_to_assembly("avx512_div.s", args, avx512);
+    }
+
+    // Running it needs a host with AVX-512, or an emulator (e.g. the
+    // Intel Software Development Emulator), which reports the
+    // features it emulates through cpuid.
+    if (!(host.features & Target::AVX512)) {
+        printf("No AVX-512 on this host. Skipping the rest of the test.\n");
+        printf("Success!\n");
+        return 0;
+    }
+
+    const int W = 123, H = 17;
+
+    {
+        Image<float> input(W, H);
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                input(x, y) = (rand() % 2000 - 1000) / 16.0f;
+            }
+        }
+        ImageParam in(Float(32), 2);
+        in.set(input);
+
+        Image<float> out(W, H);
+        make_float_pipeline(in).realize(out, host);
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                float v = input(x, y);
+                float correct = sqrtf(fabsf(v)) * 3.0f + floorf(v / 4.0f);
+                if (fabsf(out(x, y) - correct) > 0.001f) {
+                    printf("float out(%d, %d) = %f instead of %f\n", x, y, out(x, y), correct);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    {
+        Image<uint8_t> input(W + 1, H);
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W + 1; x++) {
+                input(x, y) = (uint8_t)rand();
+            }
+        }
+        ImageParam in(UInt(8), 2);
+        in.set(input);
+
+        // Write into the left of a wider image, so that a store that
+        // wasn't masked off would clobber the rest of each row.
+        const int stride = W + 128;
+        Image<uint8_t> out(stride, H);
+        memset(out.data(), 42, stride * H);
+        buffer_t window = *out.raw_buffer();
+        window.extent[0] = W;
+        make_int_pipeline(in).realize(Buffer(UInt(8), &window), host);
+
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < stride; x++) {
+                uint8_t correct = 42;
+                if (x < W) {
+                    int wide = input(x, y) * 3 - input(x + 1, y);
+                    correct = (uint8_t)(wide < 0 ? 0 : (wide > 255 ? 255 : wide));
+                }
+                if (out(x, y) != correct) {
+                    printf("int out(%d, %d) = %d instead of %d\n", x, y, out(x, y), correct);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    for (int constant = 0; constant < 2; constant++) {
+        // The divisors are only nonzero within the region computed.
+        const int stride = W + 128;
+        Image<uint8_t> input(stride, H), divisors(stride, H);
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < stride; x++) {
+                input(x, y) = (uint8_t)rand();
+                divisors(x, y) = x < W ? (uint8_t)(rand() % 255 + 1) : 0;
+            }
+        }
+        buffer_t in_window = *input.raw_buffer();
+        in_window.extent[0] = W;
+        buffer_t divisor_window = *divisors.raw_buffer();
+        divisor_window.extent[0] = W;
+        ImageParam in(UInt(8), 2), divisor(UInt(8), 2);
+        in.set(Buffer(UInt(8), &in_window));
+        divisor.set(Buffer(UInt(8), &divisor_window));
+
+        Image<uint8_t> out(2 * W, H);
+        memset(out.data(), 42, 2 * W * H);
+        buffer_t strided = *out.raw_buffer();
+        strided.extent[0] = W;
+        strided.stride[0] = 2;
+        make_div_pipeline(in, divisor, constant).realize(Buffer(UInt(8), &strided), host);
+
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < 2 * W; x++) {
+                uint8_t correct = 42;
+                if (x % 2 == 0) {
+                    correct = input(x / 2, y) / (constant ? 7 : divisors(x / 2, y));
+                }
+                if (out(x, y) != correct) {
+                    printf("div out(%d, %d) = %d instead of %d\n", x, y, out(x, y), correct);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    {
+        Image<uint8_t> input(W, H);
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                input(x, y) = (uint8_t)rand();
+            }
+        }
+        ImageParam in(UInt(8), 2);
+        in.set(input);
+
+        // Store the channels of each pixel next to each other, with
+        // room at the end of each row to check that the tail doesn't
+        // write past it.
+        const int row = 3 * W + 64;
+        Image<uint8_t> out(row, H);
+        memset(out.data(), 42, row * H);
+        buffer_t packed = *out.raw_buffer();
+        packed.extent[0] = W;
+        packed.stride[0] = 3;
+        packed.extent[1] = H;
+        packed.stride[1] = row;
+        packed.extent[2] = 3;
+        packed.stride[2] = 1;
+        make_rgb_pipeline(in).realize(Buffer(UInt(8), &packed), host);
+
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < row; x++) {
+                uint8_t correct = 42;
+                if (x < 3 * W) {
+                    correct = (uint8_t)(input(x / 3, y) + (x % 3) * 50);
+                }
+                if (out(x, y) != correct) {
+                    printf("rgb out(%d, %d) = %d instead of %d\n", x, y, out(x, y), correct);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,123 @@
+#include <Halide.h>
+#include <stdio.h>
+#include <algorithm>
+
+using namespace Halide;
+
+const int W = 32, H = 32;
+
+int clamp_coord(int c, int min, int extent) {
+    return std::min(std::max(c, min), min + extent - 1);
+}
+
+int wrap_coord(int c, int min, int extent) {
+    int r = (c - min) % extent;
+    if (r < 0) r += extent;
+    return r + min;
+}
+
+int mirror_coord(int c, int min, int extent) {
+    int r = (c - min) % (2 * extent);
+    if (r < 0) r += 2 * extent;
+    if (r >= extent) r = 2 * extent - 1 - r;
+    return r + min;
+}
+
+int mirror_interior_coord(int c, int min, int extent) {
+    int period = std::max(2 * extent - 2, 1);
+    int r = (c - min) % period;
+    if (r < 0) r += period;
+    if (r >= extent) r = period - r;
+    return r + min;
+}
+
+typedef int (*CoordMap)(int, int, int);
+
+// Realize a function over a region that extends well past the image
+// on all sides, and check it against the coordinate mapping. The
+// input is exactly the size of the image, so if bounds inference
+// asked for anything outside of it, the realization would fail.
+bool check(Func f, Image<uint8_t> input, CoordMap map, const char *name,
+           bool constant = false, uint8_t value = 0) {
+    Var x = f.args()[0], y = f.args()[1];
+    Func g;
+    g(x, y) = f(x, y);
+    g.vectorize(x, 8);
+
+    const int pad = 13;
+    Image<uint8_t> out(W + 2 * pad, H + 2 * pad);
+    out.set_min(-pad, -pad);
+    g.realize(out);
+
+    for (int y = -pad; y < H + pad; y++) {
+        for (int x = -pad; x < W + pad; x++) {
+            uint8_t correct;
+            if (constant) {
+                bool inside = x >= 0 && x < W && y >= 0 && y < H;
+                correct = inside ? input(x, y) : value;
+            } else {
+                correct = input(map(x, 0, W), map(y, 0, H));
+            }
+            if (out(x, y) != correct) {
+                printf("%s(%d, %d) = %d instead of %d\n", name, x, y, out(x, y), correct);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    Image<uint8_t> input(W, H);
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            input(x, y) = (uint8_t)(x + y * W);
+        }
+    }
+
+    ImageParam in(UInt(8), 2);
+    in.set(input);
+
+    // The ImageParam forms.
+    if (!check(BoundaryConditions::repeat_edge(in), input, clamp_coord, "repeat_edge")) return -1;
+    if (!check(BoundaryConditions::repeat_image(in), input, wrap_coord, "repeat_image")) return -1;
+    if (!check(BoundaryConditions::mirror_image(in), input, mirror_coord, "mirror_image")) return -1;
+    if (!check(BoundaryConditions::mirror_interior(in), input, mirror_interior_coord, "mirror_interior")) return -1;
+    if (!check(BoundaryConditions::constant_exterior(in, 17), input, NULL, "constant_exterior", true, 17)) return -1;
+
+    // The Func forms, with explicit bounds.
+    Var x, y;
+    Func f;
+    f(x, y) = input(x, y);
+    f.compute_root();
+    std::vector<std::pair<Expr, Expr> > bounds;
+    bounds.push_back(std::make_pair(0, W));
+    bounds.push_back(std::make_pair(0, H));
+    if (!check(BoundaryConditions::repeat_edge(f, bounds), input, clamp_coord, "repeat_edge(Func)")) return -1;
+    if (!check(BoundaryConditions::repeat_image(f, bounds), input, wrap_coord, "repeat_image(Func)")) return -1;
+    if (!check(BoundaryConditions::mirror_image(f, bounds), input, mirror_coord, "mirror_image(Func)")) return -1;
+    if (!check(BoundaryConditions::mirror_interior(f, bounds), input, mirror_interior_coord, "mirror_interior(Func)")) return -1;
+    if (!check(BoundaryConditions::constant_exterior(f, 3, bounds), input, NULL, "constant_exterior(Func)", true, 3)) return -1;
+
+    // Leaving a dimension unbounded.
+    {
+        Func g;
+        g(x, y) = x + y;
+        std::vector<std::pair<Expr, Expr> > x_only;
+        x_only.push_back(std::make_pair(2, 5));
+        Func h = BoundaryConditions::repeat_edge(g, x_only);
+        Image<int> out = h.realize(10, 10);
+        for (int yy = 0; yy < 10; yy++) {
+            for (int xx = 0; xx < 10; xx++) {
+                int correct = clamp_coord(xx, 2, 5) + yy;
+                if (out(xx, yy) != correct) {
+                    printf("partially bounded(%d, %d) = %d instead of %d\n", xx, yy, out(xx, yy), correct);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
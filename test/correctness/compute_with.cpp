@@ -0,0 +1,66 @@
+#include <stdio.h>
+#include <Halide.h>
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    const int W = 64, H = 48;
+
+    for (int parallel = 0; parallel < 2; parallel++) {
+        Var x, y;
+
+        // Two siblings over different regions, consumed together.
+        Func f, g, h;
+        f(x, y) = x + y * 2;
+        g(x, y) = x * 3 - y;
+        h(x, y) = f(x, y) + g(x + 1, y + 2);
+
+        f.compute_root();
+        g.compute_root().compute_with(f, y);
+        if (parallel) {
+            f.parallel(y);
+            g.parallel(y);
+        }
+
+        Image<int> out = h.realize(W, H);
+
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                int correct = (x + y * 2) + ((x + 1) * 3 - (y + 2));
+                if (out(x, y) != correct) {
+                    printf("out(%d, %d) = %d instead of %d\n", x, y, out(x, y), correct);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    // Fusing at the innermost loop, with an update definition that
+    // stays unfused.
+    {
+        Var x, y;
+        Func f, g, h;
+        f(x, y) = x * y;
+        g(x, y) = x - y;
+        g(x, 0) = 17;
+        h(x, y) = f(x, y) * 2 + g(x, y);
+
+        f.compute_root();
+        g.compute_root().compute_with(f, x);
+
+        Image<int> out = h.realize(W, H);
+
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                int correct = x * y * 2 + (y == 0 ? 17 : x - y);
+                if (out(x, y) != correct) {
+                    printf("out(%d, %d) = %d instead of %d\n", x, y, out(x, y), correct);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
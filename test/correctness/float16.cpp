@@ -0,0 +1,150 @@
+#include <Halide.h>
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+
+using namespace Halide;
+
+// A slow but obviously correct conversion from half bits to float.
+float half_to_float(uint16_t h) {
+    int sign = h >> 15, exp = (h >> 10) & 0x1f, mant = h & 0x3ff;
+    float result;
+    if (exp == 0x1f) {
+        result = mant ? NAN : INFINITY;
+    } else if (exp == 0) {
+        result = ldexpf((float)mant, -24);
+    } else {
+        result = ldexpf((float)(mant | 0x400), exp - 25);
+    }
+    return sign ? -result : result;
+}
+
+bool is_nan_bits(uint16_t h) {
+    return (h & 0x7c00) == 0x7c00 && (h & 0x3ff);
+}
+
+// Is h the nearest half to f, with ties going to the even mantissa?
+bool is_nearest_half(float f, uint16_t h) {
+    if (isnan(f)) return is_nan_bits(h);
+    if ((h & 0x7fff) == 0x7c00) {
+        // Infinity is right for anything at least halfway between
+        // the biggest half and the next power of two.
+        return fabs(f) >= 65520.0f && (h >> 15) == (f < 0);
+    }
+    double err = fabs((double)half_to_float(h) - f);
+    for (int d = -1; d <= 1; d += 2) {
+        uint16_t other = (uint16_t)(h + d);
+        if (is_nan_bits(other) || (other & 0x7fff) == 0x7c00 || (other >> 15) != (h >> 15)) continue;
+        double other_err = fabs((double)half_to_float(other) - f);
+        if (other_err < err || (other_err == err && (h & 1))) return false;
+    }
+    return true;
+}
+
+bool test(Target t, int vector_width) {
+    printf("Testing float16 conversions with vector width %d%s\n", vector_width,
+           (t.features & Target::F16C) ? " using f16c" : "");
+
+    Image<uint16_t> bits(1 << 16);
+    for (int i = 0; i < (1 << 16); i++) {
+        bits(i) = (uint16_t)i;
+    }
+
+    // Widen every half.
+    Var x;
+    Func widen;
+    widen(x) = cast<float>(reinterpret(Float(16), bits(x)));
+    if (vector_width > 1) widen.vectorize(x, vector_width);
+    Image<float> widened = widen.realize(1 << 16, t);
+
+    for (int i = 0; i < (1 << 16); i++) {
+        float correct = half_to_float((uint16_t)i);
+        if (isnan(correct) ? !isnan(widened(i)) : widened(i) != correct) {
+            printf("Half 0x%04x became %f instead of %f\n", i, widened(i), correct);
+            return false;
+        }
+    }
+
+    // Narrow some floats, including the ones that are exactly
+    // halves, which should round-trip.
+    const int N = 1 << 18;
+    Image<float> floats(N);
+    for (int i = 0; i < N; i++) {
+        if (i < (1 << 16)) {
+            floats(i) = half_to_float((uint16_t)i);
+        } else {
+            uint32_t u = (uint32_t)rand() ^ ((uint32_t)rand() << 16);
+            if (i & 1) {
+                // Concentrate on the range of halves.
+                u = (u & 0x87ffffff) | 0x30000000;
+            }
+            memcpy(&floats(i), &u, sizeof(u));
+        }
+    }
+    Func narrow;
+    narrow(x) = reinterpret(UInt(16), cast(Float(16), floats(x)));
+    if (vector_width > 1) narrow.vectorize(x, vector_width);
+    Image<uint16_t> narrowed = narrow.realize(N, t);
+
+    for (int i = 0; i < N; i++) {
+        if (i < (1 << 16) && !is_nan_bits((uint16_t)i) && narrowed(i) != i) {
+            printf("Half 0x%04x became 0x%04x after a round trip\n", i, narrowed(i));
+            return false;
+        }
+        if (!is_nearest_half(floats(i), narrowed(i))) {
+            printf("%g became the half 0x%04x (%g)\n",
+                   floats(i), narrowed(i), half_to_float(narrowed(i)));
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char **argv) {
+    // Arithmetic on Float(16) is done in Float(32).
+    {
+        Var x;
+        Func f, g;
+        f(x) = cast(Float(16), x) / 4.0f;
+        g(x) = cast(Float(16), x) + cast(Float(16), x);
+        if (f.value().type() != Float(32) || g.value().type() != Float(32)) {
+            printf("Arithmetic on Float(16) should give Float(32)\n");
+            return -1;
+        }
+    }
+
+    // A Func stored as Float(16) and consumed by another one.
+    {
+        Var x;
+        Func stored, consumer;
+        stored(x) = cast(Float(16), x / 4.0f);
+        consumer(x) = stored(x) + stored(x + 1);
+        stored.compute_root().vectorize(x, 8);
+        consumer.vectorize(x, 8);
+        Image<float> out = consumer.realize(1024);
+        for (int i = 0; i < 1024; i++) {
+            float correct = i / 4.0f + (i + 1) / 4.0f;
+            if (out(i) != correct) {
+                printf("out(%d) = %f instead of %f\n", i, out(i), correct);
+                return -1;
+            }
+        }
+    }
+
+    Target t = get_jit_target_from_environment();
+    Target no_f16c = t;
+    no_f16c.features &= ~Target::F16C;
+
+    if (!test(no_f16c, 1) ||
+        !test(no_f16c, 8) ||
+        !test(t, 1) ||
+        !test(t, 4) ||
+        !test(t, 8) ||
+        !test(t, 16)) {
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
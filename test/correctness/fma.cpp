@@ -0,0 +1,103 @@
+#include <Halide.h>
+#include <stdio.h>
+#include <math.h>
+
+using namespace Halide;
+
+// Inputs for which a*b + c rounds differently when fused: a*b is
+// 1 + 2^-11 + 2^-24, which rounds to 1 + 2^-11 before the add.
+const float a_val = 1.0f + 1.0f / (1 << 12);
+const float c_val = -(1.0f + 1.0f / (1 << 11));
+
+Image<float> run(Func f, const Target &t) {
+    Image<float> out(64);
+    f.realize(out, t);
+    return out;
+}
+
+int main(int argc, char **argv) {
+    Target t = get_jit_target_from_environment();
+
+    Image<float> a(64), c(64);
+    for (int i = 0; i < 64; i++) {
+        a(i) = a_val;
+        c(i) = c_val;
+    }
+    // Round the product before the add, even if the compiler would
+    // like to contract it.
+    volatile float product = a_val * a_val;
+    float unfused = product + c_val;
+    float fused = fmaf(a_val, a_val, c_val);
+    if (fused == unfused) {
+        printf("The system fmaf doesn't appear to fuse. Skipping test.\n");
+        return 0;
+    }
+
+    Var x;
+
+    // An explicit fma always fuses, vectorized or not, whatever the target.
+    for (int vec = 1; vec <= 16; vec *= 4) {
+        Func f;
+        f(x) = fma(a(x), a(x), c(x));
+        if (vec > 1) f.vectorize(x, vec);
+        Image<float> out = run(f, t);
+        for (int i = 0; i < 64; i++) {
+            if (out(i) != fused) {
+                printf("fma with vector width %d: out(%d) = %g instead of %g\n",
+                       vec, i, out(i), fused);
+                return -1;
+            }
+        }
+    }
+
+    // Double precision too.
+    {
+        Func f;
+        f(x) = fma(cast<double>(a(x)), cast<double>(a(x)), cast<double>(c(x)));
+        f.vectorize(x, 4);
+        Image<double> out(64);
+        f.realize(out, t);
+        double correct = fma((double)a_val, (double)a_val, (double)c_val);
+        for (int i = 0; i < 64; i++) {
+            if (out(i) != correct) {
+                printf("double fma: out(%d) = %g instead of %g\n", i, out(i), correct);
+                return -1;
+            }
+        }
+    }
+
+    // On x86, a*b + c in vectorized code is only fused when asked to.
+    if (t.arch != Target::X86) {
+        printf("Success!\n");
+        return 0;
+    }
+
+    Func mul_add;
+    mul_add(x) = a(x) * a(x) + c(x);
+    mul_add.vectorize(x, 8);
+
+    Image<float> out = run(mul_add, t);
+    for (int i = 0; i < 64; i++) {
+        if (out(i) != unfused) {
+            printf("Contracted a*b + c without being asked to: out(%d) = %g instead of %g\n",
+                   i, out(i), unfused);
+            return -1;
+        }
+    }
+
+    if (t.features & Target::FMA) {
+        Target contract = t;
+        contract.features |= Target::FMAContract;
+        Image<float> out = run(mul_add, contract);
+        for (int i = 0; i < 64; i++) {
+            if (out(i) != fused) {
+                printf("Didn't contract a*b + c: out(%d) = %g instead of %g\n",
+                       i, out(i), fused);
+                return -1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
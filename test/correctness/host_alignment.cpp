@@ -0,0 +1,76 @@
+#include <Halide.h>
+#include <stdio.h>
+#include <string.h>
+
+using namespace Halide;
+
+bool error_occurred;
+void halide_error(void *user_context, const char *msg) {
+    printf("%s\n", msg);
+    error_occurred = true;
+}
+
+int main(int argc, char **argv) {
+    ImageParam in(UInt(8), 2);
+    in.set_host_alignment(16).set_stride_multiple(1, 16).set_min_multiple(0, 16);
+
+    Var x, y;
+    Func f;
+    f(x, y) = in(x, y) * 2 + in(x, y + 1);
+    f.vectorize(x, 16);
+    f.output_buffer().set_host_alignment(16).set_stride_multiple(1, 16).set_min_multiple(0, 16);
+    f.set_error_handler(&halide_error);
+
+    // Halide images are 32-byte aligned, and these have a width that
+    // is a multiple of 16.
+    Image<uint8_t> input(64, 11);
+    for (int y = 0; y < input.height(); y++) {
+        for (int x = 0; x < input.width(); x++) {
+            input(x, y) = (uint8_t)(x + y * 7);
+        }
+    }
+    in.set(input);
+
+    error_occurred = false;
+    Image<uint8_t> out = f.realize(64, 10);
+    if (error_occurred) {
+        printf("There should not have been an error\n");
+        return -1;
+    }
+    for (int y = 0; y < out.height(); y++) {
+        for (int x = 0; x < out.width(); x++) {
+            uint8_t correct = (uint8_t)(input(x, y) * 2 + input(x, y + 1));
+            if (out(x, y) != correct) {
+                printf("out(%d, %d) = %d instead of %d\n", x, y, out(x, y), correct);
+                return -1;
+            }
+        }
+    }
+
+    // An input whose host pointer breaks the promise.
+    buffer_t misaligned;
+    memcpy(&misaligned, input.raw_buffer(), sizeof(buffer_t));
+    misaligned.host += 1;
+    in.set(Buffer(UInt(8), &misaligned));
+
+    error_occurred = false;
+    f.realize(out);
+    if (!error_occurred) {
+        printf("There should have been an error for a misaligned host pointer\n");
+        return -1;
+    }
+
+    // An input whose stride breaks the promise.
+    Image<uint8_t> narrow(20, 11);
+    in.set(narrow);
+
+    error_occurred = false;
+    f.realize(16, 10);
+    if (!error_occurred) {
+        printf("There should have been an error for a stride that isn't a multiple of 16\n");
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,151 @@
+#include <Halide.h>
+#include <stdio.h>
+#include <algorithm>
+
+using namespace Halide;
+using namespace Halide::Internal;
+
+// Count the allocations of partial results in the lowered code, to
+// check that the accumulators really were interleaved.
+class CountPartials : public IRVisitor {
+    using IRVisitor::visit;
+
+    void visit(const Allocate *op) {
+        if (op->name.find(".partial") != std::string::npos) {
+            count++;
+        }
+        IRVisitor::visit(op);
+    }
+
+public:
+    int count;
+    CountPartials() : count(0) {}
+};
+
+int count_partials(Func f) {
+    Stmt s = lower(f.function(), get_jit_target_from_environment());
+    CountPartials counter;
+    s.accept(&counter);
+    return counter.count;
+}
+
+template<typename T>
+bool test(int factor, int extent) {
+    const int H = 7;
+
+    Image<T> input(extent, H);
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < extent; x++) {
+            input(x, y) = (T)(rand() % 16);
+        }
+    }
+
+    Var y;
+    RDom r(0, extent);
+    Func sum, diff, minimum, maximum;
+
+    sum(y) = cast<T>(0);
+    sum(y) += input(r, y);
+    sum.update().interleave_accumulators(r, factor, true);
+
+    diff(y) = cast<T>(100);
+    diff(y) -= input(r, y);
+    diff.update().interleave_accumulators(r, factor, true);
+
+    minimum(y) = input(0, y);
+    minimum(y) = min(minimum(y), input(r, y));
+    minimum.update().interleave_accumulators(r, factor);
+
+    maximum(y) = input(0, y);
+    maximum(y) = max(maximum(y), input(r, y));
+    maximum.update().interleave_accumulators(r, factor);
+
+    Func funcs[] = {sum, diff, minimum, maximum};
+    for (int i = 0; i < 4; i++) {
+        if (count_partials(funcs[i]) == 0) {
+            printf("The accumulators of %s weren't interleaved\n", funcs[i].name().c_str());
+            return false;
+        }
+    }
+
+    Image<T> sum_result = sum.realize(H);
+    Image<T> diff_result = diff.realize(H);
+    Image<T> min_result = minimum.realize(H);
+    Image<T> max_result = maximum.realize(H);
+
+    for (int y = 0; y < H; y++) {
+        T sum_correct = 0, diff_correct = 100;
+        T min_correct = input(0, y), max_correct = input(0, y);
+        for (int x = 0; x < extent; x++) {
+            T in = input(x, y);
+            sum_correct += in;
+            diff_correct -= in;
+            min_correct = std::min(min_correct, in);
+            max_correct = std::max(max_correct, in);
+        }
+
+        // The inputs are small integers, so even the float sums are
+        // exact regardless of the order of the operations.
+        if (sum_result(y) != sum_correct) {
+            printf("sum(%d) = %f instead of %f\n", y, (double)sum_result(y), (double)sum_correct);
+            return false;
+        }
+        if (diff_result(y) != diff_correct) {
+            printf("diff(%d) = %f instead of %f\n", y, (double)diff_result(y), (double)diff_correct);
+            return false;
+        }
+        if (min_result(y) != min_correct) {
+            printf("min(%d) = %f instead of %f\n", y, (double)min_result(y), (double)min_correct);
+            return false;
+        }
+        if (max_result(y) != max_correct) {
+            printf("max(%d) = %f instead of %f\n", y, (double)max_result(y), (double)max_correct);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char **argv) {
+    bool ok = true;
+
+    // Extents that are a multiple of the number of accumulators, and
+    // ones that aren't.
+    ok = ok && test<int32_t>(4, 256);
+    ok = ok && test<int32_t>(3, 100);
+    ok = ok && test<uint16_t>(8, 37);
+    ok = ok && test<float>(4, 128);
+    ok = ok && test<float>(6, 61);
+    ok = ok && test<double>(2, 19);
+
+    // Without opting in, a float sum is left alone, but must still be
+    // correct.
+    {
+        Image<float> input(100);
+        float correct = 0;
+        for (int x = 0; x < 100; x++) {
+            input(x) = (float)(rand() % 16);
+            correct += input(x);
+        }
+        RDom r(0, 100);
+        Func f;
+        f() = 0.0f;
+        f() += input(r);
+        f.update().interleave_accumulators(r, 4);
+        if (count_partials(f) != 0) {
+            printf("A float sum was interleaved without reassociate_floats\n");
+            ok = false;
+        }
+        Image<float> result = f.realize();
+        if (result(0) != correct) {
+            printf("f() = %f instead of %f\n", result(0), correct);
+            ok = false;
+        }
+    }
+
+    if (!ok) return -1;
+
+    printf("Success!\n");
+    return 0;
+}
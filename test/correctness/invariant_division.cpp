@@ -0,0 +1,90 @@
+#include <Halide.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <limits>
+
+using namespace Halide;
+
+// Halide's division rounds towards negative infinity.
+long long floor_div(long long a, long long b) {
+    long long q = a / b;
+    if ((a % b != 0) && ((a < 0) != (b < 0))) q--;
+    return q;
+}
+
+// Divide and mod by a Param, vectorized and not, and check the
+// results against each other and against C.
+template<typename T>
+bool test(int w, T denominator) {
+    const int W = 1024, H = 64;
+    Image<T> input(W, H);
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            input(x, y) = (T)(rand() ^ (rand() << 16));
+        }
+    }
+    // Make sure the extreme values are covered.
+    input(0, 0) = std::numeric_limits<T>::min();
+    input(1, 0) = std::numeric_limits<T>::max();
+    input(2, 0) = 0;
+
+    Param<T> d;
+    d.set(denominator);
+    Var x, y;
+    Func scalar, vectorized;
+    scalar(x, y) = Tuple(input(x, y) / d, input(x, y) % d);
+    vectorized(x, y) = Tuple(input(x, y) / d, input(x, y) % d);
+    vectorized.vectorize(x, w);
+
+    Realization r_scalar = scalar.realize(W, H);
+    Realization r_vector = vectorized.realize(W, H);
+    Image<T> div_scalar = r_scalar[0], mod_scalar = r_scalar[1];
+    Image<T> div_vector = r_vector[0], mod_vector = r_vector[1];
+
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            long long a = input(x, y);
+            // Overflows, so the result doesn't matter.
+            if (denominator == (T)(-1) && a == std::numeric_limits<T>::min()) continue;
+            T correct_div = (T)floor_div(a, denominator);
+            T correct_mod = (T)(a - floor_div(a, denominator) * denominator);
+            if (div_vector(x, y) != correct_div || div_scalar(x, y) != correct_div ||
+                mod_vector(x, y) != correct_mod || mod_scalar(x, y) != correct_mod) {
+                printf("%lld / %lld: vectorized gave %lld, %lld, scalar gave %lld, %lld "
+                       "instead of %lld, %lld\n",
+                       a, (long long)denominator,
+                       (long long)div_vector(x, y), (long long)mod_vector(x, y),
+                       (long long)div_scalar(x, y), (long long)mod_scalar(x, y),
+                       (long long)correct_div, (long long)correct_mod);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template<typename T>
+bool test_all(int w) {
+    T denominators[] = {1, 2, 3, 7, 10, 100, 127, (T)(-1), (T)(-3), (T)(-100),
+                        std::numeric_limits<T>::max(), std::numeric_limits<T>::min()};
+    for (int i = 0; i < 12; i++) {
+        if (denominators[i] == 0) continue;
+        if (!test<T>(w, denominators[i])) return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    bool success = true;
+    success = success && test_all<int32_t>(4);
+    success = success && test_all<int16_t>(8);
+    success = success && test_all<int8_t>(16);
+    success = success && test_all<uint32_t>(4);
+    success = success && test_all<uint16_t>(8);
+    success = success && test_all<uint8_t>(16);
+    if (!success) return -1;
+
+    printf("Success!\n");
+    return 0;
+}
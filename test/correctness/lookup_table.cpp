@@ -0,0 +1,70 @@
+#include <Halide.h>
+#include <stdio.h>
+#include <string.h>
+
+using namespace Halide;
+
+// Does an assembly file contain the given instruction?
+bool contains(const char *filename, const char *op) {
+    FILE *f = fopen(filename, "r");
+    if (!f) return false;
+    char line[1024];
+    bool found = false;
+    while (!found && fgets(line, sizeof(line), f)) {
+        found = strstr(line, op) != NULL;
+    }
+    fclose(f);
+    return found;
+}
+
+int main(int argc, char **argv) {
+    Target t = get_jit_target_from_environment();
+    if (t.arch != Target::X86 || !(t.features & Target::SSE41)) {
+        printf("No sse4.1 on this target. Skipping test.\n");
+        return 0;
+    }
+
+    // A posterizing lookup into 16 entries of a larger table, which
+    // doesn't start at zero. The table's position in memory depends
+    // on the min coordinate of the buffer, which is only known at
+    // runtime, but it still fits in one register.
+    ImageParam in(UInt(8), 2), levels(UInt(8), 1);
+    Var x, y;
+    Func f;
+    f(x, y) = levels(in(x, y) / 16 + 42);
+    f.vectorize(x, 16);
+
+    f.compile_to_assembly("lookup_table.s", Internal::vec<Argument>(in, levels), t);
+    if (!contains("lookup_table.s", "pshufb")) {
+        printf("The lookup didn't use pshufb\n");
+        return -1;
+    }
+
+    const int W = 64, H = 8;
+    Image<uint8_t> input(W, H), table(20);
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            input(x, y) = (uint8_t)rand();
+        }
+    }
+    for (int i = 0; i < 20; i++) {
+        table(i) = (uint8_t)(i * 13 + 1);
+    }
+    table.set_min(40);
+    in.set(input);
+    levels.set(table);
+
+    Image<uint8_t> out = f.realize(W, H, t);
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            uint8_t correct = (uint8_t)((input(x, y) / 16 + 2) * 13 + 1);
+            if (out(x, y) != correct) {
+                printf("out(%d, %d) = %d instead of %d\n", x, y, out(x, y), correct);
+                return -1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
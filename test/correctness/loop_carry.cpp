@@ -0,0 +1,124 @@
+#include <stdio.h>
+#include <Halide.h>
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    const int W = 64, H = 37;
+
+    Image<int> input(W + 2, H + 2);
+    for (int y = 0; y < input.height(); y++) {
+        for (int x = 0; x < input.width(); x++) {
+            input(x, y) = x * 7 + y * 13 + (x * y) % 5;
+        }
+    }
+
+    {
+        // A 3x3 stencil of an internal buffer, vectorized across x,
+        // with y innermost. The rows should be carried from one
+        // iteration of y to the next, and the taps along x should
+        // share aligned loads.
+        Var x, y, xo, xi;
+        Func f, g;
+        f(x, y) = input(x, y) * 2;
+        g(x, y) = (f(x, y) + f(x+1, y) + f(x+2, y) +
+                   f(x, y+1) + f(x+1, y+1) + f(x+2, y+1) +
+                   f(x, y+2) + f(x+1, y+2) + f(x+2, y+2));
+        f.compute_root().vectorize(x, 8);
+        g.split(x, xo, xi, 8).vectorize(xi).reorder(xi, y, xo);
+
+        Image<int> out = g.realize(W, H);
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                int correct = 0;
+                for (int dy = 0; dy < 3; dy++) {
+                    for (int dx = 0; dx < 3; dx++) {
+                        correct += 2 * input(x + dx, y + dy);
+                    }
+                }
+                if (out(x, y) != correct) {
+                    printf("out(%d, %d) = %d instead of %d\n", x, y, out(x, y), correct);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    {
+        // A scan down the columns that reads its own previous
+        // rows. Those values change as the loop runs, so they can't
+        // be carried.
+        Var x, y;
+        RDom r(2, H - 2);
+        Func f;
+        f(x, y) = undef<int>();
+        f(x, 0) = input(x, 0);
+        f(x, 1) = input(x, 1);
+        f(x, r) = f(x, r - 1) + f(x, r - 2) + input(x, r);
+        f.update(2).vectorize(x, 8);
+
+        Image<int> out = f.realize(W, H);
+        for (int x = 0; x < W; x++) {
+            int a = input(x, 0), b = input(x, 1);
+            for (int y = 2; y < H; y++) {
+                int correct = a + b + input(x, y);
+                if (out(x, y) != correct) {
+                    printf("out(%d, %d) = %d instead of %d\n", x, y, out(x, y), correct);
+                    return -1;
+                }
+                a = b;
+                b = correct;
+            }
+        }
+    }
+
+    {
+        // Taps that are only loaded some of the time, over short and
+        // long loops.
+        Var x, y;
+        Func f, g;
+        f(x, y) = input(x, y) + 1;
+        g(x, y) = select(y % 2 == 0, f(x, y) + f(x, y+1), f(x, y+2));
+        f.compute_root();
+        g.reorder(y, x);
+
+        for (int rows = 1; rows <= H; rows += H - 1) {
+            Image<int> out = g.realize(W, rows);
+            for (int y = 0; y < rows; y++) {
+                for (int x = 0; x < W; x++) {
+                    int correct = (y % 2 == 0 ?
+                                   input(x, y) + input(x, y + 1) + 2 :
+                                   input(x, y + 2) + 1);
+                    if (out(x, y) != correct) {
+                        printf("out(%d, %d) = %d instead of %d\n", x, y, out(x, y), correct);
+                        return -1;
+                    }
+                }
+            }
+        }
+    }
+
+    {
+        // A tap that is also prefetched. The prefetch of f(x+1) uses
+        // the address of the load, so it must not be replaced by the
+        // carried value.
+        Var x;
+        Func f, g;
+        f(x) = input(x, 0) * 3;
+        g(x) = f(x) + f(x+1);
+        f.compute_root();
+        g.prefetch(f, x, 1);
+
+        Image<int> out = g.realize(W);
+        for (int x = 0; x < W; x++) {
+            int correct = 3 * (input(x, 0) + input(x + 1, 0));
+            if (out(x) != correct) {
+                printf("out(%d) = %d instead of %d\n", x, out(x), correct);
+                return -1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include <stdio.h>
+#include <algorithm>
+#include <Halide.h>
+
+using namespace Halide;
+
+// On windows, you need to use declspec to export the extern function.
+#ifdef _MSC_VER
+#define DLLEXPORT __declspec(dllexport)
+#else
+#define DLLEXPORT
+#endif
+
+int call_counter = 0;
+extern "C" DLLEXPORT int count_calls(int x) {
+    call_counter++;
+    return x;
+}
+HalideExtern_1(int, count_calls, int);
+
+int main(int argc, char **argv) {
+    const int W = 64, H = 48;
+    Var x, y;
+
+    // A shared intermediate, with a full-resolution output, a preview
+    // that reads the full-resolution output, and some statistics.
+    Func f, full, preview, stats;
+    f(x, y) = count_calls(x + y * 3);
+    f.compute_root();
+
+    full(x, y) = f(x, y) * 2;
+    full.vectorize(x, 8).parallel(y);
+
+    preview(x, y) = full(2*x, 2*y) + f(2*x + 1, 2*y + 1);
+
+    RDom r(0, W, 0, H);
+    stats(x) = 0;
+    stats(0) += f(r.x, r.y);
+    stats(1) = max(stats(1), f(r.x, r.y));
+
+    // A Tuple-valued output too.
+    Func both;
+    both(x, y) = Tuple(f(x, y), cast<float>(f(x, y)) / 2);
+
+    std::vector<Func> outputs;
+    outputs.push_back(full);
+    outputs.push_back(preview);
+    outputs.push_back(stats);
+    outputs.push_back(both);
+    Pipeline p(outputs);
+
+    Image<int> full_im(W, H), preview_im(W/2, H/2), stats_im(2);
+    Image<int> both_a(W, H);
+    Image<float> both_b(W, H);
+    std::vector<Buffer> bufs;
+    bufs.push_back(full_im);
+    bufs.push_back(preview_im);
+    bufs.push_back(stats_im);
+    bufs.push_back(both_a);
+    bufs.push_back(both_b);
+    p.realize(Realization(bufs));
+
+    // The shared intermediate should have been computed once, over
+    // the union of the regions the outputs need.
+    if (call_counter != W * H) {
+        printf("Shared intermediate was computed at %d points instead of %d\n", call_counter, W * H);
+        return -1;
+    }
+
+    int sum = 0, biggest = 0;
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            int v = x + y * 3;
+            sum += v;
+            biggest = std::max(biggest, v);
+            if (full_im(x, y) != v * 2) {
+                printf("full(%d, %d) = %d instead of %d\n", x, y, full_im(x, y), v * 2);
+                return -1;
+            }
+            if (both_a(x, y) != v || both_b(x, y) != v / 2.0f) {
+                printf("both(%d, %d) = (%d, %f) instead of (%d, %f)\n",
+                       x, y, both_a(x, y), both_b(x, y), v, v / 2.0f);
+                return -1;
+            }
+        }
+    }
+    for (int y = 0; y < H/2; y++) {
+        for (int x = 0; x < W/2; x++) {
+            int correct = (2*x + 2*y*3) * 2 + (2*x + 1 + (2*y + 1)*3);
+            if (preview_im(x, y) != correct) {
+                printf("preview(%d, %d) = %d instead of %d\n", x, y, preview_im(x, y), correct);
+                return -1;
+            }
+        }
+    }
+    if (stats_im(0) != sum || stats_im(1) != biggest) {
+        printf("stats = (%d, %d) instead of (%d, %d)\n", stats_im(0), stats_im(1), sum, biggest);
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,185 @@
+#include <Halide.h>
+#include <stdio.h>
+#include <string>
+
+using namespace Halide;
+using namespace Halide::Internal;
+
+// Finds the narrowest integer arithmetic, and the type of an
+// allocation, in a lowered statement.
+class FindTypes : public IRVisitor {
+    using IRVisitor::visit;
+
+    void record(Type t) {
+        if (t.is_int() || t.is_uint()) {
+            if (narrowest == 0 || t.bits < narrowest) narrowest = t.bits;
+        }
+    }
+
+    void visit(const Add *op) {record(op->type); IRVisitor::visit(op);}
+    void visit(const Sub *op) {record(op->type); IRVisitor::visit(op);}
+    void visit(const Mul *op) {record(op->type); IRVisitor::visit(op);}
+    void visit(const Div *op) {record(op->type); IRVisitor::visit(op);}
+    void visit(const Mod *op) {record(op->type); IRVisitor::visit(op);}
+
+    void visit(const Allocate *op) {
+        if (op->name == allocation) allocation_type = op->type;
+        IRVisitor::visit(op);
+    }
+public:
+    std::string allocation;
+    Type allocation_type;
+    int narrowest;
+    FindTypes(const std::string &a = "") : allocation(a), narrowest(0) {}
+};
+
+FindTypes find_types(Func f, const std::string &allocation = "") {
+    FindTypes types(allocation);
+    lower(f.function(), get_jit_target_from_environment()).accept(&types);
+    return types;
+}
+
+// Division and modulus in Halide round towards negative infinity.
+int floor_div(int a, int b) {
+    int q = a / b;
+    if (q * b != a && ((a < 0) != (b < 0))) q--;
+    return q;
+}
+
+int floor_mod(int a, int b) {
+    int r = a % b;
+    if (r < 0) r += (b < 0 ? -b : b);
+    return r;
+}
+
+Expr i32(Expr e) {
+    return cast<int32_t>(e);
+}
+
+int main(int argc, char **argv) {
+    // Every pair of int8 values, and of uint8 values.
+    Image<int8_t> a(256, 256), b(256, 256);
+    Image<uint8_t> ua(256, 256), ub(256, 256);
+    for (int y = 0; y < 256; y++) {
+        for (int x = 0; x < 256; x++) {
+            a(x, y) = (int8_t)(x - 128);
+            b(x, y) = (int8_t)(y - 128);
+            ua(x, y) = (uint8_t)x;
+            ub(x, y) = (uint8_t)y;
+        }
+    }
+
+    Var x, y;
+
+    // Sums and differences of signed values at the limits of int8
+    // fit in int16.
+    {
+        Func f;
+        f(x, y) = cast<int16_t>(i32(a(x, y)) - i32(b(x, y)) - 1);
+        f.vectorize(x, 8);
+        if (find_types(f).narrowest != 16) {
+            printf("The signed difference wasn't computed in 16 bits\n");
+            return -1;
+        }
+        Image<int16_t> out = f.realize(256, 256);
+        for (int y = 0; y < 256; y++) {
+            for (int x = 0; x < 256; x++) {
+                int16_t correct = (int16_t)(a(x, y) - b(x, y) - 1);
+                if (out(x, y) != correct) {
+                    printf("difference(%d, %d) = %d instead of %d\n", x, y, out(x, y), correct);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    // Division and modulus of negative values, by positive and
+    // negative divisors, must round the same way when narrowed.
+    {
+        const int divisors[] = {3, -3, 7, -8};
+        for (int i = 0; i < 4; i++) {
+            int d = divisors[i];
+            Func q, r;
+            q(x, y) = cast<int8_t>((i32(a(x, y)) - 64) / d);
+            r(x, y) = cast<int8_t>((i32(a(x, y)) + i32(b(x, y))) % d);
+            q.vectorize(x, 8);
+            r.vectorize(x, 8);
+            Image<int8_t> q_out = q.realize(256, 256);
+            Image<int8_t> r_out = r.realize(256, 256);
+            for (int y = 0; y < 256; y++) {
+                for (int x = 0; x < 256; x++) {
+                    int8_t q_correct = (int8_t)floor_div(a(x, y) - 64, d);
+                    int8_t r_correct = (int8_t)floor_mod(a(x, y) + b(x, y), d);
+                    if (q_out(x, y) != q_correct) {
+                        printf("(a - 64) / %d at %d, %d = %d instead of %d\n",
+                               d, x, y, q_out(x, y), q_correct);
+                        return -1;
+                    }
+                    if (r_out(x, y) != r_correct) {
+                        printf("(a + b) %% %d at %d, %d = %d instead of %d\n",
+                               d, x, y, r_out(x, y), r_correct);
+                        return -1;
+                    }
+                }
+            }
+        }
+    }
+
+    // A product of two bytes times four doesn't fit in 16 bits, so it
+    // must stay in 32 bits even though the result is 8 bits.
+    {
+        Func f;
+        f(x, y) = cast<uint8_t>((i32(ua(x, y)) * i32(ub(x, y)) * 4) / 1024);
+        f.vectorize(x, 8);
+        if (find_types(f).narrowest != 32) {
+            printf("A product that doesn't fit in 16 bits was narrowed\n");
+            return -1;
+        }
+        Image<uint8_t> out = f.realize(256, 256);
+        for (int y = 0; y < 256; y++) {
+            for (int x = 0; x < 256; x++) {
+                uint8_t correct = (uint8_t)((x * y * 4) / 1024);
+                if (out(x, y) != correct) {
+                    printf("product(%d, %d) = %d instead of %d\n", x, y, out(x, y), correct);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    // A stored Func whose values fit in 16 bits is stored in 16
+    // bits, and one whose values don't is left alone.
+    {
+        Func sum, big, out;
+        sum(x, y) = i32(ua(x, y)) + i32(ub(x, y)) * 2;
+        big(x, y) = i32(ua(x, y)) * 300;
+        out(x, y) = sum(x, y) + big(x, y);
+        sum.compute_root();
+        big.compute_root();
+
+        FindTypes sum_types = find_types(out, sum.name());
+        FindTypes big_types = find_types(out, big.name());
+        if (sum_types.allocation_type != UInt(16)) {
+            printf("sum wasn't stored as uint16\n");
+            return -1;
+        }
+        if (big_types.allocation_type != Int(32)) {
+            printf("big was narrowed, but its values don't fit in 16 bits\n");
+            return -1;
+        }
+
+        Image<int32_t> result = out.realize(256, 256);
+        for (int y = 0; y < 256; y++) {
+            for (int x = 0; x < 256; x++) {
+                int correct = x + y * 2 + x * 300;
+                if (result(x, y) != correct) {
+                    printf("out(%d, %d) = %d instead of %d\n", x, y, result(x, y), correct);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
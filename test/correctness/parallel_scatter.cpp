@@ -0,0 +1,110 @@
+#include <Halide.h>
+#include <stdio.h>
+#include <algorithm>
+
+using namespace Halide;
+
+bool test(ScatterStrategy strategy, int width, int height, int split) {
+    Image<uint8_t> input(width, height);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            input(x, y) = (uint8_t)(rand() & 0xff);
+        }
+    }
+
+    Var x, y, ryo, ryi;
+    RDom r(0, width, 0, height);
+    Expr bin = clamp(cast<int>(input(r.x, r.y)) / 8, 0, 31);
+    Func hist, neg_hist, last, first, blocks;
+
+    hist(x) = 0;
+    hist(bin) += 1;
+    hist.update().split(r.y, ryo, ryi, split).parallel_scatter(ryo, strategy);
+
+    neg_hist(x) = 1000000;
+    neg_hist(bin) -= 2;
+    neg_hist.update().split(r.y, ryo, ryi, split).parallel_scatter(ryo, strategy);
+
+    last(x) = -1;
+    last(bin) = max(last(bin), r.y * width + r.x);
+    last.update().split(r.y, ryo, ryi, split).parallel_scatter(ryo, strategy);
+
+    first(x) = width * height;
+    first(bin) = min(first(bin), r.y * width + r.x);
+    first.update().split(r.y, ryo, ryi, split).parallel_scatter(ryo, strategy);
+
+    // A two-dimensional output that isn't the root of the pipeline.
+    Func blocks_wrapper;
+    blocks(x, y) = 0;
+    blocks(r.x / 16, bin) += cast<int>(input(r.x, r.y));
+    blocks.compute_root();
+    blocks.update().split(r.y, ryo, ryi, split).parallel_scatter(ryo, strategy);
+    blocks_wrapper(x, y) = blocks(x, y);
+
+    Image<int> hist_result = hist.realize(32);
+    Image<int> neg_hist_result = neg_hist.realize(32);
+    Image<int> last_result = last.realize(32);
+    Image<int> first_result = first.realize(32);
+    int block_columns = (width + 15) / 16;
+    Image<int> blocks_result = blocks_wrapper.realize(block_columns, 32);
+
+    int hist_correct[32], last_correct[32], first_correct[32];
+    std::vector<int> blocks_correct(block_columns * 32);
+    for (int i = 0; i < 32; i++) {
+        hist_correct[i] = 0;
+        last_correct[i] = -1;
+        first_correct[i] = width * height;
+    }
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int b = input(x, y) / 8;
+            int site = y * width + x;
+            hist_correct[b]++;
+            last_correct[b] = std::max(last_correct[b], site);
+            first_correct[b] = std::min(first_correct[b], site);
+            blocks_correct[b * block_columns + x / 16] += input(x, y);
+        }
+    }
+
+    for (int i = 0; i < 32; i++) {
+        if (hist_result(i) != hist_correct[i]) {
+            printf("hist(%d) = %d instead of %d\n", i, hist_result(i), hist_correct[i]);
+            return false;
+        }
+        if (neg_hist_result(i) != 1000000 - 2 * hist_correct[i]) {
+            printf("neg_hist(%d) = %d instead of %d\n", i, neg_hist_result(i), 1000000 - 2 * hist_correct[i]);
+            return false;
+        }
+        if (last_result(i) != last_correct[i]) {
+            printf("last(%d) = %d instead of %d\n", i, last_result(i), last_correct[i]);
+            return false;
+        }
+        if (first_result(i) != first_correct[i]) {
+            printf("first(%d) = %d instead of %d\n", i, first_result(i), first_correct[i]);
+            return false;
+        }
+        for (int j = 0; j < block_columns; j++) {
+            if (blocks_result(j, i) != blocks_correct[i * block_columns + j]) {
+                printf("blocks(%d, %d) = %d instead of %d\n", j, i,
+                       blocks_result(j, i), blocks_correct[i * block_columns + j]);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char **argv) {
+    bool ok = true;
+
+    ok = ok && test(Scatter_Privatize, 256, 256, 16);
+    ok = ok && test(Scatter_Privatize, 100, 37, 8);
+    ok = ok && test(Scatter_Atomic, 256, 256, 16);
+    ok = ok && test(Scatter_Atomic, 100, 37, 8);
+
+    if (!ok) return -1;
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,52 @@
+#include <Halide.h>
+#include <stdio.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using namespace Halide;
+
+// Compile an atomic parallel scatter with the C backend, and check
+// that it uses the expected builtins.
+bool test(Func f, ImageParam input, const std::string &name, const char *builtin) {
+    std::string filename = name + "_c_backend.cpp";
+    f.compile_to_c(filename, Internal::vec<Argument>(input), name);
+
+    std::ifstream file(filename.c_str());
+    std::stringstream source;
+    source << file.rdbuf();
+    if (source.str().find(builtin) == std::string::npos) {
+        printf("C source for %s doesn't use %s:\n%s\n", name.c_str(), builtin, source.str().c_str());
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    ImageParam input(UInt(8), 2);
+    Var x, ryo, ryi;
+    RDom r(0, input.width(), 0, input.height());
+    Expr bin = clamp(cast<int>(input(r.x, r.y)) / 8, 0, 31);
+    Func hist, last, first;
+
+    hist(x) = 0;
+    hist(bin) += 1;
+    hist.update().split(r.y, ryo, ryi, 8).parallel_scatter(ryo, Scatter_Atomic);
+
+    last(x) = -1;
+    last(bin) = max(last(bin), r.y * input.width() + r.x);
+    last.update().split(r.y, ryo, ryi, 8).parallel_scatter(ryo, Scatter_Atomic);
+
+    first(x) = 1 << 30;
+    first(bin) = min(first(bin), r.y * input.width() + r.x);
+    first.update().split(r.y, ryo, ryi, 8).parallel_scatter(ryo, Scatter_Atomic);
+
+    if (!test(hist, input, "scatter_hist", "__sync_fetch_and_add") ||
+        !test(last, input, "scatter_last", "__sync_val_compare_and_swap") ||
+        !test(first, input, "scatter_first", "__sync_val_compare_and_swap")) {
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include <stdio.h>
+#include <Halide.h>
+
+using namespace Halide;
+
+#ifdef _MSC_VER
+#define DLLEXPORT __declspec(dllexport)
+#else
+#define DLLEXPORT
+#endif
+
+int count = 0;
+extern "C" DLLEXPORT int call_counter(int x, int y) {
+    count++;
+    return x + y * 16;
+}
+HalideExtern_2(int, call_counter, int, int);
+
+size_t biggest_alloc = 0;
+extern "C" void *my_malloc(void *, size_t x) {
+    if (x > biggest_alloc) biggest_alloc = x;
+    void *orig = malloc(x+32);
+    void *ptr = (void *)((((size_t)orig + 32) >> 5) << 5);
+    ((void **)ptr)[-1] = orig;
+    return ptr;
+}
+
+extern "C" void my_free(void *, void *ptr) {
+    free(((void**)ptr)[-1]);
+}
+
+int main(int argc, char **argv) {
+    const int W = 10;
+
+    // Heights that the strips do and don't divide.
+    for (int H = 20; H <= 22; H += 2) {
+        for (int parallel = 0; parallel < 2; parallel++) {
+            Var x, y, strip, row;
+            Func f, g;
+            f(x, y) = call_counter(x, y);
+            g(x, y) = f(x, y-1) + f(x, y) + f(x, y+1);
+
+            g.parallel_strips(y, strip, row, 4);
+            f.store_at(g, strip).compute_at(g, row);
+            if (!parallel) {
+                // Serialize the strips to count the calls and the
+                // allocations.
+                g.serial(strip);
+                g.set_custom_allocator(&my_malloc, &my_free);
+            }
+
+            count = 0;
+            biggest_alloc = 0;
+            Image<int> out = g.realize(W, H);
+
+            for (int y = 0; y < H; y++) {
+                for (int x = 0; x < W; x++) {
+                    int correct = 3 * (x + y * 16);
+                    if (out(x, y) != correct) {
+                        printf("out(%d, %d) = %d instead of %d\n", x, y, out(x, y), correct);
+                        return -1;
+                    }
+                }
+            }
+
+            if (parallel) continue;
+
+            // Each strip should compute its own rows, plus two rows
+            // to warm up, and each row only once.
+            int strip_height = (H + 3) / 4;
+            int correct = 4 * (strip_height + 2) * W;
+            if (count != correct) {
+                printf("f was called %d times instead of %d times\n", count, correct);
+                return -1;
+            }
+
+            // Each strip's buffer should be folded down to the rows in
+            // flight, rather than cover the whole strip.
+            size_t unfolded = (strip_height + 2) * W * sizeof(int);
+            if (biggest_alloc >= unfolded) {
+                printf("f's buffer was %d bytes, which is not smaller than the %d bytes of a strip\n",
+                       (int)biggest_alloc, (int)unfolded);
+                return -1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
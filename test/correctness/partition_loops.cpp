@@ -0,0 +1,200 @@
+#include <Halide.h>
+#include <stdio.h>
+#include <algorithm>
+#include <set>
+#include <string>
+
+using namespace Halide;
+using namespace Halide::Internal;
+
+// Counts the loops in a statement, and the names used more than once.
+class CountLoops : public IRVisitor {
+    using IRVisitor::visit;
+
+    void visit(const For *op) {
+        count++;
+        if (!names.insert(op->name).second) {
+            duplicates++;
+        }
+        IRVisitor::visit(op);
+    }
+public:
+    std::set<std::string> names;
+    int count, duplicates;
+    CountLoops() : count(0), duplicates(0) {}
+};
+
+// Counts the mins and maxes inside the loop with the given name.
+class CountMinMax : public IRVisitor {
+    using IRVisitor::visit;
+
+    void visit(const For *op) {
+        if (op->name == loop) {
+            found = true;
+            inside++;
+            IRVisitor::visit(op);
+            inside--;
+        } else {
+            IRVisitor::visit(op);
+        }
+    }
+
+    void visit(const Min *op) {
+        if (inside) count++;
+        IRVisitor::visit(op);
+    }
+
+    void visit(const Max *op) {
+        if (inside) count++;
+        IRVisitor::visit(op);
+    }
+public:
+    std::string loop;
+    bool found;
+    int inside, count;
+    CountMinMax(const std::string &l) : loop(l), found(false), inside(0), count(0) {}
+};
+
+// Check the lowered loop nests. Partitioned loops should get
+// distinct names, and clamping a value rather than a coordinate
+// shouldn't partition anything.
+bool check_lowering() {
+    ImageParam input(UInt(8), 2);
+    Var x, y;
+
+    Func clamped;
+    clamped(x, y) = input(clamp(x, 0, input.width() - 1), clamp(y, 0, input.height() - 1));
+    Func blur;
+    blur(x, y) = clamped(x - 1, y) + clamped(x + 1, y);
+
+    CountLoops blur_loops;
+    lower(blur.function(), get_jit_target_from_environment()).accept(&blur_loops);
+    if (blur_loops.duplicates) {
+        printf("Partitioned blur has %d loops with duplicate names\n", blur_loops.duplicates);
+        return false;
+    }
+    if (blur_loops.count <= 2) {
+        printf("blur wasn't partitioned\n");
+        return false;
+    }
+
+    // The boundary conditions that wrap around clamp a likely
+    // select. The steady state should have neither.
+    for (int i = 0; i < 3; i++) {
+        Func wrapped;
+        const char *name;
+        if (i == 0) {
+            wrapped = BoundaryConditions::repeat_image(input);
+            name = "repeat_image";
+        } else if (i == 1) {
+            wrapped = BoundaryConditions::mirror_image(input);
+            name = "mirror_image";
+        } else {
+            wrapped = BoundaryConditions::mirror_interior(input);
+            name = "mirror_interior";
+        }
+        Var bx("x"), by("y");
+        Func g("g");
+        g(bx, by) = wrapped(bx - 1, by - 1) + wrapped(bx + 1, by + 1);
+
+        CountMinMax steady(g.name() + ".s0." + bx.name());
+        lower(g.function(), get_jit_target_from_environment()).accept(&steady);
+        if (!steady.found) {
+            printf("Couldn't find the steady state of %s\n", name);
+            return false;
+        }
+        if (steady.count) {
+            printf("The steady state of %s has %d mins and maxes\n", name, steady.count);
+            return false;
+        }
+    }
+
+    Func brighter;
+    brighter(x, y) = cast<uint8_t>(min(cast<int>(input(x, y)) + x, 255));
+    CountLoops brighter_loops;
+    lower(brighter.function(), get_jit_target_from_environment()).accept(&brighter_loops);
+    if (brighter_loops.count != 2) {
+        printf("brighter has %d loops instead of 2\n", brighter_loops.count);
+        return false;
+    }
+
+    return true;
+}
+
+bool test(int width, int height) {
+    Image<uint8_t> input(width, height);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            input(x, y) = (uint8_t)(rand() & 0xff);
+        }
+    }
+
+    Var x, y, xo, xi;
+
+    // A clamped stencil, vectorized and not.
+    Func clamped;
+    clamped(x, y) = cast<uint16_t>(input(clamp(x, 0, width - 1), clamp(y, 0, height - 1)));
+    Func blur, blur_vec;
+    blur(x, y) = clamped(x - 1, y - 1) + clamped(x + 1, y + 1);
+    blur_vec(x, y) = clamped(x - 1, y - 1) + clamped(x + 1, y + 1);
+    blur_vec.vectorize(x, 8, TailStrategy_GuardWithIf);
+
+    // A boundary select with the interior marked as likely.
+    Func exterior;
+    exterior(x, y) = select(x < 0 || x >= width || y < 0 || y >= height, cast<uint8_t>(7),
+                            likely(input(clamp(x, 0, width - 1), clamp(y, 0, height - 1))));
+    Func padded;
+    padded(x, y) = exterior(x - 2, y) + exterior(x + 2, y);
+    padded.vectorize(x, 16, TailStrategy_GuardWithIf);
+
+    Image<uint16_t> blur_result = blur.realize(width + 4, height + 4);
+    Image<uint16_t> blur_vec_result = blur_vec.realize(width + 4, height + 4);
+    Image<uint8_t> padded_result = padded.realize(width, height);
+
+    for (int y = 0; y < height + 4; y++) {
+        for (int x = 0; x < width + 4; x++) {
+            int x0 = std::min(std::max(x - 1, 0), width - 1);
+            int y0 = std::min(std::max(y - 1, 0), height - 1);
+            int x1 = std::min(std::max(x + 1, 0), width - 1);
+            int y1 = std::min(std::max(y + 1, 0), height - 1);
+            uint16_t correct = input(x0, y0) + input(x1, y1);
+            if (blur_result(x, y) != correct) {
+                printf("blur(%d, %d) = %d instead of %d\n", x, y, blur_result(x, y), correct);
+                return false;
+            }
+            if (blur_vec_result(x, y) != correct) {
+                printf("blur_vec(%d, %d) = %d instead of %d\n", x, y, blur_vec_result(x, y), correct);
+                return false;
+            }
+        }
+    }
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            uint8_t a = (x - 2 < 0) ? 7 : input(x - 2, y);
+            uint8_t b = (x + 2 >= width) ? 7 : input(x + 2, y);
+            uint8_t correct = (uint8_t)(a + b);
+            if (padded_result(x, y) != correct) {
+                printf("padded(%d, %d) = %d instead of %d\n", x, y, padded_result(x, y), correct);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char **argv) {
+    bool ok = check_lowering();
+
+    // Sizes where the steady state is large, small, and empty.
+    ok = ok && test(100, 50);
+    ok = ok && test(17, 5);
+    ok = ok && test(3, 2);
+    ok = ok && test(1, 1);
+
+    if (!ok) return -1;
+
+    printf("Success!\n");
+    return 0;
+}
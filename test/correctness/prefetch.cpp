@@ -0,0 +1,78 @@
+#include <Halide.h>
+#include <stdio.h>
+
+using namespace Halide;
+using namespace Halide::Internal;
+
+// Count the prefetches in the lowered code.
+class CountPrefetches : public IRVisitor {
+    using IRVisitor::visit;
+
+    void visit(const Call *op) {
+        IRVisitor::visit(op);
+        if (op->call_type == Call::Intrinsic && op->name == Call::prefetch) {
+            count++;
+        }
+    }
+
+public:
+    int count;
+    CountPrefetches() : count(0) {}
+};
+
+int count_prefetches(Func f) {
+    Stmt s = lower(f.function(), get_jit_target_from_environment());
+    CountPrefetches counter;
+    s.accept(&counter);
+    return counter.count;
+}
+
+bool check(Func f, Image<uint16_t> input, int x_off, const char *name) {
+    if (count_prefetches(f) == 0) {
+        printf("No prefetches were injected for %s\n", name);
+        return false;
+    }
+
+    const int W = 64, H = 32;
+    Image<uint16_t> out = f.realize(W, H);
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            uint16_t correct = input(x, y) + input(x + x_off, y + 1);
+            if (out(x, y) != correct) {
+                printf("%s(%d, %d) = %d instead of %d\n", name, x, y, out(x, y), correct);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    Image<uint16_t> input(128, 64);
+    for (int y = 0; y < 64; y++) {
+        for (int x = 0; x < 128; x++) {
+            input(x, y) = (uint16_t)(rand() & 0xfff);
+        }
+    }
+    ImageParam in(UInt(16), 2);
+    in.set(input);
+    Var x, y;
+
+    // Prefetch an image read directly by the loop.
+    Func direct;
+    direct(x, y) = in(x, y) + in(x, y + 1);
+    direct.prefetch(in, y, 2);
+    if (!check(direct, input, 0, "direct")) return -1;
+
+    // Prefetch an image that is only read by a function computed
+    // within the loop.
+    Func producer, consumer;
+    producer(x, y) = in(x, y) + in(x + 1, y + 1);
+    consumer(x, y) = producer(x, y);
+    producer.compute_at(consumer, y);
+    consumer.prefetch(in, y, 2);
+    if (!check(consumer, input, 1, "consumer")) return -1;
+
+    printf("Success!\n");
+    return 0;
+}
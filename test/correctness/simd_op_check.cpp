@@ -12,7 +12,7 @@ using std::vector;
 bool failed = false;
 Var x, y;
 
-bool use_ssse3, use_sse41, use_sse42, use_avx, use_avx2;
+bool use_ssse3, use_sse41, use_sse42, use_avx, use_avx2, use_avx512, use_avx512_skylake, use_fma;
 
 char *filter = NULL;
 
@@ -318,6 +318,10 @@ void check_sse_all() {
     check("packsswb", 16, i8(clamp(i16_1, min_i8, max_i8)));
     check("packuswb", 16, u8(clamp(i16_1, 0, max_u8)));
 
+    check("pmaddwd", 4, i32(i16_1) * i32(i16_2) + i32(i16_3) * i32(in_i16(x+48)));
+    check("pmaddwd", 8, (i32(in_i16(2*x)) * i32(in_i16(2*x+32)) +
+                         i32(in_i16(2*x+1)) * i32(in_i16(2*x+33))));
+
     // SSE 3
 
     // We don't do horizontal add/sub ops, so nothing new here
@@ -329,6 +333,12 @@ void check_sse_all() {
         check("pabsd", 4, abs(i32_1));
     }
 
+    // Lookups into small tables (the pshufb path needs sse41)
+    if (use_sse41) {
+        check("pshufb", 16, in_u8(u8_1 / 16));
+        check("pshufb", 16, in_u8((u8_1 >> 4) + 100));
+    }
+
     // SSE 4.1
 
     // skip dot product and argmin
@@ -361,6 +371,8 @@ void check_sse_all() {
 
     check("pcmpeqq", 2, select(i64_1 == i64_2, i64(1), i64(2)));
     check("packusdw", 8, u16(clamp(i32_1, 0, max_u16)));
+
+    check("pmaddubsw", 8, i16(u8_1) * 3 + i16(u8_2) * 5);
     }
 
     // SSE 4.2
@@ -453,7 +465,7 @@ void check_sse_all() {
 	check("vpminsw", 16, min(i16_1, i16_2));
 	check("vpmaxub", 32, max(u8_1, u8_2));
 	check("vpminub", 32, min(u8_1, u8_2));
-	check("vpmulhuw", 16, i16((i32(i16_1) * i32(i16_2))/(256*256)));
+	check("vpmulhuw", 16, u16((u32(u16_1) * u32(u16_2))/(256*256)));
 
 	check("vpaddq", 8, i64_1 + i64_2);
 	check("vpsubq", 8, i64_1 - i64_2);
@@ -486,6 +498,43 @@ void check_sse_all() {
 	check("vpcmpeqq", 4, select(i64_1 == i64_2, i64(1), i64(2)));
 	check("vpackusdw", 16, u16(clamp(i32_1, 0, max_u16)));
 	check("vpcmpgtq", 4, select(i64_1 > i64_2, i64(1), i64(2)));
+
+	check("vpmaddwd", 8, i32(i16_1) * i32(i16_2) + i32(i16_3) * i32(in_i16(x+48)));
+	check("vpmaddubsw", 16, i16(u8_1) * 3 + i16(u8_2) * 5);
+
+	check("vpgatherdd", 8, in_i32(u8_1));
+	check("vgatherdps", 8, in_f32(u8_1));
+    }
+
+    // FMA
+
+    if (use_fma) {
+	check("vfmadd", 8, fma(f32_1, f32_2, f32_3));
+	check("vfmadd", 4, fma(f64_1, f64_2, f64_3));
+    }
+
+    // AVX-512
+
+    if (use_avx512) {
+	check("vpabsq", 8, abs(i64_1));
+	check("vpminsq", 8, min(i64_1, i64_2));
+	check("vpmaxsq", 8, max(i64_1, i64_2));
+	check("vpminuq", 8, min(u64_1, u64_2));
+	check("vpmaxuq", 8, max(u64_1, u64_2));
+	check("vpsraq", 8, i64_1 >> 3);
+	check("vpmovqd", 8, i32(i64_1));
+	check("vpmovdb", 16, u8(u32_1));
+	check("vpmovsdb", 16, i8(clamp(i32_1, min_i8, max_i8)));
+	check("vpmovusdb", 16, u8(min(u32_1, max_u8)));
+	check("vrndscaleps", 16, floor(f32_1));
+	check("vrndscalepd", 8, ceil(f64_1));
+    }
+
+    if (use_avx512_skylake) {
+	check("vpmullq", 8, i64_1 * i64_2);
+	check("vpmovwb", 32, u8(u16_1));
+	check("vcvtqq2pd", 8, f64(i64_1));
+	check("vcvttpd2qq", 8, i64(f64_1));
     }
 }
 
@@ -1339,7 +1388,23 @@ void check_neon_all() {
 
     // VST3	X	-	Store three-element structures
     // VST4	X	-	Store four-element structures
-    // Not supported for now. We need a better syntax for interleaving to take advantage of these
+    // These come from storing to a packed rgb or rgba layout, with
+    // the loop over channels unrolled.
+    for (int channels = 3; channels <= 4; channels++) {
+        for (int sign = 0; sign <= 1; sign++) {
+            for (int bits = 8; bits < 64; bits *= 2) {
+                Func tmp1, tmp2;
+                Var c;
+                tmp1(x) = cast(sign ? Int(bits) : UInt(bits), x);
+                tmp1.compute_root();
+                tmp2(c, x) = tmp1(x + c*16);
+                tmp2.compute_root().bound(c, 0, channels).unroll(c).vectorize(x, 128/bits);
+                char *op = (char *)malloc(32);
+                snprintf(op, 32, "vst%d.%d", channels, bits);
+                check(op, 128/bits, tmp2(0, 0) + tmp2(0, 63));
+            }
+        }
+    }
 
     // VSTM	X	F, D	Store Multiple Registers
     // VSTR	X	F, D	Store Register
@@ -1420,7 +1485,10 @@ int main(int argc, char **argv) {
 
     target = get_target_from_environment();
 
-    use_avx2 = target.features & Target::AVX2;
+    use_avx512_skylake = target.features & Target::AVX512_Skylake;
+    use_avx512 = use_avx512_skylake | (target.features & Target::AVX512);
+    use_avx2 = use_avx512 | (target.features & Target::AVX2);
+    use_fma = use_avx512 | (target.features & Target::FMA);
     use_avx = use_avx2 | (target.features & Target::AVX);
     use_sse41 = use_avx | (target.features & Target::SSE41);
 
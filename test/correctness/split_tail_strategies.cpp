@@ -0,0 +1,93 @@
+#include <Halide.h>
+#include <stdio.h>
+
+using namespace Halide;
+
+bool test(TailStrategy tail, int width, int height) {
+    // Rounding up reads past the end of the region we need, so
+    // leave some room.
+    Image<int> input(width + 8, height);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width + 8; x++) {
+            input(x, y) = rand() & 0xff;
+        }
+    }
+
+    Var x, y, xo, xi, yo, yi;
+
+    // An intermediate stage, which may be padded when rounding up.
+    Func g;
+    g(x, y) = input(x, y) + input(x + 1, y);
+    g.compute_root().vectorize(x, 8, tail == TailStrategy_ShiftInward ?
+                               TailStrategy_ShiftInward : TailStrategy_RoundUp);
+
+    // The output can't be padded, so it shifts inward or guards.
+    Func f;
+    f(x, y) = g(x, y) * 2;
+    TailStrategy output_tail = (tail == TailStrategy_RoundUp) ? TailStrategy_GuardWithIf : tail;
+    f.tile(x, y, xo, yo, xi, yi, 8, 4, output_tail).vectorize(xi);
+
+    // An update that adds to every site of a pure variable once,
+    // which can't shift inward.
+    Func h, h_out;
+    h(x) = x;
+    h(x) += 3;
+    h.compute_root();
+    h.update().vectorize(x, 8, tail == TailStrategy_ShiftInward ?
+                         TailStrategy_GuardWithIf : tail);
+    h_out(x) = h(x);
+
+    // An update over a reduction domain.
+    Func sum;
+    RDom r(0, width);
+    Var rxo, rxi;
+    sum(y) = 0;
+    sum(y) += input(r, y);
+    sum.update().split(r, rxo, rxi, 8, TailStrategy_GuardWithIf);
+
+    Image<int> f_result = f.realize(width, height);
+    Image<int> h_result = h_out.realize(width);
+    Image<int> sum_result = sum.realize(height);
+
+    for (int y = 0; y < height; y++) {
+        int correct_sum = 0;
+        for (int x = 0; x < width; x++) {
+            int correct = (input(x, y) + input(x + 1, y)) * 2;
+            if (f_result(x, y) != correct) {
+                printf("f(%d, %d) = %d instead of %d\n", x, y, f_result(x, y), correct);
+                return false;
+            }
+            correct_sum += input(x, y);
+        }
+        if (sum_result(y) != correct_sum) {
+            printf("sum(%d) = %d instead of %d\n", y, sum_result(y), correct_sum);
+            return false;
+        }
+    }
+
+    for (int x = 0; x < width; x++) {
+        if (h_result(x) != x + 3) {
+            printf("h(%d) = %d instead of %d\n", x, h_result(x), x + 3);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char **argv) {
+    bool ok = true;
+
+    ok = ok && test(TailStrategy_ShiftInward, 13, 9);
+    ok = ok && test(TailStrategy_ShiftInward, 64, 8);
+    ok = ok && test(TailStrategy_GuardWithIf, 13, 9);
+    ok = ok && test(TailStrategy_GuardWithIf, 64, 8);
+    ok = ok && test(TailStrategy_GuardWithIf, 5, 3);
+    ok = ok && test(TailStrategy_RoundUp, 13, 9);
+    ok = ok && test(TailStrategy_RoundUp, 5, 3);
+
+    if (!ok) return -1;
+
+    printf("Success!\n");
+    return 0;
+}
@@ -37,6 +37,68 @@ int main(int argc, char **argv) {
         return -1;
     }
 
+    // A footprint that depends on a Param should still be folded,
+    // with the fold factor rounded up to a power of two at runtime.
+    {
+        Param<int> radius;
+        Func f, g;
+        f(x, y) = x + y;
+        g(x, y) = f(x, y - radius) + f(x, y + radius);
+        f.store_root().compute_at(g, y);
+
+        g.set_custom_allocator(my_malloc, my_free);
+        radius.set(3);
+        custom_malloc_size = 0;
+        Image<int> im = g.realize(1000, 1000);
+
+        // Seven rows in use at once, rounded up to eight.
+        if (custom_malloc_size == 0 || custom_malloc_size > 1000*8*sizeof(int)) {
+            printf("Scratch space allocated was %d instead of %d\n",
+                   (int)custom_malloc_size, (int)(1000*8*sizeof(int)));
+            return -1;
+        }
+
+        for (int y = 0; y < 1000; y++) {
+            for (int x = 0; x < 1000; x++) {
+                int correct = 2 * (x + y);
+                if (im(x, y) != correct) {
+                    printf("im(%d, %d) = %d instead of %d\n", x, y, im(x, y), correct);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    // An explicit fold by a factor that isn't a power of two.
+    {
+        Param<int> radius;
+        Func f, g;
+        f(x, y) = x * y;
+        g(x, y) = f(x, y - radius) + f(x, y) + f(x, y + radius);
+        f.store_root().compute_at(g, y).fold_storage(y, 2*radius + 1);
+
+        g.set_custom_allocator(my_malloc, my_free);
+        radius.set(2);
+        custom_malloc_size = 0;
+        Image<int> im = g.realize(1000, 1000);
+
+        if (custom_malloc_size == 0 || custom_malloc_size > 1000*5*sizeof(int)) {
+            printf("Scratch space allocated was %d instead of %d\n",
+                   (int)custom_malloc_size, (int)(1000*5*sizeof(int)));
+            return -1;
+        }
+
+        for (int y = 0; y < 1000; y++) {
+            for (int x = 0; x < 1000; x++) {
+                int correct = 3 * x * y;
+                if (im(x, y) != correct) {
+                    printf("im(%d, %d) = %d instead of %d\n", x, y, im(x, y), correct);
+                    return -1;
+                }
+            }
+        }
+    }
+
     printf("Success!\n");
     return 0;
 }
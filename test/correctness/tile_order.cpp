@@ -0,0 +1,124 @@
+#include <stdio.h>
+#include <Halide.h>
+
+using namespace Halide;
+using namespace Halide::Internal;
+
+#ifdef _MSC_VER
+#define DLLEXPORT __declspec(dllexport)
+#else
+#define DLLEXPORT
+#endif
+
+// Record the order in which pixels are visited.
+int visited = 0;
+int order_x[64], order_y[64];
+extern "C" DLLEXPORT int record_visit(int x, int y) {
+    if (visited < 64) {
+        order_x[visited] = x;
+        order_y[visited] = y;
+    }
+    visited++;
+    return x + y * 1000;
+}
+HalideExtern_2(int, record_visit, int, int);
+
+// Checks that the body of the fused loop is guarded as a whole, so
+// that points of the curve off the tile grid skip everything.
+class GuardedLoop : public IRVisitor {
+    using IRVisitor::visit;
+
+    void visit(const For *op) {
+        if (ends_with(op->name, suffix)) {
+            Stmt body = op->body;
+            while (const LetStmt *let = body.as<LetStmt>()) {
+                body = let->body;
+            }
+            found = true;
+            guarded = body.as<IfThenElse>() != NULL;
+        }
+        IRVisitor::visit(op);
+    }
+public:
+    std::string suffix;
+    bool found, guarded;
+    GuardedLoop(const std::string &s) : suffix(s), found(false), guarded(false) {}
+};
+
+int main(int argc, char **argv) {
+    // The first few pixels visited by each order, when every tile is
+    // a single pixel.
+    const int morton[][2] = {{0, 0}, {1, 0}, {0, 1}, {1, 1}, {2, 0}, {3, 0}, {2, 1}, {3, 1}};
+    const int hilbert[][2] = {{0, 0}, {1, 0}, {1, 1}, {0, 1}, {0, 2}, {0, 3}, {1, 3}, {1, 2}};
+
+    for (int o = 0; o < 2; o++) {
+        TileOrder order = o == 0 ? TileOrder_Morton : TileOrder_Hilbert;
+        const int (*expected)[2] = o == 0 ? morton : hilbert;
+
+        Var x, y, t;
+        Func f;
+        f(x, y) = record_visit(x, y);
+        f.fuse(x, y, t, order);
+
+        visited = 0;
+        f.realize(4, 4);
+        if (visited != 16) {
+            printf("Visited %d pixels instead of 16\n", visited);
+            return -1;
+        }
+        for (int i = 0; i < 8; i++) {
+            if (order_x[i] != expected[i][0] || order_y[i] != expected[i][1]) {
+                printf("Visit %d was to (%d, %d) instead of (%d, %d)\n",
+                       i, order_x[i], order_y[i], expected[i][0], expected[i][1]);
+                return -1;
+            }
+        }
+    }
+
+    // Tiles that don't divide the image, over a tile grid that isn't
+    // square or a power of two, serial and parallel. Every pixel
+    // should be computed exactly once.
+    for (int o = 0; o < 2; o++) {
+        for (int parallel = 0; parallel < 2; parallel++) {
+            TileOrder order = o == 0 ? TileOrder_Morton : TileOrder_Hilbert;
+            Var x, y, xo, yo, xi, yi, t;
+            Func f, g;
+            f(x, y) = record_visit(x, y);
+            g(x, y) = f(x, y) + f(x, y);
+            g.tile(x, y, xo, yo, xi, yi, 8, 8).fuse(xo, yo, t, order);
+            if (parallel) {
+                g.parallel(t);
+            } else {
+                f.compute_at(g, t);
+            }
+
+            GuardedLoop check("." + t.name());
+            lower(g.function(), get_jit_target_from_environment()).accept(&check);
+            if (!check.found || !check.guarded) {
+                printf("The loop over %s isn't guarded as a whole\n", t.name().c_str());
+                return -1;
+            }
+
+            visited = 0;
+            Image<int> im = g.realize(100, 70);
+
+            if (visited != 100*70) {
+                printf("Visited %d pixels instead of %d\n", visited, 100*70);
+                return -1;
+            }
+
+            for (int y = 0; y < 70; y++) {
+                for (int x = 0; x < 100; x++) {
+                    int correct = 2 * (x + y * 1000);
+                    if (im(x, y) != correct) {
+                        printf("im(%d, %d) = %d instead of %d\n", x, y, im(x, y), correct);
+                        return -1;
+                    }
+                }
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,150 @@
+#include <Halide.h>
+#include <stdio.h>
+#include <algorithm>
+
+using namespace Halide;
+
+template<typename T>
+bool test(int vec_width, int extent) {
+    const int H = 5;
+
+    Image<T> input(extent, H);
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < extent; x++) {
+            input(x, y) = (T)(rand() % 16);
+        }
+    }
+
+    Var y;
+    Var rxo, rxi;
+    RDom r(0, extent);
+    Func sum, diff, prod, minimum, maximum, decay;
+
+    sum(y) = cast<T>(0);
+    sum(y) += input(r, y);
+    // The floating point inputs are small integers, so
+    // reassociating doesn't change the results.
+    sum.update().split(r, rxo, rxi, vec_width).vectorize(rxi).reassociate_floats();
+
+    diff(y) = cast<T>(100);
+    diff(y) -= input(r, y);
+    diff.update().vectorize(r, vec_width).reassociate_floats();
+
+    // Keep the products small and exactly representable
+    prod(y) = cast<T>(1);
+    prod(y) *= select(input(r, y) > 12, cast<T>(2), cast<T>(1));
+    prod.update().vectorize(r, vec_width).reassociate_floats();
+
+    minimum(y) = input(0, y);
+    minimum(y) = min(minimum(y), input(r, y));
+    minimum.update().vectorize(r, vec_width);
+
+    maximum(y) = input(0, y);
+    maximum(y) = max(maximum(y), input(r, y));
+    maximum.update().vectorize(r, vec_width);
+
+    // Not associative, so the lanes must be applied in order.
+    decay(y) = cast<T>(0);
+    decay(y) = decay(y) / 2 + input(r, y);
+    decay.update().vectorize(r, vec_width);
+
+    Image<T> sum_result = sum.realize(H);
+    Image<T> diff_result = diff.realize(H);
+    Image<T> prod_result = prod.realize(H);
+    Image<T> min_result = minimum.realize(H);
+    Image<T> max_result = maximum.realize(H);
+    Image<T> decay_result = decay.realize(H);
+
+    for (int y = 0; y < H; y++) {
+        T sum_correct = 0, diff_correct = 100, prod_correct = 1;
+        T min_correct = input(0, y), max_correct = input(0, y);
+        T decay_correct = 0;
+        for (int x = 0; x < extent; x++) {
+            T in = input(x, y);
+            sum_correct += in;
+            diff_correct -= in;
+            prod_correct *= (in > 12) ? 2 : 1;
+            min_correct = std::min(min_correct, in);
+            max_correct = std::max(max_correct, in);
+            decay_correct = decay_correct / 2 + in;
+        }
+
+        if (sum_result(y) != sum_correct) {
+            printf("sum(%d) = %f instead of %f\n", y, (double)sum_result(y), (double)sum_correct);
+            return false;
+        }
+        if (diff_result(y) != diff_correct) {
+            printf("diff(%d) = %f instead of %f\n", y, (double)diff_result(y), (double)diff_correct);
+            return false;
+        }
+        if (prod_result(y) != prod_correct) {
+            printf("prod(%d) = %f instead of %f\n", y, (double)prod_result(y), (double)prod_correct);
+            return false;
+        }
+        if (min_result(y) != min_correct) {
+            printf("min(%d) = %f instead of %f\n", y, (double)min_result(y), (double)min_correct);
+            return false;
+        }
+        if (max_result(y) != max_correct) {
+            printf("max(%d) = %f instead of %f\n", y, (double)max_result(y), (double)max_correct);
+            return false;
+        }
+        if (decay_result(y) != decay_correct) {
+            printf("decay(%d) = %f instead of %f\n", y, (double)decay_result(y), (double)decay_correct);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Without reassociate_floats, a vectorized float sum must be done in
+// order, so it rounds the same way as a serial one.
+bool test_float_order() {
+    const int N = 64;
+    Image<float> input(N);
+    input(0) = 1e8f;
+    for (int x = 1; x < N - 1; x++) {
+        input(x) = 1.0f;
+    }
+    input(N - 1) = -1e8f;
+
+    RDom r(0, N);
+    Func sum;
+    sum() = 0.0f;
+    sum() += input(r);
+    sum.update().vectorize(r, 8);
+    Image<float> result = sum.realize();
+
+    float correct = 0.0f;
+    for (int x = 0; x < N; x++) {
+        correct += input(x);
+    }
+    if (result(0) != correct) {
+        printf("Vectorized float sum is %f instead of %f\n", result(0), correct);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    bool ok = test_float_order();
+
+    // Extents that are a multiple of the vector width, and ones that
+    // aren't, which need a guard on the update.
+    ok = ok && test<uint8_t>(16, 256);
+    ok = ok && test<uint8_t>(32, 100);
+    ok = ok && test<int8_t>(16, 64);
+    ok = ok && test<uint16_t>(8, 128);
+    ok = ok && test<int16_t>(16, 37);
+    ok = ok && test<uint32_t>(4, 64);
+    ok = ok && test<int32_t>(8, 61);
+    ok = ok && test<float>(4, 128);
+    ok = ok && test<float>(8, 19);
+    ok = ok && test<double>(2, 64);
+
+    if (!ok) return -1;
+
+    printf("Success!\n");
+    return 0;
+}
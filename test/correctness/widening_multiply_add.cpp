@@ -0,0 +1,121 @@
+#include <Halide.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace Halide;
+
+// Sums of pairs of widening multiplies, and reductions of absolute
+// differences and products, which map to pmaddwd, pmaddubsw and
+// psadbw on x86.
+int main(int argc, char **argv) {
+    const int W = 256, H = 8;
+
+    Image<int16_t> a(2*W + 64, H), b(2*W + 64, H);
+    Image<uint8_t> p(W + 64, H), q(W + 64, H);
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < a.width(); x++) {
+            a(x, y) = (int16_t)(rand() - RAND_MAX/2);
+            b(x, y) = (int16_t)(rand() - RAND_MAX/2);
+        }
+        for (int x = 0; x < p.width(); x++) {
+            p(x, y) = (uint8_t)rand();
+            q(x, y) = (uint8_t)rand();
+        }
+    }
+    // Include the corner cases where pmaddwd and pmaddubsw overflow
+    // or saturate.
+    a(0, 0) = a(1, 0) = b(0, 0) = b(1, 0) = -32768;
+    p(0, 0) = p(1, 0) = 255;
+
+    Var x, y;
+
+    {
+        // Lanes that need pairing up, and lanes that are already
+        // adjacent in memory.
+        Func interleaved, paired;
+        interleaved(x, y) = (cast<int>(a(x, y)) * cast<int>(b(x, y)) +
+                             cast<int>(a(x + 32, y)) * cast<int>(b(x + 32, y)));
+        paired(x, y) = (cast<int>(a(2*x, y)) * cast<int>(b(2*x, y)) +
+                        cast<int>(a(2*x + 1, y)) * cast<int>(b(2*x + 1, y)));
+        interleaved.vectorize(x, 16);
+        paired.vectorize(x, 8);
+
+        Image<int> out_interleaved = interleaved.realize(W, H);
+        Image<int> out_paired = paired.realize(W, H);
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                int correct = (int)((uint32_t)(a(x, y) * b(x, y)) +
+                                    (uint32_t)(a(x + 32, y) * b(x + 32, y)));
+                if (out_interleaved(x, y) != correct) {
+                    printf("interleaved(%d, %d) = %d instead of %d\n",
+                           x, y, out_interleaved(x, y), correct);
+                    return -1;
+                }
+                correct = (int)((uint32_t)(a(2*x, y) * b(2*x, y)) +
+                                (uint32_t)(a(2*x + 1, y) * b(2*x + 1, y)));
+                if (out_paired(x, y) != correct) {
+                    printf("paired(%d, %d) = %d instead of %d\n",
+                           x, y, out_paired(x, y), correct);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    {
+        // Bytes times small constants, which can't saturate, and
+        // bytes times larger constants, which could.
+        for (int k = 28; k <= 29; k++) {
+            Func f;
+            f(x, y) = cast<int16_t>(p(x, y)) * 100 + cast<int16_t>(p(x + 1, y)) * k;
+            f.vectorize(x, 16);
+            Image<int16_t> out = f.realize(W, H);
+            for (int y = 0; y < H; y++) {
+                for (int x = 0; x < W; x++) {
+                    int16_t correct = (int16_t)(p(x, y) * 100 + p(x + 1, y) * k);
+                    if (out(x, y) != correct) {
+                        printf("f(%d, %d) = %d instead of %d\n", x, y, out(x, y), correct);
+                        return -1;
+                    }
+                }
+            }
+        }
+    }
+
+    {
+        // Sums of absolute differences and dot products, vectorized
+        // across the reduction domain.
+        RDom r(0, 64);
+        Func sad, dot;
+        sad(x, y) = cast<uint16_t>(0);
+        sad(x, y) += cast<uint16_t>(abs(cast<int16_t>(p(x + r, y)) - cast<int16_t>(q(x + r, y))));
+        dot(x, y) = 0;
+        dot(x, y) += cast<int>(a(x + r, y)) * cast<int>(b(x + r, y));
+        sad.update().vectorize(r, 32);
+        dot.update().vectorize(r, 16);
+
+        Image<uint16_t> out_sad = sad.realize(W, H);
+        Image<int> out_dot = dot.realize(W, H);
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                uint16_t sad_correct = 0;
+                uint32_t dot_correct = 0;
+                for (int i = 0; i < 64; i++) {
+                    sad_correct += (uint16_t)abs(p(x + i, y) - q(x + i, y));
+                    dot_correct += (uint32_t)(a(x + i, y) * b(x + i, y));
+                }
+                if (out_sad(x, y) != sad_correct) {
+                    printf("sad(%d, %d) = %d instead of %d\n", x, y, out_sad(x, y), sad_correct);
+                    return -1;
+                }
+                if (out_dot(x, y) != (int)dot_correct) {
+                    printf("dot(%d, %d) = %d instead of %d\n", x, y, out_dot(x, y), (int)dot_correct);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,21 @@
+#include <Halide.h>
+#include <stdio.h>
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    Func f, g;
+    Var x, y;
+
+    f(x, y) = x + y;
+    g(x, y) = f(x, y - 2) + f(x, y + 2);
+
+    // Five rows of f are in use at once, so this should fail when the
+    // pipeline runs.
+    f.store_root().compute_at(g, y).fold_storage(y, 4);
+
+    g.realize(100, 100);
+
+    printf("Success!\n");
+    return 0;
+}
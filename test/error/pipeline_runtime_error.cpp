@@ -0,0 +1,26 @@
+#include <Halide.h>
+#include <stdio.h>
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    Func f, g;
+    Var x;
+    f(x) = Tuple(x, sin(x));
+    g(x) = x * 2;
+
+    // The buffers of a Tuple output should be the same size, so this
+    // should fail when the pipeline runs, and the runtime error
+    // should be reported like one from Func::realize.
+    Image<int> x_out(100);
+    Image<float> sin_x_out(101);
+    Image<int> g_out(100);
+
+    std::vector<Func> outputs;
+    outputs.push_back(f);
+    outputs.push_back(g);
+    Pipeline(outputs).realize(Realization(x_out, sin_x_out, g_out));
+
+    printf("Success!\n");
+    return 0;
+}
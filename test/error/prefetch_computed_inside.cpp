@@ -0,0 +1,22 @@
+#include <Halide.h>
+#include <stdio.h>
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    Func f, g;
+    Var x, y;
+
+    f(x, y) = x + y;
+    g(x, y) = f(x, y) + f(x, y + 1);
+    f.compute_at(g, y);
+
+    // f is computed within the loop over y, so the later iterations
+    // of it don't exist yet.
+    g.prefetch(f, y, 2);
+
+    g.realize(16, 16);
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,22 @@
+#include <Halide.h>
+#include <stdio.h>
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    Func f;
+    Var x, rxo, rxi;
+    RDom r(0, 13);
+
+    f(x) = 0;
+    f(r) += 1;
+
+    // Rounding up the reduction domain would update sites outside
+    // of it.
+    f.update().split(r, rxo, rxi, 8, TailStrategy_RoundUp);
+
+    f.realize(13);
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,21 @@
+#include <Halide.h>
+#include <stdio.h>
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    Func f;
+    Var x;
+    RDom r(1, 63);
+
+    f(x) = x;
+    // Each iteration reads the site written by the previous one, so
+    // the lanes of a vector would depend on each other.
+    f(r) = f(r - 1) * 2;
+    f.update().vectorize(r, 8);
+
+    f.realize(64);
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include <Halide.h>
+#include <stdio.h>
+#include "clock.h"
+
+using namespace Halide;
+
+// An 8-bit pipeline made of saturating adds, averages, high
+// multiplies and packs.
+Func make_pipeline(ImageParam a, ImageParam b) {
+    Var x, y;
+    Func sum, avg, scaled, out;
+    sum(x, y) = cast<uint8_t>(min(cast<uint16_t>(a(x, y)) + cast<uint16_t>(b(x, y)), 255));
+    avg(x, y) = cast<uint8_t>((cast<uint16_t>(sum(x, y)) + cast<uint16_t>(a(x, y)) + 1) / 2);
+    scaled(x, y) = cast<int16_t>((cast<int32_t>(cast<int16_t>(avg(x, y))) * 23456) / 65536);
+    out(x, y) = cast<uint8_t>(clamp(scaled(x, y) * 4 - cast<int16_t>(b(x, y)), 0, 255));
+    out.vectorize(x, 32);
+    return out;
+}
+
+double time_realize(Func f, Image<uint8_t> out, const Target &t) {
+    f.realize(out, t);
+    double best = 0;
+    for (int i = 0; i < 5; i++) {
+        double t1 = current_time();
+        for (int j = 0; j < 10; j++) {
+            f.realize(out, t);
+        }
+        double t2 = current_time();
+        if (i == 0 || t2 - t1 < best) best = t2 - t1;
+    }
+    return best / 10;
+}
+
+int main(int argc, char **argv) {
+    Target avx2 = get_jit_target_from_environment();
+    if (avx2.arch != Target::X86 || !(avx2.features & Target::AVX2)) {
+        printf("No AVX2 on this target. Skipping test.\n");
+        return 0;
+    }
+    Target sse = avx2;
+    sse.features &= ~(Target::AVX | Target::AVX2);
+
+    const int W = 4096, H = 1024;
+    Image<uint8_t> in_a(W, H), in_b(W, H);
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            in_a(x, y) = (uint8_t)rand();
+            in_b(x, y) = (uint8_t)rand();
+        }
+    }
+    ImageParam a(UInt(8), 2), b(UInt(8), 2);
+    a.set(in_a);
+    b.set(in_b);
+
+    Image<uint8_t> out_sse(W, H), out_avx2(W, H);
+    double t_sse = time_realize(make_pipeline(a, b), out_sse, sse);
+    double t_avx2 = time_realize(make_pipeline(a, b), out_avx2, avx2);
+
+    double megapixels = (double)W * H / 1e6;
+    printf("sse: %1.3gms (%1.4g megapixels/s)\n", t_sse, megapixels * 1000 / t_sse);
+    printf("avx2: %1.3gms (%1.4g megapixels/s)\n", t_avx2, megapixels * 1000 / t_avx2);
+
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            if (out_sse(x, y) != out_avx2(x, y)) {
+                printf("out(%d, %d) = %d with sse, but %d with avx2\n",
+                       x, y, out_sse(x, y), out_avx2(x, y));
+                return -1;
+            }
+        }
+    }
+
+    if (t_avx2 > t_sse) {
+        printf("The 256-bit integer ops were slower than the 128-bit ones\n");
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include <Halide.h>
+#include <stdio.h>
+#include "clock.h"
+
+using namespace Halide;
+
+// A float blur followed by some arithmetic, vectorized at the natural
+// width of the target, with a row width that leaves a tail.
+Func make_pipeline(ImageParam in, const Target &t) {
+    Var x, y;
+    Func blur_x, out;
+    blur_x(x, y) = (in(x, y) + 2.0f * in(x + 1, y) + in(x + 2, y)) * 0.25f;
+    out(x, y) = sqrt(blur_x(x, y) * blur_x(x, y + 1) + 1.0f) - blur_x(x, y + 2) * 0.5f;
+    int vec = t.natural_vector_size<float>();
+    blur_x.compute_at(out, y).vectorize(x, vec, TailStrategy_GuardWithIf);
+    out.vectorize(x, vec, TailStrategy_GuardWithIf);
+    return out;
+}
+
+double time_realize(Func f, Image<float> out, const Target &t) {
+    f.realize(out, t);
+    double best = 0;
+    for (int i = 0; i < 5; i++) {
+        double t1 = current_time();
+        for (int j = 0; j < 10; j++) {
+            f.realize(out, t);
+        }
+        double t2 = current_time();
+        if (i == 0 || t2 - t1 < best) best = t2 - t1;
+    }
+    return best / 10;
+}
+
+int main(int argc, char **argv) {
+    Target avx512 = get_jit_target_from_environment();
+    if (avx512.arch != Target::X86 || !(avx512.features & Target::AVX512)) {
+        printf("No AVX-512 on this target. Skipping test.\n");
+        return 0;
+    }
+    Target avx2 = avx512;
+    avx2.features &= ~(Target::AVX512 | Target::AVX512_Skylake);
+
+    const int W = 2047, H = 1024;
+    Image<float> input(W + 2, H + 2);
+    for (int y = 0; y < H + 2; y++) {
+        for (int x = 0; x < W + 2; x++) {
+            input(x, y) = (float)(rand() & 0xfff) / 0xfff;
+        }
+    }
+    ImageParam in(Float(32), 2);
+    in.set(input);
+
+    Image<float> out_avx2(W, H), out_avx512(W, H);
+    double t_avx2 = time_realize(make_pipeline(in, avx2), out_avx2, avx2);
+    double t_avx512 = time_realize(make_pipeline(in, avx512), out_avx512, avx512);
+
+    double megapixels = (double)W * H / 1e6;
+    printf("avx2: %1.3gms (%1.4g megapixels/s)\n", t_avx2, megapixels * 1000 / t_avx2);
+    printf("avx512: %1.3gms (%1.4g megapixels/s)\n", t_avx512, megapixels * 1000 / t_avx512);
+    printf("speed-up over avx2: %1.3gx\n", t_avx2 / t_avx512);
+
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            float a = out_avx2(x, y), b = out_avx512(x, y);
+            if (a - b > 0.0001f || b - a > 0.0001f) {
+                printf("out(%d, %d) = %f with avx2, but %f with avx512\n", x, y, a, b);
+                return -1;
+            }
+        }
+    }
+
+    if (t_avx512 > t_avx2) {
+        printf("The 512-bit vectors were slower than the 256-bit ones\n");
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
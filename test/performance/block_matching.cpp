@@ -0,0 +1,85 @@
+#include <Halide.h>
+#include <stdio.h>
+#include "clock.h"
+
+using namespace Halide;
+
+// The cost of matching a 16x8 block of the left image against the
+// right image at each disparity, for stereo block matching.
+Func block_cost(ImageParam left, ImageParam right, bool vectorize_window) {
+    Var x, y, d;
+    RDom r(0, 16, 0, 8);
+    Func cost;
+    cost(x, y, d) = cast<uint16_t>(0);
+    cost(x, y, d) += cast<uint16_t>(abs(cast<int16_t>(left(x + r.x, y + r.y)) -
+                                        cast<int16_t>(right(x + r.x + d, y + r.y))));
+    cost.parallel(y);
+    cost.update().parallel(y);
+    if (vectorize_window) {
+        // Each block's sum of absolute differences is one psadbw.
+        cost.update().vectorize(r.x);
+    } else {
+        // One block per lane.
+        cost.vectorize(x, 16);
+        cost.update().vectorize(x, 16);
+    }
+    return cost;
+}
+
+double time_realize(Func f, Image<uint16_t> out) {
+    f.realize(out);
+    double best = 0;
+    for (int i = 0; i < 5; i++) {
+        double t1 = current_time();
+        f.realize(out);
+        double t2 = current_time();
+        if (i == 0 || t2 - t1 < best) best = t2 - t1;
+    }
+    return best;
+}
+
+int main(int argc, char **argv) {
+    const int W = 640, H = 480, D = 32;
+
+    Image<uint8_t> left_im(W + 16, H + 8), right_im(W + D + 16, H + 8);
+    for (int y = 0; y < right_im.height(); y++) {
+        for (int x = 0; x < right_im.width(); x++) {
+            right_im(x, y) = (uint8_t)rand();
+            if (x < left_im.width()) {
+                left_im(x, y) = (uint8_t)rand();
+            }
+        }
+    }
+    ImageParam left(UInt(8), 2), right(UInt(8), 2);
+    left.set(left_im);
+    right.set(right_im);
+
+    Image<uint16_t> out_lanes(W, H, D), out_window(W, H, D);
+    double t_lanes = time_realize(block_cost(left, right, false), out_lanes);
+    double t_window = time_realize(block_cost(left, right, true), out_window);
+
+    // Millions of block comparisons per second
+    double matches = (double)W * H * D / 1e6;
+    printf("one block per lane: %1.3gms (%1.4g million matches/s)\n", t_lanes, matches * 1000 / t_lanes);
+    printf("one block per psadbw: %1.3gms (%1.4g million matches/s)\n", t_window, matches * 1000 / t_window);
+
+    for (int d = 0; d < D; d++) {
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                if (out_lanes(x, y, d) != out_window(x, y, d)) {
+                    printf("cost(%d, %d, %d) = %d vs %d\n", x, y, d,
+                           out_lanes(x, y, d), out_window(x, y, d));
+                    return -1;
+                }
+            }
+        }
+    }
+
+    if (t_window > t_lanes) {
+        printf("Summing each block with psadbw was slower than one block per lane\n");
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
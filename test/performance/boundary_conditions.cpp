@@ -0,0 +1,89 @@
+#include <Halide.h>
+#include <stdio.h>
+#include "clock.h"
+
+using namespace Halide;
+
+const int W = 4096, H = 4096;
+
+// The separable 3x3 blur from apps/blur, with its schedule, reading
+// from the given source.
+Func blur(Func source) {
+    Var x = source.args()[0], y = source.args()[1];
+    Var yi;
+    Func blur_x, blur_y;
+    blur_x(x, y) = (source(x-1, y) + source(x, y) + source(x+1, y)) / 3;
+    blur_y(x, y) = (blur_x(x, y-1) + blur_x(x, y) + blur_x(x, y+1)) / 3;
+
+    blur_y.split(y, y, yi, 8).parallel(y).vectorize(x, 8);
+    blur_x.store_at(blur_y, y).compute_at(blur_y, yi).vectorize(x, 8);
+    return blur_y;
+}
+
+// Time the realization of a function, and return the best of a few runs.
+double time_realize(Func f, Image<uint16_t> out) {
+    double best = 0;
+    for (int i = 0; i < 5; i++) {
+        double t1 = current_time();
+        f.realize(out);
+        double t2 = current_time();
+        if (i == 0 || t2 - t1 < best) best = t2 - t1;
+    }
+    return best;
+}
+
+int main(int argc, char **argv) {
+    // A padded input, so that the unbounded blur can read past the
+    // edges of the output.
+    Image<uint16_t> padded(W + 2, H + 2);
+    for (int y = 0; y < H + 2; y++) {
+        for (int x = 0; x < W + 2; x++) {
+            padded(x, y) = (uint16_t)(rand() & 0xfff);
+        }
+    }
+    padded.set_min(-1, -1);
+
+    ImageParam in(UInt(16), 2);
+    in.set(padded);
+
+    Image<uint16_t> out(W, H);
+
+    Var x, y;
+    Func unbounded;
+    unbounded(x, y) = in(x, y);
+    double t_unbounded = time_realize(blur(unbounded), out);
+    printf("No boundary condition: %1.3gms\n", t_unbounded);
+
+    // The boundary conditions are imposed on the interior of the
+    // padded image, so every one of them reaches outside of its
+    // bounds along the edges of the output.
+    std::vector<std::pair<Expr, Expr> > bounds;
+    bounds.push_back(std::make_pair(0, W));
+    bounds.push_back(std::make_pair(0, H));
+
+    struct {
+        const char *name;
+        Func f;
+    } conditions[] = {
+        {"repeat_edge", BoundaryConditions::repeat_edge(unbounded, bounds)},
+        {"repeat_image", BoundaryConditions::repeat_image(unbounded, bounds)},
+        {"mirror_image", BoundaryConditions::mirror_image(unbounded, bounds)},
+        {"mirror_interior", BoundaryConditions::mirror_interior(unbounded, bounds)},
+        {"constant_exterior", BoundaryConditions::constant_exterior(unbounded, 0, bounds)}
+    };
+
+    for (size_t i = 0; i < sizeof(conditions) / sizeof(conditions[0]); i++) {
+        double t = time_realize(blur(conditions[i].f), out);
+        printf("%s: %1.3gms (%1.3fx the unbounded blur)\n",
+               conditions[i].name, t, t / t_unbounded);
+        // The interior loops should be the same as the unbounded
+        // blur's, so only the edges should cost anything extra.
+        if (t > 1.5 * t_unbounded) {
+            printf("%s was too slow\n", conditions[i].name);
+            return -1;
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,160 @@
+#include <Halide.h>
+#include <stdio.h>
+#include "clock.h"
+
+using namespace Halide;
+
+// Catmull-Rom weights, in Horner form.
+Expr w(Expr t, int i) {
+    switch (i) {
+    case 0: return ((-0.5f * t + 1.0f) * t - 0.5f) * t;
+    case 1: return (1.5f * t - 2.5f) * t * t + 1.0f;
+    case 2: return ((-1.5f * t + 2.0f) * t + 0.5f) * t;
+    default: return (0.5f * t - 0.5f) * t * t;
+    }
+}
+
+// The float interpolation at the heart of apps/resize: a bicubic
+// upsample by a non-integer factor, with the horizontal pass computed
+// per row of the output.
+Func make_resize(ImageParam in, float scale) {
+    Var x, y;
+    Func clamped, resize_x, resize_y;
+    clamped(x, y) = in(clamp(x, 0, in.width() - 1), clamp(y, 0, in.height() - 1));
+
+    Expr sx = (x + 0.5f) / scale - 0.5f, sy = (y + 0.5f) / scale - 0.5f;
+    Expr ix = cast<int>(floor(sx)), iy = cast<int>(floor(sy));
+    Expr fx = sx - floor(sx), fy = sy - floor(sy);
+
+    resize_x(x, y) = (w(fx, 0) * clamped(ix - 1, y) + w(fx, 1) * clamped(ix, y) +
+                      w(fx, 2) * clamped(ix + 1, y) + w(fx, 3) * clamped(ix + 2, y));
+    resize_y(x, y) = (w(fy, 0) * resize_x(x, iy - 1) + w(fy, 1) * resize_x(x, iy) +
+                      w(fy, 2) * resize_x(x, iy + 1) + w(fy, 3) * resize_x(x, iy + 2));
+
+    resize_x.compute_root().vectorize(x, 8);
+    resize_y.vectorize(x, 8);
+    return resize_y;
+}
+
+// The trilinear slicing of the grid in apps/bilateral_grid, which is
+// made of lerps.
+Func make_bilateral_grid(ImageParam in) {
+    const int s_sigma = 8;
+    const float r_sigma = 0.1f;
+    Var x, y, z, c;
+    RDom r(0, s_sigma, 0, s_sigma);
+
+    Func clamped;
+    clamped(x, y) = in(clamp(x, 0, in.width() - 1), clamp(y, 0, in.height() - 1));
+
+    Func histogram;
+    Expr val = clamp(clamped(x * s_sigma + r.x - s_sigma / 2, y * s_sigma + r.y - s_sigma / 2), 0.0f, 1.0f);
+    Expr zi = cast<int>(val * (1.0f / r_sigma) + 0.5f);
+    histogram(x, y, z, c) = 0.0f;
+    histogram(x, y, zi, c) += select(c == 0, val, 1.0f);
+
+    Func blurz, blurx, blury;
+    blurz(x, y, z, c) = (histogram(x, y, z - 2, c) + histogram(x, y, z - 1, c) * 4 +
+                         histogram(x, y, z, c) * 6 + histogram(x, y, z + 1, c) * 4 +
+                         histogram(x, y, z + 2, c));
+    blurx(x, y, z, c) = (blurz(x - 2, y, z, c) + blurz(x - 1, y, z, c) * 4 +
+                         blurz(x, y, z, c) * 6 + blurz(x + 1, y, z, c) * 4 +
+                         blurz(x + 2, y, z, c));
+    blury(x, y, z, c) = (blurx(x, y - 2, z, c) + blurx(x, y - 1, z, c) * 4 +
+                         blurx(x, y, z, c) * 6 + blurx(x, y + 1, z, c) * 4 +
+                         blurx(x, y + 2, z, c));
+
+    val = clamp(clamped(x, y), 0.0f, 1.0f);
+    Expr zv = val * (1.0f / r_sigma);
+    zi = cast<int>(zv);
+    Expr zf = zv - zi;
+    Expr xf = cast<float>(x % s_sigma) / s_sigma;
+    Expr yf = cast<float>(y % s_sigma) / s_sigma;
+    Expr xi = x / s_sigma, yi = y / s_sigma;
+    Func interpolated;
+    interpolated(x, y, c) =
+        lerp(lerp(lerp(blury(xi, yi, zi, c), blury(xi + 1, yi, zi, c), xf),
+                  lerp(blury(xi, yi + 1, zi, c), blury(xi + 1, yi + 1, zi, c), xf), yf),
+             lerp(lerp(blury(xi, yi, zi + 1, c), blury(xi + 1, yi, zi + 1, c), xf),
+                  lerp(blury(xi, yi + 1, zi + 1, c), blury(xi + 1, yi + 1, zi + 1, c), xf), yf), zf);
+
+    Func out;
+    out(x, y) = interpolated(x, y, 0) / interpolated(x, y, 1);
+
+    histogram.compute_root().parallel(z);
+    histogram.update().reorder(c, r.x, r.y, x, y).unroll(c);
+    blurz.compute_root().vectorize(x, 8);
+    blurx.compute_root().vectorize(x, 8);
+    blury.compute_root().vectorize(x, 8);
+    out.vectorize(x, 8);
+    return out;
+}
+
+double time_realize(Func f, Image<float> out, const Target &t) {
+    f.realize(out, t);
+    double best = 0;
+    for (int i = 0; i < 5; i++) {
+        double t1 = current_time();
+        for (int j = 0; j < 5; j++) {
+            f.realize(out, t);
+        }
+        double t2 = current_time();
+        if (i == 0 || t2 - t1 < best) best = t2 - t1;
+    }
+    return best / 5;
+}
+
+int main(int argc, char **argv) {
+    Target plain = get_jit_target_from_environment();
+    if (plain.arch != Target::X86 || !(plain.features & Target::FMA)) {
+        printf("No fused multiply-add on this target. Skipping test.\n");
+        return 0;
+    }
+    plain.features &= ~Target::FMAContract;
+    Target contract = plain;
+    contract.features |= Target::FMAContract;
+
+    const int W = 1536, H = 1024;
+    Image<float> input(W, H);
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            input(x, y) = (float)(rand() & 0xfff) / 0xfff;
+        }
+    }
+    ImageParam in(Float(32), 2);
+    in.set(input);
+
+    const char *names[] = {"resize", "bilateral grid"};
+    bool slower = false;
+    for (int p = 0; p < 2; p++) {
+        int out_w = p == 0 ? W * 3 / 2 : W, out_h = p == 0 ? H * 3 / 2 : H;
+        Image<float> out_plain(out_w, out_h), out_contract(out_w, out_h);
+        Func f_plain = p == 0 ? make_resize(in, 1.5f) : make_bilateral_grid(in);
+        Func f_contract = p == 0 ? make_resize(in, 1.5f) : make_bilateral_grid(in);
+        double t_plain = time_realize(f_plain, out_plain, plain);
+        double t_contract = time_realize(f_contract, out_contract, contract);
+        printf("%s: %1.3gms without contraction, %1.3gms with (%1.3gx)\n",
+               names[p], t_plain, t_contract, t_plain / t_contract);
+
+        // Fusing changes the rounding, but only slightly.
+        for (int y = 0; y < out_h; y++) {
+            for (int x = 0; x < out_w; x++) {
+                float a = out_plain(x, y), b = out_contract(x, y);
+                if (a - b > 0.001f || b - a > 0.001f) {
+                    printf("%s output differs at %d, %d: %f vs %f\n", names[p], x, y, a, b);
+                    return -1;
+                }
+            }
+        }
+
+        slower = slower || t_contract > t_plain;
+    }
+
+    if (slower) {
+        printf("Contracting a*b + c made things slower\n");
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
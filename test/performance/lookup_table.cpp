@@ -0,0 +1,136 @@
+#include <Halide.h>
+#include <stdio.h>
+#include "clock.h"
+
+using namespace Halide;
+
+// A tone curve: a float lookup table indexed by the top 12 bits of a
+// 16-bit input, as in a raw pipeline.
+Func make_tone_curve(ImageParam in, ImageParam curve) {
+    Var x, y;
+    Func f;
+    f(x, y) = curve(in(x, y) >> 4) * 0.5f;
+    f.vectorize(x, 8);
+    return f;
+}
+
+// A posterizing lookup into a table of 16 bytes.
+Func make_posterize(ImageParam in, ImageParam levels) {
+    Var x, y;
+    Func f;
+    f(x, y) = levels(in(x, y) / 16);
+    f.vectorize(x, 16);
+    return f;
+}
+
+template<typename T>
+double time_realize(Func f, Image<T> out, const Target &t) {
+    f.realize(out, t);
+    double best = 0;
+    for (int i = 0; i < 5; i++) {
+        double t1 = current_time();
+        for (int j = 0; j < 5; j++) {
+            f.realize(out, t);
+        }
+        double t2 = current_time();
+        if (i == 0 || t2 - t1 < best) best = t2 - t1;
+    }
+    return best / 5;
+}
+
+int main(int argc, char **argv) {
+    Target t = get_jit_target_from_environment();
+    if (t.arch != Target::X86 || !(t.features & Target::SSE41)) {
+        printf("No sse4.1 on this target. Skipping test.\n");
+        return 0;
+    }
+
+    const int W = 1920, H = 1080;
+    bool slower = false;
+
+    if (t.features & Target::AVX2) {
+        Image<uint16_t> input(W, H);
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                input(x, y) = (uint16_t)rand();
+            }
+        }
+        Image<float> table(4096);
+        for (int i = 0; i < 4096; i++) {
+            table(i) = (float)(i * i) / (4096 * 4096);
+        }
+        ImageParam in(UInt(16), 2), curve(Float(32), 1);
+        in.set(input);
+        curve.set(table);
+
+        Target no_gather = t;
+        no_gather.features &= ~(Target::AVX2 | Target::AVX512 | Target::AVX512_Skylake);
+
+        Image<float> out_gather(W, H), out_scalar(W, H);
+        double t_gather = time_realize(make_tone_curve(in, curve), out_gather, t);
+        double t_scalar = time_realize(make_tone_curve(in, curve), out_scalar, no_gather);
+        printf("tone curve: %1.3gms with scalar loads, %1.3gms with vpgatherdd (%1.3gx)\n",
+               t_scalar, t_gather, t_scalar / t_gather);
+
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                float correct = table(input(x, y) >> 4) * 0.5f;
+                if (out_gather(x, y) != correct || out_scalar(x, y) != correct) {
+                    printf("tone curve at %d, %d: %f and %f instead of %f\n",
+                           x, y, out_gather(x, y), out_scalar(x, y), correct);
+                    return -1;
+                }
+            }
+        }
+        slower = slower || t_gather > t_scalar;
+    } else {
+        printf("No avx2 on this target. Skipping the gather benchmark.\n");
+    }
+
+    {
+        Image<uint8_t> input(W, H);
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                input(x, y) = (uint8_t)rand();
+            }
+        }
+        Image<uint8_t> table(16);
+        for (int i = 0; i < 16; i++) {
+            table(i) = (uint8_t)(255 - i * 17);
+        }
+        ImageParam in(UInt(8), 2), levels(UInt(8), 1);
+        in.set(input);
+        levels.set(table);
+
+        Target no_pshufb = t;
+        no_pshufb.features &= ~(Target::SSE41 | Target::AVX | Target::AVX2 |
+                                Target::AVX512 | Target::AVX512_Skylake |
+                                Target::FMA | Target::F16C);
+
+        Image<uint8_t> out_pshufb(W, H), out_scalar(W, H);
+        double t_pshufb = time_realize(make_posterize(in, levels), out_pshufb, t);
+        double t_scalar = time_realize(make_posterize(in, levels), out_scalar, no_pshufb);
+        printf("posterize: %1.3gms with scalar loads, %1.3gms with pshufb (%1.3gx)\n",
+               t_scalar, t_pshufb, t_scalar / t_pshufb);
+
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                uint8_t correct = table(input(x, y) / 16);
+                if (out_pshufb(x, y) != correct || out_scalar(x, y) != correct) {
+                    printf("posterize at %d, %d: %d and %d instead of %d\n",
+                           x, y, out_pshufb(x, y), out_scalar(x, y), correct);
+                    return -1;
+                }
+            }
+        }
+        slower = slower || t_pshufb > t_scalar;
+    }
+
+    if (slower) {
+        printf("Vector table lookups were slower than scalar loads\n");
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include <Halide.h>
+#include <stdio.h>
+#include "clock.h"
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    const int W = 2048, H = 2048;
+
+    Image<float> input(W + 4, H + 4);
+    for (int y = 0; y < input.height(); y++) {
+        for (int x = 0; x < input.width(); x++) {
+            input(x, y) = (float)rand() / RAND_MAX;
+        }
+    }
+
+    // A shared 5x5 blur, consumed by a full-resolution result, a
+    // preview, and a mean.
+    Var x, y;
+    RDom k(0, 5, 0, 5);
+    Func blur;
+    blur(x, y) = sum(input(x + k.x, y + k.y)) / 25.0f;
+    blur.compute_root().vectorize(x, 8).parallel(y);
+
+    Func full, preview, mean;
+    full(x, y) = sqrt(blur(x, y));
+    full.vectorize(x, 8).parallel(y);
+
+    preview(x, y) = (blur(4*x, 4*y) + blur(4*x+2, 4*y+2)) / 2;
+    preview.vectorize(x, 8);
+
+    RDom r(0, W, 0, H);
+    mean() = 0.0f;
+    mean() += blur(r.x, r.y) / (W * H);
+
+    Image<float> full_im(W, H), preview_im(W/4, H/4), mean_im(0);
+
+    std::vector<Func> outputs;
+    outputs.push_back(full);
+    outputs.push_back(preview);
+    outputs.push_back(mean);
+    Pipeline p(outputs);
+    Realization dst(full_im, preview_im, mean_im);
+
+    // Warm up the jit
+    full.realize(full_im);
+    preview.realize(preview_im);
+    mean.realize(mean_im);
+    p.realize(dst);
+
+    double t_separate = 0, t_pipeline = 0;
+    for (int i = 0; i < 5; i++) {
+        double t1 = current_time();
+        full.realize(full_im);
+        preview.realize(preview_im);
+        mean.realize(mean_im);
+        double t2 = current_time();
+        p.realize(dst);
+        double t3 = current_time();
+        if (i == 0 || t2 - t1 < t_separate) t_separate = t2 - t1;
+        if (i == 0 || t3 - t2 < t_pipeline) t_pipeline = t3 - t2;
+    }
+
+    printf("Separate realizations: %1.3gms, one pipeline: %1.3gms. Speedup = %1.3f\n",
+           t_separate, t_pipeline, t_separate / t_pipeline);
+
+    if (t_pipeline > t_separate) {
+        printf("Computing the outputs in one pipeline was slower than computing them separately\n");
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,130 @@
+#include <Halide.h>
+#include <stdio.h>
+#include <stdint.h>
+#include "clock.h"
+
+using namespace Halide;
+
+double time_realize(Func f, Buffer out) {
+    f.realize(out);
+    double best = 0;
+    for (int i = 0; i < 5; i++) {
+        double t1 = current_time();
+        for (int j = 0; j < 5; j++) {
+            f.realize(out);
+        }
+        double t2 = current_time();
+        if (i == 0 || t2 - t1 < best) best = t2 - t1;
+    }
+    return best / 5;
+}
+
+Expr i32(Expr e) {
+    return cast<int32_t>(e);
+}
+
+Expr u16(Expr e) {
+    return cast<uint16_t>(e);
+}
+
+int main(int argc, char **argv) {
+    const int W = 1920, H = 1080;
+    Target t = get_jit_target_from_environment();
+    int vec = t.natural_vector_size<uint8_t>();
+
+    Image<uint8_t> input(W + 2, H + 2);
+    for (int y = 0; y < H + 2; y++) {
+        for (int x = 0; x < W + 2; x++) {
+            input(x, y) = (uint8_t)rand();
+        }
+    }
+
+    bool slower = false;
+
+    // A 3x3 blur of a uint8 image written with int32 math, which
+    // should be done in 16 bits, against the same blur written in 16
+    // bits by hand.
+    {
+        Var x, y;
+        Func blur_x_32, blur_32, blur_x_16, blur_16;
+        blur_x_32(x, y) = i32(input(x, y)) + 2 * i32(input(x + 1, y)) + i32(input(x + 2, y));
+        blur_32(x, y) = cast<uint8_t>((blur_x_32(x, y) + 2 * blur_x_32(x, y + 1) + blur_x_32(x, y + 2) + 8) / 16);
+        blur_x_16(x, y) = u16(input(x, y)) + 2 * u16(input(x + 1, y)) + u16(input(x + 2, y));
+        blur_16(x, y) = cast<uint8_t>((blur_x_16(x, y) + 2 * blur_x_16(x, y + 1) + blur_x_16(x, y + 2) + 8) / 16);
+
+        // The first stage is stored, so its storage gets narrowed too.
+        blur_x_32.compute_root().vectorize(x, vec);
+        blur_32.vectorize(x, vec);
+        blur_x_16.compute_root().vectorize(x, vec);
+        blur_16.vectorize(x, vec);
+
+        Image<uint8_t> out_32(W, H), out_16(W, H);
+        double t_32 = time_realize(blur_32, out_32);
+        double t_16 = time_realize(blur_16, out_16);
+
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                int sum = 0;
+                for (int dy = 0; dy < 3; dy++) {
+                    for (int dx = 0; dx < 3; dx++) {
+                        int w = (dx == 1 ? 2 : 1) * (dy == 1 ? 2 : 1);
+                        sum += w * input(x + dx, y + dy);
+                    }
+                }
+                uint8_t correct = (uint8_t)((sum + 8) / 16);
+                if (out_32(x, y) != correct || out_16(x, y) != correct) {
+                    printf("blur(%d, %d) = %d and %d instead of %d\n",
+                           x, y, out_32(x, y), out_16(x, y), correct);
+                    return -1;
+                }
+            }
+        }
+
+        printf("blur: %1.3gms with int32 math, %1.3gms with uint16 math\n",
+               t_32 * 1000, t_16 * 1000);
+        slower = slower || t_32 > t_16 * 1.2;
+    }
+
+    // Brightening by a Param with a known range, clamped to 8
+    // bits. The sum fits in 16 bits because of the range.
+    {
+        Param<int> offset;
+        offset.set_range(0, 64);
+        offset.set(17);
+
+        Var x, y;
+        Func brighter_32, brighter_16;
+        brighter_32(x, y) = cast<uint8_t>(min(i32(input(x, y)) + offset, 255));
+        brighter_16(x, y) = cast<uint8_t>(min(u16(input(x, y)) + u16(offset), 255));
+        brighter_32.vectorize(x, vec);
+        brighter_16.vectorize(x, vec);
+
+        Image<uint8_t> out_32(W, H), out_16(W, H);
+        double t_32 = time_realize(brighter_32, out_32);
+        double t_16 = time_realize(brighter_16, out_16);
+
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                int v = input(x, y) + 17;
+                uint8_t correct = (uint8_t)(v > 255 ? 255 : v);
+                if (out_32(x, y) != correct || out_16(x, y) != correct) {
+                    printf("brighter(%d, %d) = %d and %d instead of %d\n",
+                           x, y, out_32(x, y), out_16(x, y), correct);
+                    return -1;
+                }
+            }
+        }
+
+        printf("brighten: %1.3gms with int32 math, %1.3gms with uint16 math\n",
+               t_32 * 1000, t_16 * 1000);
+        slower = slower || t_32 > t_16 * 1.2;
+    }
+
+    if (slower) {
+        printf("Pipelines written with int32 math should be as fast as ones written in 16 bits\n");
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
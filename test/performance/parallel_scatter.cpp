@@ -0,0 +1,95 @@
+#include <Halide.h>
+#include <stdio.h>
+#include "clock.h"
+
+using namespace Halide;
+
+// Time the realization of a function, and return the best of a few runs.
+template<typename T>
+double time_realize(Func f, Image<T> out) {
+    double best = 0;
+    for (int i = 0; i < 5; i++) {
+        double t1 = current_time();
+        f.realize(out);
+        double t2 = current_time();
+        if (i == 0 || t2 - t1 < best) best = t2 - t1;
+    }
+    return best;
+}
+
+int main(int argc, char **argv) {
+    const int W = 4096, H = 4096;
+
+    Image<uint8_t> input(W, H);
+    Image<float> input_f(W, H);
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            input(x, y) = (uint8_t)(rand() & 0xff);
+            input_f(x, y) = (float)(rand() & 0xff) / 255.0f;
+        }
+    }
+
+    // A 256-bin histogram
+    Var x, y, z, ryo, ryi;
+    RDom r(0, W, 0, H);
+    Func hist_serial, hist_private, hist_atomic;
+    hist_serial(x) = 0;
+    hist_serial(cast<int>(input(r.x, r.y))) += 1;
+
+    hist_private(x) = 0;
+    hist_private(cast<int>(input(r.x, r.y))) += 1;
+    hist_private.update().split(r.y, ryo, ryi, 256).parallel_scatter(ryo);
+
+    hist_atomic(x) = 0;
+    hist_atomic(cast<int>(input(r.x, r.y))) += 1;
+    hist_atomic.update().split(r.y, ryo, ryi, 256).parallel_scatter(ryo, Scatter_Atomic);
+
+    Image<int> hist_out(256);
+    double t_serial = time_realize(hist_serial, hist_out);
+    Image<int> correct = hist_serial.realize(256);
+    double t_private = time_realize(hist_private, hist_out);
+    for (int i = 0; i < 256; i++) {
+        if (hist_out(i) != correct(i)) {
+            printf("Privatized histogram is incorrect at %d: %d instead of %d\n", i, hist_out(i), correct(i));
+            return -1;
+        }
+    }
+    double t_atomic = time_realize(hist_atomic, hist_out);
+    for (int i = 0; i < 256; i++) {
+        if (hist_out(i) != correct(i)) {
+            printf("Atomic histogram is incorrect at %d: %d instead of %d\n", i, hist_out(i), correct(i));
+            return -1;
+        }
+    }
+
+    printf("Histogram: serial %1.3gms, privatized %1.3gms (speedup %1.3f), atomic %1.3gms (speedup %1.3f)\n",
+           t_serial, t_private, t_serial / t_private,
+           t_atomic, t_serial / t_atomic);
+
+    // Splat each pixel into a bilateral grid.
+    const int s_sigma = 8, bins = 10;
+    Expr val = clamp(input_f(r.x, r.y), 0.0f, 1.0f);
+    Expr zi = cast<int>(val * (bins - 1) + 0.5f);
+    Func grid_serial, grid_private;
+    grid_serial(x, y, z) = 0.0f;
+    grid_serial(r.x / s_sigma, r.y / s_sigma, zi) += val;
+
+    grid_private(x, y, z) = 0.0f;
+    grid_private(r.x / s_sigma, r.y / s_sigma, zi) += val;
+    grid_private.update().split(r.y, ryo, ryi, 256).parallel_scatter(ryo);
+
+    Image<float> grid_out(W / s_sigma, H / s_sigma, bins);
+    double t_grid_serial = time_realize(grid_serial, grid_out);
+    double t_grid_private = time_realize(grid_private, grid_out);
+
+    printf("Bilateral grid construction: serial %1.3gms, privatized %1.3gms (speedup %1.3f)\n",
+           t_grid_serial, t_grid_private, t_grid_serial / t_grid_private);
+
+    if (t_private > t_serial) {
+        printf("Privatized histogram was slower than the serial one\n");
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include <Halide.h>
+#include <stdio.h>
+#include "clock.h"
+
+using namespace Halide;
+
+// The largest single allocation made while realizing.
+size_t biggest_alloc = 0;
+void *my_malloc(void *, size_t x) {
+    if (x > biggest_alloc) biggest_alloc = x;
+    void *orig = malloc(x+32);
+    void *ptr = (void *)((((size_t)orig + 32) >> 5) << 5);
+    ((void **)ptr)[-1] = orig;
+    return ptr;
+}
+
+void my_free(void *, void *ptr) {
+    free(((void**)ptr)[-1]);
+}
+
+enum Strategy {Sliding, Parallel, Strips};
+
+// A blur with a tall vertical footprint, so that recomputing the
+// horizontal pass per row is expensive.
+Func blur(ImageParam in, Strategy strategy) {
+    Var x, y, strip, row;
+    Func blur_x, blur_y;
+    blur_x(x, y) = (in(x, y) + in(x+1, y) + in(x+2, y)) / 3;
+    blur_y(x, y) = (blur_x(x, y) + blur_x(x, y+1) + blur_x(x, y+2) +
+                    blur_x(x, y+3) + blur_x(x, y+4)) / 5;
+
+    blur_y.vectorize(x, 8);
+    blur_x.vectorize(x, 8);
+    if (strategy == Sliding) {
+        // Reuse the rows, on one core
+        blur_x.store_root().compute_at(blur_y, y);
+    } else if (strategy == Parallel) {
+        // Use all the cores, recomputing the rows
+        blur_y.parallel(y);
+        blur_x.compute_at(blur_y, y);
+    } else {
+        blur_y.parallel_strips(y, strip, row, 16);
+        blur_x.store_at(blur_y, strip).compute_at(blur_y, row);
+    }
+    return blur_y;
+}
+
+double time_realize(Func f, Image<float> out) {
+    f.realize(out);
+    double best = 0;
+    for (int i = 0; i < 5; i++) {
+        double t1 = current_time();
+        f.realize(out);
+        double t2 = current_time();
+        if (i == 0 || t2 - t1 < best) best = t2 - t1;
+    }
+    return best;
+}
+
+int main(int argc, char **argv) {
+    const int W = 4096, H = 4096;
+
+    Image<float> input(W + 2, H + 4);
+    for (int y = 0; y < input.height(); y++) {
+        for (int x = 0; x < input.width(); x++) {
+            input(x, y) = (float)rand() / RAND_MAX;
+        }
+    }
+    ImageParam in(Float(32), 2);
+    in.set(input);
+
+    Image<float> out(W, H);
+
+    const char *names[] = {"sliding window", "parallel", "parallel strips"};
+    double times[3];
+    size_t mem[3];
+    for (int i = 0; i < 3; i++) {
+        Func f = blur(in, (Strategy)i);
+        times[i] = time_realize(f, out);
+
+        // Measure the largest buffer. The strips allocate
+        // concurrently, but their buffers are all the same size.
+        Func g = blur(in, (Strategy)i);
+        g.set_custom_allocator(my_malloc, my_free);
+        biggest_alloc = 0;
+        g.realize(out);
+        mem[i] = biggest_alloc;
+        printf("%s: %1.3gms, largest allocation %d bytes\n", names[i], times[i], (int)mem[i]);
+    }
+
+    if (times[Strips] > times[Sliding] || times[Strips] > times[Parallel]) {
+        printf("Parallel strips were slower than one of the existing options\n");
+        return -1;
+    }
+
+    // Each strip's buffer should be folded, so it should be no bigger
+    // than the buffer of the serial sliding window.
+    if (mem[Strips] > mem[Sliding]) {
+        printf("The buffer of each strip was larger than the sliding window's buffer\n");
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,75 @@
+#include <Halide.h>
+#include <stdio.h>
+#include "clock.h"
+
+using namespace Halide;
+
+// Time the realization of a function, and return the best of a few runs.
+double time_realize(Func f, Image<uint16_t> out) {
+    double best = 0;
+    for (int i = 0; i < 5; i++) {
+        double t1 = current_time();
+        f.realize(out);
+        double t2 = current_time();
+        if (i == 0 || t2 - t1 < best) best = t2 - t1;
+    }
+    return best;
+}
+
+int main(int argc, char **argv) {
+    const int W = 2048, H = 2048;
+
+    // Give the input a border, so that the unclamped blur can read
+    // past the edges of the output.
+    Image<uint16_t> input(W + 2, H + 2);
+    for (int y = 0; y < H + 2; y++) {
+        for (int x = 0; x < W + 2; x++) {
+            input(x, y) = (uint16_t)(rand() & 0xfff);
+        }
+    }
+
+    Var x, y;
+
+    // A 3x3 box blur that clamps its reads to the output region, and
+    // one that doesn't need to.
+    Func clamped, blur_clamped, blur_unclamped;
+    clamped(x, y) = input(clamp(x, 0, W - 1) + 1, clamp(y, 0, H - 1) + 1);
+    Expr sum_clamped = 0, sum_unclamped = 0;
+    for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            sum_clamped += clamped(x + dx, y + dy);
+            sum_unclamped += input(x + dx + 1, y + dy + 1);
+        }
+    }
+    blur_clamped(x, y) = cast<uint16_t>(sum_clamped / 9);
+    blur_unclamped(x, y) = cast<uint16_t>(sum_unclamped / 9);
+    blur_clamped.vectorize(x, 8);
+    blur_unclamped.vectorize(x, 8);
+
+    Image<uint16_t> out_clamped(W, H), out_unclamped(W, H);
+    double t_clamped = time_realize(blur_clamped, out_clamped);
+    double t_unclamped = time_realize(blur_unclamped, out_unclamped);
+
+    printf("Clamped blur: %1.3gms, unclamped blur: %1.3gms. Ratio = %1.3f\n",
+           t_clamped, t_unclamped, t_clamped / t_unclamped);
+
+    // In the interior the two blurs compute the same thing, and the
+    // clamps should have been partitioned away from there.
+    for (int y = 1; y < H - 1; y++) {
+        for (int x = 1; x < W - 1; x++) {
+            if (out_clamped(x, y) != out_unclamped(x, y)) {
+                printf("out_clamped(%d, %d) = %d instead of %d\n",
+                       x, y, out_clamped(x, y), out_unclamped(x, y));
+                return -1;
+            }
+        }
+    }
+
+    if (t_clamped > 1.5 * t_unclamped) {
+        printf("Clamping cost too much. The loops were probably not partitioned.\n");
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
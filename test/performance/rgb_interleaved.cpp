@@ -124,6 +124,64 @@ int main(int argc, char **argv) {
 
     printf("Interleaved to semi-planar bandwidth %.3e byte/s.\n", (buffer_size / (t4 - t3)) * 1000 * iterations);
 
+    // Now go the other way, from planar to interleaved. The stores
+    // of the three channels become a single three-way interleaving.
+    ImageParam planar(UInt(8), 3);
+    Func interleaved;
+    interleaved(x, y, c) = planar(x, y, c);
+
+    planar.set_stride(0, 1);
+    planar.set_extent(2, 3);
+    interleaved.output_buffer().set_stride(0, 3);
+    interleaved.output_buffer().set_stride(2, 1);
+    interleaved.output_buffer().set_extent(2, 3);
+
+    interleaved.reorder(c, x, y).bound(c, 0, 3).unroll(c);
+    interleaved.vectorize(x, 16);
+
+    // The planar image from the test above is the input, and the
+    // interleaved buffer is the output.
+    memset(&dst_buffer, 0, sizeof(dst_buffer));
+    dst_buffer.host = dst_storage;
+    dst_buffer.extent[0] = buffer_side_length;
+    dst_buffer.stride[0] = 1;
+    dst_buffer.extent[1] = buffer_side_length;
+    dst_buffer.stride[1] = dst_buffer.stride[0] * dst_buffer.extent[0];
+    dst_buffer.extent[2] = 3;
+    dst_buffer.stride[2] = dst_buffer.stride[1] * dst_buffer.extent[1];
+    dst_buffer.elem_size = 1;
+    Image<uint8_t> planar_image(&dst_buffer, "planar_image");
+
+    for (int32_t x = 0; x < buffer_side_length; x++) {
+        for (int32_t y = 0; y < buffer_side_length; y++) {
+            planar_image(x, y, 0) = 0;
+            planar_image(x, y, 1) = 128;
+            planar_image(x, y, 2) = 255;
+        }
+    }
+    memset(src_storage, 0, buffer_size * 3);
+
+    planar.set(planar_image);
+    interleaved.compile_jit();
+    interleaved.realize(src_image);
+
+    double t5 = current_time();
+
+    for (int i = 0; i < iterations; i++)
+        interleaved.realize(src_image);
+
+    double t6 = current_time();
+
+    for (int32_t x = 0; x < buffer_side_length; x++) {
+        for (int32_t y = 0; y < buffer_side_length; y++) {
+            assert(src_image(x, y, 0) == 0);
+            assert(src_image(x, y, 1) == 128);
+            assert(src_image(x, y, 2) == 255);
+        }
+    }
+
+    printf("Planar to interleaved bandwidth %.3e byte/s.\n", (buffer_size / (t6 - t5)) * 1000 * iterations);
+
     delete[] src_storage;
     delete[] dst_storage;
 
@@ -0,0 +1,120 @@
+#include <Halide.h>
+#include <stdio.h>
+#include <math.h>
+#include "clock.h"
+
+using namespace Halide;
+
+enum Op {Sin, Cos, FastSin, FastCos};
+const char *op_names[] = {"sin", "cos", "fast_sin", "fast_cos"};
+
+Expr apply(Op op, Expr x) {
+    switch (op) {
+    case Sin: return sin(x);
+    case Cos: return cos(x);
+    case FastSin: return fast_sin(x);
+    default: return fast_cos(x);
+    }
+}
+
+double reference(Op op, float x) {
+    return (op == Sin || op == FastSin) ? sin((double)x) : cos((double)x);
+}
+
+double time_realize(Func f, Image<float> out) {
+    f.realize(out);
+    double best = 0;
+    for (int i = 0; i < 5; i++) {
+        double t1 = current_time();
+        for (int j = 0; j < 5; j++) {
+            f.realize(out);
+        }
+        double t2 = current_time();
+        if (i == 0 || t2 - t1 < best) best = t2 - t1;
+    }
+    return best / 5;
+}
+
+int main(int argc, char **argv) {
+    Target t = get_jit_target_from_environment();
+    if (t.arch != Target::X86 && t.arch != Target::ARM) {
+        printf("No vector math library for this target. Skipping test.\n");
+        return 0;
+    }
+
+    // Inputs spanning [-100, 100], which covers many periods.
+    const int N = 1 << 20;
+    Image<float> input(N);
+    for (int i = 0; i < N; i++) {
+        input(i) = (i - N / 2) * (200.0f / N);
+    }
+    ImageParam in(Float(32), 1);
+    in.set(input);
+
+    const int vec = t.natural_vector_size<float>();
+    // The fast variants are allowed a looser tolerance.
+    const double tolerance[] = {1e-6, 1e-6, 1e-4, 1e-4};
+    bool slower = false;
+    for (int op = Sin; op <= FastCos; op++) {
+        Var x;
+        Func scalar, vectorized;
+        scalar(x) = apply((Op)op, in(x));
+        vectorized(x) = apply((Op)op, in(x));
+        vectorized.vectorize(x, vec);
+
+        Image<float> out_scalar(N), out_vector(N);
+        double t_scalar = time_realize(scalar, out_scalar);
+        double t_vector = time_realize(vectorized, out_vector);
+
+        double max_err = 0;
+        for (int i = 0; i < N; i++) {
+            double err = fabs(out_vector(i) - reference((Op)op, input(i)));
+            if (err > max_err) max_err = err;
+        }
+
+        printf("%s: max error %g, %1.3gms scalar, %1.3gms vectorized (%1.3gx)\n",
+               op_names[op], max_err, t_scalar, t_vector, t_scalar / t_vector);
+
+        if (max_err > tolerance[op]) {
+            printf("%s is not accurate enough when vectorized\n", op_names[op]);
+            return -1;
+        }
+
+        slower = slower || t_vector > t_scalar;
+    }
+
+    // Out of range arguments give nan rather than garbage.
+    {
+        Var x;
+        Func f;
+        Image<float> special(8);
+        special(0) = INFINITY;
+        special(1) = -INFINITY;
+        special(2) = NAN;
+        special(3) = 1e10f;
+        for (int i = 4; i < 8; i++) special(i) = 0.0f;
+        f(x) = sin(special(x)) + cos(special(x));
+        f.vectorize(x, 4);
+        Image<float> out = f.realize(8);
+        for (int i = 0; i < 4; i++) {
+            if (!isnan(out(i))) {
+                printf("sin + cos of %f is %f instead of nan\n", special(i), out(i));
+                return -1;
+            }
+        }
+        for (int i = 4; i < 8; i++) {
+            if (out(i) != 1.0f) {
+                printf("sin + cos of 0 is %f instead of 1\n", out(i));
+                return -1;
+            }
+        }
+    }
+
+    if (slower) {
+        printf("Vectorized transcendentals were slower than scalar ones\n");
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
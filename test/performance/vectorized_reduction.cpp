@@ -0,0 +1,91 @@
+#include <Halide.h>
+#include <stdio.h>
+#include "clock.h"
+
+using namespace Halide;
+
+template<typename A>
+const char *string_of_type();
+
+#define DECL_SOT(name)                                          \
+    template<>                                                  \
+    const char *string_of_type<name>() {return #name;}
+
+DECL_SOT(uint8_t);
+DECL_SOT(uint16_t);
+DECL_SOT(int32_t);
+DECL_SOT(float);
+
+// Compare a dot product of each row of an image with a kernel,
+// vectorized across the reduction domain, to the scalar version.
+template<typename A>
+bool test(int vec_width) {
+    const int W = 1024;
+    const int H = 2048;
+
+    Image<A> input(W, H), kernel(W);
+    for (int x = 0; x < W; x++) {
+        kernel(x) = (A)(rand() % 4);
+        for (int y = 0; y < H; y++) {
+            input(x, y) = (A)(rand() % 16);
+        }
+    }
+
+    Var y, rxo, rxi;
+    RDom r(0, W);
+    Func f, g;
+
+    f(y) = cast<A>(0);
+    f(y) += input(r, y) * kernel(r);
+    f.update().split(r, rxo, rxi, vec_width).vectorize(rxi);
+
+    g(y) = cast<A>(0);
+    g(y) += input(r, y) * kernel(r);
+
+    Image<A> outputf = f.realize(H);
+    Image<A> outputg = g.realize(H);
+
+    double t1 = current_time();
+    for (int i = 0; i < 10; i++) {
+        g.realize(outputg);
+    }
+    double t2 = current_time();
+    for (int i = 0; i < 10; i++) {
+        f.realize(outputf);
+    }
+    double t3 = current_time();
+
+    for (int y = 0; y < H; y++) {
+        if (outputf(y) != outputg(y)) {
+            printf("%s x %d failed: %f vs %f\n",
+                   string_of_type<A>(), vec_width,
+                   (double)outputf(y),
+                   (double)outputg(y));
+            return false;
+        }
+    }
+
+    printf("Vectorized vs scalar reduction (%s x %d): %1.3gms %1.3gms. Speedup = %1.3f\n",
+           string_of_type<A>(), vec_width, (t3-t2), (t2-t1), (t2-t1)/(t3-t2));
+
+    if ((t3 - t2) > (t2 - t1)) {
+        return false;
+    }
+
+    return true;
+}
+
+int main(int argc, char **argv) {
+
+    bool ok = true;
+
+    ok = ok && test<float>(4);
+    ok = ok && test<float>(8);
+    ok = ok && test<uint8_t>(16);
+    ok = ok && test<uint16_t>(8);
+    ok = ok && test<int32_t>(4);
+
+    if (!ok) return -1;
+    printf("Success!\n");
+    return 0;
+}